@@ -0,0 +1,343 @@
+/** Compiler libs **/
+#include <xc.h>             // Using standard macros and register access for debug
+#include <stdio.h>
+#include <string.h>
+
+/** Custom libs **/
+#include "ConfigBits.h"     // Provide configuration bits, specific to PIC32 devices
+#include "nRF24L01.h"
+#include "nRF24L01_codec.h"
+#include "nRF24L01_aead.h"
+#include "benchmark_thresholds.h"  // Regression thresholds, shared with host/bench_test.c
+
+/* NOTE: Build this example (and nRF24L01.c) with -DNRF_BENCH_ENABLE=1 */
+#if !NRF_BENCH_ENABLE
+    #error "Benchmark example requires NRF_BENCH_ENABLE=1"
+#endif
+
+/** Test macros **/
+#define BENCH_ROLE_PTX                  // Comment out to benchmark PRX paths
+#define BENCH_ITERATIONS    5000
+#define BENCH_CS            GPIO_RPB7
+#define BENCH_CE            GPIO_RPB10
+#define BENCH_SDI           SDI1_RPB8
+#define BENCH_SDO           SDO1_RPB11
+#define BENCH_IRQ           INT2_RPB13
+#define BENCH_SPI_MODULE    SPI1_MODULE
+#define PRX_ADDR            (0xB3B4B5B605)
+#define CODEC_FIELDS        6
+#define CODEC_FRAMES        240
+#define CODEC_MIN_PACKING   2       // Minimum samples per packet
+#define AEAD_FRAMES         200
+
+/* Benchmark helpers */
+static bool BenchReport(void);
+static bool BenchCodec(void);
+static bool BenchAead(void);
+void BenchOutput(const char *line);
+
+int main(int argc, char** argv)
+{
+    /* Oscillator configuration parameters */
+    OscConfig_t oscConfig = {
+        .oscSource = OSC_COSC_FRCPLL,
+        .sysFreq = 40000000,
+        .pbFreq = 40000000
+    };
+
+    /* SPI configuration parameters */
+    SpiStandardConfig_t spiConfig = {
+        .pinSelect = {
+            .sdiPin = BENCH_SDI,
+            .sdoPin = BENCH_SDO,
+            .ss1Pin = BENCH_CS
+        },
+        .isMasterEnabled = true,
+        .frameWidth = SPI_WIDTH_8BIT,
+        .sckFreq = 1000000,
+        .clkMode = SPI_CLK_MODE_0
+    };
+
+    /* Configure pre-initialized oscillator module */
+    OSC_ConfigOsc(oscConfig);
+
+    /* Initialize SPI module for nRF24L01+ communication */
+    SPI_ConfigStandardModeSfr(&BENCH_SPI_MODULE, spiConfig);
+
+    uint8_t txData[32] = {0x5A, 0x32, 0x3D, 0x01, 0xD9, 0x56, 0x43, 0x5F,
+                          0x4D, 0x3F, 0xE2, 0xFD, 0x55, 0x8E, 0xEE, 0xE7,
+                          0x90, 0xFC, 0x57, 0xE1, 0xE8, 0x4C, 0xFD, 0xAC,
+                          0x04, 0xAE, 0x45, 0xF5, 0xD3, 0x41, 0x20, 0x0D};
+    uint8_t rxData[32];
+
+#if defined BENCH_ROLE_PTX
+
+    /* PTX configuration structure */
+    NrfPtxConfig_t ptxConfig = {
+        .spiSfr = &BENCH_SPI_MODULE,
+        .isAck = true,
+        .retrDelay = NRF_ARD_1000,
+        .retrCount = NRF_ARC_15,
+        .rfChannel = NRF_RF_CH_2,
+        .rfPower = NRF_RF_PWR_MIN,
+        .dataRate = NRF_RF_DR_2000,
+        .pinConfig = {
+            .cePin = BENCH_CE,
+            .csPin = BENCH_CS,
+            .irqPin = BENCH_IRQ
+        }
+    };
+
+    NRF_ConfigPtxSfr(ptxConfig);
+    NrfPayloadConfig_t payloadConfig = NRF_ConfigPtxPayloadStruct(ptxConfig, PRX_ADDR);
+    NRF_ResetBenchStats();
+
+    /* Polling-based path */
+    for(uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        NRF_SendReceivePayload(payloadConfig, rxData, txData, sizeof(txData));
+    }
+
+    /* Interrupt-based path (wait for each operation to conclude) */
+    for(uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        NRF_SendPayload(payloadConfig, rxData, txData, sizeof(txData));
+        while( NRF_ReadStatus() == NRF_FLAG_NO_STATUS );
+    }
+
+#else
+
+    /* PRX configuration structure (peer runs the PTX role of this example) */
+    NrfPrxConfig_t prxConfig = {
+        .spiSfr = &BENCH_SPI_MODULE,
+        .isAck = true,
+        .dataRate = NRF_RF_DR_2000,
+        .rfChannel = NRF_RF_CH_2,
+        .pipeAddr = {
+            .pipe5 = PRX_ADDR
+        },
+        .pinConfig = {
+            .cePin = BENCH_CE,
+            .csPin = BENCH_CS,
+            .irqPin = BENCH_IRQ
+        }
+    };
+
+    NRF_ConfigPrxSfr(prxConfig);
+    NrfPayloadConfig_t payloadConfig = NRF_ConfigPrxPayloadStruct(prxConfig);
+    NRF_ResetBenchStats();
+    NRF_StartReception(payloadConfig, rxData);
+
+    /* Reload ACK payload after every reception */
+    NrfBenchStats_t stats;
+    uint32_t received = 0;
+    while( received < BENCH_ITERATIONS )
+    {
+        NRF_ReadBenchStats(NRF_BENCH_READ_PAYLOAD, &stats);
+        if( stats.calls != received )
+        {
+            received = stats.calls;
+            NRF_StoreAckPayload(payloadConfig, NRF_RX_PIPE_5, txData, 3);
+        }
+    }
+
+    NRF_StopReception(payloadConfig);
+
+#endif
+
+    bool isPassed = BenchReport();
+    isPassed &= BenchCodec();
+    isPassed &= BenchAead();
+
+    /* Main program execution */
+    while(1)
+    {
+        /* Inspect "isPassed" with debugger or route BenchOutput() to UART */
+        (void)isPassed;
+    }
+
+    return 0;
+}
+
+/*
+ *  Emits one CSV line per path (header first) and checks thresholds
+ */
+static bool BenchReport(void)
+{
+    char line[128];
+    bool isPassed = true;
+
+    BenchOutput("path,calls,spi_transactions,spi_bytes,copy_iterations,core_ticks,status\n");
+
+    for(uint8_t i = 0; i < sizeof(benchThreshold) / sizeof(benchThreshold[0]); i++)
+    {
+        NrfBenchStats_t stats;
+        NRF_ReadBenchStats(benchThreshold[i].path, &stats);
+
+        /* Path not exercised by this role */
+        if( stats.calls == 0 )
+        {
+            continue;
+        }
+
+        uint32_t spiTransactions = stats.spiTransactions / stats.calls;
+        uint32_t spiBytes = stats.spiBytes / stats.calls;
+        uint32_t copyIterations = stats.copyIterations / stats.calls;
+        uint32_t coreTicks = stats.coreTicks / stats.calls;
+
+        bool isPathPassed = (spiTransactions <= benchThreshold[i].maxSpiTransactions) &&
+                            (spiBytes <= benchThreshold[i].maxSpiBytes) &&
+                            (copyIterations <= benchThreshold[i].maxCopyIterations);
+        isPassed &= isPathPassed;
+
+        snprintf(line, sizeof(line), "%s,%lu,%lu,%lu,%lu,%lu,%s\n",
+                 benchThreshold[i].name, (unsigned long)stats.calls,
+                 (unsigned long)spiTransactions, (unsigned long)spiBytes,
+                 (unsigned long)copyIterations, (unsigned long)coreTicks,
+                 isPathPassed ? "pass" : "FAIL");
+        BenchOutput(line);
+    }
+
+    return isPassed;
+}
+
+/*
+ *  Encodes and decodes synthetic sensor frames (codec cost is radio-free), and
+ *  checks round trip and packing density
+ */
+static bool BenchCodec(void)
+{
+    static int32_t frames[CODEC_FRAMES * CODEC_FIELDS];
+    static int32_t decoded[CODEC_FRAMES * CODEC_FIELDS];
+    static NrfCodecCtx_t txCtx, rxCtx;
+    uint8_t buf[NRF_CODEC_PAYLOAD_SIZE];
+    uint8_t size;
+    char line[128];
+
+    /* Slowly changing readings (temperature, humidity, pressure, 3-axis) */
+    for(uint32_t i = 0; i < CODEC_FRAMES; i++)
+    {
+        int32_t *frame = &frames[i * CODEC_FIELDS];
+        frame[0] = 2150 + (int32_t)(i % 7) - 3;
+        frame[1] = 4500 + (int32_t)(i / 16);
+        frame[2] = 101325 + (int32_t)(i % 5) * 2;
+        frame[3] = (int32_t)((i * 37) % 61) - 30;
+        frame[4] = -1000 + (int32_t)((i * 13) % 23);
+        frame[5] = 16384 - (int32_t)((i * 7) % 19);
+    }
+
+    NRF_CodecInit(&txCtx, CODEC_FIELDS, 16);
+    NRF_CodecInit(&rxCtx, CODEC_FIELDS, 16);
+
+    uint32_t packets = 0;
+    uint32_t bytes = 0;
+    uint32_t encodeTicks = 0;
+    uint32_t decodeTicks = 0;
+    bool isMatch = true;
+
+    for(uint32_t i = 0; i < CODEC_FRAMES; )
+    {
+        uint32_t start = _CP0_GET_COUNT();
+        uint8_t count = NRF_CodecEncode(&txCtx, &frames[i * CODEC_FIELDS], CODEC_FRAMES - i, buf, &size);
+        encodeTicks += _CP0_GET_COUNT() - start;
+
+        start = _CP0_GET_COUNT();
+        uint8_t decodedCount = NRF_CodecDecode(&rxCtx, buf, size, &decoded[i * CODEC_FIELDS], CODEC_FRAMES - i);
+        decodeTicks += _CP0_GET_COUNT() - start;
+
+        /* Lossless link: every packet is acknowledged */
+        NRF_CodecConfirm(&txCtx, true);
+
+        if( (count == 0) || (decodedCount != count) )
+        {
+            isMatch = false;
+            break;
+        }
+
+        i += count;
+        packets++;
+        bytes += size;
+    }
+
+    isMatch &= (memcmp(frames, decoded, sizeof(frames)) == 0);
+    bool isPassed = isMatch && (packets * CODEC_MIN_PACKING <= CODEC_FRAMES);
+
+    BenchOutput("codec,frames,packets,payload_bytes,encode_ticks_per_frame,decode_ticks_per_frame,status\n");
+    snprintf(line, sizeof(line), "codec,%lu,%lu,%lu,%lu,%lu,%s\n",
+             (unsigned long)CODEC_FRAMES, (unsigned long)packets, (unsigned long)bytes,
+             (unsigned long)(encodeTicks / CODEC_FRAMES), (unsigned long)(decodeTicks / CODEC_FRAMES),
+             isPassed ? "pass" : "FAIL");
+    BenchOutput(line);
+
+    return isPassed;
+}
+
+/*
+ *  Seals and opens full frames with keystream precomputed between frames (as
+ *  during air time) and without it, and checks round trip and forgery rejection
+ */
+static bool BenchAead(void)
+{
+    static const uint8_t key[32] = {
+        0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8A, 0x8B, 0x8C, 0x8D, 0x8E, 0x8F,
+        0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0x9B, 0x9C, 0x9D, 0x9E, 0x9F
+    };
+    static NrfAeadCtx_t txCtx, rxCtx, coldCtx;
+    uint8_t plain[NRF_AEAD_MAX_DATA];
+    uint8_t opened[NRF_AEAD_MAX_DATA];
+    uint8_t frame[32];
+    uint8_t frameSize, openedSize;
+    char line[128];
+    bool isMatch = true;
+
+    NRF_AeadInit(&txCtx, key, 0x01);
+    NRF_AeadInit(&rxCtx, key, 0x01);
+    NRF_AeadInit(&coldCtx, key, 0x02);
+
+    for(uint32_t i = 0; i < AEAD_FRAMES; i++)
+    {
+        for(uint8_t j = 0; j < NRF_AEAD_MAX_DATA; j++)
+        {
+            plain[j] = (uint8_t)(i + j);
+        }
+
+        /* Sender generates material of the next frame while this one is on air */
+        NRF_AeadSeal(&txCtx, plain, NRF_AEAD_MAX_DATA, frame, &frameSize);
+        NRF_AeadPrecompute(&txCtx);
+
+        isMatch &= NRF_AeadOpen(&rxCtx, frame, frameSize, opened, &openedSize) &&
+                   (openedSize == NRF_AEAD_MAX_DATA) && (memcmp(plain, opened, openedSize) == 0);
+
+        /* Naive encrypt-then-send reference */
+        NRF_AeadSeal(&coldCtx, plain, NRF_AEAD_MAX_DATA, frame, &frameSize);
+    }
+
+    /* Replayed and forged frames must be rejected */
+    NRF_AeadSeal(&txCtx, plain, NRF_AEAD_MAX_DATA, frame, &frameSize);
+    frame[4] ^= 0x01;
+    isMatch &= !NRF_AeadOpen(&rxCtx, frame, frameSize, opened, &openedSize);
+    isMatch &= (rxCtx.rejected == 1);
+
+    uint32_t sealTicks = txCtx.criticalTicks / txCtx.frames;
+    uint32_t openTicks = rxCtx.criticalTicks / rxCtx.frames;
+    uint32_t coldTicks = coldCtx.criticalTicks / coldCtx.frames;
+    bool isPassed = isMatch && (txCtx.coldFrames == 1) && (sealTicks < coldTicks);
+
+    BenchOutput("aead,frames,seal_ticks_per_frame,open_ticks_per_frame,precompute_ticks_per_frame,cold_seal_ticks_per_frame,status\n");
+    snprintf(line, sizeof(line), "aead,%lu,%lu,%lu,%lu,%lu,%s\n",
+             (unsigned long)AEAD_FRAMES, (unsigned long)sealTicks, (unsigned long)openTicks,
+             (unsigned long)(txCtx.precomputeTicks / AEAD_FRAMES), (unsigned long)coldTicks,
+             isPassed ? "pass" : "FAIL");
+    BenchOutput(line);
+
+    return isPassed;
+}
+
+/*
+ *  Output sink for benchmark results (override to route to UART)
+ */
+void __attribute__((weak)) BenchOutput(const char *line)
+{
+    /* Inspect "line" with debugger */
+    (void)line;
+}
@@ -0,0 +1,50 @@
+#ifndef BENCHMARK_THRESHOLDS_H
+#define	BENCHMARK_THRESHOLDS_H
+
+/* Regression thresholds (per call) for a 32-byte payload and 3-byte ACK
+ * payload, shared by the target benchmark (benchmark.c) and the host one
+ * (host/bench_test.c, run by "make -C host check"). A path fails if any
+ * average exceeds its threshold. Core ticks are not thresholded since they
+ * depend on SYSCLK and SCK; they are reported only */
+
+#include "nRF24L01.h"
+
+/* Byte copies per 32-byte payload through the wide SPI frame stage */
+#if NRF_SPI_BURST_WIDTH == 8
+    #define BENCH_PAYLOAD_COPIES    0
+#else
+    #define BENCH_PAYLOAD_COPIES    32
+#endif
+
+/* A 3-byte ACK payload takes a leading byte and one word in 16-bit frames
+ * (one more transfer), it is too short for 32-bit frames */
+#if NRF_SPI_BURST_WIDTH == 16
+    #define BENCH_ACK_TRANSFERS     1
+    #define BENCH_ACK_COPIES        2
+#else
+    #define BENCH_ACK_TRANSFERS     0
+    #define BENCH_ACK_COPIES        0
+#endif
+
+typedef struct {
+    NrfBenchPath_t  path;
+    const char     *name;
+    uint32_t        maxSpiTransactions;
+    uint32_t        maxSpiBytes;
+    uint32_t        maxCopyIterations;
+} BenchThreshold_t;
+
+static const BenchThreshold_t benchThreshold[] = {
+    { NRF_BENCH_SEND_PAYLOAD,           "send_payload",
+      7,                            49, BENCH_PAYLOAD_COPIES },
+    { NRF_BENCH_SEND_RECEIVE_PAYLOAD,   "send_receive_payload",
+      12 + BENCH_ACK_TRANSFERS,     58, BENCH_PAYLOAD_COPIES + BENCH_ACK_COPIES },
+    { NRF_BENCH_READ_ACK_PAYLOAD,       "read_ack_payload",
+      4 + BENCH_ACK_TRANSFERS,      8,  BENCH_ACK_COPIES },
+    { NRF_BENCH_READ_PAYLOAD,           "read_payload",
+      4,                            37, BENCH_PAYLOAD_COPIES },
+    { NRF_BENCH_STORE_ACK_PAYLOAD,      "store_ack_payload",
+      2 + BENCH_ACK_TRANSFERS,      4,  BENCH_ACK_COPIES },
+};
+
+#endif	/* BENCHMARK_THRESHOLDS_H */
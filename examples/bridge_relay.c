@@ -0,0 +1,125 @@
+/** Compiler libs **/
+#include <xc.h>         // Using standard macros and register access for debug
+
+/** Custom libs **/
+#include "ConfigBits.h" // Provide configuration bits, specific to PIC32 devices
+#include "nRF24L01.h"
+#include "nRF24L01_bridge.h"
+
+/* NOTE: RX radio uses driver INTx (INT2_ISR_MACRO in nRF24L01.h), TX radio
+ *       uses bridge INTx (BRIDGE_INT3_ISR_MACRO in nRF24L01_bridge.h) */
+
+/** Test macros **/
+#define RX_CS           GPIO_RPB4
+#define RX_CE           GPIO_RPB3
+#define RX_SDI          SDI2_RPA4
+#define RX_SDO          SDO2_RPB5
+//#define RX_SCK        GPIO_RPB15      // Fixed pin for SPI2 module
+#define RX_IRQ          INT2_RPB13
+#define RX_SPI_MODULE   SPI2_MODULE
+#define TX_CS           GPIO_RPB7
+#define TX_CE           GPIO_RPB10
+#define TX_SDI          SDI1_RPB8
+#define TX_SDO          SDO1_RPB11
+//#define TX_SCK        GPIO_RPB14      // Fixed pin for SPI1 module
+#define TX_IRQ          INT3_RPB9
+#define TX_SPI_MODULE   SPI1_MODULE
+#define NEXT_HOP_ADDR   (0xC3C4C5C605)
+
+int main(int argc, char** argv)
+{
+    /* Oscillator configuration parameters */
+    OscConfig_t oscConfig = {
+        .oscSource = OSC_COSC_FRCPLL,
+        .sysFreq = 40000000,
+        .pbFreq = 40000000
+    };
+
+    /* SPI configuration parameters for both radios */
+    SpiStandardConfig_t spiRxConfig = {
+        .pinSelect = {
+            .sdiPin = RX_SDI,
+            .sdoPin = RX_SDO,
+            .ss1Pin = RX_CS
+        },
+        .isMasterEnabled = true,
+        .frameWidth = SPI_WIDTH_8BIT,
+        .sckFreq = 8000000,
+        .clkMode = SPI_CLK_MODE_0
+    };
+    SpiStandardConfig_t spiTxConfig = {
+        .pinSelect = {
+            .sdiPin = TX_SDI,
+            .sdoPin = TX_SDO,
+            .ss1Pin = TX_CS
+        },
+        .isMasterEnabled = true,
+        .frameWidth = SPI_WIDTH_8BIT,
+        .sckFreq = 8000000,
+        .clkMode = SPI_CLK_MODE_0
+    };
+
+    /* Configure pre-initialized oscillator module */
+    OSC_ConfigOsc(oscConfig);
+
+    /* Initialize SPI modules for nRF24L01+ communication */
+    SPI_ConfigStandardModeSfr(&RX_SPI_MODULE, spiRxConfig);
+    SPI_ConfigStandardModeSfr(&TX_SPI_MODULE, spiTxConfig);
+
+    /* RX radio listens on channel A */
+    NrfPrxConfig_t prxConfig = {
+        .spiSfr = &RX_SPI_MODULE,
+        .isAck = true,
+        .dataRate = NRF_RF_DR_2000,
+        .rfChannel = NRF_RF_CH_2,
+        .pipeAddr = {
+            .pipe5 = 0xB3B4B5B605
+        },
+        .pinConfig = {
+            .cePin = RX_CE,
+            .csPin = RX_CS,
+            .irqPin = RX_IRQ
+        }
+    };
+
+    /* TX radio sends on channel B */
+    NrfPtxConfig_t ptxConfig = {
+        .spiSfr = &TX_SPI_MODULE,
+        .isAck = true,
+        .retrDelay = NRF_ARD_250,
+        .retrCount = NRF_ARC_5,
+        .rfChannel = NRF_RF_CH_80,
+        .rfPower = NRF_RF_PWR_MAX,
+        .dataRate = NRF_RF_DR_2000,
+        .pinConfig = {
+            .cePin = TX_CE,
+            .csPin = TX_CS,
+            .irqPin = TX_IRQ
+        }
+    };
+
+    /* Configure RX radio and start forwarding before reception starts */
+    NRF_ConfigPrxSfr(prxConfig);
+    NrfPayloadConfig_t prxPayloadConfig = NRF_ConfigPrxPayloadStruct(prxConfig);
+
+    if( !NRF_BridgeStart(ptxConfig, NEXT_HOP_ADDR) )
+    {
+        while(1);   // TX radio not responding
+    }
+
+    /* Received payloads are forwarded from ISR, buffer is reused for each */
+    static uint8_t rxBuffer[32];
+    NRF_StartReception(prxPayloadConfig, rxBuffer);
+
+    /* Main program execution */
+    while(1)
+    {
+        NrfBridgeStats_t stats;
+        NRF_BridgeReadStats(&stats);
+
+        /* Inspect "stats" with debugger: latency in core timer ticks */
+        (void)stats;
+    }
+
+    return 0;
+}
@@ -0,0 +1,237 @@
+/*
+ *  Host test of the link encryption (nRF24L01_aead.c)
+ *
+ *  The module is included, so its ChaCha20 block and Poly1305 functions are
+ *  checked on their own against RFC 8439: the block function test vector
+ *  (section 2.3.2) and the tag of the AEAD construction test vector (section
+ *  2.8.2, its one-time key, associated data and ciphertext). The frame format
+ *  fixes the last nonce word at zero and carries no associated data, so the
+ *  2.8.2 ciphertext itself can't be produced through the API. A whole frame
+ *  is instead compared with one sealed by an independent ChaCha20-Poly1305
+ *  implementation under the frame's nonce (salt | counter | 0). The receiver
+ *  must accept it and reject it again after a flipped tag or ciphertext bit,
+ *  a truncation or a replay.
+ */
+#include "nRF24L01_aead.c"
+
+/** Standard libs **/
+#include <stdio.h>
+
+/* RFC 8439 section 2.8.2 */
+static const uint8_t rfcPolyKey[32] = {
+    0x7B, 0xAC, 0x2B, 0x25, 0x2D, 0xB4, 0x47, 0xAF, 0x09, 0xB6, 0x7A, 0x55, 0xA4, 0xE9, 0x55, 0x84,
+    0x0A, 0xE1, 0xD6, 0x73, 0x10, 0x75, 0xD9, 0xEB, 0x2A, 0x93, 0x75, 0x78, 0x3E, 0xD5, 0x53, 0xFF
+};
+static const uint8_t rfcAad[12] = {
+    0x50, 0x51, 0x52, 0x53, 0xC0, 0xC1, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7
+};
+static const uint8_t rfcCipher[114] = {
+    0xD3, 0x1A, 0x8D, 0x34, 0x64, 0x8E, 0x60, 0xDB, 0x7B, 0x86, 0xAF, 0xBC, 0x53, 0xEF, 0x7E, 0xC2,
+    0xA4, 0xAD, 0xED, 0x51, 0x29, 0x6E, 0x08, 0xFE, 0xA9, 0xE2, 0xB5, 0xA7, 0x36, 0xEE, 0x62, 0xD6,
+    0x3D, 0xBE, 0xA4, 0x5E, 0x8C, 0xA9, 0x67, 0x12, 0x82, 0xFA, 0xFB, 0x69, 0xDA, 0x92, 0x72, 0x8B,
+    0x1A, 0x71, 0xDE, 0x0A, 0x9E, 0x06, 0x0B, 0x29, 0x05, 0xD6, 0xA5, 0xB6, 0x7E, 0xCD, 0x3B, 0x36,
+    0x92, 0xDD, 0xBD, 0x7F, 0x2D, 0x77, 0x8B, 0x8C, 0x98, 0x03, 0xAE, 0xE3, 0x28, 0x09, 0x1B, 0x58,
+    0xFA, 0xB3, 0x24, 0xE4, 0xFA, 0xD6, 0x75, 0x94, 0x55, 0x85, 0x80, 0x8B, 0x48, 0x31, 0xD7, 0xBC,
+    0x3F, 0xF4, 0xDE, 0xF0, 0x8E, 0x4B, 0x7A, 0x9D, 0xE5, 0x76, 0xD2, 0x65, 0x86, 0xCE, 0xC6, 0x4B,
+    0x61, 0x16
+};
+static const uint8_t rfcTag[16] = {
+    0x1A, 0xE1, 0x0B, 0x59, 0x4F, 0x09, 0xE2, 0x6A, 0x7E, 0x90, 0x2E, 0xCB, 0xD0, 0x60, 0x06, 0x91
+};
+
+/* RFC 8439 section 2.3.2, key 00..1F, nonce 00000009 0000004A 00000000,
+ * block counter 1 */
+static const uint8_t rfcBlock[64] = {
+    0x10, 0xF1, 0xE7, 0xE4, 0xD1, 0x3B, 0x59, 0x15, 0x50, 0x0F, 0xDD, 0x1F, 0xA3, 0x20, 0x71, 0xC4,
+    0xC7, 0xD1, 0xF4, 0xC7, 0x33, 0xC0, 0x68, 0x03, 0x04, 0x22, 0xAA, 0x9A, 0xC3, 0xD4, 0x6C, 0x4E,
+    0xD2, 0x82, 0x64, 0x46, 0x07, 0x9F, 0xAA, 0x09, 0x14, 0xC2, 0xD7, 0x05, 0xD9, 0x8B, 0x02, 0xA2,
+    0xB5, 0x12, 0x9C, 0xD1, 0xDE, 0x16, 0x4E, 0xB9, 0xCB, 0xD0, 0x83, 0xE8, 0xA2, 0x50, 0x3C, 0x4E
+};
+
+/* Frame under key 80..9F, salt 7, counter 0x43424140 (nonce 07000000
+ * 40414243 00000000) of the first 20 bytes of the 2.8.2 plaintext, sealed
+ * by OpenSSL's ChaCha20-Poly1305 without associated data */
+#if NRF_AEAD_MAX_DATA < 20
+    #error "Frame vector needs NRF_AEAD_TAG_SIZE of 8 or less"
+#endif
+
+#define FRAME_SALT              0x00000007
+#define FRAME_COUNTER           0x43424140
+static const char framePlain[20] = "Ladies and Gentlemen";
+static const uint8_t frameCipher[20] = {
+    0xFF, 0x54, 0xDA, 0x57, 0x78, 0x80, 0xE8, 0xA4, 0xC2, 0xEE, 0x4F, 0x95, 0x83, 0xB0, 0xEF, 0x78,
+    0xE3, 0x32, 0xF9, 0xAD
+};
+static const uint8_t frameTag[16] = {
+    0xA7, 0x81, 0xFE, 0x73, 0xE1, 0x98, 0xCC, 0x8B, 0x70, 0x70, 0xBE, 0x4A, 0x30, 0x25, 0x44, 0xF8
+};
+
+static uint8_t sentFrame[32];
+static uint8_t sentSize = 0;
+
+
+/*
+ *  Driver calls used by the AEAD module
+ */
+uint32_t _CP0_GET_COUNT(void)
+{
+    static uint32_t ticks = 0;
+
+    return ticks += 10;
+}
+
+
+NrfOpHandle_t NRF_SendPayloadOp(NrfPayloadConfig_t config, void *rxPtr, void *txPtr, uint8_t txSize)
+{
+    (void)config;
+    (void)rxPtr;
+
+    memcpy(sentFrame, txPtr, txSize);
+    sentSize = txSize;
+
+    return (NrfOpHandle_t)1;
+}
+
+
+static bool TestChachaBlock(void)
+{
+    NrfAeadCtx_t ctx;
+    uint8_t key[32];
+    uint8_t block[64];
+
+    for(uint8_t i = 0; i < 32; i++)
+    {
+        key[i] = i;
+    }
+    NRF_AeadInit(&ctx, key, 0x09000000);
+    ChachaBlock(&ctx, 0x4A000000, 1, block);
+
+    bool isPassed = (memcmp(block, rfcBlock, sizeof(block)) == 0);
+    printf("aead RFC 8439 2.3.2 block: %s\n", isPassed ? "ok" : "FAILED");
+
+    return isPassed;
+}
+
+
+/*
+ *  MAC data: associated data and ciphertext, each padded to 16 bytes, then
+ *  both lengths as 64-bit little-endian values
+ */
+static bool TestPoly1305(void)
+{
+    uint8_t macData[16 + 128 + 16] = {0};
+    uint8_t tag[16];
+
+    memcpy(&macData[0], rfcAad, sizeof(rfcAad));
+    memcpy(&macData[16], rfcCipher, sizeof(rfcCipher));
+    macData[144] = sizeof(rfcAad);
+    macData[152] = sizeof(rfcCipher);
+
+    Poly1305(rfcPolyKey, macData, sizeof(macData) / 16, tag);
+
+    bool isPassed = (memcmp(tag, rfcTag, sizeof(tag)) == 0);
+    printf("aead RFC 8439 2.8.2 tag: %s\n", isPassed ? "ok" : "FAILED");
+
+    return isPassed;
+}
+
+
+static bool TestFrame(void)
+{
+    NrfAeadCtx_t txCtx;
+    NrfAeadCtx_t rxCtx;
+    NrfPayloadConfig_t payldConfig = { .spiSfr = NULL };
+    uint8_t key[32];
+    uint8_t frame[2][32];
+    uint8_t plain[32];
+    uint8_t plainSize = 0;
+
+    for(uint8_t i = 0; i < 32; i++)
+    {
+        key[i] = 0x80 + i;
+    }
+    NRF_AeadInit(&txCtx, key, FRAME_SALT);
+    NRF_AeadInit(&rxCtx, key, FRAME_SALT);
+    txCtx.counter = FRAME_COUNTER;
+
+    /* Sent frame: counter, ciphertext, truncated tag */
+    bool isSealed = (NRF_AeadSendPayloadOp(&txCtx, payldConfig, NULL, frame[0], framePlain, sizeof(framePlain)) != NRF_OP_INVALID) &&
+                    (sentSize == sizeof(framePlain) + NRF_AEAD_OVERHEAD) &&
+                    (Le32Read(sentFrame) == FRAME_COUNTER) &&
+                    (memcmp(&sentFrame[4], frameCipher, sizeof(frameCipher)) == 0) &&
+                    (memcmp(&sentFrame[4 + sizeof(frameCipher)], frameTag, NRF_AEAD_TAG_SIZE) == 0);
+
+    /* Next frame was precomputed while the first one is on air */
+    isSealed &= (NRF_AeadSendPayloadOp(&txCtx, payldConfig, NULL, frame[1], "x", 1) != NRF_OP_INVALID) &&
+                (txCtx.coldFrames == 1) && (txCtx.frames == 2);
+
+    bool isOpened = NRF_AeadOpen(&rxCtx, frame[0], sizeof(framePlain) + NRF_AEAD_OVERHEAD, plain, &plainSize) &&
+                    (plainSize == sizeof(framePlain)) && (memcmp(plain, framePlain, plainSize) == 0);
+
+    printf("aead frame: %s%s%s\n", (isSealed && isOpened) ? "ok" : "FAILED",
+           isSealed ? "" : ", sealed frame differs", isOpened ? "" : ", not opened");
+
+    return isSealed && isOpened;
+}
+
+
+/*
+ *  Every altered frame is rejected and counted, the intact one is accepted
+ */
+static bool TestReject(void)
+{
+    NrfAeadCtx_t txCtx;
+    NrfAeadCtx_t rxCtx;
+    uint8_t key[32] = {0};
+    uint8_t frame[32];
+    uint8_t bad[32];
+    uint8_t frameSize;
+    uint8_t plain[32];
+    uint8_t plainSize;
+    bool isPassed = true;
+
+    NRF_AeadInit(&txCtx, key, FRAME_SALT);
+    NRF_AeadInit(&rxCtx, key, FRAME_SALT);
+    txCtx.counter = 5;
+    isPassed &= NRF_AeadSeal(&txCtx, framePlain, sizeof(framePlain), frame, &frameSize);
+
+    /* Each tag byte and the first ciphertext byte flipped */
+    uint32_t rejects = 0;
+    for(uint8_t i = frameSize - NRF_AEAD_TAG_SIZE - 1; i < frameSize; i++)
+    {
+        memcpy(bad, frame, frameSize);
+        bad[(i == frameSize - NRF_AEAD_TAG_SIZE - 1) ? 4 : i] ^= 0x01;
+        rejects += NRF_AeadOpen(&rxCtx, bad, frameSize, plain, &plainSize) ? 0 : 1;
+    }
+    isPassed &= (rejects == NRF_AEAD_TAG_SIZE + 1);
+
+    /* Truncated frame and altered counter */
+    isPassed &= !NRF_AeadOpen(&rxCtx, frame, frameSize - 1, plain, &plainSize);
+    isPassed &= !NRF_AeadOpen(&rxCtx, frame, NRF_AEAD_OVERHEAD - 1, plain, &plainSize);
+    memcpy(bad, frame, frameSize);
+    bad[0] ^= 0x01;
+    isPassed &= !NRF_AeadOpen(&rxCtx, bad, frameSize, plain, &plainSize);
+
+    /* Intact frame once, then its replay */
+    isPassed &= NRF_AeadOpen(&rxCtx, frame, frameSize, plain, &plainSize) &&
+                (memcmp(plain, framePlain, sizeof(framePlain)) == 0);
+    isPassed &= !NRF_AeadOpen(&rxCtx, frame, frameSize, plain, &plainSize);
+    isPassed &= (rxCtx.rejected == NRF_AEAD_TAG_SIZE + 5) && (rxCtx.frames == 1);
+
+    printf("aead tampered frames: %s, %u rejected\n", isPassed ? "ok" : "FAILED", rxCtx.rejected);
+
+    return isPassed;
+}
+
+
+int main(void)
+{
+    bool isPassed = true;
+
+    isPassed &= TestChachaBlock();
+    isPassed &= TestPoly1305();
+    isPassed &= TestFrame();
+    isPassed &= TestReject();
+
+    return isPassed ? 0 : 1;
+}
@@ -0,0 +1,323 @@
+/*
+ *  Host test of message aggregation (nRF24L01_aggr.c)
+ *
+ *  The driver calls used by the module and the core timer are replaced by a
+ *  simulated link. A frame built from two messages is compared with bytes
+ *  worked out by hand from the frame layout. A stream of messages of every
+ *  size then goes through the link, which loses frames in a fixed pattern.
+ *  Splitting the delivered frames must give back the pushed messages in
+ *  order, minus those of lost frames, and the statistics must account for
+ *  every message. Frames must leave when full or when their first message
+ *  has waited out the latency bound, not before.
+ */
+#include "nRF24L01_aggr.h"
+
+/** Standard libs **/
+#include <stdio.h>
+#include <string.h>
+
+#define SYS_FREQ                80000000
+#define TICKS_PER_US            (SYS_FREQ / 1000000 / 2)
+#define LATENCY_US              500
+#define MESSAGES                600
+#define TASK_CALLS_MAX          100000      // Bound of main loop iterations
+
+/** Simulated link (a single frame in flight, as used by the module) **/
+static uint8_t linkFrame[NRF_AGGR_FRAME_SIZE];
+static uint8_t linkSize;
+static bool isLinkBusy = false;
+static uint32_t linkPolls;                  // Polls until frame in flight completes
+static uint32_t linkFrames = 0;
+static uint32_t frameLossEvery = 0;         // 0 = lossless
+static uint32_t clockTicks = 0;
+
+/** Receiving end **/
+static uint8_t rxStream[MESSAGES * NRF_AGGR_MAX_MSG_SIZE];
+static uint32_t rxSize = 0;
+static uint32_t rxMsgs = 0;
+
+
+/*
+ *  Driver calls used by the aggregation module
+ */
+uint32_t _CP0_GET_COUNT(void)
+{
+    return clockTicks;
+}
+
+
+uint32_t OSC_GetSysFreq(void)
+{
+    return SYS_FREQ;
+}
+
+
+NrfOpHandle_t NRF_SendPayloadOp(NrfPayloadConfig_t config, void *rxPtr, void *txPtr, uint8_t txSize)
+{
+    (void)config;
+    (void)rxPtr;
+
+    if( isLinkBusy || (txSize > NRF_AGGR_FRAME_SIZE) )
+    {
+        return NRF_OP_INVALID;
+    }
+
+    isLinkBusy = true;
+    memcpy(linkFrame, txPtr, txSize);
+    linkSize = txSize;
+    linkPolls = 2;
+
+    return (NrfOpHandle_t)1;
+}
+
+
+bool NRF_PollOp(NrfOpHandle_t opHandle, NrfOpResult_t *result)
+{
+    (void)opHandle;
+
+    if( --linkPolls != 0 )
+    {
+        return false;
+    }
+
+    memset(result, 0, sizeof(NrfOpResult_t));
+    linkFrames++;
+
+    if( frameLossEvery && ((linkFrames % frameLossEvery) == 0) )
+    {
+        result->status = NRF_FLAG_MAX_RT;
+        return true;
+    }
+
+    /* Receiver splits the frame */
+    uint8_t offset = 0;
+    uint8_t msgSize;
+    const uint8_t *msgPtr;
+
+    while( (msgSize = NRF_AggrSplit(linkFrame, linkSize, &offset, &msgPtr)) != 0 )
+    {
+        memcpy(&rxStream[rxSize], msgPtr, msgSize);
+        rxSize += msgSize;
+        rxMsgs++;
+    }
+
+    result->status = NRF_FLAG_TX_DS;
+    return true;
+}
+
+
+bool NRF_ReleaseOp(NrfOpHandle_t opHandle)
+{
+    (void)opHandle;
+
+    isLinkBusy = false;
+
+    return true;
+}
+
+
+/*
+ *  Message "index" (1-31 bytes, contents tell index and position apart)
+ */
+static uint8_t MessageMake(uint32_t index, uint8_t *msgPtr)
+{
+    uint8_t size = 1 + (uint8_t)((index * 7) % NRF_AGGR_MAX_MSG_SIZE);
+
+    for(uint8_t i = 0; i < size; i++)
+    {
+        msgPtr[i] = (uint8_t)(index + 31 * i);
+    }
+
+    return size;
+}
+
+
+/*
+ *  Polls until the frame in flight completes (without advancing the clock)
+ */
+static bool WaitIdle(NrfAggrCtx_t *ctx)
+{
+    for(uint32_t i = 0; i < 10; i++)
+    {
+        if( NRF_AggrIsIdle(ctx) )
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/*
+ *  Frame of "AB" and "XYZ": each message behind its length byte
+ */
+static bool TestGolden(void)
+{
+    static const uint8_t expected[] = { 0x02, 'A', 'B', 0x03, 'X', 'Y', 'Z' };
+    NrfAggrCtx_t ctx;
+    NrfPayloadConfig_t payldConfig = { .spiSfr = NULL };
+
+    NRF_AggrInit(&ctx, payldConfig, NULL, LATENCY_US);
+    bool isPassed = NRF_AggrPush(&ctx, "AB", 2) && NRF_AggrPush(&ctx, "XYZ", 3) && !isLinkBusy;
+    isPassed &= NRF_AggrFlush(&ctx) && isLinkBusy;
+    isPassed &= (linkSize == sizeof(expected)) && (memcmp(linkFrame, expected, linkSize) == 0);
+
+    isPassed &= WaitIdle(&ctx) && (ctx.framesSent == 1) && (ctx.msgsSent == 2);
+
+    printf("aggr golden frame: %s, %u bytes\n", isPassed ? "ok" : "FAILED", linkSize);
+
+    return isPassed;
+}
+
+
+/*
+ *  Single message waits for the latency bound, a full frame leaves at once
+ */
+static bool TestLatency(void)
+{
+    NrfAggrCtx_t ctx;
+    NrfPayloadConfig_t payldConfig = { .spiSfr = NULL };
+    uint8_t msg[NRF_AGGR_MAX_MSG_SIZE];
+    bool isPassed = true;
+
+    NRF_AggrInit(&ctx, payldConfig, NULL, LATENCY_US);
+
+    isPassed &= NRF_AggrPush(&ctx, "A", 1);
+    clockTicks += LATENCY_US * TICKS_PER_US - 1;
+    NRF_AggrTask(&ctx);
+    bool isHeld = !isLinkBusy;
+
+    clockTicks += 1;
+    NRF_AggrTask(&ctx);
+    bool isSentOnTime = isLinkBusy && (linkSize == 2);
+    isPassed &= WaitIdle(&ctx);
+
+    /* 31 bytes leave no room for another message, sent without waiting */
+    memset(msg, 0x5A, sizeof(msg));
+    isPassed &= NRF_AggrPush(&ctx, msg, 30);
+    bool isFullSent = isLinkBusy && (linkSize == 31);
+    isPassed &= WaitIdle(&ctx);
+
+    isPassed &= isHeld && isSentOnTime && isFullSent;
+    printf("aggr latency bound: %s%s%s%s\n", isPassed ? "ok" : "FAILED", isHeld ? "" : ", sent early",
+           isSentOnTime ? "" : ", not sent on time", isFullSent ? "" : ", full frame held");
+
+    return isPassed;
+}
+
+
+/*
+ *  Pushes the message stream from a main loop, checks what the receiver got
+ */
+static bool TestStream(const char *name, uint32_t frameLoss)
+{
+    static uint8_t expStream[sizeof(rxStream)];
+    NrfAggrCtx_t ctx;
+    NrfPayloadConfig_t payldConfig = { .spiSfr = NULL };
+    uint8_t msg[NRF_AGGR_MAX_MSG_SIZE];
+    uint32_t next = 0;
+    uint32_t calls = 0;
+    uint32_t expSize = 0;
+    uint32_t frameStart = 0;                // Stream offset of frame in flight
+    uint32_t frameSize = 0;
+    uint32_t frames = 0;
+
+    frameLossEvery = frameLoss;
+    linkFrames = 0;
+    rxSize = rxMsgs = 0;
+    NRF_AggrInit(&ctx, payldConfig, NULL, LATENCY_US);
+
+    while( (calls++ < TASK_CALLS_MAX) && ((next < MESSAGES) || !NRF_AggrIsIdle(&ctx)) )
+    {
+        clockTicks += 37 * TICKS_PER_US;
+
+        if( next < MESSAGES )
+        {
+            uint8_t size = MessageMake(next, msg);
+            if( NRF_AggrPush(&ctx, msg, size) )
+            {
+                next++;
+            }
+        }
+        else
+        {
+            NRF_AggrTask(&ctx);
+        }
+    }
+    frameLossEvery = 0;
+
+    /* Messages are packed into frames in push order until the next one
+     * doesn't fit, messages of every "frameLoss"-th frame are missing (a
+     * frame-sized message after the last one closes the last frame) */
+    for(uint32_t i = 0; i <= MESSAGES; i++)
+    {
+        uint8_t size = (i < MESSAGES) ? MessageMake(i, msg) : NRF_AGGR_FRAME_SIZE;
+
+        if( (frameSize + 1 + size) > NRF_AGGR_FRAME_SIZE )
+        {
+            frames++;
+            expSize = (frameLoss && ((frames % frameLoss) == 0)) ? frameStart : expSize;
+            frameStart = expSize;
+            frameSize = 0;
+        }
+        if( i == MESSAGES )
+        {
+            break;
+        }
+        memcpy(&expStream[expSize], msg, size);
+        expSize += size;
+        frameSize += 1 + size;
+    }
+
+    bool isStream = (rxSize == expSize) && (memcmp(rxStream, expStream, rxSize) == 0);
+    bool isStats = ((ctx.msgsSent + ctx.msgsLost) == MESSAGES) && (ctx.msgsSent == rxMsgs) &&
+                   ((ctx.framesSent + ctx.framesLost) == frames) &&
+                   (ctx.framesLost == (frameLoss ? (frames / frameLoss) : 0));
+    bool isPassed = (next == MESSAGES) && isStream && isStats;
+
+    printf("aggr %s: %s, %u frames sent, %u lost, %u messages received%s%s\n", name, isPassed ? "ok" : "FAILED",
+           ctx.framesSent, ctx.framesLost, rxMsgs, isStream ? "" : ", stream differs",
+           isStats ? "" : ", statistics differ");
+
+    return isPassed;
+}
+
+
+/*
+ *  Zero padding and a length past the frame end both end the frame
+ */
+static bool TestSplit(void)
+{
+    static const uint8_t padded[8] = { 0x02, 0x11, 0x22, 0x00, 0x01, 0x33, 0x00, 0x00 };
+    static const uint8_t truncated[5] = { 0x01, 0x44, 0x05, 0x55, 0x66 };
+    const uint8_t *msgPtr;
+    uint8_t offset = 0;
+    bool isPassed = true;
+
+    isPassed &= (NRF_AggrSplit(padded, sizeof(padded), &offset, &msgPtr) == 2) && (msgPtr == &padded[1]);
+    isPassed &= (NRF_AggrSplit(padded, sizeof(padded), &offset, &msgPtr) == 0);
+    isPassed &= (NRF_AggrSplit(padded, sizeof(padded), &offset, &msgPtr) == 0);
+
+    offset = 0;
+    isPassed &= (NRF_AggrSplit(truncated, sizeof(truncated), &offset, &msgPtr) == 1) && (*msgPtr == 0x44);
+    isPassed &= (NRF_AggrSplit(truncated, sizeof(truncated), &offset, &msgPtr) == 0);
+
+    printf("aggr frame split: %s\n", isPassed ? "ok" : "FAILED");
+
+    return isPassed;
+}
+
+
+int main(void)
+{
+    bool isPassed = true;
+
+    isPassed &= TestGolden();
+    isPassed &= TestLatency();
+    isPassed &= TestSplit();
+    isPassed &= TestStream("lossless", 0);
+    isPassed &= TestStream("frame loss", 4);
+
+    return isPassed ? 0 : 1;
+}
@@ -0,0 +1,278 @@
+/*
+ *  Host benchmark of the API paths (NRF_BENCH_ENABLE)
+ *
+ *  Runs the paths of examples/benchmark.c against a simulated device: a PTX
+ *  sends 32-byte payloads and reads 3-byte ACK payloads, blocking and
+ *  interrupt-based, then a PRX reads 32-byte payloads and stores 3-byte ACK
+ *  payloads. Per-call averages are printed as CSV and checked against the
+ *  thresholds in examples/benchmark_thresholds.h. The SPI stand-in counts
+ *  every transfer on its own, and the driver's figures must add up to it.
+ */
+#include "host.h"
+#include "benchmark_thresholds.h"
+
+/** Standard libs **/
+#include <stdio.h>
+#include <string.h>
+
+#if !NRF_BENCH_ENABLE
+    #error "Build with NRF_BENCH_ENABLE"
+#endif
+
+#define BENCH_ITERATIONS        100
+#define CE_PIN                  1
+#define CS_PIN                  2
+#define PRX_ADDR                0xB3B4B5B605
+
+static const NrfPtxConfig_t ptxConfig = {
+    .spiSfr = &SPI1_MODULE,
+    .isAck = true,
+    .retrDelay = NRF_ARD_1000,
+    .retrCount = NRF_ARC_15,
+    .rfChannel = NRF_RF_CH_2,
+    .rfPower = NRF_RF_PWR_MIN,
+    .dataRate = NRF_RF_DR_2000,
+    .pinConfig = {
+        .cePin = CE_PIN,
+        .csPin = CS_PIN,
+        .irqPin = 3
+    }
+};
+
+static const NrfPrxConfig_t prxConfig = {
+    .spiSfr = &SPI1_MODULE,
+    .isAck = NRF_ACK,
+    .dataRate = NRF_RF_DR_2000,
+    .rfChannel = NRF_RF_CH_2,
+    .pipeAddr = {
+        .pipe5 = PRX_ADDR
+    },
+    .pinConfig = {
+        .cePin = CE_PIN,
+        .csPin = CS_PIN,
+        .irqPin = 3
+    }
+};
+
+/** Simulated device **/
+static uint8_t devRegs[32];
+static uint8_t devFlags;                    // STATUS interrupt flags
+static uint8_t devAckFlags;                 // Raised by next CE pulse (PTX)
+static uint8_t devRxPipe;
+static uint8_t devRxWidth;                  // Payload pending in RX FIFO (0 = empty)
+static bool isCsHeld = false;               // CS driven as GPIO (split transaction)
+static bool isCmdSent = false;
+static uint8_t heldCmd;
+
+
+/*
+ *  Register file with STATUS flags and a single-entry RX FIFO, payload bytes
+ *  read are dummies
+ */
+static void Device(volatile uint8_t *rxPtr, volatile uint8_t *txPtr, uint32_t size)
+{
+    /* Payload phase of split transaction */
+    if( isCsHeld && isCmdSent )
+    {
+        if( heldCmd == NRF_READ_RX_PL_CMD )
+        {
+            devRxWidth = 0;
+        }
+        for(uint32_t i = 0; (rxPtr != NULL) && (i < size); i++)
+        {
+            rxPtr[i] = (uint8_t)i;
+        }
+        return;
+    }
+
+    uint8_t command = txPtr[0];
+    if( isCsHeld )
+    {
+        isCmdSent = true;
+        heldCmd = command;
+    }
+
+    uint8_t status = devFlags | ((devRxWidth != 0) ? (devRxPipe << 1) : 0x0E);
+    for(uint32_t i = 0; (rxPtr != NULL) && (i < size); i++)
+    {
+        if( i == 0 )
+        {
+            rxPtr[i] = status;
+        }
+        else if( command == NRF_READ_RX_PL_WID_CMD )
+        {
+            rxPtr[i] = devRxWidth;
+        }
+        else if( command == NRF_READ_CMD(NRF_FIFO_STATUS_REG) )
+        {
+            rxPtr[i] = 0x10 | ((devRxWidth != 0) ? 0x00 : 0x01);
+        }
+        else
+        {
+            rxPtr[i] = devRegs[command & 0x1F];
+        }
+    }
+
+    if( command == NRF_WRITE_CMD(NRF_STATUS_REG) )
+    {
+        devFlags &= ~txPtr[1];
+    }
+    else if( ((command & 0xE0) == 0x20) && (size > 1) )
+    {
+        devRegs[command & 0x1F] = txPtr[1];
+    }
+}
+
+
+static void DevicePin(uint32_t pin, bool isHigh)
+{
+    if( pin == CS_PIN )
+    {
+        isCsHeld = !isHigh;
+        isCmdSent = false;
+    }
+    if( (pin == CE_PIN) && isHigh && (devAckFlags != 0) )
+    {
+        devFlags = devAckFlags;
+        devRxWidth = 3;
+        devAckFlags = 0;
+    }
+}
+
+
+/*
+ *  Starts accounting of a role once it is configured
+ */
+static void BenchReset(void)
+{
+    NRF_ResetBenchStats();
+    hostSpiTransactions = 0;
+    hostSpiBytes = 0;
+}
+
+
+/*
+ *  Acknowledges the next send with a 3-byte ACK payload once CE is pulsed
+ */
+static void DeviceAck(void)
+{
+    devAckFlags = NRF_TX_DS_MASK | NRF_RX_DR_MASK;
+    devRxPipe = 0;
+}
+
+
+/*
+ *  Receives a 32-byte payload on pipe 5
+ */
+static void DeviceReceive(void)
+{
+    devFlags = NRF_RX_DR_MASK;
+    devRxPipe = 5;
+    devRxWidth = 32;
+}
+
+
+/*
+ *  Emits one CSV line per path exercised by "role" (header first), checks
+ *  thresholds and that the driver accounted for every transfer the SPI
+ *  stand-in saw
+ */
+static bool BenchReport(const char *role)
+{
+    uint32_t spiTransactions = 0;
+    uint32_t spiBytes = 0;
+    bool isPassed = true;
+
+    printf("path,calls,spi_transactions,spi_bytes,copy_iterations,core_ticks,status\n");
+
+    for(uint8_t i = 0; i < sizeof(benchThreshold) / sizeof(benchThreshold[0]); i++)
+    {
+        NrfBenchStats_t stats;
+        NRF_ReadBenchStats(benchThreshold[i].path, &stats);
+
+        /* Path not exercised by this role */
+        if( stats.calls == 0 )
+        {
+            continue;
+        }
+
+        spiTransactions += stats.spiTransactions;
+        spiBytes += stats.spiBytes;
+
+        bool isPathPassed = (stats.spiTransactions <= benchThreshold[i].maxSpiTransactions * stats.calls) &&
+                            (stats.spiBytes <= benchThreshold[i].maxSpiBytes * stats.calls) &&
+                            (stats.copyIterations <= benchThreshold[i].maxCopyIterations * stats.calls);
+        isPassed &= isPathPassed;
+
+        printf("%s,%u,%u,%u,%u,%u,%s\n", benchThreshold[i].name, stats.calls,
+               stats.spiTransactions / stats.calls, stats.spiBytes / stats.calls,
+               stats.copyIterations / stats.calls, stats.coreTicks / stats.calls,
+               isPathPassed ? "pass" : "FAIL");
+    }
+
+    bool isCounted = (spiTransactions == hostSpiTransactions) && (spiBytes == hostSpiBytes);
+    printf("bench %u %s: %s, %u/%u SPI transactions and %u/%u bytes accounted\n", NRF_SPI_BURST_WIDTH, role,
+           (isPassed && isCounted) ? "ok" : "FAILED", spiTransactions, hostSpiTransactions,
+           spiBytes, hostSpiBytes);
+
+    return isPassed && isCounted;
+}
+
+
+int main(void)
+{
+    static uint8_t rxData[32] __attribute__((aligned(4)));
+    static const uint8_t txData[32] = {
+        0x5A, 0x32, 0x3D, 0x01, 0xD9, 0x56, 0x43, 0x5F,
+        0x4D, 0x3F, 0xE2, 0xFD, 0x55, 0x8E, 0xEE, 0xE7,
+        0x90, 0xFC, 0x57, 0xE1, 0xE8, 0x4C, 0xFD, 0xAC,
+        0x04, 0xAE, 0x45, 0xF5, 0xD3, 0x41, 0x20, 0x0D
+    };
+
+    hostSpiDevice = Device;
+    hostPinDevice = DevicePin;
+    IC_MODULE.ICxIEC0.W = 0xFFFFFFFF;
+    IC_MODULE.ICxIFS0.W = 0xFFFFFFFF;
+
+    /* PTX paths */
+    bool isOk = NRF_ConfigPtxSfr(ptxConfig);
+    NrfPayloadConfig_t payldConfig = NRF_ConfigPtxPayloadStruct(ptxConfig, PRX_ADDR);
+    BenchReset();
+
+    /* Polling-based path */
+    for(uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        DeviceAck();
+        isOk &= NRF_SendReceivePayload(payldConfig, rxData, (void *)txData, sizeof(txData));
+    }
+
+    /* Interrupt-based path */
+    for(uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        DeviceAck();
+        isOk &= NRF_SendPayload(payldConfig, rxData, (void *)txData, sizeof(txData));
+        IC_MODULE.ICxIFS0.SET = NRF_INTxIF_MASK;
+        HostServiceIrq();
+    }
+
+    isOk &= BenchReport("ptx");
+
+    /* PRX paths */
+    isOk &= NRF_ConfigPrxSfr(prxConfig);
+    payldConfig = NRF_ConfigPrxPayloadStruct(prxConfig);
+    isOk &= NRF_StartReception(payldConfig, rxData);
+    BenchReset();
+
+    /* Reload ACK payload after every reception */
+    for(uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        DeviceReceive();
+        IC_MODULE.ICxIFS0.SET = NRF_INTxIF_MASK;
+        HostServiceIrq();
+        isOk &= NRF_StoreAckPayload(payldConfig, NRF_RX_PIPE_5, (void *)txData, 3);
+    }
+
+    isOk &= BenchReport("prx");
+
+    return isOk ? 0 : 1;
+}
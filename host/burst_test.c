@@ -0,0 +1,181 @@
+/*
+ *  Host test of wide SPI frames (NRF_SPI_BURST_WIDTH)
+ *
+ *  A PTX sends a non-palindromic payload and reads back an ACK payload, once
+ *  interrupt-based and once blocking. Both buffers are misaligned and the TX
+ *  payload is const, so an in-place byte swap would fault. The SPI stand-in
+ *  shifts wide frames MSb first like the PIC32, and the simulated device
+ *  records W_TX_PAYLOAD bytes in wire order. They must equal the payload, as
+ *  in the 8-bit build, and the ACK payload must arrive in its original order.
+ *  The wire bytes are also written to a file for comparison across widths.
+ */
+#include "host.h"
+
+/** Standard libs **/
+#include <stdio.h>
+#include <string.h>
+
+#define CE_PIN                  1
+#define CS_PIN                  2
+
+static const NrfPtxConfig_t ptxConfig = {
+    .spiSfr = &SPI1_MODULE,
+    .isAck = true,
+    .retrDelay = NRF_ARD_1000,
+    .retrCount = NRF_ARC_15,
+    .rfChannel = NRF_RF_CH_2,
+    .rfPower = NRF_RF_PWR_MIN,
+    .dataRate = NRF_RF_DR_2000,
+    .pinConfig = {
+        .cePin = CE_PIN,
+        .csPin = CS_PIN,
+        .irqPin = 3
+    }
+};
+
+/* 29 bytes: 16/32-bit frames take leading 1/1 bytes and 14/7 words */
+static const uint8_t txPayload[1 + 29] __attribute__((aligned(4))) = {
+    0x00,
+    0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A,
+    0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A,
+    0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29
+};
+
+/* 27 bytes: 16/32-bit frames take leading 1/3 bytes and 13/6 words */
+static const uint8_t ackPayload[27] = {
+    0xA1, 0xB2, 0xC3, 0xD4, 0xE5, 0xF6, 0x07, 0x18, 0x29,
+    0x3A, 0x4B, 0x5C, 0x6D, 0x7E, 0x8F, 0x90, 0x81, 0x72,
+    0x63, 0x54, 0x45, 0x36, 0x27, 0x18, 0x09, 0xFA, 0xEB
+};
+
+/** Simulated device **/
+static uint8_t devRegs[32];
+static bool isCsHeld = false;               // CS driven as GPIO (split transaction)
+static bool isCmdSent = false;
+static uint8_t heldCmd;
+static uint32_t ackIndex;
+static uint8_t wire[2][32];                 // W_TX_PAYLOAD bytes of each send
+static uint32_t wireSize[2];
+static uint32_t sends = 0;
+
+
+/*
+ *  Register file with a pending ACK payload on pipe 0 (TX_DS and RX_DR set),
+ *  bytes arrive and leave in wire order
+ */
+static void Device(volatile uint8_t *rxPtr, volatile uint8_t *txPtr, uint32_t size)
+{
+    /* Payload phase of split transaction */
+    if( isCsHeld && isCmdSent )
+    {
+        for(uint32_t i = 0; i < size; i++)
+        {
+            if( (heldCmd == NRF_WRITE_TX_PL_CMD) && (wireSize[sends] < sizeof(wire[0])) )
+            {
+                wire[sends][wireSize[sends]++] = txPtr[i];
+            }
+            if( (heldCmd == NRF_READ_RX_PL_CMD) && (rxPtr != NULL) )
+            {
+                rxPtr[i] = (ackIndex < sizeof(ackPayload)) ? ackPayload[ackIndex++] : 0x00;
+            }
+        }
+        return;
+    }
+
+    uint8_t command = txPtr[0];
+    if( isCsHeld )
+    {
+        isCmdSent = true;
+        heldCmd = command;
+        ackIndex = 0;
+    }
+
+    for(uint32_t i = 0; (rxPtr != NULL) && (i < size); i++)
+    {
+        if( i == 0 )
+        {
+            rxPtr[i] = NRF_TX_DS_MASK | NRF_RX_DR_MASK;
+        }
+        else if( command == NRF_READ_RX_PL_WID_CMD )
+        {
+            rxPtr[i] = sizeof(ackPayload);
+        }
+        else
+        {
+            rxPtr[i] = devRegs[command & 0x1F];
+        }
+    }
+
+    if( ((command & 0xE0) == 0x20) && (size > 1) )
+    {
+        devRegs[command & 0x1F] = txPtr[1];
+    }
+}
+
+
+static void DevicePin(uint32_t pin, bool isHigh)
+{
+    if( pin == CS_PIN )
+    {
+        isCsHeld = !isHigh;
+        isCmdSent = false;
+    }
+}
+
+
+/*
+ *  Checks wire bytes of latest send and the ACK payload read into "ackPtr"
+ */
+static bool CheckSend(const char *name, const uint8_t *ackPtr)
+{
+    bool isWire = (wireSize[sends] == (sizeof(txPayload) - 1)) &&
+                  (memcmp(wire[sends], &txPayload[1], wireSize[sends]) == 0);
+    bool isAck = (memcmp(ackPtr, ackPayload, sizeof(ackPayload)) == 0);
+
+    printf("burst %u %s: %s, %u wire bytes%s%s\n", NRF_SPI_BURST_WIDTH, name,
+           (isWire && isAck) ? "ok" : "FAILED", wireSize[sends],
+           isWire ? "" : ", wire order differs", isAck ? "" : ", ACK payload differs");
+    sends++;
+
+    return isWire && isAck;
+}
+
+
+int main(int argc, char **argv)
+{
+    static uint8_t ackBuf[2][1 + 32] __attribute__((aligned(4)));
+
+    if( argc != 2 )
+    {
+        fprintf(stderr, "usage: %s <wire>\n", argv[0]);
+        return 2;
+    }
+
+    hostSpiDevice = Device;
+    hostPinDevice = DevicePin;
+    IC_MODULE.ICxIEC0.W = 0xFFFFFFFF;
+    IC_MODULE.ICxIFS0.W = 0xFFFFFFFF;
+
+    bool isOk = NRF_ConfigPtxSfr(ptxConfig);
+    NrfPayloadConfig_t payldConfig = NRF_ConfigPtxPayloadStruct(ptxConfig, 0xB3B4B5B605);
+
+    /* Interrupt-based send, ACK payload read from INTx ISR */
+    isOk &= NRF_SendPayload(payldConfig, &ackBuf[0][1], (void *)&txPayload[1], sizeof(txPayload) - 1);
+    IC_MODULE.ICxIFS0.SET = NRF_INTxIF_MASK;
+    HostServiceIrq();
+    isOk &= CheckSend("interrupt", &ackBuf[0][1]);
+
+    /* Blocking send */
+    isOk &= NRF_SendReceivePayload(payldConfig, &ackBuf[1][1], (void *)&txPayload[1], sizeof(txPayload) - 1);
+    isOk &= CheckSend("blocking", &ackBuf[1][1]);
+
+    FILE *file = fopen(argv[1], "wb");
+    if( (file == NULL) || (fwrite(wire, 1, sizeof(wire), file) != sizeof(wire)) )
+    {
+        perror(argv[1]);
+        return 2;
+    }
+    fclose(file);
+
+    return isOk ? 0 : 1;
+}
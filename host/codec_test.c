@@ -0,0 +1,242 @@
+/*
+ *  Host test of the telemetry codec (nRF24L01_codec.c)
+ *
+ *  A key packet is compared with bytes worked out by hand from the packet
+ *  layout. A stream of six-field samples, with slow drift and jumps across
+ *  the int32_t range, then goes through a simulated link that loses frames
+ *  and ACKs in a fixed pattern. The sender repeats the samples of every
+ *  unacknowledged packet, and every packet the receiver decodes must give
+ *  back exactly the samples it was encoded from. Packets against an unknown
+ *  reference and malformed packets must decode to nothing.
+ */
+#include "nRF24L01_codec.h"
+
+/** Standard libs **/
+#include <stdio.h>
+#include <string.h>
+
+#define FIELDS                  6
+#define SAMPLES                 400
+#define KEY_INTERVAL            8
+#define RESTART_AT              (KEY_INTERVAL + 3)  // Packet on which receiver restarts
+
+static int32_t stream[SAMPLES][FIELDS];
+
+
+/*
+ *  Samples left from "next" on (more than a packet can hold is enough)
+ */
+static uint8_t Remaining(uint32_t next)
+{
+    return ((SAMPLES - next) > NRF_CODEC_PAYLOAD_SIZE) ? NRF_CODEC_PAYLOAD_SIZE : (uint8_t)(SAMPLES - next);
+}
+
+
+/*
+ *  Two samples (1, -1) and (300, -1): zigzag 1 -> 0x02, -1 -> 0x01,
+ *  delta 299 -> 598 = 0x256 -> varint D6 04, delta 0 -> 00
+ */
+static bool TestGolden(void)
+{
+    static const int32_t samples[2][2] = { { 1, -1 }, { 300, -1 } };
+    static const uint8_t expected[] = { 0x80, 0x02, 0x01, 0xD6, 0x04, 0x00 };
+    NrfCodecCtx_t enc;
+    NrfCodecCtx_t dec;
+    uint8_t buf[NRF_CODEC_PAYLOAD_SIZE];
+    uint8_t size;
+    int32_t out[2][2];
+
+    NRF_CodecInit(&enc, 2, 0);
+    NRF_CodecInit(&dec, 2, 0);
+
+    uint8_t count = NRF_CodecEncode(&enc, &samples[0][0], 2, buf, &size);
+    bool isBytes = (count == 2) && (size == sizeof(expected)) && (memcmp(buf, expected, size) == 0);
+    bool isDecoded = (NRF_CodecDecode(&dec, buf, size, &out[0][0], 2) == 2) &&
+                     (memcmp(out, samples, sizeof(out)) == 0);
+
+    printf("codec golden key packet: %s, %u bytes%s%s\n", (isBytes && isDecoded) ? "ok" : "FAILED", size,
+           isBytes ? "" : ", bytes differ", isDecoded ? "" : ", decode differs");
+
+    return isBytes && isDecoded;
+}
+
+
+/*
+ *  Sends the stream over a link that loses every "frameLoss"-th frame and
+ *  every "ackLoss"-th ACK (0 = never), checks each decoded packet against
+ *  the samples it was encoded from
+ */
+static bool TestStream(const char *name, uint32_t frameLoss, uint32_t ackLoss)
+{
+    NrfCodecCtx_t enc;
+    NrfCodecCtx_t dec;
+    uint8_t buf[NRF_CODEC_PAYLOAD_SIZE];
+    int32_t out[NRF_CODEC_PAYLOAD_SIZE][FIELDS];
+    uint32_t next = 0;
+    uint32_t packets = 0;
+    uint32_t decoded = 0;
+    uint32_t undecodable = 0;
+    uint32_t errors = 0;
+
+    NRF_CodecInit(&enc, FIELDS, KEY_INTERVAL);
+    NRF_CodecInit(&dec, FIELDS, 0);
+
+    while( (next < SAMPLES) && (packets < 10 * SAMPLES) )
+    {
+        uint8_t size;
+        uint8_t count = NRF_CodecEncode(&enc, &stream[next][0], Remaining(next), buf, &size);
+        packets++;
+
+        if( (count == 0) || (size > NRF_CODEC_PAYLOAD_SIZE) )
+        {
+            errors++;
+            break;
+        }
+
+        bool isFrameLost = frameLoss && ((packets % frameLoss) == 0);
+        bool isAckLost = ackLoss && ((packets % ackLoss) == 0);
+
+        if( !isFrameLost )
+        {
+            uint8_t got = NRF_CodecDecode(&dec, buf, size, &out[0][0], NRF_CODEC_PAYLOAD_SIZE);
+
+            if( got == 0 )
+            {
+                undecodable++;
+            }
+            else if( (got != count) || (memcmp(out, stream[next], count * sizeof(stream[0])) != 0) )
+            {
+                errors++;
+            }
+            else
+            {
+                decoded++;
+            }
+        }
+
+        /* Unacknowledged samples are sent again */
+        bool isAcked = !isFrameLost && !isAckLost;
+        NRF_CodecConfirm(&enc, isAcked);
+        if( isAcked )
+        {
+            next += count;
+        }
+    }
+
+    bool isPassed = (next == SAMPLES) && (errors == 0) && (undecodable == 0);
+    printf("codec %s: %s, %u packets, %u decoded, %u undecodable, %u wrong\n", name,
+           isPassed ? "ok" : "FAILED", packets, decoded, undecodable, errors);
+
+    return isPassed;
+}
+
+
+/*
+ *  Receiver restarts mid-stream: delta packets decode to nothing until the
+ *  next key packet, then decoding resumes
+ */
+static bool TestResync(void)
+{
+    NrfCodecCtx_t enc;
+    NrfCodecCtx_t dec;
+    uint8_t buf[NRF_CODEC_PAYLOAD_SIZE];
+    int32_t out[NRF_CODEC_PAYLOAD_SIZE][FIELDS];
+    uint32_t next = 0;
+    uint32_t rejected = 0;
+    bool isResumed = false;
+    bool isPassed = true;
+
+    NRF_CodecInit(&enc, FIELDS, KEY_INTERVAL);
+    NRF_CodecInit(&dec, FIELDS, 0);
+
+    for(uint32_t i = 0; (i < 4 * KEY_INTERVAL) && (next < SAMPLES); i++)
+    {
+        uint8_t size;
+        uint8_t count = NRF_CodecEncode(&enc, &stream[next][0], Remaining(next), buf, &size);
+
+        if( i == RESTART_AT )
+        {
+            NRF_CodecInit(&dec, FIELDS, 0);
+        }
+
+        uint8_t got = NRF_CodecDecode(&dec, buf, size, &out[0][0], NRF_CODEC_PAYLOAD_SIZE);
+        bool isKey = (buf[0] & 0x80) != 0;
+
+        if( (i >= RESTART_AT) && !isResumed )
+        {
+            isResumed = isKey;
+            rejected += isKey ? 0 : 1;
+            isPassed &= isKey ? (got == count) : (got == 0);
+        }
+        else
+        {
+            isPassed &= (got == count) && (memcmp(out, stream[next], count * sizeof(stream[0])) == 0);
+        }
+
+        NRF_CodecConfirm(&enc, true);
+        next += count;
+    }
+
+    isPassed &= isResumed && (rejected > 0) && (rejected < KEY_INTERVAL);
+    printf("codec receiver restart: %s, %u delta packets rejected before key packet\n",
+           isPassed ? "ok" : "FAILED", rejected);
+
+    return isPassed;
+}
+
+
+/*
+ *  Truncated samples, unfinished varints and trailing bytes are rejected
+ */
+static bool TestMalformed(void)
+{
+    static const uint8_t truncated[] = { 0x80, 0x02 };              // Second field missing
+    static const uint8_t unfinished[] = { 0x80, 0x02, 0xD6 };       // Varint continues past end
+    static const uint8_t longVarint[] = { 0x80, 0x02, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01 };
+    static const uint8_t unknownRef[] = { 0x05, 0x04, 0x02, 0x01 }; // Delta against unseen packet
+    NrfCodecCtx_t dec;
+    int32_t out[4][2];
+    bool isPassed = true;
+
+    NRF_CodecInit(&dec, 2, 0);
+    isPassed &= (NRF_CodecDecode(&dec, truncated, sizeof(truncated), &out[0][0], 4) == 0);
+    isPassed &= (NRF_CodecDecode(&dec, unfinished, sizeof(unfinished), &out[0][0], 4) == 0);
+    isPassed &= (NRF_CodecDecode(&dec, longVarint, sizeof(longVarint), &out[0][0], 4) == 0);
+    isPassed &= (NRF_CodecDecode(&dec, unknownRef, sizeof(unknownRef), &out[0][0], 4) == 0);
+    isPassed &= (NRF_CodecDecode(&dec, unknownRef, 0, &out[0][0], 4) == 0);
+
+    /* More samples than the caller has room for */
+    static const uint8_t twoSamples[] = { 0x80, 0x02, 0x01, 0xD6, 0x04, 0x00 };
+    isPassed &= (NRF_CodecDecode(&dec, twoSamples, sizeof(twoSamples), &out[0][0], 1) == 0);
+
+    printf("codec malformed packets: %s\n", isPassed ? "ok" : "FAILED");
+
+    return isPassed;
+}
+
+
+int main(void)
+{
+    bool isPassed = true;
+
+    /* Slow drift with a few full-range jumps (wrapping deltas) */
+    for(uint32_t i = 0; i < SAMPLES; i++)
+    {
+        stream[i][0] = 2150 + (int32_t)(i % 7) - 3;
+        stream[i][1] = -400 + (int32_t)(i / 3);
+        stream[i][2] = 101325 + (int32_t)((i * 37) % 11);
+        stream[i][3] = (int32_t)(i * 1000);
+        stream[i][4] = ((i % 50) == 25) ? INT32_MIN : (((i % 50) == 26) ? INT32_MAX : 0);
+        stream[i][5] = (int32_t)(i & 1);
+    }
+
+    isPassed &= TestGolden();
+    isPassed &= TestStream("lossless", 0, 0);
+    isPassed &= TestStream("frame loss", 5, 0);
+    isPassed &= TestStream("ACK loss", 0, 3);
+    isPassed &= TestStream("frame and ACK loss", 7, 4);
+    isPassed &= TestResync();
+    isPassed &= TestMalformed();
+
+    return isPassed ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+/*
+ *  Host test of the PRX duplicate filter (NRF_DEDUP_ENABLE)
+ *
+ *  The driver is included, so sequence numbers go straight into the filter
+ *  of the payload ISR with the pipe they came in on. Each case is a list of
+ *  payloads with the verdict worked out by hand from the documented window:
+ *  a number is accepted once while it is within NRF_DEDUP_WINDOW of the
+ *  newest one of its source, and a number further behind restarts the
+ *  window. Sequences cross the 255 -> 0 wrap, sources on pipes sharing upper
+ *  address bytes stay apart, and the counters must add up.
+ */
+#include "host.h"
+#include "nRF24L01.c"
+
+/** Standard libs **/
+#include <stdio.h>
+
+#if !NRF_DEDUP_ENABLE
+    #error "Build with NRF_DEDUP_ENABLE"
+#endif
+
+#if NRF_DEDUP_WINDOW != 32
+    #error "Cases assume a 32-number window"
+#endif
+
+typedef struct {
+    NrfRxPipeNo_t   pipeNo;
+    uint8_t         seq;
+    bool            isDuplicate;
+} Payload_t;
+
+
+/*
+ *  Feeds "count" payloads to the filter after a reset, checks every verdict
+ *  and the counters
+ */
+static bool RunCase(const char *name, const Payload_t *payloads, uint32_t count, uint32_t resyncs)
+{
+    NrfDedupStats_t stats;
+    uint32_t duplicates = 0;
+    uint32_t wrong = 0;
+    uint32_t firstWrong = UINT32_MAX;
+
+    NRF_ResetDedup();
+
+    for(uint32_t i = 0; i < count; i++)
+    {
+        if( DedupIsDuplicate(payloads[i].pipeNo, payloads[i].seq) != payloads[i].isDuplicate )
+        {
+            firstWrong = (wrong++ == 0) ? i : firstWrong;
+        }
+        duplicates += payloads[i].isDuplicate ? 1 : 0;
+    }
+
+    NRF_ReadDedupStats(&stats);
+    bool isStats = (stats.accepted == (count - duplicates)) && (stats.duplicates == duplicates) &&
+                   (stats.resyncs == resyncs) && (stats.evictions == 0);
+    bool isPassed = (wrong == 0) && isStats;
+
+    printf("dedup %s: %s, %u accepted, %u duplicates, %u resyncs", name, isPassed ? "ok" : "FAILED",
+           stats.accepted, stats.duplicates, stats.resyncs);
+    if( wrong )
+    {
+        printf(", %u wrong verdicts (first at payload %u)", wrong, firstWrong);
+    }
+    printf("%s\n", isStats ? "" : ", counters differ");
+
+    return isPassed;
+}
+
+
+int main(void)
+{
+    /* Sequence wraps, retransmissions on both sides of the wrap are caught,
+     * a late payload behind the wrap is accepted once */
+    static const Payload_t wrap[] = {
+        { NRF_RX_PIPE_0, 250, false }, { NRF_RX_PIPE_0, 251, false }, { NRF_RX_PIPE_0, 252, false },
+        { NRF_RX_PIPE_0, 254, false }, { NRF_RX_PIPE_0, 255, false }, { NRF_RX_PIPE_0, 0, false },
+        { NRF_RX_PIPE_0, 1, false }, { NRF_RX_PIPE_0, 1, true }, { NRF_RX_PIPE_0, 255, true },
+        { NRF_RX_PIPE_0, 250, true }, { NRF_RX_PIPE_0, 253, false }, { NRF_RX_PIPE_0, 253, true },
+        { NRF_RX_PIPE_0, 0, true }, { NRF_RX_PIPE_0, 2, false }, { NRF_RX_PIPE_0, 252, true }
+    };
+
+    /* Newest 100: 69 (31 behind) is still in the window, 68 (32 behind) is
+     * taken as a restart. A jump of 31 keeps 68 in the window, one more
+     * pushes it out and the next 68 restarts the window again */
+    static const Payload_t edge[] = {
+        { NRF_RX_PIPE_1, 100, false }, { NRF_RX_PIPE_1, 69, false }, { NRF_RX_PIPE_1, 69, true },
+        { NRF_RX_PIPE_1, 100, true }, { NRF_RX_PIPE_1, 68, false }, { NRF_RX_PIPE_1, 99, false },
+        { NRF_RX_PIPE_1, 68, true }, { NRF_RX_PIPE_1, 100, false }, { NRF_RX_PIPE_1, 68, false },
+        { NRF_RX_PIPE_1, 68, true }
+    };
+
+    /* Pipes 1-3 share upper address bytes, yet each is its own source */
+    static const Payload_t sources[] = {
+        { NRF_RX_PIPE_1, 7, false }, { NRF_RX_PIPE_2, 7, false }, { NRF_RX_PIPE_3, 7, false },
+        { NRF_RX_PIPE_2, 7, true }, { NRF_RX_PIPE_1, 8, false }, { NRF_RX_PIPE_3, 7, true },
+        { NRF_RX_PIPE_2, 8, false }, { NRF_RX_PIPE_1, 7, true }, { NRF_RX_PIPE_3, 8, false }
+    };
+
+    /* Every payload sent twice over four sequence wraps */
+    static Payload_t stream[2 * 1024];
+    for(uint32_t i = 0; i < 1024; i++)
+    {
+        stream[2 * i] = (Payload_t){ NRF_RX_PIPE_4, (uint8_t)(i + 200), false };
+        stream[2 * i + 1] = (Payload_t){ NRF_RX_PIPE_4, (uint8_t)(i + 200), true };
+    }
+
+    /* Pipe addresses as stored by NRF_ConfigPrxSfr(): write command in the
+     * low byte, pipes 2-5 hold their LSB only */
+    rxPipeAddr[NRF_RX_PIPE_0] = (0xE7E7E7E7E7ULL << 8) | NRF_WRITE_CMD(NRF_RX_ADDR_P0_REG);
+    rxPipeAddr[NRF_RX_PIPE_1] = (0xC2C2C2C2C2ULL << 8) | NRF_WRITE_CMD(NRF_RX_ADDR_P1_REG);
+    rxPipeAddr[NRF_RX_PIPE_2] = (0xC3ULL << 8) | NRF_WRITE_CMD(NRF_RX_ADDR_P2_REG);
+    rxPipeAddr[NRF_RX_PIPE_3] = (0xC4ULL << 8) | NRF_WRITE_CMD(NRF_RX_ADDR_P3_REG);
+    rxPipeAddr[NRF_RX_PIPE_4] = (0xC5ULL << 8) | NRF_WRITE_CMD(NRF_RX_ADDR_P4_REG);
+
+    bool isPassed = true;
+
+    isPassed &= RunCase("sequence wrap", wrap, sizeof(wrap) / sizeof(wrap[0]), 0);
+    isPassed &= RunCase("window edge", edge, sizeof(edge) / sizeof(edge[0]), 2);
+    isPassed &= RunCase("sources", sources, sizeof(sources) / sizeof(sources[0]), 0);
+    isPassed &= RunCase("retransmitted stream", stream, sizeof(stream) / sizeof(stream[0]), 0);
+
+    return isPassed ? 0 : 1;
+}
@@ -0,0 +1,275 @@
+/*
+ *  Host test of forward error correction (nRF24L01_fec.c)
+ *
+ *  Parity frames of a small group are compared with bytes worked out by hand
+ *  (the XOR row) and with a bitwise GF(256) reference of the Cauchy row the
+ *  header documents. Groups are then sent through a link that erases every
+ *  combination of up to K of their N+K frames, for several N and K. Every
+ *  data frame must reach the handler exactly once with its original size and
+ *  contents, and the statistics must account for each one. One erasure past
+ *  the limit must lose the missing frames without handing over wrong data.
+ */
+#include "nRF24L01_fec.h"
+
+/** Standard libs **/
+#include <stdio.h>
+#include <string.h>
+
+#define GF_POLY_LOW             0x1D        // x^8 + x^4 + x^3 + x^2 + 1 without x^8
+
+/** Receiving end of a group (data frames carry their index in byte 0) **/
+typedef struct {
+    uint8_t     size[NRF_FEC_MAX_DATA_FRAMES];
+    uint8_t     data[NRF_FEC_MAX_DATA_FRAMES][NRF_FEC_MAX_DATA_SIZE];
+    uint32_t    count[NRF_FEC_MAX_DATA_FRAMES];
+    uint32_t    strays;                     // Frames with an unknown index
+} RxGroup_t;
+
+
+static void Handler(const uint8_t *dataPtr, uint8_t size, void *context)
+{
+    RxGroup_t *rx = context;
+
+    if( (size == 0) || (dataPtr[0] >= NRF_FEC_MAX_DATA_FRAMES) )
+    {
+        rx->strays++;
+        return;
+    }
+
+    rx->size[dataPtr[0]] = size;
+    memcpy(rx->data[dataPtr[0]], dataPtr, size);
+    rx->count[dataPtr[0]]++;
+}
+
+
+/*
+ *  Bitwise GF(256) product and inverse, independent of the module's tables
+ */
+static uint8_t RefMul(uint8_t a, uint8_t b)
+{
+    uint8_t product = 0;
+
+    while( b )
+    {
+        product ^= (b & 1) ? a : 0;
+        a = (a & 0x80) ? (uint8_t)((a << 1) ^ GF_POLY_LOW) : (uint8_t)(a << 1);
+        b >>= 1;
+    }
+
+    return product;
+}
+
+
+static uint8_t RefInv(uint8_t a)
+{
+    uint8_t b = 1;
+
+    while( RefMul(a, b) != 1 )
+    {
+        b++;
+    }
+
+    return b;
+}
+
+
+/*
+ *  Data frame "index" of group "group" (2-29 bytes)
+ */
+static uint8_t DataMake(uint32_t group, uint8_t index, uint8_t *dataPtr)
+{
+    uint8_t size = 2 + (uint8_t)((group * 7 + index * 5) % (NRF_FEC_MAX_DATA_SIZE - 1));
+
+    dataPtr[0] = index;
+    for(uint8_t b = 1; b < size; b++)
+    {
+        dataPtr[b] = (uint8_t)(group * 13 + index * 31 + b);
+    }
+
+    return size;
+}
+
+
+/*
+ *  "AB" and "XYZ" protected by two parity frames. Blocks are length byte and
+ *  zero padded data: 02 41 42 00 and 03 58 59 5A. Parity 0 is their XOR,
+ *  parity 1 weighs data frame i by y / (1 + y) with y = K + i
+ */
+static bool TestGolden(void)
+{
+    static const uint8_t xorFrame[] = { 0x00, 0x02, 0x01, 0x19, 0x1B, 0x5A };
+    static const uint8_t blocks[2][4] = { { 0x02, 'A', 'B', 0x00 }, { 0x03, 'X', 'Y', 'Z' } };
+    NrfFecCtx_t ctx;
+    uint8_t frame[32];
+    uint8_t cauchyFrame[6] = { 0x00, 0x03 };
+    bool isPassed = NRF_FecInit(&ctx, 2, 2, NULL, NULL);
+
+    for(uint8_t b = 0; b < 4; b++)
+    {
+        cauchyFrame[2 + b] = RefMul(blocks[0][b], RefMul(2, RefInv(1 ^ 2))) ^
+                             RefMul(blocks[1][b], RefMul(3, RefInv(1 ^ 3)));
+    }
+
+    isPassed &= (NRF_FecEncode(&ctx, "AB", 2, frame) == 4) && (memcmp(frame, "\x00\x00" "AB", 4) == 0);
+    isPassed &= (NRF_FecParity(&ctx, frame) == 0);
+    isPassed &= (NRF_FecEncode(&ctx, "XYZ", 3, frame) == 5) && (memcmp(frame, "\x00\x01" "XYZ", 5) == 0);
+    bool isXor = (NRF_FecParity(&ctx, frame) == sizeof(xorFrame)) && (memcmp(frame, xorFrame, sizeof(xorFrame)) == 0);
+    bool isCauchy = (NRF_FecParity(&ctx, frame) == sizeof(cauchyFrame)) && (memcmp(frame, cauchyFrame, sizeof(cauchyFrame)) == 0);
+
+    /* Group closed, next data frame opens group 1 */
+    isPassed &= (NRF_FecParity(&ctx, frame) == 0) && (NRF_FecEncode(&ctx, "A", 1, frame) == 3) && (frame[0] == 1);
+
+    isPassed &= isXor && isCauchy;
+    printf("fec golden parity: %s%s%s\n", isPassed ? "ok" : "FAILED",
+           isXor ? "" : ", XOR row differs", isCauchy ? "" : ", Cauchy row differs");
+
+    return isPassed;
+}
+
+
+/*
+ *  Sends one group per erasure pattern of up to K frames (bit i of the
+ *  pattern erases frame i), checks every group on its own
+ */
+static bool TestErasures(uint8_t dataFrames, uint8_t parityFrames)
+{
+    static RxGroup_t rx;
+    NrfFecCtx_t enc;
+    NrfFecCtx_t dec;
+    NrfFecStats_t stats;
+    uint8_t frames = dataFrames + parityFrames;
+    uint8_t sent[NRF_FEC_MAX_DATA_FRAMES][NRF_FEC_MAX_DATA_SIZE];
+    uint8_t sentSize[NRF_FEC_MAX_DATA_FRAMES];
+    uint8_t frame[32];
+    uint32_t groups = 0;
+    uint32_t erased = 0;
+    uint32_t wrong = 0;
+
+    NRF_FecInit(&enc, dataFrames, parityFrames, NULL, NULL);
+    NRF_FecInit(&dec, dataFrames, parityFrames, Handler, &rx);
+
+    for(uint32_t pattern = 0; pattern < (1UL << frames); pattern++)
+    {
+        if( __builtin_popcount(pattern) > parityFrames )
+        {
+            continue;
+        }
+
+        memset(&rx, 0, sizeof(rx));
+        uint8_t index = 0;
+
+        for(uint8_t i = 0; i < dataFrames; i++)
+        {
+            sentSize[i] = DataMake(groups, i, sent[i]);
+            uint8_t size = NRF_FecEncode(&enc, sent[i], sentSize[i], frame);
+
+            do
+            {
+                if( !(pattern & (1UL << index)) )
+                {
+                    NRF_FecDecode(&dec, frame, size);
+                }
+                index++;
+            } while( (size = NRF_FecParity(&enc, frame)) != 0 );
+        }
+
+        /* Each data frame handed over once, intact */
+        for(uint8_t i = 0; i < dataFrames; i++)
+        {
+            bool isIntact = (rx.count[i] == 1) && (rx.size[i] == sentSize[i]) &&
+                            (memcmp(rx.data[i], sent[i], sentSize[i]) == 0);
+            wrong += isIntact ? 0 : 1;
+            erased += (pattern & (1UL << i)) ? 1 : 0;
+        }
+        wrong += rx.strays;
+        groups++;
+    }
+
+    /* Group numbers wrap many times, the last group stays open */
+    NRF_FecReadStats(&dec, &stats);
+    bool isStats = (stats.groups == groups - 1) && (stats.recovered == erased) &&
+                   (stats.delivered + stats.recovered == groups * dataFrames) &&
+                   (stats.lost == 0) && (stats.discarded == 0);
+    bool isPassed = (wrong == 0) && isStats;
+
+    printf("fec N=%u K=%u: %s, %u groups, %u frames recovered, %u wrong%s\n", dataFrames, parityFrames,
+           isPassed ? "ok" : "FAILED", groups, stats.recovered, wrong, isStats ? "" : ", statistics differ");
+
+    return isPassed;
+}
+
+
+/*
+ *  K+1 erased data frames can't be restored: they are counted lost once the
+ *  next group arrives, the rest of the group is handed over untouched
+ */
+static bool TestBeyondLimit(void)
+{
+    static RxGroup_t rx;
+    NrfFecCtx_t enc;
+    NrfFecCtx_t dec;
+    NrfFecStats_t stats;
+    uint8_t data[NRF_FEC_MAX_DATA_SIZE];
+    uint8_t frame[32];
+    uint8_t parity[32];
+    uint8_t paritySize = 0;
+    bool isPassed = true;
+
+    memset(&rx, 0, sizeof(rx));
+    NRF_FecInit(&enc, 8, 2, NULL, NULL);
+    NRF_FecInit(&dec, 8, 2, Handler, &rx);
+
+    for(uint32_t group = 0; group < 2; group++)
+    {
+        for(uint8_t i = 0; i < 8; i++)
+        {
+            uint8_t size = NRF_FecEncode(&enc, data, DataMake(group, i, data), frame);
+
+            /* Data frames 0-2 of group 0 erased */
+            if( (group != 0) || (i > 2) )
+            {
+                NRF_FecDecode(&dec, frame, size);
+            }
+            while( (size = NRF_FecParity(&enc, frame)) != 0 )
+            {
+                NRF_FecDecode(&dec, frame, size);
+                memcpy(parity, frame, size);
+                paritySize = size;
+            }
+        }
+
+        /* Group 0: only data frames 3-7 handed over */
+        for(uint8_t i = 0; (group == 0) && (i < 8); i++)
+        {
+            uint8_t size = DataMake(group, i, data);
+            isPassed &= (i > 2) ? ((rx.count[i] == 1) && (rx.size[i] == size) && (memcmp(rx.data[i], data, size) == 0))
+                                : (rx.count[i] == 0);
+        }
+    }
+
+    /* Late frame of group 1 after it was complete */
+    NRF_FecDecode(&dec, parity, paritySize);
+
+    NRF_FecReadStats(&dec, &stats);
+    isPassed &= (stats.groups == 1) && (stats.lost == 3) && (stats.recovered == 0) &&
+                (stats.delivered == 13) && (stats.discarded == 1) && (rx.strays == 0);
+
+    printf("fec beyond limit: %s, %u lost, %u discarded\n", isPassed ? "ok" : "FAILED", stats.lost, stats.discarded);
+
+    return isPassed;
+}
+
+
+int main(void)
+{
+    bool isPassed = true;
+
+    isPassed &= TestGolden();
+    isPassed &= TestErasures(1, 1);
+    isPassed &= TestErasures(4, 2);
+    isPassed &= TestErasures(8, 3);
+    isPassed &= TestErasures(NRF_FEC_MAX_DATA_FRAMES, NRF_FEC_MAX_PARITY_FRAMES);
+    isPassed &= TestBeyondLimit();
+
+    return isPassed ? 0 : 1;
+}
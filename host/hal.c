@@ -0,0 +1,151 @@
+#include "host.h"
+
+/** Standard libs **/
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Core timer runs at SYSCLK/2 and advances by a fixed step per read, so
+ * capture and replay of the same calls see the same time */
+#define HOST_SYS_FREQ           80000000
+#define HOST_TICK_STEP          5000
+
+IcSfr_t IC_MODULE;
+SpiSfr_t SPI1_MODULE;
+
+void (*hostSpiDevice)(volatile uint8_t *rxPtr, volatile uint8_t *txPtr, uint32_t size) = NULL;
+void (*hostPinDevice)(uint32_t pin, bool isHigh) = NULL;
+void (*hostTimerClbk)(void) = NULL;
+uint32_t hostSpiTransactions = 0;
+uint32_t hostSpiBytes = 0;
+
+static uint32_t tickCount = 0;
+static uint32_t tickCompare = 0;
+
+
+/*
+ *  Plays the interrupt controller: INTx flags raised by the driver since the
+ *  last call are taken as a pending interrupt and ISR_Nrf() is vectored
+ */
+void HostServiceIrq(void)
+{
+    uint32_t flags = IC_MODULE.ICxIFS0.SET & IC_INTxIF_MASK;
+    
+    IC_MODULE.ICxIFS0.SET &= ~IC_INTxIF_MASK;
+    if( flags != 0 )
+    {
+        ISR_Nrf();
+    }
+}
+
+
+uint32_t _CP0_GET_COUNT(void)
+{
+    return tickCount += HOST_TICK_STEP;
+}
+
+/* Compare is only stored, ticks come from the harness */
+uint32_t _CP0_GET_COMPARE(void) { return tickCompare; }
+void _CP0_SET_COMPARE(uint32_t value) { tickCompare = value; }
+
+void _CP0_BIS_CAUSE(uint32_t mask) { (void)mask; }
+void _CP0_BIC_CAUSE(uint32_t mask) { (void)mask; }
+
+uint32_t OSC_GetSysFreq(void) { return HOST_SYS_FREQ; }
+uint32_t OSC_GetPbFreq(void) { return HOST_SYS_FREQ; }
+
+void PIO_ConfigPpsSfr(uint32_t pin) { (void)pin; }
+void PIO_ConfigGpioPin(uint32_t pin, int type, int dir) { (void)pin; (void)type; (void)dir; }
+void PIO_ConfigPpsPin(uint32_t pin, int type) { (void)pin; (void)type; }
+void PIO_ConfigGpioPinPull(uint32_t pin, int pull) { (void)pin; (void)pull; }
+void PIO_ClearPin(uint32_t pin)
+{
+    if( hostPinDevice != NULL )
+    {
+        hostPinDevice(pin, false);
+    }
+}
+
+void PIO_SetPin(uint32_t pin)
+{
+    if( hostPinDevice != NULL )
+    {
+        hostPinDevice(pin, true);
+    }
+}
+
+/* IRQ line is active-low and idle, interrupts come from HostServiceIrq() */
+bool PIO_ReadPin(uint32_t pin) { (void)pin; return true; }
+
+void TMR_DelayUs(uint32_t us) { (void)us; }
+
+void TMR_SetCoreTimerCallback(void (*clbkPtr)(void))
+{
+    hostTimerClbk = clbkPtr;
+}
+
+void SPI_EnableSsState(uint32_t pin) { (void)pin; }
+void SPI_DisableSsState(uint32_t pin) { (void)pin; }
+
+/*
+ *  Applies the latest CLR and SET writes to SPIxCON (the driver turns the
+ *  module off with CLR and back on with SET) and returns frame width in bytes
+ */
+static uint32_t SpiFrameBytes(SpiSfr_t *spiSfr)
+{
+    spiSfr->SPIxCON.W = (spiSfr->SPIxCON.W & ~spiSfr->SPIxCON.CLR) | spiSfr->SPIxCON.SET;
+    spiSfr->SPIxCON.CLR = 0;
+    spiSfr->SPIxCON.SET = 0;
+    
+    if( spiSfr->SPIxCON.W & SPI_MODE32_MASK )
+    {
+        return 4;
+    }
+    
+    return (spiSfr->SPIxCON.W & SPI_MODE16_MASK) ? 2 : 1;
+}
+
+
+/*
+ *  Device sees the bytes in wire order: a wide frame is shifted out MSb first,
+ *  so the bytes of each little-endian word go out last to first
+ */
+bool SPI_MasterReadWrite(SpiSfr_t *spiSfr, volatile void *rxPtr, volatile void *txPtr, uint32_t size)
+{
+    uint8_t wireTx[64];
+    uint8_t wireRx[64];
+    uint32_t width = SpiFrameBytes(spiSfr);
+    
+    if( hostSpiDevice == NULL )
+    {
+        fprintf(stderr, "SPI access without a device\n");
+        abort();
+    }
+    if( (size % width) || (size > sizeof(wireTx)) )
+    {
+        fprintf(stderr, "SPI transfer of %u bytes in %u-byte frames\n", size, width);
+        abort();
+    }
+    
+    for(uint32_t i = 0; i < size; i++)
+    {
+        wireTx[i] = ((volatile uint8_t *)txPtr)[i - i % width + (width - 1 - i % width)];
+    }
+    hostSpiTransactions++;
+    hostSpiBytes += size;
+    hostSpiDevice((rxPtr != NULL) ? wireRx : NULL, wireTx, size);
+    for(uint32_t i = 0; (rxPtr != NULL) && (i < size); i++)
+    {
+        ((volatile uint8_t *)rxPtr)[i - i % width + (width - 1 - i % width)] = wireRx[i];
+    }
+    
+    return true;
+}
+
+/* Transfer completes at once, callback runs as the SPI ISR would */
+bool SPI_MasterWrite2(SpiSfr_t *spiSfr, volatile void *rxPtr, volatile void *txPtr, uint32_t size, void (*clbkPtr)(void))
+{
+    SPI_MasterReadWrite(spiSfr, rxPtr, txPtr, size);
+    clbkPtr();
+    
+    return true;
+}
@@ -0,0 +1,29 @@
+#ifndef HOST_H
+#define	HOST_H
+
+/* Host harness of the driver: stand-ins of the PIC32 libraries (hal.c) and
+ * the hooks a host program uses to play the hardware side */
+
+#include "nRF24L01.h"
+
+/* Device behind the SPI stand-ins, bytes in wire order (NULL in replay
+ * builds, where any SPI access is an error) */
+extern void (*hostSpiDevice)(volatile uint8_t *rxPtr, volatile uint8_t *txPtr, uint32_t size);
+
+/* Pin driven by PIO_SetPin()/PIO_ClearPin() (NULL if not observed) */
+extern void (*hostPinDevice)(uint32_t pin, bool isHigh);
+
+/* Transfers and bytes through the SPI stand-ins, counted independently of
+ * NRF_BENCH_ENABLE (the harness may reset them) */
+extern uint32_t hostSpiTransactions;
+extern uint32_t hostSpiBytes;
+
+/* Callback registered with TMR_SetCoreTimerCallback() */
+extern void (*hostTimerClbk)(void);
+
+void HostServiceIrq(void);
+
+/* Driver ISR (not part of the public API) */
+void ISR_Nrf(void);
+
+#endif	/* HOST_H */
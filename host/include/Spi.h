@@ -0,0 +1,13 @@
+#ifndef HOST_SPI_H
+#define	HOST_SPI_H
+
+/* Host stand-in of the PIC32 SPI library (sizes are byte counts) */
+
+#include "xc.h"
+
+bool SPI_MasterReadWrite(SpiSfr_t *spiSfr, volatile void *rxPtr, volatile void *txPtr, uint32_t size);
+bool SPI_MasterWrite2(SpiSfr_t *spiSfr, volatile void *rxPtr, volatile void *txPtr, uint32_t size, void (*clbkPtr)(void));
+void SPI_EnableSsState(uint32_t pin);
+void SPI_DisableSsState(uint32_t pin);
+
+#endif	/* HOST_SPI_H */
@@ -0,0 +1,11 @@
+#ifndef HOST_TMR_H
+#define	HOST_TMR_H
+
+/* Host stand-in of the PIC32 timer library */
+
+#include "xc.h"
+
+void TMR_DelayUs(uint32_t us);
+void TMR_SetCoreTimerCallback(void (*clbkPtr)(void));
+
+#endif	/* HOST_TMR_H */
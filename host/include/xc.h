@@ -0,0 +1,143 @@
+#ifndef HOST_XC_H
+#define	HOST_XC_H
+
+/* Host stand-in of the PIC32 device header, just enough of the interrupt
+ * controller, SPI module and CP0 to build the driver on Linux (see Makefile).
+ * Registers are plain memory, so SET/CLR/INV writes land in their own fields
+ * and are applied by the host harness (see HostServiceIrq()) */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define INLINE                  inline __attribute__((always_inline))
+#define __ISR(vector, ipl)      __attribute__((used))
+
+#define IPL1SOFT                1
+#define IPL2SOFT                2
+#define IPL3SOFT                3
+
+#define _CORE_SOFTWARE_0_VECTOR 1
+#define _CORE_SOFTWARE_1_VECTOR 2
+#define EXTERNAL_0_VECTOR       3
+#define EXTERNAL_1_VECTOR       7
+#define EXTERNAL_2_VECTOR       11
+#define EXTERNAL_3_VECTOR       15
+#define EXTERNAL_4_VECTOR       19
+
+typedef struct {
+    volatile uint32_t W;
+    volatile uint32_t CLR;
+    volatile uint32_t SET;
+    volatile uint32_t INV;
+} Reg_t;
+
+/* Interrupt controller */
+typedef struct {
+    Reg_t   ICxINTCON;
+    Reg_t   ICxIFS0;
+    Reg_t   ICxIEC0;
+    Reg_t   ICxIPC0;
+    Reg_t   ICxIPC1;
+    Reg_t   ICxIPC2;
+    Reg_t   ICxIPC3;
+    Reg_t   ICxIPC4;
+    Reg_t   ICxIPC5;
+} IcSfr_t;
+
+extern IcSfr_t IC_MODULE;
+
+#define IC_CS0IF_MASK           (1 << 1)
+#define IC_CS0IE_MASK           (1 << 1)
+#define IC_CS0IS_MASK           (3 << 8)
+#define IC_CS0IP_MASK           (7 << 10)
+#define IC_CS0IS_POS            8
+#define IC_CS0IP_POS            10
+
+#define IC_INT0IF_MASK          (1 << 3)
+#define IC_INT1IF_MASK          (1 << 8)
+#define IC_INT2IF_MASK          (1 << 13)
+#define IC_INT3IF_MASK          (1 << 18)
+#define IC_INT4IF_MASK          (1 << 23)
+#define IC_INT0IE_MASK          IC_INT0IF_MASK
+#define IC_INT1IE_MASK          IC_INT1IF_MASK
+#define IC_INT2IE_MASK          IC_INT2IF_MASK
+#define IC_INT3IE_MASK          IC_INT3IF_MASK
+#define IC_INT4IE_MASK          IC_INT4IF_MASK
+#define IC_INTxIF_MASK          (IC_INT0IF_MASK | IC_INT1IF_MASK | IC_INT2IF_MASK | \
+                                 IC_INT3IF_MASK | IC_INT4IF_MASK)
+
+#define IC_INT0IS_MASK          0x03
+#define IC_INT0IP_MASK          0x1C
+#define IC_INT0IS_POS           0
+#define IC_INT0IP_POS           2
+#define IC_INT1IS_MASK          IC_INT0IS_MASK
+#define IC_INT1IP_MASK          IC_INT0IP_MASK
+#define IC_INT1IS_POS           IC_INT0IS_POS
+#define IC_INT1IP_POS           IC_INT0IP_POS
+#define IC_INT2IS_MASK          IC_INT0IS_MASK
+#define IC_INT2IP_MASK          IC_INT0IP_MASK
+#define IC_INT2IS_POS           IC_INT0IS_POS
+#define IC_INT2IP_POS           IC_INT0IP_POS
+#define IC_INT3IS_MASK          IC_INT0IS_MASK
+#define IC_INT3IP_MASK          IC_INT0IP_MASK
+#define IC_INT3IS_POS           IC_INT0IS_POS
+#define IC_INT3IP_POS           IC_INT0IP_POS
+#define IC_INT4IS_MASK          IC_INT0IS_MASK
+#define IC_INT4IP_MASK          IC_INT0IP_MASK
+#define IC_INT4IS_POS           IC_INT0IS_POS
+#define IC_INT4IP_POS           IC_INT0IP_POS
+
+#define IC_INT0EP_MASK          (1 << 0)
+#define IC_INT1EP_MASK          (1 << 1)
+#define IC_INT2EP_MASK          (1 << 2)
+#define IC_INT3EP_MASK          (1 << 3)
+#define IC_INT4EP_MASK          (1 << 4)
+
+/* SPI module */
+typedef struct {
+    Reg_t   SPIxCON;
+    Reg_t   SPIxSTAT;
+    Reg_t   SPIxBUF;
+    Reg_t   SPIxBRG;
+    Reg_t   SPIxCON2;
+} SpiSfr_t;
+
+extern SpiSfr_t SPI1_MODULE;
+
+#define SPI_MODE16_MASK         (1 << 10)
+#define SPI_MODE32_MASK         (1 << 11)
+#define SPI_ON_MASK             (1 << 15)
+
+/* CP0 */
+#define _CP0_CAUSE_IP0_MASK     (1 << 8)
+
+uint32_t _CP0_GET_COUNT(void);
+uint32_t _CP0_GET_COMPARE(void);
+void _CP0_SET_COMPARE(uint32_t value);
+void _CP0_BIS_CAUSE(uint32_t mask);
+void _CP0_BIC_CAUSE(uint32_t mask);
+
+/* Single threaded host, so interrupts are never taken asynchronously */
+#define __builtin_disable_interrupts()      (0u)
+#define __builtin_enable_interrupts()       ((void)0)
+#define __builtin_mtc0(reg, sel, value)     ((void)(value))
+
+/* Oscillator */
+uint32_t OSC_GetSysFreq(void);
+uint32_t OSC_GetPbFreq(void);
+
+/* Ports */
+#define PIO_TYPE_DIGITAL        0
+#define PIO_DIR_OUTPUT          0
+#define PIO_CN_PULLUP           0
+
+void PIO_ConfigPpsSfr(uint32_t pin);
+void PIO_ConfigGpioPin(uint32_t pin, int type, int dir);
+void PIO_ConfigPpsPin(uint32_t pin, int type);
+void PIO_ConfigGpioPinPull(uint32_t pin, int pull);
+void PIO_ClearPin(uint32_t pin);
+void PIO_SetPin(uint32_t pin);
+bool PIO_ReadPin(uint32_t pin);
+
+#endif	/* HOST_XC_H */
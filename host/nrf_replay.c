@@ -0,0 +1,405 @@
+/*
+ *  Host capture/replay of the PRX reception scenario
+ *
+ *  Built with NRF_CAPTURE_ENABLE, the program runs the scenario against a
+ *  simulated device and writes the capture stream to a file. Built with
+ *  NRF_REPLAY_ENABLE, it makes the same driver calls against a stream (from
+ *  this program or from a target running the same scenario) and fails on any
+ *  mismatch. Adapt Scenario*() to the API calls of the recorded firmware.
+ *
+ *  Both builds check the payloads against a fixed table: each must reach the
+ *  RX sink with its pipe, length and bytes, in order, and each must raise the
+ *  user callback exactly once before the next arrives. The callback may run
+ *  ahead of the sink while the payload read is still in flight (replay
+ *  completes SPI later than the capture device). The capture build also checks the register values the device
+ *  holds after configuration against values derived from "prxConfig" and
+ *  the datasheet.
+ */
+#include "host.h"
+
+/** Standard libs **/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RX_PAYLOADS             6           // IRQ edges of simulated device
+#define TIMER_TICKS_MAX         32          // Bound of configuration ticks
+
+static const NrfPrxConfig_t prxConfig = {
+    .spiSfr = &SPI1_MODULE,
+    .isAck = NRF_ACK,
+    .rfChannel = NRF_RF_CH_10,
+    .dataRate = NRF_RF_DR_1000,
+    .pipeAddr = {
+        .pipe0 = 0xE7E7E7E7E7,
+        .pipe1 = 0xC2C2C2C2C2,
+        .pipe2 = 0xC3,
+        .pipe3 = 0xC4,
+        .pipe4 = 0xC5,
+        .pipe5 = 0xC6
+    },
+    .pinConfig = {
+        .cePin = 1,
+        .csPin = 2,
+        .irqPin = 3
+    }
+};
+
+static uint8_t rxBuf[32] __attribute__((aligned(4)));
+
+/** Golden payloads (pipe, length, bytes) in order of arrival **/
+typedef struct {
+    NrfRxPipeNo_t   pipeNo;
+    uint8_t         length;
+    uint8_t         data[32];
+} Golden_t;
+
+static const Golden_t golden[RX_PAYLOADS] = {
+    { NRF_RX_PIPE_0, 8,  { 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17 } },
+    { NRF_RX_PIPE_1, 1,  { 0xA5 } },
+    { NRF_RX_PIPE_5, 32, { 0x00, 0xFF, 0x01, 0xFE, 0x02, 0xFD, 0x03, 0xFC,
+                           0x04, 0xFB, 0x05, 0xFA, 0x06, 0xF9, 0x07, 0xF8,
+                           0x08, 0xF7, 0x09, 0xF6, 0x0A, 0xF5, 0x0B, 0xF4,
+                           0x0C, 0xF3, 0x0D, 0xF2, 0x0E, 0xF1, 0x0F, 0xF0 } },
+    { NRF_RX_PIPE_2, 3,  { 0xC3, 0x00, 0x3C } },
+    { NRF_RX_PIPE_0, 29, { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+                           0x09, 0x0A, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16,
+                           0x17, 0x18, 0x19, 0x1A, 0x21, 0x22, 0x23, 0x24,
+                           0x25, 0x26, 0x27, 0x28, 0x29 } },
+    { NRF_RX_PIPE_4, 5,  { 0xDE, 0xAD, 0xBE, 0xEF, 0x42 } },
+};
+
+static uint32_t sinkCount = 0;
+static uint32_t goldenErrors = 0;
+static char order[2 * RX_PAYLOADS + 1];     // 'S' sink, 'C' user callback
+static uint32_t orderLen = 0;
+
+static void OnOrder(char event)
+{
+    if( orderLen < (sizeof(order) - 1) )
+    {
+        order[orderLen++] = event;
+    }
+}
+
+
+static void OnPayload(const uint8_t *payldPtr, uint8_t length, NrfRxPipeNo_t pipeNo)
+{
+    OnOrder('S');
+
+    const Golden_t *exp = &golden[sinkCount % RX_PAYLOADS];
+    if( (sinkCount >= RX_PAYLOADS) || (pipeNo != exp->pipeNo) || (length != exp->length) ||
+        (memcmp(payldPtr, exp->data, length) != 0) )
+    {
+        fprintf(stderr, "payload %u: pipe %d, %u bytes, differs from golden\n", sinkCount, pipeNo, length);
+        goldenErrors++;
+    }
+    sinkCount++;
+}
+
+
+static void OnReceive(void)
+{
+    OnOrder('C');
+}
+
+
+/*
+ *  Checks that every golden payload arrived, each before its callback
+ */
+static bool GoldenCheck(void)
+{
+    bool isOrder = (orderLen == 2 * RX_PAYLOADS);
+    for(uint32_t i = 0; isOrder && (i < orderLen); i++)
+    {
+        isOrder = (i % 2) ? (order[i] != order[i - 1]) : true;
+    }
+
+    bool isPassed = isOrder && (sinkCount == RX_PAYLOADS) && (goldenErrors == 0);
+    printf("golden: %s, %u/%u payloads, order %s\n", isPassed ? "ok" : "FAILED",
+           sinkCount, RX_PAYLOADS, order);
+
+    return isPassed;
+}
+
+#if NRF_CAPTURE_ENABLE
+
+#define CS_PIN                  2
+
+/* Register values after configuration (datasheet encoding of "prxConfig"):
+ * CONFIG EN_CRC | CRCO | PWR_UP | PRIM_RX, auto-ACK and RX enabled on all
+ * six pipes, 5-byte addresses, RF_CH 10, dynamic payload length on all pipes
+ * with EN_DPL | EN_ACK_PAY */
+typedef struct {
+    uint8_t reg;
+    uint8_t value;
+} GoldenReg_t;
+
+static const GoldenReg_t goldenReg[] = {
+    { NRF_CONFIG_REG,       0x0F },
+    { NRF_EN_AA_REG,        0x3F },
+    { NRF_EN_RXADDR_REG,    0x3F },
+    { NRF_SETUP_AW_REG,     0x03 },
+    { NRF_RF_CH_REG,        10 },
+    { NRF_DYNPD_REG,        0x3F },
+    { NRF_FEATURE_REG,      0x06 },
+};
+
+/* Address registers, least significant byte first */
+static const uint8_t goldenAddr[6][5] = {
+    { 0xE7, 0xE7, 0xE7, 0xE7, 0xE7 },
+    { 0xC2, 0xC2, 0xC2, 0xC2, 0xC2 },
+    { 0xC3 }, { 0xC4 }, { 0xC5 }, { 0xC6 }
+};
+
+/** Simulated device **/
+static uint8_t devRegs[32];
+static uint8_t devAddr[6][5];               // RX_ADDR_P0..P5
+static uint8_t devFlags;                    // STATUS interrupt flags
+static const Golden_t *devRx = NULL;        // Payload in RX FIFO (NULL = empty)
+static bool isCsHeld = false;               // CS driven as GPIO (split transaction)
+static bool isCmdSent = false;
+static uint8_t heldCmd;
+static uint32_t devRxIndex;
+
+
+/*
+ *  Register file with STATUS flags and a single-entry RX FIFO holding the
+ *  next golden payload
+ */
+static void Device(volatile uint8_t *rxPtr, volatile uint8_t *txPtr, uint32_t size)
+{
+    /* Payload phase of split transaction */
+    if( isCsHeld && isCmdSent )
+    {
+        for(uint32_t i = 0; (rxPtr != NULL) && (i < size); i++)
+        {
+            rxPtr[i] = ((heldCmd == NRF_READ_RX_PL_CMD) && (devRx != NULL) && (devRxIndex < devRx->length)) ?
+                       devRx->data[devRxIndex++] : 0x00;
+        }
+        return;
+    }
+    
+    uint8_t command = txPtr[0];
+    uint8_t reg = command & 0x1F;
+    if( isCsHeld )
+    {
+        isCmdSent = true;
+        heldCmd = command;
+        devRxIndex = 0;
+    }
+    
+    uint8_t status = devFlags | ((devRx != NULL) ? (devRx->pipeNo << 1) : 0x0E);
+    for(uint32_t i = 0; (rxPtr != NULL) && (i < size); i++)
+    {
+        if( i == 0 )
+        {
+            rxPtr[i] = status;
+        }
+        else if( command == NRF_READ_RX_PL_WID_CMD )
+        {
+            rxPtr[i] = (devRx != NULL) ? devRx->length : 0;
+        }
+        else if( command == NRF_READ_CMD(NRF_FIFO_STATUS_REG) )
+        {
+            rxPtr[i] = 0x10 | ((devRx != NULL) ? 0x00 : 0x01);
+        }
+        else if( (command & 0xE0) == 0x00 )
+        {
+            rxPtr[i] = devRegs[reg];
+        }
+        else
+        {
+            rxPtr[i] = 0x00;
+        }
+    }
+    
+    if( command == NRF_FLUSH_RX_CMD )
+    {
+        devRx = NULL;
+    }
+    else if( command == NRF_WRITE_CMD(NRF_STATUS_REG) )
+    {
+        devFlags &= ~txPtr[1];
+    }
+    else if( ((command & 0xE0) == 0x20) && (reg >= NRF_RX_ADDR_P0_REG) && (reg <= NRF_RX_ADDR_P5_REG) )
+    {
+        for(uint32_t i = 1; (i < size) && (i <= 5); i++)
+        {
+            devAddr[reg - NRF_RX_ADDR_P0_REG][i - 1] = txPtr[i];
+        }
+    }
+    else if( ((command & 0xE0) == 0x20) && (size > 1) )
+    {
+        devRegs[reg] = txPtr[1];
+    }
+}
+
+
+static void DevicePin(uint32_t pin, bool isHigh)
+{
+    if( pin == CS_PIN )
+    {
+        /* Payload leaves RX FIFO once its read ends */
+        if( isHigh && isCsHeld && isCmdSent && (heldCmd == NRF_READ_RX_PL_CMD) )
+        {
+            devRx = NULL;
+        }
+        isCsHeld = !isHigh;
+        isCmdSent = false;
+    }
+}
+
+
+/*
+ *  Checks registers written by configuration against golden values
+ */
+static bool DeviceRegCheck(void)
+{
+    bool isPassed = (memcmp(devAddr, goldenAddr, sizeof(devAddr)) == 0);
+    
+    for(uint32_t i = 0; i < sizeof(goldenReg) / sizeof(goldenReg[0]); i++)
+    {
+        if( devRegs[goldenReg[i].reg] != goldenReg[i].value )
+        {
+            fprintf(stderr, "register 0x%02X: 0x%02X, expected 0x%02X\n", goldenReg[i].reg,
+                    devRegs[goldenReg[i].reg], goldenReg[i].value);
+            isPassed = false;
+        }
+    }
+    
+    printf("registers: %s\n", isPassed ? "ok" : "FAILED");
+    
+    return isPassed;
+}
+
+
+int main(int argc, char **argv)
+{
+    static uint8_t stream[NRF_CAPTURE_SIZE];
+    uint32_t size = 0;
+    uint32_t count;
+    
+    if( argc != 2 )
+    {
+        fprintf(stderr, "usage: %s <stream>\n", argv[0]);
+        return 2;
+    }
+    
+    hostSpiDevice = Device;
+    hostPinDevice = DevicePin;
+    IC_MODULE.ICxIEC0.W = 0xFFFFFFFF;
+    IC_MODULE.ICxIFS0.W = 0xFFFFFFFF;
+    
+    NrfPayloadConfig_t payldConfig = NRF_ConfigPrxPayloadStruct(prxConfig);
+    NRF_SetUserCallback(NRF_CLBK_RX_PAYLOAD_RECEIVE, OnReceive);
+    NRF_SetRxSink(OnPayload);
+    
+    bool isOk = NRF_ConfigPrxSfrAsync(prxConfig);
+    for(uint32_t i = 0; (i < TIMER_TICKS_MAX) && !NRF_IsConfigDone(); i++)
+    {
+        hostTimerClbk();
+    }
+    isOk &= NRF_IsConfigDone();
+    isOk &= (hostTimerClbk == NULL);    // PRX configuration hands core timer back
+    isOk &= DeviceRegCheck();
+    isOk &= NRF_StartReception(payldConfig, rxBuf);
+    
+    /* Device receives one golden payload per IRQ edge */
+    for(uint32_t i = 0; i < RX_PAYLOADS; i++)
+    {
+        devRx = &golden[i];
+        devFlags = NRF_RX_DR_MASK;
+        IC_MODULE.ICxIFS0.SET = NRF_INTxIF_MASK;
+        HostServiceIrq();
+    }
+    isOk &= GoldenCheck();
+    
+    while( (count = NRF_ReadCapture(&stream[size], sizeof(stream) - size)) != 0 )
+    {
+        size += count;
+    }
+    
+    FILE *file = fopen(argv[1], "wb");
+    if( (file == NULL) || (fwrite(stream, 1, size, file) != size) )
+    {
+        perror(argv[1]);
+        return 2;
+    }
+    fclose(file);
+    
+    printf("capture: %u bytes, %u lost\n", size, NRF_ReadCaptureLost());
+    
+    return (isOk && (NRF_ReadCaptureLost() == 0)) ? 0 : 1;
+}
+
+#elif NRF_REPLAY_ENABLE
+
+/*
+ *  Delivers recorded events until the next API call is due
+ */
+static NrfReplayResult_t ReplayUntilWait(void)
+{
+    NrfReplayResult_t result;
+    
+    while( (result = NRF_ReplayStep()) == NRF_REPLAY_STEP )
+    {
+        HostServiceIrq();
+    }
+    
+    return result;
+}
+
+
+int main(int argc, char **argv)
+{
+    static uint8_t stream[1 << 16];
+    NrfReplayStats_t stats;
+    
+    if( argc != 2 )
+    {
+        fprintf(stderr, "usage: %s <stream>\n", argv[0]);
+        return 2;
+    }
+    
+    FILE *file = fopen(argv[1], "rb");
+    if( file == NULL )
+    {
+        perror(argv[1]);
+        return 2;
+    }
+    uint32_t size = fread(stream, 1, sizeof(stream), file);
+    fclose(file);
+    
+    IC_MODULE.ICxIEC0.W = 0xFFFFFFFF;
+    IC_MODULE.ICxIFS0.W = 0xFFFFFFFF;
+    
+    if( !NRF_ReplayLoad(stream, size) )
+    {
+        fprintf(stderr, "%s: not a stream of this build\n", argv[1]);
+        return 2;
+    }
+    
+    NrfPayloadConfig_t payldConfig = NRF_ConfigPrxPayloadStruct(prxConfig);
+    NRF_SetUserCallback(NRF_CLBK_RX_PAYLOAD_RECEIVE, OnReceive);
+    NRF_SetRxSink(OnPayload);
+    
+    bool isOk = NRF_ConfigPrxSfrAsync(prxConfig);
+    ReplayUntilWait();
+    isOk &= NRF_IsConfigDone();
+    isOk &= NRF_StartReception(payldConfig, rxBuf);
+    isOk &= (ReplayUntilWait() == NRF_REPLAY_END);
+    isOk &= GoldenCheck();
+    
+    NRF_ReadReplayStats(&stats);
+    printf("replay: %u records, %u transactions, %u mismatches (first at %d), "
+           "%u gaps, max distance difference %u ticks\n",
+           stats.records, stats.transactions, stats.mismatches, (int)stats.firstMismatch,
+           stats.gaps, stats.deltaMax);
+    
+    return (isOk && (stats.mismatches == 0)) ? 0 : 1;
+}
+
+#else
+    #error "Build with NRF_CAPTURE_ENABLE or NRF_REPLAY_ENABLE"
+#endif
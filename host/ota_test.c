@@ -0,0 +1,289 @@
+/*
+ *  Host test of the firmware transfer (nRF24L01_ota.c)
+ *
+ *  Both ends of a transfer run in one program. The driver calls used by the
+ *  OTA module are replaced by a simulated link: every queued frame goes on
+ *  air when the sender polls it, the receiver takes it over through its RX
+ *  sink and the latest stored status returns as ACK payload. Frames and ACKs
+ *  are dropped in a fixed pattern to exercise go-back-N. Pages are written to
+ *  a RAM-backed flash sink, which must hold the exact image at the end.
+ */
+#include "nRF24L01_ota.h"
+
+/** Standard libs **/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define IMAGE_SIZE              5000        // Last page partially filled
+#define LINK_OPS                NRF_OP_POOL_SIZE
+#define TASK_CALLS_MAX          100000      // Bound of main loop iterations
+
+/** Simulated link **/
+typedef struct {
+    bool            isUsed;
+    bool            isDone;
+    uint8_t        *ackPtr;
+    uint8_t         frame[32];
+    uint8_t         size;
+    uint32_t        seq;                    // Queue order
+    NrfOpResult_t   result;
+} LinkOp_t;
+
+static LinkOp_t linkOp[LINK_OPS];
+static uint32_t linkSeq = 0;
+static uint32_t linkAired = 0;              // Frames put on air (counts losses)
+static uint32_t frameLossEvery = 0;         // 0 = lossless
+static uint32_t ackLossEvery = 0;
+static NrfRxSink_t linkSink = NULL;
+static uint8_t linkAck[32];
+static uint8_t linkAckSize = 0;
+
+/** Flash stand-in **/
+static uint8_t image[IMAGE_SIZE];
+static uint8_t flash[IMAGE_SIZE];
+static uint32_t flashWrites = 0;
+static uint32_t flashFailAt = UINT32_MAX;   // Page write that fails
+
+static NrfOtaRxCtx_t rxCtx;
+static NrfOtaTxCtx_t txCtx;
+static const NrfPayloadConfig_t payldConfig = { .spiSfr = NULL };
+
+
+/*
+ *  Driver calls used by the OTA module
+ */
+void NRF_SetRxSink(NrfRxSink_t sinkPtr)
+{
+    linkSink = sinkPtr;
+}
+
+
+bool NRF_StartReception(NrfPayloadConfig_t config, void *rxPtr)
+{
+    (void)config;
+    (void)rxPtr;
+
+    return true;
+}
+
+
+bool NRF_IsRxFifoLoading(void)
+{
+    return false;
+}
+
+
+bool NRF_StoreAckPayload(NrfPayloadConfig_t config, NrfRxPipeNo_t pipeNo, void *txPtr, uint8_t txSize)
+{
+    (void)config;
+    (void)pipeNo;
+
+    memcpy(linkAck, txPtr, txSize);
+    linkAckSize = txSize;
+
+    return true;
+}
+
+
+NrfOpHandle_t NRF_SendPayloadOp(NrfPayloadConfig_t config, void *rxPtr, void *txPtr, uint8_t txSize)
+{
+    (void)config;
+
+    for(uint32_t i = 0; i < LINK_OPS; i++)
+    {
+        if( !linkOp[i].isUsed )
+        {
+            linkOp[i].isUsed = true;
+            linkOp[i].isDone = false;
+            linkOp[i].ackPtr = rxPtr;
+            memcpy(linkOp[i].frame, txPtr, txSize);
+            linkOp[i].size = txSize;
+            linkOp[i].seq = linkSeq++;
+
+            return (NrfOpHandle_t)(i + 1);
+        }
+    }
+
+    return NRF_OP_INVALID;
+}
+
+
+/*
+ *  Puts oldest pending frame on air
+ */
+static void LinkAirNext(void)
+{
+    LinkOp_t *op = NULL;
+
+    for(uint32_t i = 0; i < LINK_OPS; i++)
+    {
+        if( linkOp[i].isUsed && !linkOp[i].isDone && ((op == NULL) || (linkOp[i].seq < op->seq)) )
+        {
+            op = &linkOp[i];
+        }
+    }
+
+    linkAired++;
+    op->isDone = true;
+    memset(&op->result, 0, sizeof(op->result));
+
+    if( frameLossEvery && ((linkAired % frameLossEvery) == 0) )
+    {
+        op->result.status = NRF_FLAG_MAX_RT;
+        return;
+    }
+
+    /* ACK carries status stored before this frame arrived */
+    uint8_t ackSize = linkAckSize;
+    uint8_t ack[32];
+    memcpy(ack, linkAck, ackSize);
+    linkAckSize = 0;
+
+    linkSink(op->frame, op->size, NRF_RX_PIPE_0);
+
+    if( ackLossEvery && ((linkAired % ackLossEvery) == 0) )
+    {
+        op->result.status = NRF_FLAG_MAX_RT;
+    }
+    else if( ackSize )
+    {
+        memcpy(op->ackPtr, ack, ackSize);
+        op->result.status = NRF_FLAG_ACK_PLD;
+        op->result.length = ackSize;
+    }
+    else
+    {
+        op->result.status = NRF_FLAG_TX_DS;
+    }
+}
+
+
+bool NRF_PollOp(NrfOpHandle_t opHandle, NrfOpResult_t *result)
+{
+    LinkOp_t *op = &linkOp[opHandle - 1];
+
+    /* Frames go on air in queueing order */
+    while( !op->isDone )
+    {
+        LinkAirNext();
+    }
+
+    if( result != NULL )
+    {
+        *result = op->result;
+    }
+
+    return true;
+}
+
+
+bool NRF_ReleaseOp(NrfOpHandle_t opHandle)
+{
+    linkOp[opHandle - 1].isUsed = false;
+
+    return true;
+}
+
+
+/*
+ *  RAM-backed flash sink
+ */
+static bool FlashSink(uint32_t offset, const uint8_t *dataPtr, uint16_t size, void *context)
+{
+    (void)context;
+
+    if( (offset % NRF_OTA_PAGE_SIZE) || ((offset + size) > IMAGE_SIZE) || (flashWrites++ == flashFailAt) )
+    {
+        return false;
+    }
+
+    memcpy(&flash[offset], dataPtr, size);
+
+    return true;
+}
+
+
+/*
+ *  Runs both main loops until sender concludes, "stopAfter" frames stop and
+ *  restart the sender once
+ */
+static bool RunTransfer(const char *name, NrfOtaState_t expectedState, uint32_t stopAfter)
+{
+    NrfOtaState_t txState = NRF_OTA_STARTING;
+    NrfOtaState_t rxState = NRF_OTA_IDLE;
+    uint32_t calls = 0;
+    uint32_t restartFrames = 0;
+
+    while( (calls++ < TASK_CALLS_MAX) && ((txState == NRF_OTA_STARTING) ||
+           (txState == NRF_OTA_TRANSFER) || (txState == NRF_OTA_VERIFY)) )
+    {
+        txState = NRF_OtaTxTask(&txCtx);
+        rxState = NRF_OtaRxTask(&rxCtx);
+
+        if( stopAfter && (txCtx.framesSent >= stopAfter) )
+        {
+            stopAfter = 0;
+            restartFrames = txCtx.framesSent;
+            NRF_OtaTxStop(&txCtx);
+            NRF_OtaTxStart(&txCtx, payldConfig, image, IMAGE_SIZE);
+        }
+    }
+
+    bool isImage = (memcmp(flash, image, IMAGE_SIZE) == 0);
+    bool isPassed = (txState == expectedState) && (rxState == expectedState) &&
+                    ((expectedState != NRF_OTA_DONE) || isImage);
+
+    printf("%s: %s, tx %u rx %u, %u frames (+%u before restart), %u rewinds, %u pages\n",
+           name, isPassed ? "ok" : "FAILED", txState, rxState, txCtx.framesSent,
+           restartFrames, txCtx.rewinds, rxCtx.committed);
+
+    return isPassed;
+}
+
+
+/*
+ *  Resets link, flash and receiver, then starts sender
+ */
+static void Setup(uint32_t frameLoss, uint32_t ackLoss, uint32_t failAt)
+{
+    memset(linkOp, 0, sizeof(linkOp));
+    memset(flash, 0xFF, sizeof(flash));
+    linkAckSize = 0;
+    linkAired = 0;
+    frameLossEvery = frameLoss;
+    ackLossEvery = ackLoss;
+    flashWrites = 0;
+    flashFailAt = failAt;
+
+    NRF_OtaRxStart(&rxCtx, payldConfig, NRF_RX_PIPE_0, FlashSink, NULL);
+    NRF_OtaTxStart(&txCtx, payldConfig, image, IMAGE_SIZE);
+}
+
+
+int main(void)
+{
+    bool isPassed = true;
+
+    for(uint32_t i = 0; i < IMAGE_SIZE; i++)
+    {
+        image[i] = (uint8_t)(i * 7 + (i >> 8));
+    }
+
+    Setup(0, 0, UINT32_MAX);
+    isPassed &= RunTransfer("lossless", NRF_OTA_DONE, 0);
+
+    Setup(5, 0, UINT32_MAX);
+    isPassed &= RunTransfer("frame loss", NRF_OTA_DONE, 0);
+
+    Setup(7, 11, UINT32_MAX);
+    isPassed &= RunTransfer("frame and ACK loss", NRF_OTA_DONE, 0);
+
+    Setup(0, 0, UINT32_MAX);
+    isPassed &= RunTransfer("sender restart", NRF_OTA_DONE, 100);
+
+    Setup(0, 0, 2);
+    isPassed &= RunTransfer("flash failure", NRF_OTA_ERROR, 0);
+
+    return isPassed ? 0 : 1;
+}
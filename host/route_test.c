@@ -0,0 +1,293 @@
+/*
+ *  Host test of tree routing (nRF24L01_route.c)
+ *
+ *  The driver calls used by the routing module are replaced by a simulated
+ *  radio: frames come in through the RX sink the module registers, and every
+ *  forwarded frame is recorded with the pipe address it was sent to. Next
+ *  hops are compared with paths worked out by hand from the octal node
+ *  addresses. Frames at the hop limit and frames arriving on a full queue
+ *  must be dropped, and every frame must be accounted for exactly once in
+ *  the statistics.
+ */
+#include "nRF24L01_route.h"
+
+/** Standard libs **/
+#include <stdio.h>
+#include <string.h>
+
+#define NODE                    02          // Relay under test, child of the gateway
+#define HOP_LIMIT               (2 * NRF_ROUTE_MAX_DEPTH)
+
+IcSfr_t IC_MODULE;
+
+/** Simulated radio **/
+static NrfRxSink_t radioSink = NULL;
+static bool isRadioPtx = false;
+static bool isRadioBusy = false;
+static uint32_t sendLossEvery = 0;          // 0 = every send acknowledged
+static uint32_t sends = 0;
+static uint64_t sentAddr[32];
+static uint8_t sentFrame[32][32];
+static uint8_t sentSize[32];
+static uint32_t clockTicks = 0;
+
+/** Delivery handler **/
+static uint32_t handled = 0;
+static uint16_t handledSrc;
+static uint8_t handledHops;
+static uint8_t handledData[NRF_ROUTE_MAX_DATA];
+static uint8_t handledSize;
+
+
+/*
+ *  Driver calls used by the routing module
+ */
+uint32_t _CP0_GET_COUNT(void)
+{
+    return clockTicks += 10;
+}
+
+
+void NRF_SetRxSink(NrfRxSink_t sinkPtr)
+{
+    radioSink = sinkPtr;
+}
+
+
+bool NRF_SwitchToPrx(NrfPayloadConfig_t payldConfig, const uint64_t rxAddr, void *rxPtr)
+{
+    (void)payldConfig;
+    (void)rxPtr;
+
+    isRadioPtx = false;
+
+    return rxAddr == NRF_ROUTE_PIPE_ADDR(NODE);
+}
+
+
+bool NRF_SwitchToPtx(NrfPayloadConfig_t payldConfig)
+{
+    (void)payldConfig;
+
+    isRadioPtx = true;
+
+    return true;
+}
+
+
+NrfOpHandle_t NRF_SendPayloadOp(NrfPayloadConfig_t config, void *rxPtr, void *txPtr, uint8_t txSize)
+{
+    (void)rxPtr;
+
+    if( isRadioBusy || !isRadioPtx || (sends >= 32) )
+    {
+        return NRF_OP_INVALID;
+    }
+
+    isRadioBusy = true;
+    sentAddr[sends] = config.pipeAddr;
+    memcpy(sentFrame[sends], txPtr, txSize);
+    sentSize[sends] = txSize;
+    sends++;
+
+    return (NrfOpHandle_t)1;
+}
+
+
+bool NRF_PollOp(NrfOpHandle_t opHandle, NrfOpResult_t *result)
+{
+    (void)opHandle;
+
+    memset(result, 0, sizeof(NrfOpResult_t));
+    result->status = (sendLossEvery && ((sends % sendLossEvery) == 0)) ? NRF_FLAG_MAX_RT : NRF_FLAG_TX_DS;
+    result->timestamp = _CP0_GET_COUNT();
+
+    return true;
+}
+
+
+bool NRF_ReleaseOp(NrfOpHandle_t opHandle)
+{
+    (void)opHandle;
+
+    isRadioBusy = false;
+
+    return true;
+}
+
+
+static void Handler(uint16_t srcNode, const uint8_t *dataPtr, uint8_t size, uint8_t hops, void *context)
+{
+    (void)context;
+
+    handled++;
+    handledSrc = srcNode;
+    handledHops = hops;
+    memcpy(handledData, dataPtr, size);
+    handledSize = size;
+}
+
+
+/*
+ *  Frame from "src" to "dst" as taken from air, "hops" taken before this one
+ */
+static void Receive(uint16_t src, uint16_t dst, uint8_t hops, const char *data)
+{
+    uint8_t frame[32] = { (uint8_t)dst, (uint8_t)(dst >> 8), (uint8_t)src, (uint8_t)(src >> 8), hops };
+    uint8_t size = strlen(data);
+
+    memcpy(&frame[NRF_ROUTE_HEADER_SIZE], data, size);
+    radioSink(frame, NRF_ROUTE_HEADER_SIZE + size, NRF_RX_PIPE_1);
+}
+
+
+/*
+ *  Resets the simulated radio and starts the relay
+ */
+static bool Setup(NrfRouteCtx_t *ctx, uint32_t lossEvery)
+{
+    NrfPayloadConfig_t payldConfig = { .spiSfr = NULL };
+
+    isRadioBusy = false;
+    sendLossEvery = lossEvery;
+    sends = 0;
+    handled = 0;
+
+    return NRF_RouteStart(ctx, payldConfig, NODE, Handler, NULL) && (radioSink != NULL) && !isRadioPtx;
+}
+
+
+/*
+ *  Relay 02: its children 012-072 and their subtrees go down, the gateway
+ *  and every other branch go up
+ */
+static bool TestNextHop(void)
+{
+    NrfRouteCtx_t ctx;
+    bool isPassed = Setup(&ctx, 0);
+
+    isPassed &= (NRF_RouteNextHop(&ctx, 00) == 00);
+    isPassed &= (NRF_RouteNextHop(&ctx, 01) == 00);
+    isPassed &= (NRF_RouteNextHop(&ctx, 021) == 00);
+    isPassed &= (NRF_RouteNextHop(&ctx, 012) == 012);
+    isPassed &= (NRF_RouteNextHop(&ctx, 072) == 072);
+    isPassed &= (NRF_RouteNextHop(&ctx, 0312) == 012);
+    isPassed &= (NRF_RouteNextHop(&ctx, 077772) == 072);
+    isPassed &= NRF_RouteIsValidNode(077777) && !NRF_RouteIsValidNode(020) && !NRF_RouteIsValidNode(0177777);
+
+    printf("route next hop: %s\n", isPassed ? "ok" : "FAILED");
+
+    return isPassed;
+}
+
+
+/*
+ *  A frame that took HOP_LIMIT - 1 hops still arrives (HOP_LIMIT in total),
+ *  one more hop is over the limit
+ */
+static bool TestHopLimit(void)
+{
+    NrfRouteCtx_t ctx;
+    NrfRouteStats_t stats;
+    bool isPassed = Setup(&ctx, 0);
+
+    Receive(01, 021, HOP_LIMIT - 1, "up");
+    Receive(01, 021, HOP_LIMIT, "over");
+    Receive(01, 021, 0xFF, "wrapped");
+    Receive(0312, NODE, HOP_LIMIT - 1, "here");
+    Receive(0312, NODE, HOP_LIMIT, "late");
+
+    NRF_RouteTask(&ctx);
+    NRF_RouteTask(&ctx);
+    NRF_RouteTask(&ctx);
+
+    /* Forwarded to the gateway with its hop taken, delivered to the handler */
+    bool isForwarded = (sends == 1) && (sentAddr[0] == NRF_ROUTE_PIPE_ADDR(00)) &&
+                       (sentSize[0] == NRF_ROUTE_HEADER_SIZE + 2) && (sentFrame[0][4] == HOP_LIMIT) &&
+                       (memcmp(&sentFrame[0][NRF_ROUTE_HEADER_SIZE], "up", 2) == 0);
+    bool isDelivered = (handled == 1) && (handledSrc == 0312) && (handledHops == HOP_LIMIT) &&
+                       (handledSize == 4) && (memcmp(handledData, "here", 4) == 0);
+
+    NRF_RouteReadStats(&ctx, &stats);
+    bool isStats = (stats.received == 5) && (stats.dropped == 3) && (stats.forwarded == 1) &&
+                   (stats.delivered == 1) && (stats.lost == 0) && (stats.queueDepth == 0);
+
+    isPassed &= isForwarded && isDelivered && isStats && !isRadioPtx;
+    printf("route hop limit: %s, %u received, %u dropped%s%s%s\n", isPassed ? "ok" : "FAILED",
+           stats.received, stats.dropped, isForwarded ? "" : ", forwarded frame differs",
+           isDelivered ? "" : ", delivered frame differs", isStats ? "" : ", statistics differ");
+    NRF_RouteStop(&ctx);
+
+    return isPassed;
+}
+
+
+/*
+ *  Frames keep arriving while the main loop is busy: the queue takes
+ *  NRF_ROUTE_QUEUE_DEPTH of them, the rest and own data are dropped. Every
+ *  third send is not acknowledged
+ */
+static bool TestQueueFull(void)
+{
+    NrfRouteCtx_t ctx;
+    NrfRouteStats_t stats;
+    char data[4] = "q00";
+    bool isPassed = Setup(&ctx, 3);
+
+    for(uint8_t i = 0; i < NRF_ROUTE_QUEUE_DEPTH + 3; i++)
+    {
+        data[1] = '0' + (i / 10);
+        data[2] = '0' + (i % 10);
+        Receive(012, 01, 1, data);
+    }
+    bool isOwnRefused = !NRF_RouteSend(&ctx, 01, "own", 3);
+
+    NRF_RouteReadStats(&ctx, &stats);
+    bool isFull = (stats.queueDepth == NRF_ROUTE_QUEUE_DEPTH) && (stats.queueMax == NRF_ROUTE_QUEUE_DEPTH) &&
+                  (stats.dropped == 3 + 1) && (stats.received == NRF_ROUTE_QUEUE_DEPTH + 3);
+
+    for(uint32_t i = 0; i < 2 * NRF_ROUTE_QUEUE_DEPTH; i++)
+    {
+        NRF_RouteTask(&ctx);
+    }
+
+    /* Queued frames left in arrival order, all towards the gateway */
+    bool isOrder = (sends == NRF_ROUTE_QUEUE_DEPTH);
+    for(uint8_t i = 0; isOrder && (i < NRF_ROUTE_QUEUE_DEPTH); i++)
+    {
+        isOrder = (sentAddr[i] == NRF_ROUTE_PIPE_ADDR(00)) &&
+                  (sentFrame[i][NRF_ROUTE_HEADER_SIZE + 1] == '0' + (i / 10)) &&
+                  (sentFrame[i][NRF_ROUTE_HEADER_SIZE + 2] == '0' + (i % 10));
+    }
+
+    /* Room again for own data */
+    isPassed &= NRF_RouteSend(&ctx, 01, "own", 3);
+    NRF_RouteTask(&ctx);
+    NRF_RouteTask(&ctx);
+
+    NRF_RouteReadStats(&ctx, &stats);
+    uint32_t queued = NRF_ROUTE_QUEUE_DEPTH + 1;
+    bool isStats = (stats.forwarded + stats.lost == queued) && (stats.lost == queued / 3) &&
+                   (stats.dropped == 3 + 1) && (stats.queueDepth == 0) && (stats.delivered == 0);
+
+    isPassed &= isOwnRefused && isFull && isOrder && isStats;
+    printf("route queue full: %s, %u forwarded, %u lost, %u dropped, queue max %u%s%s%s\n",
+           isPassed ? "ok" : "FAILED", stats.forwarded, stats.lost, stats.dropped, stats.queueMax,
+           isFull ? "" : ", queue not full", isOrder ? "" : ", forwarded frames differ",
+           isStats ? "" : ", statistics differ");
+    NRF_RouteStop(&ctx);
+
+    return isPassed;
+}
+
+
+int main(void)
+{
+    bool isPassed = true;
+
+    isPassed &= TestNextHop();
+    isPassed &= TestHopLimit();
+    isPassed &= TestQueueFull();
+
+    return isPassed ? 0 : 1;
+}
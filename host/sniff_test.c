@@ -0,0 +1,296 @@
+/*
+ *  Host test of the air capture export (nRF24L01_sniff.c)
+ *
+ *  The PIC32 libraries used by the sniffer are replaced by a simulated
+ *  capture radio whose RX FIFO is filled before each ISR call, and by a core
+ *  timer the test sets. One frame is an Enhanced ShockBurst frame built bit
+ *  by bit, with a CRC-16 computed here and checked against the CCITT check
+ *  value. The others are noise, and some of them overrun the ring. The
+ *  exported file is then parsed as pcap: global header, then one record
+ *  header and pseudo-header per frame. Timestamps are worked out by hand
+ *  across a core timer wrap.
+ */
+#include "nRF24L01_sniff.h"
+
+/** Standard libs **/
+#include <stdio.h>
+#include <string.h>
+
+#if NRF_SNIFF_RING_DEPTH != 4
+    #error "Build with NRF_SNIFF_RING_DEPTH=4"
+#endif
+
+#define SYS_FREQ                80000000    // 40 core timer ticks per us
+#define SNIFF_ADDR              0xB3B4B5B605
+#define RECORD_SIZE             (16 + 16 + NRF_SNIFF_FRAME_SIZE)
+#define FILE_MAX                (24 + 8 * RECORD_SIZE)
+
+IcSfr_t IC_MODULE;
+static SpiSfr_t spiModule;
+
+/** Simulated capture radio **/
+static uint8_t fifo[8][NRF_SNIFF_FRAME_SIZE];
+static uint32_t fifoCount = 0;
+static uint32_t clockTicks = 0;
+
+/** pcap file **/
+static uint8_t file[FILE_MAX];
+static uint32_t fileSize = 0;
+static uint32_t writesLeft = UINT32_MAX;    // Writes until writer fails
+
+void ISR_NrfSniff(void);
+
+
+/*
+ *  PIC32 library calls used by the sniffer
+ */
+uint32_t _CP0_GET_COUNT(void) { return clockTicks; }
+uint32_t OSC_GetSysFreq(void) { return SYS_FREQ; }
+void TMR_DelayUs(uint32_t us) { (void)us; }
+void PIO_ConfigPpsSfr(uint32_t pin) { (void)pin; }
+void PIO_ConfigGpioPin(uint32_t pin, int type, int dir) { (void)pin; (void)type; (void)dir; }
+void PIO_ConfigPpsPin(uint32_t pin, int type) { (void)pin; (void)type; }
+void PIO_ConfigGpioPinPull(uint32_t pin, int pull) { (void)pin; (void)pull; }
+void PIO_ClearPin(uint32_t pin) { (void)pin; }
+void PIO_SetPin(uint32_t pin) { (void)pin; }
+void SPI_EnableSsState(uint32_t pin) { (void)pin; }
+
+
+/*
+ *  Capture radio: STATUS reports pipe 0 while the FIFO holds frames,
+ *  R_RX_PAYLOAD pops the oldest one
+ */
+bool SPI_MasterReadWrite(SpiSfr_t *spiSfr, volatile void *rxPtr, volatile void *txPtr, uint32_t size)
+{
+    volatile uint8_t *rx = rxPtr;
+    volatile uint8_t *tx = txPtr;
+    uint8_t status = fifoCount ? NRF_RX_DR_MASK : NRF_RX_P_NO_MASK;
+
+    (void)spiSfr;
+
+    rx[0] = status;
+    for(uint32_t i = 1; i < size; i++)
+    {
+        rx[i] = (tx[0] == NRF_READ_RX_PL_CMD) ? fifo[0][i - 1] : status;
+    }
+
+    if( (tx[0] == NRF_READ_RX_PL_CMD) && fifoCount )
+    {
+        memmove(fifo[0], fifo[1], --fifoCount * sizeof(fifo[0]));
+    }
+
+    return true;
+}
+
+
+static bool Writer(const void *dataPtr, uint32_t size, void *context)
+{
+    (void)context;
+
+    if( (writesLeft-- == 0) || ((fileSize + size) > FILE_MAX) )
+    {
+        return false;
+    }
+
+    memcpy(&file[fileSize], dataPtr, size);
+    fileSize += size;
+
+    return true;
+}
+
+
+/*
+ *  CRC-16 CCITT (x^16 + x^12 + x^5 + 1, initial value 0xFFFF) of "bitCount"
+ *  bits, MSBit first
+ */
+static uint16_t Crc16(const uint8_t *bufPtr, uint32_t bitCount)
+{
+    uint16_t crc = 0xFFFF;
+
+    for(uint32_t i = 0; i < bitCount; i++)
+    {
+        uint16_t bit = (bufPtr[i / 8] >> (7 - (i % 8))) & 0x01;
+        crc = ((crc >> 15) ^ bit) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+
+    return crc;
+}
+
+
+static void BitsPut(uint8_t *bufPtr, uint32_t *pos, uint32_t value, uint8_t count)
+{
+    for(int8_t i = count - 1; i >= 0; i--, (*pos)++)
+    {
+        bufPtr[*pos / 8] |= ((value >> i) & 0x01) << (7 - (*pos % 8));
+    }
+}
+
+
+/*
+ *  ESB frame on air: address (MSByte first), 9-bit packet control field
+ *  (length, PID, NO_ACK), payload, CRC-16 over all of them. The chip clocks
+ *  out what follows the address
+ */
+static uint16_t EsbMake(const char *payload, uint8_t pid, bool isNoAck, uint8_t *framePtr)
+{
+    uint8_t air[5 + NRF_SNIFF_FRAME_SIZE] = {0};
+    uint32_t pos = 0;
+    uint8_t length = strlen(payload);
+
+    BitsPut(air, &pos, (uint32_t)(SNIFF_ADDR >> 8), 32);
+    BitsPut(air, &pos, (uint8_t)SNIFF_ADDR, 8);
+    BitsPut(air, &pos, (length << 3) | (pid << 1) | isNoAck, 9);
+    for(uint8_t i = 0; i < length; i++)
+    {
+        BitsPut(air, &pos, (uint8_t)payload[i], 8);
+    }
+    uint16_t crc = Crc16(air, pos);
+    BitsPut(air, &pos, crc, 16);
+
+    memcpy(framePtr, &air[5], NRF_SNIFF_FRAME_SIZE);
+
+    return crc;
+}
+
+
+/*
+ *  Noise frame "k" (length field 63 can't decode)
+ */
+static void NoiseMake(uint8_t k, uint8_t *framePtr)
+{
+    memset(framePtr, 0x30 + k, NRF_SNIFF_FRAME_SIZE);
+    framePtr[0] = 0xFC | (k & 0x03);
+}
+
+
+static uint32_t Le32(const uint8_t *bufPtr)
+{
+    return bufPtr[0] | (bufPtr[1] << 8) | (bufPtr[2] << 16) | ((uint32_t)bufPtr[3] << 24);
+}
+
+
+/*
+ *  Runs the capture ISR at core timer count "now" with "count" frames of
+ *  "frames" waiting in the FIFO
+ */
+static void Capture(uint32_t now, uint8_t frames[][NRF_SNIFF_FRAME_SIZE], uint32_t count)
+{
+    memcpy(fifo, frames, count * sizeof(fifo[0]));
+    fifoCount = count;
+    clockTicks = now;
+
+    ISR_NrfSniff();
+}
+
+
+int main(void)
+{
+    static const NrfSniffConfig_t sniffConfig = {
+        .spiSfr = &spiModule,
+        .rfChannel = NRF_RF_CH_2,
+        .dataRate = NRF_RF_DR_2000,
+        .addr = SNIFF_ADDR,
+        .addrWidth = 5,
+        .pinConfig = { .cePin = 1, .csPin = 2, .irqPin = 3 }
+    };
+    uint8_t frames[7][NRF_SNIFF_FRAME_SIZE] = {{0}};
+    NrfSniffStats_t stats;
+    bool isPassed = true;
+
+    /* CCITT check value */
+    bool isCrc = (Crc16((const uint8_t *)"123456789", 72) == 0x29B1);
+
+    /* Frame 0 decodes, 1-6 are noise */
+    uint16_t esbCrc = EsbMake("ESB", 2, true, frames[0]);
+    for(uint8_t k = 1; k < 7; k++)
+    {
+        NoiseMake(k, frames[k]);
+    }
+
+    clockTicks = 0xFFFF0000;
+    isPassed &= NRF_SniffStart(sniffConfig) && NRF_SniffPcapHeader(Writer, NULL);
+
+    /* Frame 0, then 1-5 at once: 1-3 fill the ring, 4 and 5 overrun it */
+    Capture(0xFFFFF000, &frames[0], 1);
+    Capture(0x00010000, &frames[1], 5);
+
+    /* Writer fails on the second record, which stays in the ring */
+    writesLeft = 1;
+    isPassed &= (NRF_SniffPcapExport(Writer, NULL, 2) == 1);
+    writesLeft = UINT32_MAX;
+    isPassed &= (NRF_SniffPcapExport(Writer, NULL, 1) == 1);
+
+    /* Frame 6 follows the overrun, 1.5 s later */
+    Capture(0x00010000 + 1500000 * 40, &frames[6], 1);
+    isPassed &= (NRF_SniffPcapExport(Writer, NULL, 10) == 3);
+    isPassed &= (NRF_SniffPcapExport(Writer, NULL, 10) == 0);
+
+    /* Global header: magic, version 2.4, zone, accuracy, snap length, link type */
+    static const uint8_t global[24] = {
+        0xD4, 0xC3, 0xB2, 0xA1, 0x02, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x30, 0x00, 0x00, 0x00, 0x93, 0x00, 0x00, 0x00
+    };
+    bool isGlobal = (fileSize >= sizeof(global)) && (memcmp(file, global, sizeof(global)) == 0);
+
+    /* Records: captured frame, seconds and microseconds since start (40
+     * ticks per us: 0xF000 -> 1536 us, + 0x11000 -> 3276 us, + 60000000 ->
+     * 1503276 us), pseudo-header flags */
+    static const struct {
+        uint8_t     frame;
+        uint32_t    sec;
+        uint32_t    usec;
+        uint8_t     flags;
+    } expected[5] = {
+        { 0, 0, 1536, 0x03 }, { 1, 0, 3276, 0x00 }, { 2, 0, 3276, 0x00 },
+        { 3, 0, 3276, 0x00 }, { 6, 1, 503276, 0x04 }
+    };
+    uint32_t records = 0;
+    uint32_t wrong = 0;
+
+    for(uint32_t offset = sizeof(global); (offset + 16) <= fileSize; records++)
+    {
+        const uint8_t *rec = &file[offset];
+        uint32_t inclLen = Le32(&rec[8]);
+
+        if( (records >= 5) || (inclLen != Le32(&rec[12])) || ((offset + 16 + inclLen) > fileSize) )
+        {
+            wrong++;
+            break;
+        }
+
+        const uint8_t *pseudo = &rec[16];
+        bool isRecord = (inclLen == 16 + NRF_SNIFF_FRAME_SIZE) &&
+                        (Le32(&rec[0]) == expected[records].sec) && (Le32(&rec[4]) == expected[records].usec) &&
+                        (pseudo[0] == 1) && (pseudo[1] == expected[records].flags) &&
+                        (pseudo[2] == NRF_RF_CH_2) && (pseudo[3] == NRF_RF_DR_2000) && (pseudo[15] == 0) &&
+                        (memcmp(&pseudo[16], frames[expected[records].frame], NRF_SNIFF_FRAME_SIZE) == 0);
+
+        /* Decoded frame: address LSByte first, length, PID, CRC, bit offset */
+        if( expected[records].flags & 0x01 )
+        {
+            static const uint8_t addr[5] = { 0x05, 0xB6, 0xB5, 0xB4, 0xB3 };
+            isRecord &= (pseudo[4] == 5) && (memcmp(&pseudo[5], addr, 5) == 0) && (pseudo[10] == 3) &&
+                        (pseudo[11] == 2) && (pseudo[12] == (uint8_t)esbCrc) &&
+                        (pseudo[13] == (esbCrc >> 8)) && (pseudo[14] == 0);
+        }
+        else
+        {
+            static const uint8_t none[11] = {0};
+            isRecord &= (memcmp(&pseudo[4], none, sizeof(none)) == 0);
+        }
+
+        wrong += isRecord ? 0 : 1;
+        offset += 16 + inclLen;
+    }
+
+    NRF_SniffReadStats(&stats);
+    bool isStats = (stats.captured == 5) && (stats.overruns == 2) && (stats.exported == 5) && (stats.decoded == 1);
+    bool isFile = isGlobal && (records == 5) && (wrong == 0) && (fileSize == sizeof(global) + 5 * RECORD_SIZE);
+
+    isPassed &= isCrc && isFile && isStats;
+    printf("sniff pcap export: %s, %u bytes, %u records, %u wrong%s%s%s\n", isPassed ? "ok" : "FAILED",
+           fileSize, records, wrong, isCrc ? "" : ", CRC reference differs",
+           isGlobal ? "" : ", global header differs", isStats ? "" : ", statistics differ");
+
+    return isPassed ? 0 : 1;
+}
@@ -1,13 +1,48 @@
 #include "nRF24L01.h"
 
+/** Standard libs **/
+#include <string.h>
+
 /******************************************************************************/
 /*--------------------------Local Data Variables------------------------------*/
 /******************************************************************************/
 
-/** Write/Read storage variables **/
-static volatile uint8_t nullData[33] = {0};     // Used for dummy writes only
-static volatile uint8_t txData[33] = {0};
-static volatile uint8_t rxData[33] = {0};
+/* No operation record */
+#define OP_NONE                 0xFF
+
+/* NOTE: PIC32 SPI shifts a wide frame MSb first, so payload bytes are swapped
+ *       big-endian within each word (in a staging buffer) to keep nRF byte
+ *       order on the wire (sizes passed to the SPI library stay byte counts) */
+#if NRF_SPI_BURST_WIDTH == 32
+    #define BURST_BYTES             4
+    #define BURST_MODE_MASK         SPI_MODE32_MASK
+#elif NRF_SPI_BURST_WIDTH == 16
+    #define BURST_BYTES             2
+    #define BURST_MODE_MASK         SPI_MODE16_MASK
+#elif NRF_SPI_BURST_WIDTH != 8
+    #error "NRF_SPI_BURST_WIDTH must be 8, 16 or 32"
+#endif
+
+/** Write/Read storage variables (payloads are not staged, see SpiCommandBegin()) **/
+static volatile uint8_t txData[2] = {0};
+static volatile uint8_t rxData[6] = {0};        // Sized for address writes
+
+/** Dummy MOSI of payload reads and MISO sink of blocking payload writes **/
+static const uint8_t payloadFill[32] __attribute__((aligned(4))) = {0};
+static volatile uint8_t payloadSink[32] __attribute__((aligned(4)));
+
+/** Split transaction (command + payload phase) variables **/
+static volatile uint8_t splitCmd = 0x00;        // 0x00 while no split transaction
+static volatile uint32_t splitCsPin;
+static void (*splitClbkPtr)(void);
+
+#if NRF_SPI_BURST_WIDTH != 8
+/** Payload burst variables (payload body clocked in wide SPI frames) **/
+static volatile uint8_t burstStage[32] __attribute__((aligned(4)));   // Words in wire order
+static SpiSfr_t *burstSpiSfr;
+static volatile uint8_t *burstRxPtr;            // Caller buffer of words read
+static volatile uint8_t burstWords;
+#endif
 
 /** Payload related variables **/
 static volatile NrfPayloadConfig_t isrPayldConfig;
@@ -43,6 +78,10 @@ static void (*userClbkReadPayload)(void);
 static void (*userClbkReadAckPayload)(void);
 static void (*userClbkStartTransmission)(void);
 static void (*userClbkPayloadTimeout)(void);
+static void (*userClbkConfigDone)(void);
+
+/** Receive sink, called with every received payload from ISR (see NRF_SetRxSink()) **/
+static NrfRxSink_t rxSinkPtr;
 
 /** Register sequence for series of register writes (used with "regConfig") **/
 static const uint8_t configRegMap[10] = {
@@ -51,6 +90,321 @@ static const uint8_t configRegMap[10] = {
     NRF_DYNPD_REG, NRF_FEATURE_REG
 };
 
+#if NRF_BENCH_ENABLE
+/** Benchmark counters (path of the currently executing driver code) **/
+static volatile NrfBenchStats_t benchStats[NRF_BENCH_PATH_COUNT];
+static volatile NrfBenchPath_t benchPath = NRF_BENCH_SEND_PAYLOAD;
+#endif
+
+#if NRF_TRACE_ENABLE
+/** Trace ring (free-running indexes, wrapped with NRF_TRACE_DEPTH mask) **/
+static NrfTraceRecord_t traceRing[NRF_TRACE_DEPTH];
+static volatile uint32_t traceHead;
+static volatile uint32_t traceTail;
+
+/** Pending interrupt-based SPI transaction (traced on completion) **/
+static volatile uint8_t *traceAsyncRxPtr;
+static volatile uint8_t traceAsyncCmd;
+static volatile uint8_t traceAsyncSize;
+static void (*traceAsyncClbkPtr)(void);
+#endif
+
+#if NRF_ISR_PROFILE_ENABLE
+/** ISR profiling statistics (sum kept wide, mean derived on read) **/
+static volatile struct {
+    uint32_t    count;
+    uint32_t    min;
+    uint32_t    max;
+    uint64_t    sum;
+    uint32_t    histogram[NRF_PROFILE_BINS];
+} isrProfile[NRF_PROFILE_COUNT];
+
+/** Latency probe state **/
+static volatile bool isProbePending = false;
+static volatile bool isProbeIecSet;
+static volatile uint32_t probeStamp;
+static uint32_t irqPin;
+#endif
+
+#if NRF_EVENT_ENABLE
+/** Deferred event queue and handlers (indexed by NrfUserCallback_t) **/
+static NrfEvent_t eventRing[NRF_EVENT_DEPTH];
+static volatile uint32_t eventHead;
+static volatile uint32_t eventTail;
+static volatile uint32_t eventDropped;
+static NrfEventHandler_t eventHandler[NRF_CLBK_CONFIG_DONE + 1];
+static void *eventContext[NRF_CLBK_CONFIG_DONE + 1];
+static volatile uint8_t clbkPending[NRF_CLBK_CONFIG_DONE + 1];     // Deferred user callbacks
+#endif
+
+#if NRF_SCK_CALIBRATION_ENABLE
+/** SCK calibration state **/
+static SpiSfr_t *sckSpiSfr = NULL;
+static uint32_t sckCsPin;
+static uint32_t sckBrgLimit;        // BRG configured by user (slowest SCK)
+#endif
+
+#if NRF_DEDUP_ENABLE
+/** Duplicate filter table (open addressing keyed by full pipe address) **/
+static struct {
+    uint64_t    addr;
+    uint32_t    window;         // Bit i set: sequence "lastSeq - i" seen (0 = free slot)
+    uint32_t    stamp;          // Core timer count of latest payload
+    uint8_t     lastSeq;
+} dedupTable[NRF_DEDUP_SLOTS];
+static volatile NrfDedupStats_t dedupStats;
+#endif
+
+#if NRF_LBT_ENABLE
+/** Listen-before-talk state of current payload **/
+static volatile bool isLbtListening;            // Receiver on, RPD sampled at lbtDeadline
+static volatile bool isLbtBackoff;              // Deferred, listens again at lbtDeadline
+static volatile bool isLbtStartEvent;           // Listening send starts a payload (not a round)
+static volatile bool isLbtBlocking;             // Blocking send pulses CE itself
+static uint32_t lbtDeadline;                    // Core timer count of next step
+static SpiSfr_t *lbtSpiSfr;
+static uint32_t lbtCePin;
+static volatile uint8_t lbtDeferCount;
+static volatile bool isLbtDeferred;             // Payload on air was deferred
+static volatile NrfLbtStats_t lbtStats;
+#endif
+
+#if NRF_RETRY_ENABLE
+/** Software retransmission state of current payload **/
+static volatile uint8_t retryRound;             // Rounds added so far (0 = first round)
+static volatile uint8_t retryArd;
+static volatile NrfRetryStats_t retryStats;
+#endif
+
+#if NRF_HEALTH_ENABLE
+/** Health check counters **/
+static volatile NrfHealthStats_t healthStats;
+#endif
+
+#if NRF_SCATTER_ENABLE
+/** Scatter send in progress (items in address order, "scatterPos" is the
+ *  item on air, followed by "scatterLoaded" - 1 more in TX FIFO) **/
+static NrfScatterItem_t *scatterItems;
+static uint8_t scatterOrder[NRF_SCATTER_MAX_ITEMS];
+static uint8_t scatterCount;
+static volatile uint8_t scatterPos;
+static volatile uint8_t scatterLoaded;
+static volatile uint8_t scatterDelivered;
+static uint32_t scatterArc;                     // Retransmissions of concluded items
+static uint64_t scatterAddr;                    // TX_ADDR and RX_ADDR_P0 content
+static bool isScatterAddrValid;
+#endif
+
+#if NRF_LBT_ENABLE || NRF_RETRY_ENABLE
+/** Random draw state (backoff and ARD) **/
+static uint32_t randomSeed;
+#endif
+
+#if NRF_CAPTURE_ENABLE
+/** Capture ring (free-running byte indexes, records are written whole) **/
+static uint8_t captureRing[NRF_CAPTURE_SIZE];
+static volatile uint32_t captureHead;
+static volatile uint32_t captureTail;
+static volatile uint32_t captureStamp;          // Core timer count of latest record
+static volatile uint32_t captureLost;           // Records lost since latest gap record
+static volatile uint32_t captureLostTotal;
+static volatile bool isCaptureStarted = false;
+
+/** Pending interrupt-based SPI transaction (MISO captured on completion) **/
+static volatile uint8_t *captureAsyncRxPtr;
+static volatile uint8_t captureAsyncSize;
+static void (*captureAsyncClbkPtr)(void);
+#endif
+
+#if NRF_REPLAY_ENABLE
+/** Replayed stream (position is the next record to consume) **/
+static const uint8_t *replayPtr = NULL;
+static const uint8_t *replayEnd = NULL;
+static uint32_t replayStamp;                    // Core timer count of latest record
+static NrfReplayStats_t replayStats;
+
+/** Pending interrupt-based SPI transaction (concluded by NRF_ReplayStep()) **/
+static volatile uint8_t *replayAsyncRxPtr;
+static uint8_t replayAsyncSize;
+static void (*replayAsyncClbkPtr)(void);
+#endif
+
+/******************************************************************************/
+/*--------------------------------Local Macros--------------------------------*/
+/******************************************************************************/
+
+/* Indices of "configRegMap" (and "configState.reg") entries */
+#define REG_IDX_CONFIG          1
+#define REG_IDX_EN_AA           2
+#define REG_IDX_EN_RXADDR       3
+#define REG_IDX_SETUP_AW        4
+#define REG_IDX_SETUP_RETR      5
+#define REG_IDX_RF_CH           6
+#define REG_IDX_DYNPD           8
+#define REG_IDX_FEATURE         9
+
+/* TX/RX PLL settle time from standby (130 us) */
+#define NRF_PLL_SETTLE_US       130
+
+#if NRF_BENCH_ENABLE
+
+/* Attribute the enclosed code (and its SPI traffic) to a benchmark path. Paths
+ * nest, so an ISR preempting an API call restores the caller's path on exit */
+#define BENCH_BEGIN(path)       NrfBenchPath_t benchPrev = benchPath;           \
+                                uint32_t benchStart = _CP0_GET_COUNT();         \
+                                benchPath = (path)
+#define BENCH_END()             benchStats[benchPath].coreTicks +=              \
+                                    _CP0_GET_COUNT() - benchStart;              \
+                                benchPath = benchPrev
+#define BENCH_CALL(path)        benchStats[(path)].calls++
+#define BENCH_COPY(count)       benchStats[benchPath].copyIterations += (count)
+
+#else
+
+#define BENCH_BEGIN(path)
+#define BENCH_END()
+#define BENCH_CALL(path)
+#define BENCH_COPY(count)
+
+#endif
+
+#if NRF_TRACE_ENABLE
+
+#if (NRF_TRACE_DEPTH & (NRF_TRACE_DEPTH - 1)) != 0
+    #error "NRF_TRACE_DEPTH must be a power of two"
+#endif
+
+#define TRACE(event, command, length, status)                                   \
+                                TraceRecord((event), (command), (length), (status))
+
+#else
+
+#define TRACE(event, command, length, status)
+
+#endif
+
+#if NRF_EVENT_ENABLE
+
+#if (NRF_EVENT_DEPTH & (NRF_EVENT_DEPTH - 1)) != 0
+    #error "NRF_EVENT_DEPTH must be a power of two"
+#endif
+
+#if NRF_EVENT_SWI_ENABLE && (NRF_EVENT_ICX_IPL >= NRF_ICX_IPL)
+    #error "NRF_EVENT_ICX_IPL must be lower than NRF_ICX_IPL"
+#endif
+
+#define EVENT(kind, pipeNo, length, status)                                     \
+                                EventPost((kind), (pipeNo), (length), (status))
+
+/* User callbacks are deferred to NRF_ProcessEvents() as well */
+#define USER_CLBK(kind, clbkPtr)                                                \
+                                if( (clbkPtr) != NULL )                         \
+                                {                                               \
+                                    EventDeferCallback(kind);                   \
+                                }
+
+#else
+
+#define EVENT(kind, pipeNo, length, status)
+
+#define USER_CLBK(kind, clbkPtr)                                                \
+                                if( (clbkPtr) != NULL )                         \
+                                {                                               \
+                                    (clbkPtr)();                                \
+                                }
+
+#endif
+
+#if NRF_DEDUP_ENABLE
+
+#if (NRF_DEDUP_SLOTS & (NRF_DEDUP_SLOTS - 1)) != 0
+    #error "NRF_DEDUP_SLOTS must be a power of two"
+#endif
+
+#endif
+
+#if NRF_LBT_ENABLE
+
+#if (NRF_LBT_MAX_BACKOFF & (NRF_LBT_MAX_BACKOFF - 1)) != 0
+    #error "NRF_LBT_MAX_BACKOFF must be a power of two"
+#endif
+
+/* RX time until RPD reflects the channel (PLL settling included) */
+#define LBT_RPD_SETTLE_US       170
+
+/* Backoff slot, one core timer callback period */
+#define LBT_SLOT_US             1000
+
+/* Send is listening or deferred (device is not idle between them) */
+#define LBT_IS_PENDING()        (isLbtListening || isLbtBackoff)
+
+#else
+
+#define LBT_IS_PENDING()        (false)
+
+#endif
+
+#if NRF_RETRY_ENABLE
+/* Added round in progress (SETUP_RETR holds a drawn ARD) */
+#define RETRY_IS_ACTIVE()       (retryRound != 0)
+#else
+#define RETRY_IS_ACTIVE()       (false)
+#endif
+
+#if (NRF_HEALTH_ENABLE || NRF_LBT_ENABLE) && !defined(IC_CTIE_MASK)
+/* Core timer interrupt enable (IEC0 bit 0 on PIC32MX) */
+#define IC_CTIE_MASK            (1 << 0)
+#endif
+
+#if NRF_SCATTER_ENABLE && (NRF_SCATTER_MAX_ITEMS > 255)
+    #error "NRF_SCATTER_MAX_ITEMS must not exceed 255"
+#endif
+
+#if NRF_CAPTURE_ENABLE && NRF_REPLAY_ENABLE
+    #error "NRF_CAPTURE_ENABLE and NRF_REPLAY_ENABLE are mutually exclusive"
+#endif
+
+#if NRF_CAPTURE_ENABLE
+
+#if (NRF_CAPTURE_SIZE & (NRF_CAPTURE_SIZE - 1)) != 0
+    #error "NRF_CAPTURE_SIZE must be a power of two"
+#endif
+
+#define CAPTURE_PUT(byte)       captureRing[captureHead++ & (NRF_CAPTURE_SIZE - 1)] = (byte)
+
+#define CAPTURE_SPI(rxPtr, txPtr, length)                                       \
+                                CaptureRecord(((rxPtr) != NULL) ? NRF_CAPTURE_SPI : \
+                                              NRF_CAPTURE_SPI_TX, (length), (txPtr), (rxPtr))
+#define CAPTURE_IRQ()           CaptureRecord(NRF_CAPTURE_IRQ, 0, NULL, NULL)
+#define CAPTURE_TICK(handler, isActive)                                         \
+                                if( isActive )                                  \
+                                {                                               \
+                                    CaptureRecord(NRF_CAPTURE_TICK, (handler), NULL, NULL); \
+                                }
+
+#else
+
+#define CAPTURE_SPI(rxPtr, txPtr, length)
+#define CAPTURE_IRQ()
+#define CAPTURE_TICK(handler, isActive)
+
+#endif
+
+/* Stream header size (see NRF_CAPTURE_START) */
+#define CAPTURE_HEADER_SIZE     7
+
+#if NRF_ISR_PROFILE_ENABLE
+
+#define PROFILE_BEGIN()         uint32_t profileStart = _CP0_GET_COUNT()
+#define PROFILE_END(sel)        ProfileRecord((sel), _CP0_GET_COUNT() - profileStart)
+
+#else
+
+#define PROFILE_BEGIN()
+#define PROFILE_END(sel)
+
+#endif
+
 /******************************************************************************/
 /*--------------------------Local Data Structures-----------------------------*/
 /******************************************************************************/
@@ -81,6 +435,94 @@ typedef struct {
     uint8_t     RX_ADDR_P5;
 } const PipeAddrConfig_t;
 
+/* Steps of asynchronous configuration (registers are written by the API call
+ * itself, core timer ticks only wait for the oscillator) */
+typedef enum {
+    CONFIG_STEP_IDLE = 0,
+    CONFIG_STEP_SETTLE = 1
+} ConfigStep_t;
+
+/** Configuration state (shared by blocking and asynchronous configuration) **/
+static struct {
+    SpiSfr_t       *spiSfr;
+    NrfPinConfig_t  pinConfig;
+    uint8_t         reg[10];            // Values in "configRegMap" order
+    uint8_t         pipeStatus;         // PIPE_x addresses to be written
+    uint64_t        pipeAddr[6];
+    bool            isPtx;
+    bool            isSettling;         // Oscillator settling after power-up
+    uint32_t        powerUpStamp;       // Core timer count at power-up
+    void          (*prevTimerClbkPtr)(void);    // Restored after asynchronous PRX configuration
+} configState;
+static volatile ConfigStep_t configStep = CONFIG_STEP_IDLE;
+static volatile bool isConfigDone = false;
+
+/** Core timer callback last set by driver (NULL if none) **/
+static void (*coreTimerClbkPtr)(void) = NULL;
+
+/** Role switch duration estimate and end of RX PLL settling (core timer ticks) **/
+static volatile uint32_t switchEstimate = 0;
+static uint32_t switchSettleEnd = 0;
+
+/* States of operation record */
+typedef enum {
+    OP_STATE_FREE = 0,
+    OP_STATE_QUEUED = 1,            // Send waiting for previous one
+    OP_STATE_PENDING = 2,
+    OP_STATE_DONE = 3
+} OpState_t;
+
+/** Operation records (see NRF_SendPayloadOp()) **/
+static struct {
+    volatile OpState_t  state;
+    uint16_t            generation;
+    uint8_t             next;           // Next queued send (OP_NONE at tail)
+    NrfOpResult_t       result;
+    NrfPayloadConfig_t  payldConfig;    // Arguments of queued send
+    void               *rxPtr;
+    void               *txPtr;
+    uint8_t             txSize;
+    NrfTxClass_t        txClass;
+    uint32_t            queueStamp;     // Core timer count at queueing
+#if NRF_SCATTER_ENABLE
+    bool                isScatter;      // "txPtr" holds items, "txSize" count
+#endif
+} opPool[NRF_OP_POOL_SIZE];
+
+/** Operations currently served by the device and queues of sends (one per
+ *  transmit class) **/
+static volatile uint8_t opTx = OP_NONE;
+static volatile uint8_t opAck = OP_NONE;
+static volatile uint8_t opRx = OP_NONE;
+static volatile uint8_t opQueueHead[NRF_TX_CLASS_COUNT] = { OP_NONE, OP_NONE };
+static volatile uint8_t opQueueTail[NRF_TX_CLASS_COUNT] = { OP_NONE, OP_NONE };
+static volatile uint8_t opArc;
+#if NRF_SCATTER_ENABLE
+static volatile uint8_t opSuspended = OP_NONE;  // Scatter send preempted by urgent one
+#endif
+
+/** Send queue counters per transmit class **/
+static volatile struct {
+    uint32_t    queued;
+    uint32_t    started;
+    uint32_t    preempted;
+    uint32_t    delayMax;
+    uint64_t    delaySum;
+} txClassStats[NRF_TX_CLASS_COUNT];
+
+#if NRF_REPLAY_ENABLE
+/* Parsed capture record (see NRF_CAPTURE_START for layout) */
+typedef struct {
+    uint8_t         type;           // NrfCaptureType_t
+    uint32_t        delta;          // Core timer ticks since previous record
+    uint8_t         length;         // SPI bytes or tick handler
+    uint32_t        lost;           // Records lost (gap only)
+    const uint8_t  *mosiPtr;        // NULL if not recorded
+    const uint8_t  *misoPtr;
+    const uint8_t  *nextPtr;
+} ReplayRecord_t;
+#endif
+
 
 /******************************************************************************/
 /*------------------------Local Function Prototypes---------------------------*/
@@ -88,6 +530,28 @@ typedef struct {
 
 /** Non-ISR sub-function **/
 static void IsrHandlerPtrConfig(IsrNrfMode_t isrMode);
+static bool SendPayload(NrfPayloadConfig_t payldConfig, void *rxPtr, void *txPtr, uint8_t txSize);
+static bool ConfigBegin(SpiSfr_t *spiSfr, NrfPinConfig_t pinConfig);
+static void ConfigPtxRegs(const NrfPtxConfig_t ptxConfig, uint8_t *regPtr);
+static void ConfigPtxState(const NrfPtxConfig_t ptxConfig);
+static bool ConfigPrxState(const NrfPrxConfig_t prxConfig);
+static void ConfigApply(void);
+static bool ConfigIsSettled(void);
+static void ConfigEnd(void);
+static uint8_t ConfigWriteRegs(SpiSfr_t *spiSfr, uint8_t firstIdx);
+INLINE static void RadioRegWrite(NrfRadio_t *radio, uint8_t reg, uint8_t value);
+INLINE static uint8_t RadioRegRead(NrfRadio_t *radio, uint8_t reg);
+static void RadioAddrWrite(NrfRadio_t *radio, uint8_t reg, uint64_t addr);
+static void RegShadowWrite(SpiSfr_t *spiSfr, uint8_t regIdx, uint8_t value);
+static uint8_t OpAlloc(void);
+INLINE static NrfOpHandle_t OpHandle(uint8_t idx);
+static uint8_t OpLookup(NrfOpHandle_t opHandle);
+static void OpComplete(uint8_t idx, NrfStatusFlag_t status, uint8_t arc, uint8_t length, NrfRxPipeNo_t pipeNo);
+static NrfOpHandle_t OpSend(NrfPayloadConfig_t payldConfig, void *rxPtr, void *txPtr, uint8_t txSize, NrfTxClass_t txClass);
+static void OpEnqueue(uint8_t idx, NrfTxClass_t txClass);
+static void OpTxStart(void);
+static void OpTxComplete(NrfStatusFlag_t status, uint8_t length);
+static void OpTxKick(void);
 
 /** ISR handlers **/
 static void ISR_NrfHandler_ReadAckPayload(void);
@@ -95,11 +559,94 @@ static void ISR_NrfHandler_ReadPayload(void);
 static void ISR_NrfHandler_SendPayloadCont(void);
 static void ISR_NrfHandler_ReadPayloadCont(void);
 static void ISR_NrfHandler_StartTransmission(void);
+static void TxStart(bool isStartEvent);
+static void TxPulse(bool isStartEvent);
 static void ISR_NrfHandler_RestartReception(void);
+static void ISR_NrfHandler_SendQueued(void);
 static void ISR_NrfTimeoutHandler_SendPayload(void);
+static void ISR_NrfTimeoutHandler_Config(void);
+INLINE static void CoreTimerSetCallback(void (*clbkPtr)(void));
+INLINE static void SwitchSettleWait(void);
 
 /** Other functions **/
 INLINE static void InterruptSfrConfig(const uint32_t pinCode);
+INLINE static void SpiReadWrite(SpiSfr_t *spiSfr, volatile void *rxPtr, volatile void *txPtr, uint32_t size);
+INLINE static void SpiWriteAsync(SpiSfr_t *spiSfr, volatile void *rxPtr, volatile void *txPtr, uint32_t size, void (*clbkPtr)(void));
+static uint8_t SpiCommandBegin(SpiSfr_t *spiSfr, uint32_t csPin, uint8_t command);
+static void SpiCommandEnd(void);
+static void SpiPayloadAsync(SpiSfr_t *spiSfr, volatile void *rxPtr, volatile void *txPtr, uint32_t size, void (*clbkPtr)(void));
+static void ISR_NrfHandler_SplitDone(void);
+static void SpiPayloadReadWrite(SpiSfr_t *spiSfr, volatile void *rxPtr, volatile void *txPtr, uint32_t size);
+#if NRF_SPI_BURST_WIDTH != 8
+INLINE static void SpiBurstMode(SpiSfr_t *spiSfr, bool isEnabled);
+static uint8_t BurstHead(SpiSfr_t *spiSfr, volatile void *rxPtr, volatile void *txPtr, uint32_t size);
+INLINE static void BurstCopy(volatile uint8_t *dstPtr, volatile uint8_t *srcPtr, uint8_t words);
+static void ISR_NrfHandler_BurstDone(void);
+#endif
+#if NRF_TRACE_ENABLE
+INLINE static void TraceRecord(uint8_t event, uint8_t command, uint8_t length, uint8_t status);
+static void ISR_NrfHandler_TraceSpiDone(void);
+#endif
+#if NRF_ISR_PROFILE_ENABLE
+static void ProfileRecord(NrfProfileSel_t sel, uint32_t ticks);
+static NrfProfileSel_t ProfileHandlerSel(void (*handlerPtr)(void));
+#endif
+#if NRF_EVENT_ENABLE
+static void EventPost(NrfUserCallback_t kind, NrfRxPipeNo_t pipeNo, uint8_t length, NrfStatusFlag_t status);
+static void EventDeferCallback(NrfUserCallback_t kind);
+static void (*EventUserCallback(NrfUserCallback_t kind))(void);
+INLINE static void EventSwiEnable(void);
+#endif
+#if NRF_SCK_CALIBRATION_ENABLE
+static void SckCalibrate(SpiSfr_t *spiSfr, uint32_t csPin);
+static bool SckPatternTest(SpiSfr_t *spiSfr, uint32_t brg);
+INLINE static void SpiSetBrg(SpiSfr_t *spiSfr, uint32_t brg);
+#endif
+#if NRF_DEDUP_ENABLE
+static bool DedupIsDuplicate(NrfRxPipeNo_t pipeNo, uint8_t seq);
+#endif
+#if NRF_LBT_ENABLE
+static bool LbtIsClear(bool isBusy);
+static void LbtListenStart(SpiSfr_t *spiSfr, uint32_t cePin);
+static void LbtArm(uint32_t deadline);
+static bool LbtSample(SpiSfr_t *spiSfr);
+static void LbtListenStop(SpiSfr_t *spiSfr, uint32_t cePin);
+static void LbtStep(void);
+static void LbtCancel(SpiSfr_t *spiSfr, uint32_t cePin);
+static uint32_t LbtBackoff(void);
+static void LbtComplete(SpiSfr_t *spiSfr, NrfStatusFlag_t status);
+#endif
+#if NRF_RETRY_ENABLE
+static bool RetryIsRearmed(SpiSfr_t *spiSfr, NrfStatusFlag_t status);
+static void RetryRestore(SpiSfr_t *spiSfr);
+#endif
+#if NRF_LBT_ENABLE || NRF_RETRY_ENABLE
+static uint32_t RandomDraw(void);
+#endif
+#if NRF_HEALTH_ENABLE
+static bool HealthIsIntact(SpiSfr_t *spiSfr);
+static uint8_t HealthRestore(SpiSfr_t *spiSfr);
+#endif
+#if NRF_SCATTER_ENABLE
+static void ScatterStart(NrfPayloadConfig_t payldConfig, NrfScatterItem_t *items, uint8_t count);
+static void ScatterResume(NrfPayloadConfig_t payldConfig);
+static void ScatterLoad(SpiSfr_t *spiSfr, uint8_t maxLoaded);
+static void ScatterWriteAddr(SpiSfr_t *spiSfr, uint64_t addr);
+static void ISR_NrfHandler_Scatter(void);
+#endif
+#if NRF_CAPTURE_ENABLE
+static void CaptureRecord(uint8_t type, uint8_t length, volatile void *mosiPtr, volatile void *misoPtr);
+static void CaptureBegin(void);
+INLINE static uint8_t CaptureVarintSize(uint32_t value);
+INLINE static void CaptureVarint(uint32_t value);
+static void ISR_NrfHandler_CaptureSpiDone(void);
+#endif
+#if NRF_REPLAY_ENABLE
+static bool ReplayParse(ReplayRecord_t *rec);
+static bool ReplayVarint(const uint8_t **bytePtr, uint32_t *value);
+static void ReplayTransaction(uint8_t type, volatile uint8_t *rxPtr, volatile uint8_t *txPtr, uint8_t length);
+static void ReplayMismatch(void);
+#endif
 
 
 /******************************************************************************/
@@ -111,79 +658,46 @@ INLINE static void InterruptSfrConfig(const uint32_t pinCode);
  */
 extern bool NRF_ConfigPtxSfr(const NrfPtxConfig_t ptxConfig)
 {
-    /* IRQ pin as non-GPIO, controlled by Interrupt Controller */
-    PIO_ConfigPpsSfr(ptxConfig.pinConfig.irqPin);
-    
-    /* Configure PIO settings for CE and IRQ pins (CS configured by SPI) */
-    PIO_ConfigGpioPin(ptxConfig.pinConfig.cePin, PIO_TYPE_DIGITAL, PIO_DIR_OUTPUT);
-    PIO_ConfigPpsPin(ptxConfig.pinConfig.irqPin, PIO_TYPE_DIGITAL);
-    PIO_ConfigGpioPinPull(ptxConfig.pinConfig.irqPin, PIO_CN_PULLUP);
-    PIO_ClearPin(ptxConfig.pinConfig.cePin);
-
-    /* Enable current slave */
-    SPI_EnableSsState(ptxConfig.pinConfig.csPin);
-    
-    /* Power-up the device */
-    txData[0] = NRF_WRITE_CMD(NRF_CONFIG_REG);
-    txData[1] = NRF_PWR_UP_MASK;
-    SPI_MasterReadWrite(ptxConfig.spiSfr, rxData, txData, 2);
-    
-    /* Delay after power-up */
-    TMR_DelayUs(1500);
-    
-    /* Device not responding or SPI not configured */
-    if( rxData[0] == NRF_FLAG_NO_RP )
+    /* Power-up the device (if needed) */
+    if( !ConfigBegin(ptxConfig.spiSfr, ptxConfig.pinConfig) )
     {
         return false;
     }
     
-    /* Set timeout callback for interrupt mode */
-    TMR_SetCoreTimerCallback(ISR_NrfTimeoutHandler_SendPayload);
-    isTimeoutEnabled = false;
-            
-    /* Store nRF register configuration settings */
-    RegConfig_t regConfig = {
-        .STATUS =       (NRF_MAX_RT_MASK | NRF_TX_DS_MASK | NRF_RX_DR_MASK),
-        .CONFIG =       (NRF_PWR_UP_MASK | NRF_CRCO_MASK | NRF_EN_CRC_MASK),
-        .SETUP_AW =     (NRF_AW_MASK),
-        .SETUP_RETR =   ((ptxConfig.retrCount << NRF_ARC_POS) |
-                        (ptxConfig.retrDelay << NRF_ARD_POS)),
-        .RF_CH =        (ptxConfig.rfChannel << NRF_RF_CH_POS),
-        .RF_SETUP =     ((ptxConfig.rfPower << NRF_RF_PWR_POS) |
-                        ((ptxConfig.dataRate & 0x1) << NRF_RF_DR_HIGH_POS) |
-                        ((ptxConfig.dataRate & 0x2) << NRF_RF_DR_LOW_POS)),
-        .FEATURE =      ((ptxConfig.isAck << NRF_EN_ACK_PAY_POS) | NRF_EN_DPL_MASK),
-        .EN_AA =        (ptxConfig.isAck ? 0x01 : 0x00),
-        .EN_RXADDR =    (0x01),
-        .DYNPD =        (0x01),
-    };
-    
-    /* Flush TX + RX FIFO */
-    txData[0] = NRF_FLUSH_RX_CMD;
-    SPI_MasterReadWrite(ptxConfig.spiSfr, rxData, txData, 1);
-    txData[0] = NRF_FLUSH_TX_CMD;
-    SPI_MasterReadWrite(ptxConfig.spiSfr, rxData, txData, 1);
+    ConfigPtxState(ptxConfig);
     
-    /* Pointer for indirect member access of structure */
-    const uint8_t *txPtr = (uint8_t *)&regConfig;
+    /* Registers are written while oscillator settles */
+    ConfigApply();
+    while( !ConfigIsSettled() );
+    ConfigEnd();
     
-    /* Modify configuration registers */
-    for(uint8_t i = 0; i < 10; i++, txPtr++)
+    return true;
+}
+
+
+/*
+ *  Configures nRF as PTX without waiting, completion is signaled by
+ *  NRF_IsConfigDone() and NRF_CLBK_CONFIG_DONE callback
+ */
+extern bool NRF_ConfigPtxSfrAsync(const NrfPtxConfig_t ptxConfig)
+{
+    /* Power-up the device (if needed) */
+    if( !ConfigBegin(ptxConfig.spiSfr, ptxConfig.pinConfig) )
     {
-        txData[0] = NRF_WRITE_CMD(configRegMap[i]);
-        txData[1] = *txPtr;
-        
-        SPI_MasterReadWrite(ptxConfig.spiSfr, rxData, txData, 2);
+        return false;
     }
     
-    /* SYS_CLK is read for timeout purpose */
-    sysFreq = OSC_GetSysFreq();
-    
-    /* Disable current slave */
-    SPI_DisableSsState(ptxConfig.pinConfig.csPin);
+    ConfigPtxState(ptxConfig);
     
-    /* Configures interrupt SFRs (based on IRQ pin's PPS register code) */
-    InterruptSfrConfig(ptxConfig.pinConfig.irqPin);
+    /* Registers are written in thread context, core timer ticks only wait
+     * for the oscillator to settle */
+    ConfigApply();
+    configStep = CONFIG_STEP_SETTLE;
+    if( coreTimerClbkPtr != ISR_NrfTimeoutHandler_Config )
+    {
+        configState.prevTimerClbkPtr = coreTimerClbkPtr;
+    }
+    CoreTimerSetCallback(ISR_NrfTimeoutHandler_Config);
     
     return true;
 }
@@ -194,117 +708,67 @@ extern bool NRF_ConfigPtxSfr(const NrfPtxConfig_t ptxConfig)
  */
 extern bool NRF_ConfigPrxSfr(const NrfPrxConfig_t prxConfig)
 {
-    /* IRQ pin as non-GPIO, controlled by Interrupt Controller */
-    PIO_ConfigPpsSfr(prxConfig.pinConfig.irqPin);
-    
-    /* Configure PIO settings for CE and IRQ pins (CS configured by SPI) */
-    PIO_ConfigGpioPin(prxConfig.pinConfig.cePin, PIO_TYPE_DIGITAL, PIO_DIR_OUTPUT);
-    PIO_ConfigPpsPin(prxConfig.pinConfig.irqPin, PIO_TYPE_DIGITAL);
-    PIO_ConfigGpioPinPull(prxConfig.pinConfig.irqPin, PIO_CN_PULLUP);
-    PIO_ClearPin(prxConfig.pinConfig.cePin);
-    
-    /* Enable current slave */
-    SPI_EnableSsState(prxConfig.pinConfig.csPin);
+    /* No PIPE_x address check */
+    if( !ConfigPrxState(prxConfig) )
+    {
+        return false;
+    }
     
     /* Power-up the device (if needed) */
-    txData[0] = NRF_WRITE_CMD(NRF_CONFIG_REG);
-    txData[1] = NRF_PWR_UP_MASK;
-    SPI_MasterReadWrite(prxConfig.spiSfr, rxData, txData, 2);
-    
-    /* Delay after power-up */
-    TMR_DelayUs(1500);
-    
-    /* Device not responding or SPI not configured */
-    if( rxData[0] == NRF_FLAG_NO_RP )
+    if( !ConfigBegin(prxConfig.spiSfr, prxConfig.pinConfig) )
     {
         return false;
     }
-     
-    /* Individual bits reflect whether PIPE_x is enabled or not */
-    uint8_t pipeStatus = ( ((bool)prxConfig.pipeAddr.pipe0 << 0) |
-                           ((bool)prxConfig.pipeAddr.pipe1 << 1) |
-                           ((bool)prxConfig.pipeAddr.pipe2 << 2) |
-                           ((bool)prxConfig.pipeAddr.pipe3 << 3) |
-                           ((bool)prxConfig.pipeAddr.pipe4 << 4) |
-                           ((bool)prxConfig.pipeAddr.pipe5 << 5) );
     
+    /* Registers are written while oscillator settles */
+    ConfigApply();
+    while( !ConfigIsSettled() );
+    ConfigEnd();
+    
+    return true;
+}
+
+
+/*
+ *  Configures nRF as PRX without waiting, completion is signaled by
+ *  NRF_IsConfigDone() and NRF_CLBK_CONFIG_DONE callback
+ */
+extern bool NRF_ConfigPrxSfrAsync(const NrfPrxConfig_t prxConfig)
+{
     /* No PIPE_x address check */
-    if( pipeStatus == 0x00 )
+    if( !ConfigPrxState(prxConfig) )
     {
         return false;
     }
     
-    /* Store nRF register configuration settings */
-    RegConfig_t regConfig = {
-        .STATUS =       (NRF_MAX_RT_MASK | NRF_TX_DS_MASK | NRF_RX_DR_MASK),
-        .CONFIG =       (NRF_PWR_UP_MASK | NRF_PRIM_RX_MASK | NRF_CRCO_MASK | NRF_EN_CRC_MASK),
-        .SETUP_AW =     (NRF_AW_MASK),
-        .SETUP_RETR =   (0x00),
-        .RF_CH =        (prxConfig.rfChannel << NRF_RF_CH_POS),
-        .RF_SETUP =     (((prxConfig.dataRate & 0x1) << NRF_RF_DR_HIGH_POS) |
-                        ((prxConfig.dataRate & 0x2) << NRF_RF_DR_LOW_POS)),
-        .FEATURE =      ((prxConfig.isAck << NRF_EN_ACK_PAY_POS) | NRF_EN_DPL_MASK),
-        .EN_AA =        (prxConfig.isAck ? (pipeStatus & 0x3F) : 0x00),
-        .EN_RXADDR =    (pipeStatus & 0x3F),
-        .DYNPD =        (pipeStatus & 0x3F),
-    };
-    
-    /* Flush TX + RX FIFO */
-    txData[0] = NRF_FLUSH_RX_CMD;
-    SPI_MasterReadWrite(prxConfig.spiSfr, rxData, txData, 1);
-    txData[0] = NRF_FLUSH_TX_CMD;
-    SPI_MasterReadWrite(prxConfig.spiSfr, rxData, txData, 1);
-    
-    /* Pointers for indirect member access of structure */
-    const uint8_t *txPtr;
-    const uint64_t *txPtr64;
-    
-    txPtr = (uint8_t *)&regConfig;
-    
-    /* Modify configuration registers */
-    for(uint8_t i = 0; i < 10; i++, txPtr++)
+    /* Power-up the device (if needed) */
+    if( !ConfigBegin(prxConfig.spiSfr, prxConfig.pinConfig) )
     {
-        txData[0] = NRF_WRITE_CMD(configRegMap[i]);
-        txData[1] = *txPtr;
-        
-        SPI_MasterReadWrite(prxConfig.spiSfr, rxData, txData, 2);
+        return false;
     }
     
-    txPtr64 = &prxConfig.pipeAddr.pipe0;
-    uint64_t txData64 = 0;
-    
-    /* Modify PIPE_x addresses */
-    for(uint8_t i = 0; i < 6; i++, txPtr64++)
+    /* Registers are written in thread context, core timer ticks only wait
+     * for the oscillator to settle */
+    ConfigApply();
+    configStep = CONFIG_STEP_SETTLE;
+    if( coreTimerClbkPtr != ISR_NrfTimeoutHandler_Config )
     {
-        /* Non-zero address is valid */
-        if( (pipeStatus >> i) & 0x01 )
-        {
-            /* Write 5-byte address for first two pipes */
-            if( i < 2 )
-            {
-                txData64 = (*txPtr64 << 8) | (NRF_WRITE_CMD(NRF_RX_ADDR_P0_REG + i));
-                SPI_MasterReadWrite(prxConfig.spiSfr, rxData, &txData64, 6);
-            }
-            /* Write 1-byte address for other pipes */
-            else
-            {
-                txData64 = ((*txPtr64 & 0xFF) << 8) | (NRF_WRITE_CMD(NRF_RX_ADDR_P0_REG + i));
-                SPI_MasterReadWrite(prxConfig.spiSfr, rxData, &txData64, 2);
-            }
-        }
-        
-        rxPipeAddr[i] = txData64;   // Store all addresses into local array
+        configState.prevTimerClbkPtr = coreTimerClbkPtr;
     }
-    
-    /* Configures interrupt SFRs (based on IRQ pin's PPS register code) */
-    InterruptSfrConfig(prxConfig.pinConfig.irqPin);
-    
-    /* Disable current slave */
-    SPI_DisableSsState(prxConfig.pinConfig.csPin);
+    CoreTimerSetCallback(ISR_NrfTimeoutHandler_Config);
     
     return true;
 }
 
+
+/*
+ *  Returns true once the last configuration has completed
+ */
+extern bool NRF_IsConfigDone(void)
+{
+    return isConfigDone;
+}
+
 /*
  *  Set user callback for a certain type of operation.
  */
@@ -325,11 +789,21 @@ void NRF_SetUserCallback(NrfUserCallback_t cType, void (*fPtr)(void))
     {
         userClbkStartTransmission = fPtr;
     }
+    /* Callback after asynchronous configuration */
+    else if( cType == NRF_CLBK_CONFIG_DONE )
+    {
+        userClbkConfigDone = fPtr;
+    }
     /* Callback after PTX send payload timeout operation */
     else 
     {
         userClbkPayloadTimeout = fPtr;
     }
+    
+#if NRF_EVENT_ENABLE
+    /* Callbacks are called from deferred event dispatch */
+    EventSwiEnable();
+#endif
 }
 
 /*
@@ -352,6 +826,11 @@ void NRF_ReleaseUserCallback(NrfUserCallback_t cType)
     {
         userClbkStartTransmission = NULL;
     }
+    /* Callback after asynchronous configuration */
+    else if( cType == NRF_CLBK_CONFIG_DONE )
+    {
+        userClbkConfigDone = NULL;
+    }
     /* Callback after PTX send payload timeout operation */
     else 
     {
@@ -359,12 +838,30 @@ void NRF_ReleaseUserCallback(NrfUserCallback_t cType)
     }
 }
 
+/*
+ *  Sets sink receiving every payload straight from the ISR, before reception
+ *  resumes ("sinkPtr" = NULL removes it). Sink must not block
+ */
+void NRF_SetRxSink(NrfRxSink_t sinkPtr)
+{
+    rxSinkPtr = sinkPtr;
+}
+
 /*
  *  Sends payload and waits (polling) for ACK payload (or successful
  *  transmission if no-acknowledge is enabled)
  */
  extern bool NRF_SendReceivePayload(NrfPayloadConfig_t payldConfig, void *rxPtr, void *txPtr, uint8_t txSize)
 {
+    /* Asynchronous configuration still in progress */
+    if( configStep != CONFIG_STEP_IDLE )
+    {
+        return false;
+    }
+    
+    BENCH_CALL(NRF_BENCH_SEND_RECEIVE_PAYLOAD);
+    BENCH_BEGIN(NRF_BENCH_SEND_RECEIVE_PAYLOAD);
+    
     /* Reset status */
     statusFlag = NRF_FLAG_NO_STATUS;
     
@@ -373,34 +870,47 @@ void NRF_ReleaseUserCallback(NrfUserCallback_t cType)
     
     /* Flush TX + RX FIFO */
     txData[0] = NRF_FLUSH_TX_CMD;
-    SPI_MasterReadWrite(payldConfig.spiSfr, rxData, txData, 1);
+    SpiReadWrite(payldConfig.spiSfr, rxData, txData, 1);
     txData[0] = NRF_FLUSH_RX_CMD;
-    SPI_MasterReadWrite(payldConfig.spiSfr, rxData, txData, 1);
+    SpiReadWrite(payldConfig.spiSfr, rxData, txData, 1);
     
     /* Clear device status - in case of previous MAX_RT */
     txData[0] = NRF_WRITE_CMD(NRF_STATUS_REG);
     txData[1] = NRF_MAX_RT_MASK | NRF_TX_DS_MASK | NRF_RX_DR_MASK;
-    SPI_MasterReadWrite(payldConfig.spiSfr, rxData, txData, 2); 
+    SpiReadWrite(payldConfig.spiSfr, rxData, txData, 2); 
     
     uint64_t txData64 = 0;
     
     /* Configure RX_PIPE_0_ADDR for ACK payload */
     txData64 = (payldConfig.pipeAddr << 8) | NRF_WRITE_CMD(NRF_RX_ADDR_P0_REG);
-    SPI_MasterReadWrite(payldConfig.spiSfr, rxData, &txData64, 6);
+    SpiReadWrite(payldConfig.spiSfr, rxData, &txData64, 6);
     
     /* Configure TX_ADDR */
     txData64 = (payldConfig.pipeAddr << 8) | NRF_WRITE_CMD(NRF_TX_ADDR_REG);
-    SPI_MasterReadWrite(payldConfig.spiSfr, rxData, &txData64, 6);
+    SpiReadWrite(payldConfig.spiSfr, rxData, &txData64, 6);
 
-    /* Send combined command and data */
+    /* Send command and then data directly from user buffer */
     txSize = (txSize > 32) ? 32 : txSize;   // Max 32 bytes per payload
-    txData[0] = NRF_WRITE_TX_PL_CMD;
-    txData[1] = 0x00;
-    for(uint8_t i = 1; i <= txSize; i++)
+    SpiCommandBegin(payldConfig.spiSfr, payldConfig.pinConfig.csPin, NRF_WRITE_TX_PL_CMD);
+    SpiPayloadReadWrite(payldConfig.spiSfr, NULL, txPtr, txSize);
+    SpiCommandEnd();
+    
+#if NRF_LBT_ENABLE
+    /* Listening and backoff run the deadlines of interrupt mode, stepped here
+     * with core timer interrupt masked so its handler does not step them too */
+    uint32_t iecMask = icSfr->ICxIEC0.W & IC_CTIE_MASK;
+    icSfr->ICxIEC0.CLR = iecMask;
+    
+    lbtDeferCount = 0;
+    isLbtBlocking = true;
+    LbtListenStart(payldConfig.spiSfr, payldConfig.pinConfig.cePin);
+    while( LBT_IS_PENDING() )
     {
-        txData[i] = *((uint8_t *)(txPtr+i-1));
+        LbtStep();
     }
-    SPI_MasterReadWrite(payldConfig.spiSfr, rxData, txData, txSize+1);
+    
+    icSfr->ICxIEC0.SET = iecMask;
+#endif
     
     /* Start transmission */
     PIO_ClearPin(payldConfig.pinConfig.cePin);  // Clear if not cleared yet
@@ -417,9 +927,30 @@ void NRF_ReleaseUserCallback(NrfUserCallback_t cType)
 
     /* Check nRF status */
     txData[0] = NRF_NOP_CMD;
-    SPI_MasterReadWrite(payldConfig.spiSfr, rxData, txData, 1);
+    SpiReadWrite(payldConfig.spiSfr, rxData, txData, 1);
     statusFlag = (rxData[0] & 0x70);
     
+#if NRF_RETRY_ENABLE
+    /* MAX_RT starts another round with a new ARD (payload is kept in TX FIFO) */
+    while( RetryIsRearmed(payldConfig.spiSfr, statusFlag) )
+    {
+        PIO_SetPin(payldConfig.pinConfig.cePin);
+        TMR_DelayUs(15);
+        PIO_ClearPin(payldConfig.pinConfig.cePin);
+        
+        timeout = _CP0_GET_COUNT() + delay;
+        while( PIO_ReadPin(payldConfig.pinConfig.irqPin) && (timeout > _CP0_GET_COUNT()) );
+        
+        txData[0] = NRF_NOP_CMD;
+        SpiReadWrite(payldConfig.spiSfr, rxData, txData, 1);
+        statusFlag = (rxData[0] & 0x70);
+    }
+#endif
+    
+#if NRF_LBT_ENABLE
+    LbtComplete(payldConfig.spiSfr, statusFlag);
+#endif
+    
     bool retVal = true;
     
     /* Payload with ACK */
@@ -428,17 +959,21 @@ void NRF_ReleaseUserCallback(NrfUserCallback_t cType)
         /* Payload width check */
         txData[0] = NRF_READ_RX_PL_WID_CMD;
         txData[1] = 0x00;
-        SPI_MasterReadWrite(payldConfig.spiSfr, rxData, txData, 2);
+        SpiReadWrite(payldConfig.spiSfr, rxData, txData, 2);
         uint8_t payldWidth = rxData[1];
 
-        /* Read payload */
-        txData[0] = NRF_READ_RX_PL_CMD;
-        SPI_MasterReadWrite(payldConfig.spiSfr, rxData, txData, payldWidth+1);
-        
-        /* Dump status and copy ACK payload */
-        for(uint8_t i = 0; i < payldWidth; i++)
+        /* Corrupted width must be discarded by flushing RX FIFO */
+        if( (payldWidth > 32) || (rxPtr == NULL) )
+        {
+            txData[0] = NRF_FLUSH_RX_CMD;
+            SpiReadWrite(payldConfig.spiSfr, rxData, txData, 1);
+        }
+        /* Read payload directly into user buffer */
+        else
         {
-            *((uint8_t *)rxPtr + i) = rxData[1 + i];
+            SpiCommandBegin(payldConfig.spiSfr, payldConfig.pinConfig.csPin, NRF_READ_RX_PL_CMD);
+            SpiPayloadReadWrite(payldConfig.spiSfr, rxPtr, NULL, payldWidth);
+            SpiCommandEnd();
         }
     }
     /* Link lost or unresponsive device or successful send without ACK */
@@ -451,67 +986,29 @@ void NRF_ReleaseUserCallback(NrfUserCallback_t cType)
     /* Clear device status */
     txData[0] = NRF_WRITE_CMD(NRF_STATUS_REG);
     txData[1] = NRF_MAX_RT_MASK | NRF_TX_DS_MASK | NRF_RX_DR_MASK;
-    SPI_MasterReadWrite(payldConfig.spiSfr, rxData, txData, 2); 
+    SpiReadWrite(payldConfig.spiSfr, rxData, txData, 2); 
     
     /* Disable current slave */
     SPI_DisableSsState(payldConfig.pinConfig.csPin);
     
+    BENCH_END();
+    
     return retVal;   
 }
 
 
 /*
- *  Loads TX FIFO and sends data (ISR based)
+ *  Loads TX FIFO and sends data (ISR based), refused while a queued operation
+ *  is being sent
  */
 extern bool NRF_SendPayload(NrfPayloadConfig_t payldConfig, void *rxPtr, void *txPtr, uint8_t txSize)
 {
-    /* Reset status */
-    statusFlag = NRF_FLAG_NO_STATUS;
+    if( opTx != OP_NONE )
+    {
+        return false;
+    }
     
-    /* Enable current slave */
-    SPI_EnableSsState(payldConfig.pinConfig.csPin);
-    
-    /* Configure ISR variables */
-    isrRxPtr = rxPtr;
-    isrPayldConfig = payldConfig;
-    
-    /* Configure ISR handler */
-    IsrHandlerPtrConfig(ISR_NRF_MODE_0);
-    
-    /* Flush TX + RX FIFO */
-    txData[0] = NRF_FLUSH_TX_CMD;
-    SPI_MasterReadWrite(payldConfig.spiSfr, rxData, txData, 1);
-    txData[0] = NRF_FLUSH_RX_CMD;
-    SPI_MasterReadWrite(payldConfig.spiSfr, rxData, txData, 1);
-    
-    /* Clear device status - in case of previous MAX_RT */
-    txData[0] = NRF_WRITE_CMD(NRF_STATUS_REG);
-    txData[1] = NRF_MAX_RT_MASK | NRF_TX_DS_MASK | NRF_RX_DR_MASK;
-    SPI_MasterReadWrite(payldConfig.spiSfr, rxData, txData, 2); 
-    
-    uint64_t txData64 = 0;
-    
-    /* Configure RX_PIPE_0_ADDR for ACK payload */
-    txData64 = (payldConfig.pipeAddr << 8) | NRF_WRITE_CMD(NRF_RX_ADDR_P0_REG);
-    SPI_MasterReadWrite(payldConfig.spiSfr, rxData, &txData64, 6);
-    
-    /* Configure TX_ADDR */
-    txData64 = (payldConfig.pipeAddr << 8) | NRF_WRITE_CMD(NRF_TX_ADDR_REG);
-    SPI_MasterReadWrite(payldConfig.spiSfr, rxData, &txData64, 6);
-
-    /* Send combined command and data */
-    txSize = (txSize > 32) ? 32 : txSize;   // Max 32 bytes per payload
-    txData[0] = NRF_WRITE_TX_PL_CMD;
-    txData[1] = 0x00;
-    for(uint8_t i = 1; i <= txSize; i++)
-    {
-        txData[i] = *((uint8_t *)(txPtr+i-1));
-    }
-    
-    /* Start transmission after packet upload */
-    SPI_MasterWrite2(payldConfig.spiSfr, NULL, txData, txSize+1, ISR_NrfHandler_StartTransmission);
-
-    return true;
+    return SendPayload(payldConfig, rxPtr, txPtr, txSize);
 }
 
 
@@ -535,12 +1032,12 @@ extern bool NRF_StartReception(NrfPayloadConfig_t payldConfig, void *rxPtr)
     
     /* Flush RX FIFO */
     txData[0] = NRF_FLUSH_RX_CMD;
-    SPI_MasterReadWrite(payldConfig.spiSfr, rxData, txData, 1);
+    SpiReadWrite(payldConfig.spiSfr, rxData, txData, 1);
     
     /* Clear device status  */
     txData[0] = NRF_WRITE_CMD(NRF_STATUS_REG);
     txData[1] = NRF_MAX_RT_MASK | NRF_TX_DS_MASK | NRF_RX_DR_MASK;
-    SPI_MasterReadWrite(payldConfig.spiSfr, rxData, txData, 2); 
+    SpiReadWrite(payldConfig.spiSfr, rxData, txData, 2); 
     
     /* INTx interrupt source enabled */
     icSfr->ICxIFS0.CLR = NRF_INTxIF_MASK;
@@ -569,7 +1066,7 @@ extern bool NRF_StopReception(NrfPayloadConfig_t payldConfig)
     /* Clear device status (just in case) */
     txData[0] = NRF_WRITE_CMD(NRF_STATUS_REG);
     txData[1] = NRF_MAX_RT_MASK | NRF_TX_DS_MASK | NRF_RX_DR_MASK;
-    SPI_MasterReadWrite(payldConfig.spiSfr, rxData, txData, 2); 
+    SpiReadWrite(payldConfig.spiSfr, rxData, txData, 2); 
     
     /* Disable current slave */
     SPI_DisableSsState(payldConfig.pinConfig.csPin);
@@ -583,6 +1080,9 @@ extern bool NRF_StopReception(NrfPayloadConfig_t payldConfig)
  */
 extern bool NRF_StoreAckPayload(NrfPayloadConfig_t payldConfig, NrfRxPipeNo_t pipeNo, void *txPtr, uint8_t txSize)
 {
+    BENCH_CALL(NRF_BENCH_STORE_ACK_PAYLOAD);
+    BENCH_BEGIN(NRF_BENCH_STORE_ACK_PAYLOAD);
+    
     /* Temporarily disable reception */
     PIO_ClearPin(payldConfig.pinConfig.cePin);
     
@@ -596,360 +1096,4073 @@ extern bool NRF_StoreAckPayload(NrfPayloadConfig_t payldConfig, NrfRxPipeNo_t pi
      * is temporarily disabled if already active */
     isRxFifoLoading = true;
     
-    /* Load combined command and data */
+    /* Load command and then data directly from user buffer, which must stay
+     * valid until loading is done (see NRF_IsRxFifoLoading()) */
     txSize = (txSize > 32) ? 32 : txSize;       // Max 32 bytes per payload
-    txData[0] = NRF_WRITE_ACK_PL_CMD(pipeNo);
-    txData[1] = 0x00;
-    for(uint8_t i = 1; i <= txSize; i++)
-    {
-        txData[i] = *((uint8_t *)(txPtr+i-1));
-    }
+    SpiCommandBegin(payldConfig.spiSfr, payldConfig.pinConfig.csPin, NRF_WRITE_ACK_PL_CMD(pipeNo));
     
-    SPI_MasterWrite2(payldConfig.spiSfr, NULL, txData, txSize+1, ISR_NrfHandler_RestartReception);
+    SpiPayloadAsync(payldConfig.spiSfr, NULL, txPtr, txSize, ISR_NrfHandler_RestartReception);
+    
+    BENCH_END();
     
     return true;
 }
 
 
 /*
- *  Reads status of the latest nRF operation
+ *  Switches configured device to PRX and starts reception on given PIPE_0
+ *  address, without flushing FIFOs or rewriting whole configuration
  */
-extern NrfStatusFlag_t NRF_ReadStatus(void)
+extern bool NRF_SwitchToPrx(NrfPayloadConfig_t payldConfig, const uint64_t rxAddr, void *rxPtr)
 {
-    NrfStatusFlag_t tempFlag = statusFlag;
+    uint32_t switchStart = _CP0_GET_COUNT();
     
-    /* Status valid after ISR done */
-    if( (icSfr->ICxIEC0.W & NRF_INTxIE_MASK) && (icSfr->ICxIFS0.W & NRF_INTxIF_MASK) )
+    /* Operation still in progress */
+    if( isTimeoutEnabled || splitCmd || LBT_IS_PENDING() )
     {
-        return NRF_FLAG_NO_STATUS;
+        return false;
     }
-    else
-    {    
-        statusFlag = NRF_FLAG_NO_STATUS;    // Reset after new status update
-        return tempFlag;
+    
+    /* Enable current slave */
+    SPI_EnableSsState(payldConfig.pinConfig.csPin);
+    SwitchSettleWait();
+    PIO_ClearPin(payldConfig.pinConfig.cePin);
+    
+    /* Own address on PIPE_0 */
+    uint64_t txData64 = ((rxAddr & 0xFFFFFFFFFF) << 8) | NRF_WRITE_CMD(NRF_RX_ADDR_P0_REG);
+    SpiReadWrite(payldConfig.spiSfr, rxData, &txData64, 6);
+    rxPipeAddr[0] = txData64;
+    
+    /* Enable PIPE_0 and flip PRIM_RX (only registers that change are written) */
+    RegShadowWrite(payldConfig.spiSfr, REG_IDX_EN_RXADDR, configState.reg[REG_IDX_EN_RXADDR] | 0x01);
+    RegShadowWrite(payldConfig.spiSfr, REG_IDX_DYNPD, configState.reg[REG_IDX_DYNPD] | 0x01);
+    if( configState.reg[REG_IDX_EN_AA] )
+    {
+        RegShadowWrite(payldConfig.spiSfr, REG_IDX_EN_AA, configState.reg[REG_IDX_EN_AA] | 0x01);
+    }
+    RegShadowWrite(payldConfig.spiSfr, REG_IDX_CONFIG, configState.reg[REG_IDX_CONFIG] | NRF_PRIM_RX_MASK);
+    
+    /* Clear TX flags only, so queued RX payloads are still read out */
+    txData[0] = NRF_WRITE_CMD(NRF_STATUS_REG);
+    txData[1] = NRF_MAX_RT_MASK | NRF_TX_DS_MASK;
+    SpiReadWrite(payldConfig.spiSfr, rxData, txData, 2);
+    bool isRxPending = rxData[0] & NRF_RX_DR_MASK;
+    
+    /* Configure ISR variables and handler */
+    isrRxPtr = rxPtr;
+    isrPayldConfig = payldConfig;
+    IsrHandlerPtrConfig(ISR_NRF_MODE_1);
+    
+    /* INTx interrupt source enabled */
+    icSfr->ICxIFS0.CLR = NRF_INTxIF_MASK;
+    icSfr->ICxIEC0.SET = NRF_INTxIE_MASK;
+    
+    /* IRQ line is already low (no edge), so raise flag in software */
+    if( isRxPending )
+    {
+        icSfr->ICxIFS0.SET = NRF_INTxIF_MASK;
     }
+    
+    /* Start reception (device enters RX after PLL settle time) */
+    PIO_SetPin(payldConfig.pinConfig.cePin);
+    configState.isPtx = false;
+    
+    uint32_t ceTick = _CP0_GET_COUNT();
+    switchSettleEnd = ceTick + NRF_PLL_SETTLE_US * (sysFreq / 1000000 / 2);
+    switchEstimate = switchSettleEnd - switchStart;
+    
+    return true;
 }
 
 
 /*
- *  Flushes the RX FIFO (intended for PRX use)
+ *  Switches configured device to PTX without flushing FIFOs or rewriting
+ *  whole configuration (TX addresses are set by the send functions)
  */
-extern void NRF_FlushRxFifo(NrfPayloadConfig_t payldConfig)
+extern bool NRF_SwitchToPtx(NrfPayloadConfig_t payldConfig)
 {
-    /* Flush TX FIFO */
-    txData[0] = NRF_FLUSH_TX_CMD;
-    SPI_MasterReadWrite(payldConfig.spiSfr, rxData, txData, 1);
+    uint32_t switchStart = _CP0_GET_COUNT();
+    
+    /* Payload read still in progress */
+    if( splitCmd )
+    {
+        return false;
+    }
+    
+    /* INTx interrupt source disabled */
+    icSfr->ICxIFS0.CLR = NRF_INTxIF_MASK;
+    icSfr->ICxIEC0.CLR = NRF_INTxIE_MASK;
+    
+    /* Stop reception (not before RX PLL of a previous switch has settled) */
+    SwitchSettleWait();
+    PIO_ClearPin(payldConfig.pinConfig.cePin);
+    
+    /* Enable current slave */
+    SPI_EnableSsState(payldConfig.pinConfig.csPin);
+    
+    /* ACK is received on PIPE_0, then flip PRIM_RX */
+    RegShadowWrite(payldConfig.spiSfr, REG_IDX_EN_RXADDR, configState.reg[REG_IDX_EN_RXADDR] | 0x01);
+    RegShadowWrite(payldConfig.spiSfr, REG_IDX_DYNPD, configState.reg[REG_IDX_DYNPD] | 0x01);
+    if( configState.reg[REG_IDX_EN_AA] )
+    {
+        RegShadowWrite(payldConfig.spiSfr, REG_IDX_EN_AA, configState.reg[REG_IDX_EN_AA] | 0x01);
+    }
+    RegShadowWrite(payldConfig.spiSfr, REG_IDX_CONFIG, configState.reg[REG_IDX_CONFIG] & ~NRF_PRIM_RX_MASK);
+    
+    /* Disable current slave */
+    SPI_DisableSsState(payldConfig.pinConfig.csPin);
+    
+    /* Set timeout callback for interrupt mode */
+    CoreTimerSetCallback(ISR_NrfTimeoutHandler_SendPayload);
+    isTimeoutEnabled = false;
+    configState.isPtx = true;
+    
+    /* PLL settles on the CE pulse of next transmission, nothing observable
+     * before it */
+    switchEstimate = (_CP0_GET_COUNT() - switchStart) + NRF_PLL_SETTLE_US * (sysFreq / 1000000 / 2);
+    
+    return true;
 }
 
 
 /*
- *  Checks if ACK payload is being loaded in the RX FIFO
+ *  Returns estimated duration of the latest role switch in core timer ticks
+ *  (measured software path plus nominal PLL settle time, the device signals
+ *  nothing when it enters RX or TX)
  */
-extern bool NRF_IsRxFifoLoading(void)
+extern uint32_t NRF_ReadSwitchEstimate(void)
 {
-    return isRxFifoLoading;
+    return switchEstimate;
 }
 
 
 /*
- *  Reads pipe address of the latest reception
+ *  Queues payload for sending and returns its operation handle (sending starts
+ *  immediately if no other send is in progress)
  */
-extern uint64_t NRF_ReadPrxPipeAddr(void)
+extern NrfOpHandle_t NRF_SendPayloadOp(NrfPayloadConfig_t payldConfig, void *rxPtr, void *txPtr, uint8_t txSize)
 {
-    NrfRxPipeNo_t tempNo = rxPipeNo;
-    
-    rxPipeNo = NRF_RX_NO_PIPE;      // Reset pipe state (number)
-    
-    /* Data in valid pipe number */
-    if( tempNo != NRF_RX_NO_PIPE)
-    {
-        return rxPipeAddr[tempNo];
-    }
-    /* Data haven't arrived yet */
-    else
-    {
-        return 0;
-    }
+    return OpSend(payldConfig, rxPtr, txPtr, txSize, NRF_TX_CLASS_BULK);
 }
 
 
-/******************************************************************************/
-/*------------------------Local Function Definitions--------------------------*/
-/******************************************************************************/
-
 /*
- *  Configures TX and RX ISR handler function pointers
+ *  Loads ACK payload into the PRX TX FIFO and returns its operation handle
  */
-static void IsrHandlerPtrConfig(IsrNrfMode_t isrMode)
+extern NrfOpHandle_t NRF_StoreAckPayloadOp(NrfPayloadConfig_t payldConfig, NrfRxPipeNo_t pipeNo, void *txPtr, uint8_t txSize)
 {
-    switch( isrMode )
+    /* Previous ACK payload still loading */
+    if( (opAck != OP_NONE) || (isRxFifoLoading == true) )
     {
-        /* Standard nRF payload transmission */
-        case ISR_NRF_MODE_0:
-            isrHandlerPtr = ISR_NrfHandler_ReadAckPayload;
-            break;
-        /* Standard nRF payload reception */
-        case ISR_NRF_MODE_1:
-            isrHandlerPtr = ISR_NrfHandler_ReadPayload;
-            break;
-        default:
-            break;
+        return NRF_OP_INVALID;
+    }
+    
+    uint8_t idx = OpAlloc();
+    
+    /* Pool exhausted */
+    if( idx == OP_NONE )
+    {
+        return NRF_OP_INVALID;
     }
+    
+    opPool[idx].txSize = (txSize > 32) ? 32 : txSize;
+    opPool[idx].result.pipeNo = pipeNo;
+    opAck = idx;
+    
+    NrfOpHandle_t opHandle = OpHandle(idx);
+    NRF_StoreAckPayload(payldConfig, pipeNo, txPtr, txSize);
+    
+    return opHandle;
 }
 
 
 /*
- *  ISR handler for NRF_SendPayload()
+ *  Arms reception of a single payload into "rxPtr" and returns its operation
+ *  handle (reception pauses after the payload until next call)
  */
-static void ISR_NrfHandler_ReadAckPayload(void)
+extern NrfOpHandle_t NRF_ReceivePayloadOp(NrfPayloadConfig_t payldConfig, void *rxPtr)
 {
-    /* Read and clear nRF status */
-    txData[0] = NRF_WRITE_CMD(NRF_STATUS_REG);
-    txData[1] = NRF_MAX_RT_MASK | NRF_TX_DS_MASK | NRF_RX_DR_MASK;
-    SPI_MasterReadWrite(isrPayldConfig.spiSfr, rxData, txData, 2);
-    statusFlag = (rxData[0] & 0x70);
+    /* One receive operation at a time, into a valid buffer */
+    if( (opRx != OP_NONE) || (rxPtr == NULL) )
+    {
+        return NRF_OP_INVALID;
+    }
     
-    /* Payload with ACK */
-    if( statusFlag == NRF_FLAG_ACK_PLD )
+    uint8_t idx = OpAlloc();
+    
+    /* Pool exhausted */
+    if( idx == OP_NONE )
     {
-        /* Payload width check */
-        txData[0] = NRF_READ_RX_PL_WID_CMD;
-        txData[1] = 0x00;
-        SPI_MasterReadWrite(isrPayldConfig.spiSfr, rxData, txData, 2);
-        isrPayldWidth = rxData[1];
-
-        /* Read payload */
-        nullData[0] = NRF_READ_RX_PL_CMD;
-        nullData[1] = 0x00;
-        SPI_MasterWrite2(isrPayldConfig.spiSfr, rxData, nullData, isrPayldWidth+1, ISR_NrfHandler_SendPayloadCont);
+        return NRF_OP_INVALID;
     }
-    /* Link lost or successful send without ACK */
-    else
+    
+    NrfOpHandle_t opHandle = OpHandle(idx);
+    
+    /* Start reception if not started yet */
+    if( (isrHandlerPtr != ISR_NrfHandler_ReadPayload) || !(icSfr->ICxIEC0.W & NRF_INTxIE_MASK) )
     {
-        /* Disable INTx interrupt source */
-        icSfr->ICxIEC0.CLR = NRF_INTxIE_MASK;
-        icSfr->ICxIFS0.CLR = NRF_INTxIF_MASK;
+        opRx = idx;
+        NRF_StartReception(payldConfig, rxPtr);
+        
+        return opHandle;
     }
     
-    /* Call user callback */
-    if (userClbkReadAckPayload != NULL) {
-        userClbkReadAckPayload();
+    /* INTx interrupt source disabled, no payload read starts while the FIFO
+     * status is read below */
+    icSfr->ICxIEC0.CLR = NRF_INTxIE_MASK;
+    
+    uint32_t intStatus = __builtin_disable_interrupts();
+    bool isReading = splitCmd;
+    if( !isReading )
+    {
+        opRx = idx;
+        isrRxPtr = rxPtr;
+    }
+    __builtin_mtc0(12, 0, intStatus);
+    
+    /* Payload read still in progress (into previous buffer) */
+    if( isReading )
+    {
+        opPool[idx].generation++;
+        opPool[idx].state = OP_STATE_FREE;
+        icSfr->ICxIEC0.SET = NRF_INTxIE_MASK;
+        
+        return NRF_OP_INVALID;
+    }
+    
+    /* Payloads left in RX FIFO raise no new IRQ edge */
+    txData[0] = NRF_NOP_CMD;
+    SpiReadWrite(payldConfig.spiSfr, rxData, txData, 1);
+    if( ((rxData[0] & 0x0E) >> 1) <= NRF_RX_PIPE_5 )
+    {
+        icSfr->ICxIFS0.SET = NRF_INTxIF_MASK;
     }
+    
+    /* Resume reception */
+    icSfr->ICxIEC0.SET = NRF_INTxIE_MASK;
+    PIO_SetPin(payldConfig.pinConfig.cePin);
+    
+    return opHandle;
 }
 
 
 /*
- *  Handles reading of RX FIFO during enabled reception
- *  Initiated by the NRF_StartReception()
+ *  Returns true and copies result once the operation has completed
  */
-static void ISR_NrfHandler_ReadPayload(void)
+extern bool NRF_PollOp(NrfOpHandle_t opHandle, NrfOpResult_t *result)
 {
-    /* Read and clear nRF status */
-    txData[0] = NRF_WRITE_CMD(NRF_STATUS_REG);
-    txData[1] = NRF_MAX_RT_MASK | NRF_TX_DS_MASK | NRF_RX_DR_MASK;
-    SPI_MasterReadWrite(isrPayldConfig.spiSfr, rxData, txData, 2);
-    statusFlag = (rxData[0] & 0x70);
-    rxPipeNo = (rxData[0] & 0x0E) >> 1;
+    uint8_t idx = OpLookup(opHandle);
     
-    /* Payload in RX FIFO */
-    if( (statusFlag == NRF_FLAG_RX_DR) || (statusFlag == NRF_FLAG_ACK_PLD) )
+    /* Invalid (released) handle or operation still in progress */
+    if( (idx == OP_NONE) || (opPool[idx].state != OP_STATE_DONE) )
     {
-        /* Stop reception */
-        PIO_ClearPin(isrPayldConfig.pinConfig.cePin);
-        
-        /* Payload width check */
-        txData[0] = NRF_READ_RX_PL_WID_CMD;
-        txData[1] = 0x00;
-        SPI_MasterReadWrite(isrPayldConfig.spiSfr, rxData, txData, 2);
-        uint8_t payldWidth = rxData[1];
-
-        /* Read payload */
-        nullData[0] = NRF_READ_RX_PL_CMD;
-        nullData[1] = 0x00;
-        SPI_MasterWrite2(isrPayldConfig.spiSfr, rxData, nullData, payldWidth+1, ISR_NrfHandler_ReadPayloadCont);
+        return false;
     }
-    /* PTX couldn't establish link */
-    else
+    
+    if( result != NULL )
     {
-        /* Clear flag only */
-        icSfr->ICxIFS0.CLR = NRF_INTxIF_MASK;
+        *result = opPool[idx].result;
     }
     
-    /* Call user callback */
-    if (userClbkReadPayload != NULL) {
-        userClbkReadPayload();
-    }
+    return true;
 }
 
 
 /*
- *  ISR handler for ISR_NrfHandler_SendPayload() (executed within scope of SPI
- *  ISR), where the former is initially triggered by the NRF_SendPayload()
+ *  Waits (polling) for the operation to complete, at most "timeoutMs"
  */
-static void ISR_NrfHandler_SendPayloadCont(void)
+extern bool NRF_WaitOp(NrfOpHandle_t opHandle, NrfOpResult_t *result, uint32_t timeoutMs)
 {
-    /* Disable INTx interrupt source */
-    icSfr->ICxIEC0.CLR = NRF_INTxIE_MASK;
-    icSfr->ICxIFS0.CLR = NRF_INTxIF_MASK;
+    uint32_t start = _CP0_GET_COUNT();
+    uint32_t delay = timeoutMs * (sysFreq / 1000 / 2);
     
-    /* Disable current slave */
-    SPI_EnableSsState(isrPayldConfig.pinConfig.csPin);
-    
-    /* "isrRxPtr" starts at initial "rxPtr" address,
-     * while "rxData" is a temporary storage */
-    /* Dump status and copy ACK payload */
-    for(uint8_t i = 0; i < isrPayldWidth; i++)
+    while( !NRF_PollOp(opHandle, result) )
     {
-        *((uint8_t *)isrRxPtr + i) = rxData[1 + i];
+        /* Released handle never completes */
+        if( OpLookup(opHandle) == OP_NONE )
+        {
+            return false;
+        }
+        
+        if( (_CP0_GET_COUNT() - start) >= delay )
+        {
+            return false;
+        }
     }
+    
+    return true;
 }
 
 
 /*
- *  ISR handler for ISR_NrfHandler_ReadPayload() (executed within scope of SPI
- *  ISR), where the former is initially triggered by the NRF_StartReception()
+ *  Returns operation record to the pool (queued sends are cancelled, pending
+ *  operations can't be released)
  */
-static void ISR_NrfHandler_ReadPayloadCont(void)
+extern bool NRF_ReleaseOp(NrfOpHandle_t opHandle)
 {
-    /* Clear flag only */
-    icSfr->ICxIFS0.CLR = NRF_INTxIF_MASK;
+    uint32_t intStatus = __builtin_disable_interrupts();
+    uint8_t idx = OpLookup(opHandle);
     
-    /* "isrRxPtr" starts at initial "rxPtr" address,
-     * while "rxData" is a temporary storage */
-    /* Dump status and copy ACK payload */
-    for(uint8_t i = 0; i < isrPayldWidth; i++)
+    if( (idx == OP_NONE) || (opPool[idx].state == OP_STATE_PENDING) )
     {
-        *((uint8_t *)isrRxPtr + i) = rxData[1 + i];
+        __builtin_mtc0(12, 0, intStatus);
+        return false;
     }
     
-    /* Start new reception */
-    PIO_SetPin(isrPayldConfig.pinConfig.cePin);
+    /* Remove not yet started send from queue of its class */
+    if( opPool[idx].state == OP_STATE_QUEUED )
+    {
+        NrfTxClass_t txClass = opPool[idx].txClass;
+        uint8_t prev = OP_NONE;
+        for(uint8_t i = opQueueHead[txClass]; i != idx; i = opPool[i].next)
+        {
+            prev = i;
+        }
+        
+        if( prev == OP_NONE )
+        {
+            opQueueHead[txClass] = opPool[idx].next;
+        }
+        else
+        {
+            opPool[prev].next = opPool[idx].next;
+        }
+        if( opQueueTail[txClass] == idx )
+        {
+            opQueueTail[txClass] = prev;
+        }
+    }
+    
+    /* Stale handles are rejected by generation mismatch */
+    opPool[idx].generation++;
+    opPool[idx].state = OP_STATE_FREE;
+    __builtin_mtc0(12, 0, intStatus);
+    
+    return true;
 }
 
 
 /*
- *  ISR handler for NRF_SendPayload() (executed within scope of SPI ISR)
+ *  Queues payload in urgent class and returns its operation handle, the send
+ *  starts before all queued bulk sends once the send in progress concludes (a
+ *  scatter send is suspended at its next packet boundary)
  */
-static void ISR_NrfHandler_StartTransmission(void)
+extern NrfOpHandle_t NRF_SendUrgentOp(NrfPayloadConfig_t payldConfig, void *rxPtr, void *txPtr, uint8_t txSize)
 {
-    /* Start transmission */
-    PIO_ClearPin(isrPayldConfig.pinConfig.cePin);  // Clear if not cleared yet
+    return OpSend(payldConfig, rxPtr, txPtr, txSize, NRF_TX_CLASS_URGENT);
+}
+
+
+/*
+ *  Reads send queue counters of a single transmit class
+ */
+extern bool NRF_ReadTxClassStats(NrfTxClass_t txClass, NrfTxClassStats_t *stats)
+{
+    if( (txClass >= NRF_TX_CLASS_COUNT) || (stats == NULL) )
+    {
+        return false;
+    }
+    
+    /* Counters are updated from ISRs as well */
+    uint32_t intStatus = __builtin_disable_interrupts();
+    stats->queued = txClassStats[txClass].queued;
+    stats->started = txClassStats[txClass].started;
+    stats->preempted = txClassStats[txClass].preempted;
+    stats->delayMax = txClassStats[txClass].delayMax;
+    stats->delayMean = (txClassStats[txClass].started != 0) ?
+                       (uint32_t)(txClassStats[txClass].delaySum / txClassStats[txClass].started) : 0;
+    __builtin_mtc0(12, 0, intStatus);
+    
+    return true;
+}
+
+
+/*
+ *  Resets send queue counters of all transmit classes
+ */
+extern void NRF_ResetTxClassStats(void)
+{
+    uint32_t intStatus = __builtin_disable_interrupts();
+    memset((void *)txClassStats, 0, sizeof(txClassStats));
+    __builtin_mtc0(12, 0, intStatus);
+}
+
+
+/*
+ *  Reads status of the latest nRF operation
+ */
+extern NrfStatusFlag_t NRF_ReadStatus(void)
+{
+    NrfStatusFlag_t tempFlag = statusFlag;
+    
+    /* Status valid after ISR done */
+    if( (icSfr->ICxIEC0.W & NRF_INTxIE_MASK) && (icSfr->ICxIFS0.W & NRF_INTxIF_MASK) )
+    {
+        return NRF_FLAG_NO_STATUS;
+    }
+    else
+    {    
+        statusFlag = NRF_FLAG_NO_STATUS;    // Reset after new status update
+        return tempFlag;
+    }
+}
+
+
+/*
+ *  Flushes the RX FIFO (intended for PRX use)
+ */
+extern void NRF_FlushRxFifo(NrfPayloadConfig_t payldConfig)
+{
+    /* Flush TX FIFO */
+    txData[0] = NRF_FLUSH_TX_CMD;
+    SpiReadWrite(payldConfig.spiSfr, rxData, txData, 1);
+}
+
+
+/*
+ *  Checks if ACK payload is being loaded in the RX FIFO
+ */
+extern bool NRF_IsRxFifoLoading(void)
+{
+    return isRxFifoLoading;
+}
+
+
+/*
+ *  Reads pipe address of the latest reception
+ */
+extern uint64_t NRF_ReadPrxPipeAddr(void)
+{
+    NrfRxPipeNo_t tempNo = rxPipeNo;
+    
+    rxPipeNo = NRF_RX_NO_PIPE;      // Reset pipe state (number)
+    
+    /* Data in valid pipe number */
+    if( tempNo != NRF_RX_NO_PIPE)
+    {
+        return rxPipeAddr[tempNo];
+    }
+    /* Data haven't arrived yet */
+    else
+    {
+        return 0;
+    }
+}
+
+
+/*
+ *  Configures a second radio (own SPI module and pins) as PTX towards "txAddr"
+ *  with the same register values as NRF_ConfigPtxSfr(), but without ACK
+ *  payloads and with IRQ raised by TX events only. Its transactions bypass
+ *  the driver state (benchmark, trace, capture), so they may run from an ISR
+ *  of any priority
+ */
+extern bool NRF_RadioConfigPtx(NrfRadio_t *radio, const NrfPtxConfig_t ptxConfig, const uint64_t txAddr)
+{
+    uint8_t reg[10];
+    
+    radio->spiSfr = ptxConfig.spiSfr;
+    radio->pinConfig = ptxConfig.pinConfig;
+    
+    /* IRQ pin as non-GPIO, controlled by Interrupt Controller */
+    PIO_ConfigPpsSfr(radio->pinConfig.irqPin);
+    
+    /* Configure PIO settings for CE and IRQ pins (CS configured by SPI) */
+    PIO_ConfigGpioPin(radio->pinConfig.cePin, PIO_TYPE_DIGITAL, PIO_DIR_OUTPUT);
+    PIO_ConfigPpsPin(radio->pinConfig.irqPin, PIO_TYPE_DIGITAL);
+    PIO_ConfigGpioPinPull(radio->pinConfig.irqPin, PIO_CN_PULLUP);
+    PIO_ClearPin(radio->pinConfig.cePin);
+    
+    /* Radio has its own SPI module, its slave stays selected */
+    SPI_EnableSsState(radio->pinConfig.csPin);
+    
+    /* Device not responding or SPI not configured */
+    uint8_t config = RadioRegRead(radio, NRF_CONFIG_REG);
+    if( radio->rxData[0] == NRF_FLAG_NO_RP )
+    {
+        return false;
+    }
+    
+    ConfigPtxRegs(ptxConfig, reg);
+    reg[REG_IDX_CONFIG] |= NRF_MASK_RX_DR_MASK;
+    reg[REG_IDX_FEATURE] = NRF_EN_DPL_MASK;
+    
+    NRF_RadioFlushTx(radio);
+    radio->txData[0] = NRF_FLUSH_RX_CMD;
+    SPI_MasterReadWrite(radio->spiSfr, radio->rxData, radio->txData, 1);
+    
+    for(uint8_t i = 0; i < 10; i++)
+    {
+        RadioRegWrite(radio, configRegMap[i], reg[i]);
+    }
+    RadioAddrWrite(radio, NRF_TX_ADDR_REG, txAddr);
+    RadioAddrWrite(radio, NRF_RX_ADDR_P0_REG, txAddr);     // ACKs are received on PIPE_0
+    
+    /* Oscillator settles after power-up (warm restart leaves it running) */
+    if( !(config & NRF_PWR_UP_MASK) )
+    {
+        TMR_DelayUs(1500);
+    }
+    
+    return true;
+}
+
+
+/*
+ *  Clears "flagMask" flags of second radio, returns STATUS read before
+ *  clearing (IRQ pin is released once all raised flags are cleared)
+ */
+extern uint8_t NRF_RadioClearFlags(NrfRadio_t *radio, uint8_t flagMask)
+{
+    RadioRegWrite(radio, NRF_STATUS_REG, flagMask);
+    
+    return radio->rxData[0];
+}
+
+
+/*
+ *  Returns true if TX FIFO of second radio is empty
+ */
+extern bool NRF_RadioIsTxFifoEmpty(NrfRadio_t *radio)
+{
+    return (RadioRegRead(radio, NRF_FIFO_STATUS_REG) & NRF_TX_FIFO_EMPTY_MASK) != 0;
+}
+
+
+/*
+ *  Loads payload into TX FIFO of second radio, "frame[0]" is reserved for the
+ *  command and the payload of "length" bytes follows it, so the whole
+ *  transaction is clocked out in one transfer
+ */
+extern void NRF_RadioWriteTx(NrfRadio_t *radio, uint8_t *frame, uint8_t length)
+{
+    frame[0] = NRF_WRITE_TX_PL_CMD;
+    SPI_MasterReadWrite(radio->spiSfr, NULL, frame, length + 1);
+}
+
+
+/*
+ *  Discards payloads in TX FIFO of second radio
+ */
+extern void NRF_RadioFlushTx(NrfRadio_t *radio)
+{
+    radio->txData[0] = NRF_FLUSH_TX_CMD;
+    SPI_MasterReadWrite(radio->spiSfr, radio->rxData, radio->txData, 1);
+}
+
+
+/*
+ *  Drives CE of second radio, with CE high a PTX stays in Standby-II and
+ *  sends each payload as soon as it is loaded
+ */
+extern void NRF_RadioSetCe(NrfRadio_t *radio, bool isHigh)
+{
+    if( isHigh )
+    {
+        PIO_SetPin(radio->pinConfig.cePin);
+    }
+    else
+    {
+        PIO_ClearPin(radio->pinConfig.cePin);
+    }
+}
+
+
+#if NRF_BENCH_ENABLE
+
+/*
+ *  Reads accumulated cost counters of a single API path
+ */
+extern bool NRF_ReadBenchStats(NrfBenchPath_t path, NrfBenchStats_t *stats)
+{
+    if( (path >= NRF_BENCH_PATH_COUNT) || (stats == NULL) )
+    {
+        return false;
+    }
+    
+    /* Counters are updated from ISRs as well */
+    uint32_t intStatus = __builtin_disable_interrupts();
+    stats->calls = benchStats[path].calls;
+    stats->spiTransactions = benchStats[path].spiTransactions;
+    stats->spiBytes = benchStats[path].spiBytes;
+    stats->copyIterations = benchStats[path].copyIterations;
+    stats->coreTicks = benchStats[path].coreTicks;
+    __builtin_mtc0(12, 0, intStatus);
+    
+    return true;
+}
+
+
+/*
+ *  Resets cost counters of all API paths
+ */
+extern void NRF_ResetBenchStats(void)
+{
+    uint32_t intStatus = __builtin_disable_interrupts();
+    for(uint8_t i = 0; i < NRF_BENCH_PATH_COUNT; i++)
+    {
+        benchStats[i].calls = 0;
+        benchStats[i].spiTransactions = 0;
+        benchStats[i].spiBytes = 0;
+        benchStats[i].copyIterations = 0;
+        benchStats[i].coreTicks = 0;
+    }
+    __builtin_mtc0(12, 0, intStatus);
+}
+
+#endif
+
+
+#if NRF_TRACE_ENABLE
+
+/*
+ *  Moves up to "maxCount" oldest trace records into "bufPtr" and returns the
+ *  number of records moved (records lost to ring overrun are skipped)
+ */
+extern uint32_t NRF_ReadTrace(NrfTraceRecord_t *bufPtr, uint32_t maxCount)
+{
+    uint32_t count = 0;
+    
+    while( count < maxCount )
+    {
+        uint32_t intStatus = __builtin_disable_interrupts();
+        
+        /* Skip records overwritten since last read */
+        if( (traceHead - traceTail) > NRF_TRACE_DEPTH )
+        {
+            traceTail = traceHead - NRF_TRACE_DEPTH;
+        }
+        
+        /* Ring is empty */
+        if( traceTail == traceHead )
+        {
+            __builtin_mtc0(12, 0, intStatus);
+            break;
+        }
+        
+        bufPtr[count++] = traceRing[traceTail++ & (NRF_TRACE_DEPTH - 1)];
+        __builtin_mtc0(12, 0, intStatus);
+    }
+    
+    return count;
+}
+
+
+/*
+ *  Discards all trace records
+ */
+extern void NRF_ClearTrace(void)
+{
+    uint32_t intStatus = __builtin_disable_interrupts();
+    traceTail = traceHead;
+    __builtin_mtc0(12, 0, intStatus);
+}
+
+#endif
+
+
+#if NRF_ISR_PROFILE_ENABLE
+
+/*
+ *  Raises the INTx flag in software and lets ISR_Nrf() measure the delay until
+ *  it is serviced, i.e. the latency a real IRQ edge would see at this moment
+ */
+extern bool NRF_ProbeIsrLatency(void)
+{
+    uint32_t intStatus = __builtin_disable_interrupts();
+    
+    /* Previous probe or real nRF event still pending */
+    if( isProbePending || (icSfr->ICxIFS0.W & NRF_INTxIF_MASK) )
+    {
+        __builtin_mtc0(12, 0, intStatus);
+        return false;
+    }
+    
+    isProbeIecSet = (icSfr->ICxIEC0.W & NRF_INTxIE_MASK) ? true : false;
+    isProbePending = true;
+    probeStamp = _CP0_GET_COUNT();
+    icSfr->ICxIFS0.SET = NRF_INTxIF_MASK;
+    icSfr->ICxIEC0.SET = NRF_INTxIE_MASK;
+    
+    __builtin_mtc0(12, 0, intStatus);
+    
+    return true;
+}
+
+
+/*
+ *  Reads latency or execution time statistics
+ */
+extern bool NRF_ReadIsrProfile(NrfProfileSel_t sel, NrfIsrProfile_t *profile)
+{
+    if( (sel >= NRF_PROFILE_COUNT) || (profile == NULL) )
+    {
+        return false;
+    }
+    
+    uint32_t intStatus = __builtin_disable_interrupts();
+    profile->count = isrProfile[sel].count;
+    profile->min = isrProfile[sel].min;
+    profile->max = isrProfile[sel].max;
+    profile->mean = isrProfile[sel].count ? (uint32_t)(isrProfile[sel].sum / isrProfile[sel].count) : 0;
+    for(uint8_t i = 0; i < NRF_PROFILE_BINS; i++)
+    {
+        profile->histogram[i] = isrProfile[sel].histogram[i];
+    }
+    __builtin_mtc0(12, 0, intStatus);
+    
+    return true;
+}
+
+
+/*
+ *  Resets all latency and execution time statistics
+ */
+extern void NRF_ResetIsrProfile(void)
+{
+    uint32_t intStatus = __builtin_disable_interrupts();
+    for(uint8_t i = 0; i < NRF_PROFILE_COUNT; i++)
+    {
+        isrProfile[i].count = 0;
+        isrProfile[i].min = 0;
+        isrProfile[i].max = 0;
+        isrProfile[i].sum = 0;
+        for(uint8_t j = 0; j < NRF_PROFILE_BINS; j++)
+        {
+            isrProfile[i].histogram[j] = 0;
+        }
+    }
+    __builtin_mtc0(12, 0, intStatus);
+}
+
+#endif
+
+#if NRF_SCK_CALIBRATION_ENABLE
+
+/*
+ *  Returns SCK frequency chosen by calibration (0 if not configured yet)
+ */
+extern uint32_t NRF_ReadSckFreq(void)
+{
+    if( sckSpiSfr == NULL )
+    {
+        return 0;
+    }
+    
+    return OSC_GetPbFreq() / (2 * (sckSpiSfr->SPIxBRG.W + 1));
+}
+
+
+/*
+ *  Re-checks SCK with test patterns and backs off one step on failure. The
+ *  driver doesn't schedule it, the application calls it periodically while no
+ *  operation is in progress
+ */
+extern bool NRF_CheckSckFreq(void)
+{
+    if( sckSpiSfr == NULL )
+    {
+        return false;
+    }
+    
+    uint32_t brg = sckSpiSfr->SPIxBRG.W;
+    
+    SPI_EnableSsState(sckCsPin);
+    bool isPassed = SckPatternTest(sckSpiSfr, brg);
+    
+    /* Never slower than user configured SCK */
+    if( !isPassed && (brg < sckBrgLimit) )
+    {
+        SpiSetBrg(sckSpiSfr, brg + 1);
+    }
+    SPI_DisableSsState(sckCsPin);
+    
+    return isPassed;
+}
+
+#endif
+
+
+#if NRF_EVENT_ENABLE
+
+/*
+ *  Sets deferred handler (and its context) for a certain type of event,
+ *  returns false for an unknown type
+ */
+extern bool NRF_SetEventHandler(NrfUserCallback_t cType, NrfEventHandler_t handler, void *context)
+{
+    if( (uint32_t)cType > NRF_CLBK_CONFIG_DONE )
+    {
+        return false;
+    }
+    
+    uint32_t intStatus = __builtin_disable_interrupts();
+    eventHandler[cType] = handler;
+    eventContext[cType] = context;
+    __builtin_mtc0(12, 0, intStatus);
+    
+    EventSwiEnable();
+    
+    return true;
+}
+
+
+/*
+ *  Dispatches queued events to their handlers, returns number of events
+ *  dispatched (call from main loop if not dispatched by software interrupt)
+ */
+extern uint32_t NRF_ProcessEvents(void)
+{
+    uint32_t count = 0;
+    NrfEvent_t event;
+    
+    while( 1 )
+    {
+        uint32_t intStatus = __builtin_disable_interrupts();
+        if( eventTail == eventHead )
+        {
+            __builtin_mtc0(12, 0, intStatus);
+            break;
+        }
+        event = eventRing[eventTail & (NRF_EVENT_DEPTH - 1)];
+        eventTail++;
+        NrfEventHandler_t handler = eventHandler[event.kind];
+        void *context = eventContext[event.kind];
+        __builtin_mtc0(12, 0, intStatus);
+        
+        /* Handler executes with interrupts enabled */
+        if( handler != NULL )
+        {
+            handler(&event, context);
+        }
+        count++;
+    }
+    
+    /* Deferred user callbacks, once per recorded call */
+    for(uint8_t kind = 0; kind <= NRF_CLBK_CONFIG_DONE; kind++)
+    {
+        while( clbkPending[kind] != 0 )
+        {
+            uint32_t intStatus = __builtin_disable_interrupts();
+            clbkPending[kind]--;
+            void (*clbkPtr)(void) = EventUserCallback(kind);
+            __builtin_mtc0(12, 0, intStatus);
+            
+            if( clbkPtr != NULL )
+            {
+                clbkPtr();
+            }
+            count++;
+        }
+    }
+    
+    return count;
+}
+
+
+/*
+ *  Returns number of events dropped on full queue
+ */
+extern uint32_t NRF_ReadDroppedEvents(void)
+{
+    return eventDropped;
+}
+
+#endif
+
+
+#if NRF_DEDUP_ENABLE
+
+/*
+ *  Reads duplicate filter counters
+ */
+extern void NRF_ReadDedupStats(NrfDedupStats_t *stats)
+{
+    uint32_t intStatus = __builtin_disable_interrupts();
+    *stats = dedupStats;
+    __builtin_mtc0(12, 0, intStatus);
+}
+
+
+/*
+ *  Forgets all sources and resets counters (e.g. after pipe addresses were
+ *  reassigned to other senders)
+ */
+extern void NRF_ResetDedup(void)
+{
+    uint32_t intStatus = __builtin_disable_interrupts();
+    memset(dedupTable, 0, sizeof(dedupTable));
+    memset((void *)&dedupStats, 0, sizeof(dedupStats));
+    __builtin_mtc0(12, 0, intStatus);
+}
+
+#endif
+
+
+#if NRF_LBT_ENABLE
+
+/*
+ *  Reads listen-before-talk counters
+ */
+extern void NRF_ReadLbtStats(NrfLbtStats_t *stats)
+{
+    uint32_t intStatus = __builtin_disable_interrupts();
+    *stats = lbtStats;
+    __builtin_mtc0(12, 0, intStatus);
+}
+
+
+/*
+ *  Resets listen-before-talk counters
+ */
+extern void NRF_ResetLbtStats(void)
+{
+    uint32_t intStatus = __builtin_disable_interrupts();
+    memset((void *)&lbtStats, 0, sizeof(lbtStats));
+    __builtin_mtc0(12, 0, intStatus);
+}
+
+#endif
+
+
+#if NRF_RETRY_ENABLE
+
+/*
+ *  Reads software retransmission counters
+ */
+extern void NRF_ReadRetryStats(NrfRetryStats_t *stats)
+{
+    uint32_t intStatus = __builtin_disable_interrupts();
+    *stats = retryStats;
+    __builtin_mtc0(12, 0, intStatus);
+}
+
+
+/*
+ *  Resets software retransmission counters
+ */
+extern void NRF_ResetRetryStats(void)
+{
+    uint32_t intStatus = __builtin_disable_interrupts();
+    memset((void *)&retryStats, 0, sizeof(retryStats));
+    __builtin_mtc0(12, 0, intStatus);
+}
+
+#endif
+
+
+#if NRF_HEALTH_ENABLE
+
+/*
+ *  Compares key registers (CONFIG, RF_CH, SETUP_AW and PIPE_0 address) with
+ *  configured values and rewrites those that differ after a brown-out or reset
+ *  of device, call periodically from main loop
+ */
+extern NrfHealthResult_t NRF_CheckHealth(void)
+{
+    SpiSfr_t *spiSfr = configState.spiSfr;
+    
+    /* Interrupt-driven operations must not interleave with check, so INTx and
+     * core timer sources are masked (other interrupts keep running) */
+    uint32_t iecMask = icSfr->ICxIEC0.W & (NRF_INTxIE_MASK | IC_CTIE_MASK);
+    icSfr->ICxIEC0.CLR = iecMask;
+    
+    /* Registers are not settled (or changed for listen-before-talk or an added
+     * retransmission round) or SPI is taken by a split transaction */
+    if( !isConfigDone || (configStep != CONFIG_STEP_IDLE) || splitCmd ||
+        LBT_IS_PENDING() || RETRY_IS_ACTIVE() || (icSfr->ICxIFS0.W & NRF_INTxIF_MASK) )
+    {
+        icSfr->ICxIEC0.SET = iecMask;
+        return NRF_HEALTH_BUSY;
+    }
+    
+    healthStats.checks++;
+    SPI_EnableSsState(configState.pinConfig.csPin);
+    
+    if( HealthIsIntact(spiSfr) )
+    {
+        /* Idle PTX leaves slave disabled, reception and sends keep it */
+        if( configState.isPtx && !isTimeoutEnabled )
+        {
+            SPI_DisableSsState(configState.pinConfig.csPin);
+        }
+        icSfr->ICxIEC0.SET = iecMask;
+        return NRF_HEALTH_OK;
+    }
+    
+    uint32_t recoveryStart = _CP0_GET_COUNT();
+    healthStats.detections++;
+    
+    /* Device in power down lost its configuration too */
+    txData[0] = NRF_READ_CMD(NRF_CONFIG_REG);
+    txData[1] = 0x00;
+    SpiReadWrite(spiSfr, rxData, txData, 2);
+    bool isPoweredDown = !(rxData[1] & NRF_PWR_UP_MASK);
+    
+    healthStats.restoredRegs += HealthRestore(spiSfr);
+    
+    /* Registers still differ, device is not responding */
+    if( !HealthIsIntact(spiSfr) )
+    {
+        healthStats.unresponsive++;
+        icSfr->ICxIEC0.SET = iecMask;
+        return NRF_HEALTH_NO_RP;
+    }
+    
+    icSfr->ICxIEC0.SET = iecMask;
+    
+    /* Oscillator settles with interrupts running (1.5 ms) */
+    if( isPoweredDown )
+    {
+        TMR_DelayUs(1500);
+    }
+    
+    /* Payload in flight was lost with TX FIFO, next tick concludes it as
+     * unresponsive and moves on to queued operations (reception resumes by
+     * itself as CE is still high) */
+    uint32_t intStatus = __builtin_disable_interrupts();
+    if( isTimeoutEnabled )
+    {
+        timeoutCount = timeoutVal;
+    }
+    else if( configState.isPtx )
+    {
+        SPI_DisableSsState(configState.pinConfig.csPin);
+    }
+    
+    uint32_t recovery = _CP0_GET_COUNT() - recoveryStart;
+    healthStats.recoveryLast = recovery;
+    if( recovery > healthStats.recoveryMax )
+    {
+        healthStats.recoveryMax = recovery;
+    }
+    __builtin_mtc0(12, 0, intStatus);
+    
+    return NRF_HEALTH_RESTORED;
+}
+
+
+/*
+ *  Reads health check counters
+ */
+extern void NRF_ReadHealthStats(NrfHealthStats_t *stats)
+{
+    uint32_t intStatus = __builtin_disable_interrupts();
+    *stats = healthStats;
+    __builtin_mtc0(12, 0, intStatus);
+}
+
+
+/*
+ *  Resets health check counters
+ */
+extern void NRF_ResetHealthStats(void)
+{
+    uint32_t intStatus = __builtin_disable_interrupts();
+    memset((void *)&healthStats, 0, sizeof(healthStats));
+    __builtin_mtc0(12, 0, intStatus);
+}
+
+#endif
+
+
+#if NRF_SCATTER_ENABLE
+
+/*
+ *  Queues payloads for several destinations as one send operation, which
+ *  completes once all "items" have concluded (array must stay valid until
+ *  then). Result holds delivered count as length and summed retransmissions
+ */
+extern NrfOpHandle_t NRF_SendScatterOp(NrfPayloadConfig_t payldConfig, NrfScatterItem_t *items, uint8_t count)
+{
+    if( (count == 0) || (count > NRF_SCATTER_MAX_ITEMS) || (configStep != CONFIG_STEP_IDLE) )
+    {
+        return NRF_OP_INVALID;
+    }
+    
+    uint8_t idx = OpAlloc();
+    
+    /* Pool exhausted */
+    if( idx == OP_NONE )
+    {
+        return NRF_OP_INVALID;
+    }
+    
+    opPool[idx].payldConfig = payldConfig;
+    opPool[idx].rxPtr = NULL;
+    opPool[idx].txPtr = items;
+    opPool[idx].txSize = count;
+    opPool[idx].isScatter = true;
+    
+    /* Queued behind single bulk sends like any other */
+    OpEnqueue(idx, NRF_TX_CLASS_BULK);
+    
+    NrfOpHandle_t opHandle = OpHandle(idx);
+    OpTxStart();
+    
+    return opHandle;
+}
+
+#endif
+
+
+#if NRF_CAPTURE_ENABLE
+
+/*
+ *  Moves up to "maxSize" oldest capture stream bytes into "bufPtr" and returns
+ *  the number of bytes moved (reading in pieces yields the same stream)
+ */
+extern uint32_t NRF_ReadCapture(uint8_t *bufPtr, uint32_t maxSize)
+{
+    /* Single reader, writers only advance head past complete records */
+    uint32_t head = captureHead;
+    uint32_t count = 0;
+    
+    while( (count < maxSize) && (captureTail != head) )
+    {
+        bufPtr[count++] = captureRing[captureTail & (NRF_CAPTURE_SIZE - 1)];
+        captureTail++;
+    }
+    
+    return count;
+}
+
+
+/*
+ *  Discards captured bytes and starts a new stream (with header)
+ */
+extern void NRF_ClearCapture(void)
+{
+    uint32_t intStatus = __builtin_disable_interrupts();
+    CaptureBegin();
+    __builtin_mtc0(12, 0, intStatus);
+}
+
+
+/*
+ *  Returns number of records lost on full capture ring since power-up
+ */
+extern uint32_t NRF_ReadCaptureLost(void)
+{
+    return captureLostTotal;
+}
+
+#endif
+
+
+#if NRF_REPLAY_ENABLE
+
+/*
+ *  Starts replay of a capture stream, returns false if stream header doesn't
+ *  match this build (the stream must stay in place until replay ends)
+ */
+extern bool NRF_ReplayLoad(const uint8_t *streamPtr, uint32_t size)
+{
+    if( (size < CAPTURE_HEADER_SIZE) || (streamPtr[0] != NRF_CAPTURE_START) ||
+        (streamPtr[1] != NRF_CAPTURE_VERSION) || (streamPtr[6] != NRF_SPI_BURST_WIDTH) )
+    {
+        return false;
+    }
+    
+    replayPtr = &streamPtr[CAPTURE_HEADER_SIZE];
+    replayEnd = &streamPtr[size];
+    replayAsyncClbkPtr = NULL;
+    
+    memset(&replayStats, 0, sizeof(replayStats));
+    replayStats.firstMismatch = UINT32_MAX;
+    replayStamp = _CP0_GET_COUNT();
+    
+    return true;
+}
+
+
+/*
+ *  Delivers the next recorded IRQ edge, SPI completion or core timer tick to
+ *  the driver. Returns NRF_REPLAY_WAIT if the next record is a transaction the
+ *  application starts through the driver API (make that call, then step again)
+ */
+extern NrfReplayResult_t NRF_ReplayStep(void)
+{
+    ReplayRecord_t rec;
+    
+    if( !ReplayParse(&rec) )
+    {
+        return NRF_REPLAY_END;
+    }
+    
+    if( (rec.type == NRF_CAPTURE_SPI) || (rec.type == NRF_CAPTURE_SPI_TX) || (rec.type == NRF_CAPTURE_SPI_ASYNC) )
+    {
+        return NRF_REPLAY_WAIT;
+    }
+    
+    /* Record is consumed before the driver runs into the following ones */
+    replayPtr = rec.nextPtr;
+    replayStats.records++;
+    replayStamp = _CP0_GET_COUNT();
+    
+    if( rec.type == NRF_CAPTURE_IRQ )
+    {
+        icSfr->ICxIFS0.SET = NRF_INTxIF_MASK;
+    }
+    else if( rec.type == NRF_CAPTURE_TICK )
+    {
+        if( rec.length == NRF_CAPTURE_TICK_CONFIG )
+        {
+            ISR_NrfTimeoutHandler_Config();
+        }
+        else
+        {
+            ISR_NrfTimeoutHandler_SendPayload();
+        }
+    }
+    else if( rec.type == NRF_CAPTURE_SPI_DONE )
+    {
+        void (*clbkPtr)(void) = replayAsyncClbkPtr;
+        
+        if( clbkPtr == NULL )
+        {
+            ReplayMismatch();
+        }
+        else
+        {
+            /* Recorded MISO may be shorter only if it was discarded */
+            for(uint8_t i = 0; (i < rec.length) && (i < replayAsyncSize) && (replayAsyncRxPtr != NULL); i++)
+            {
+                replayAsyncRxPtr[i] = rec.misoPtr[i];
+            }
+            
+            replayAsyncClbkPtr = NULL;
+            clbkPtr();
+        }
+    }
+    else
+    {
+        replayStats.gaps++;
+    }
+    
+    return NRF_REPLAY_STEP;
+}
+
+
+/*
+ *  Reads replay results (mismatches and timing)
+ */
+extern void NRF_ReadReplayStats(NrfReplayStats_t *stats)
+{
+    *stats = replayStats;
+}
+
+#endif
+
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+/*
+ *  Configures pins and powers-up the device (skipped if already powered-up, in
+ *  which case no oscillator settle time is needed)
+ */
+static bool ConfigBegin(SpiSfr_t *spiSfr, NrfPinConfig_t pinConfig)
+{
+    isConfigDone = false;
+    configStep = CONFIG_STEP_IDLE;
+    configState.spiSfr = spiSfr;
+    configState.pinConfig = pinConfig;
+    
+    /* IRQ pin as non-GPIO, controlled by Interrupt Controller */
+    PIO_ConfigPpsSfr(pinConfig.irqPin);
+    
+    /* Configure PIO settings for CE and IRQ pins (CS configured by SPI) */
+    PIO_ConfigGpioPin(pinConfig.cePin, PIO_TYPE_DIGITAL, PIO_DIR_OUTPUT);
+    PIO_ConfigPpsPin(pinConfig.irqPin, PIO_TYPE_DIGITAL);
+    PIO_ConfigGpioPinPull(pinConfig.irqPin, PIO_CN_PULLUP);
+    PIO_ClearPin(pinConfig.cePin);
+    
+    /* CS pin is driven as GPIO during payload transfers (see SpiCommandBegin()) */
+    PIO_ConfigGpioPin(pinConfig.csPin, PIO_TYPE_DIGITAL, PIO_DIR_OUTPUT);
+    PIO_SetPin(pinConfig.csPin);
+    
+    /* Enable current slave */
+    SPI_EnableSsState(pinConfig.csPin);
+    
+    /* Read CONFIG register (warm restart leaves device powered-up) */
+    txData[0] = NRF_READ_CMD(NRF_CONFIG_REG);
+    txData[1] = 0x00;
+    SpiReadWrite(spiSfr, rxData, txData, 2);
+    
+    /* Device not responding or SPI not configured */
+    if( rxData[0] == NRF_FLAG_NO_RP )
+    {
+        return false;
+    }
+    
+    /* SYS_CLK is read for timeout and settle time purpose */
+    sysFreq = OSC_GetSysFreq();
+    
+    /* Power-up the device */
+    configState.isSettling = !(rxData[1] & NRF_PWR_UP_MASK);
+    if( configState.isSettling )
+    {
+        txData[0] = NRF_WRITE_CMD(NRF_CONFIG_REG);
+        txData[1] = NRF_PWR_UP_MASK;
+        SpiReadWrite(spiSfr, rxData, txData, 2);
+        
+        configState.powerUpStamp = _CP0_GET_COUNT();
+    }
+    
+#if NRF_ISR_PROFILE_ENABLE
+    irqPin = pinConfig.irqPin;
+#endif
+    
+    return true;
+}
+
+
+/*
+ *  Fills PTX register values in "configRegMap" order
+ */
+static void ConfigPtxRegs(const NrfPtxConfig_t ptxConfig, uint8_t *regPtr)
+{
+    RegConfig_t regConfig = {
+        .STATUS =       (NRF_MAX_RT_MASK | NRF_TX_DS_MASK | NRF_RX_DR_MASK),
+        .CONFIG =       (NRF_PWR_UP_MASK | NRF_CRCO_MASK | NRF_EN_CRC_MASK),
+        .SETUP_AW =     (NRF_AW_MASK),
+        .SETUP_RETR =   ((ptxConfig.retrCount << NRF_ARC_POS) |
+                        (ptxConfig.retrDelay << NRF_ARD_POS)),
+        .RF_CH =        (ptxConfig.rfChannel << NRF_RF_CH_POS),
+        .RF_SETUP =     ((ptxConfig.rfPower << NRF_RF_PWR_POS) |
+                        ((ptxConfig.dataRate & 0x1) << NRF_RF_DR_HIGH_POS) |
+                        ((ptxConfig.dataRate & 0x2) << NRF_RF_DR_LOW_POS)),
+        .FEATURE =      ((ptxConfig.isAck << NRF_EN_ACK_PAY_POS) | NRF_EN_DPL_MASK),
+        .EN_AA =        (ptxConfig.isAck ? 0x01 : 0x00),
+        .EN_RXADDR =    (0x01),
+        .DYNPD =        (0x01),
+    };
+    
+    memcpy(regPtr, (const void *)&regConfig, sizeof(configState.reg));
+}
+
+
+/*
+ *  Stores PTX register configuration
+ */
+static void ConfigPtxState(const NrfPtxConfig_t ptxConfig)
+{
+    /* Store nRF register configuration settings */
+    ConfigPtxRegs(ptxConfig, configState.reg);
+    configState.pipeStatus = 0x00;      // PIPE_0 address is set per payload
+    configState.isPtx = true;
+}
+
+
+/*
+ *  Stores PRX register and PIPE_x address configuration
+ */
+static bool ConfigPrxState(const NrfPrxConfig_t prxConfig)
+{
+    /* Individual bits reflect whether PIPE_x is enabled or not */
+    uint8_t pipeStatus = ( ((bool)prxConfig.pipeAddr.pipe0 << 0) |
+                           ((bool)prxConfig.pipeAddr.pipe1 << 1) |
+                           ((bool)prxConfig.pipeAddr.pipe2 << 2) |
+                           ((bool)prxConfig.pipeAddr.pipe3 << 3) |
+                           ((bool)prxConfig.pipeAddr.pipe4 << 4) |
+                           ((bool)prxConfig.pipeAddr.pipe5 << 5) );
+    
+    /* No PIPE_x address check */
+    if( pipeStatus == 0x00 )
+    {
+        return false;
+    }
+    
+    /* Store nRF register configuration settings */
+    RegConfig_t regConfig = {
+        .STATUS =       (NRF_MAX_RT_MASK | NRF_TX_DS_MASK | NRF_RX_DR_MASK),
+        .CONFIG =       (NRF_PWR_UP_MASK | NRF_PRIM_RX_MASK | NRF_CRCO_MASK | NRF_EN_CRC_MASK),
+        .SETUP_AW =     (NRF_AW_MASK),
+        .SETUP_RETR =   (0x00),
+        .RF_CH =        (prxConfig.rfChannel << NRF_RF_CH_POS),
+        .RF_SETUP =     (((prxConfig.dataRate & 0x1) << NRF_RF_DR_HIGH_POS) |
+                        ((prxConfig.dataRate & 0x2) << NRF_RF_DR_LOW_POS)),
+        .FEATURE =      ((prxConfig.isAck << NRF_EN_ACK_PAY_POS) | NRF_EN_DPL_MASK),
+        .EN_AA =        (prxConfig.isAck ? (pipeStatus & 0x3F) : 0x00),
+        .EN_RXADDR =    (pipeStatus & 0x3F),
+        .DYNPD =        (pipeStatus & 0x3F),
+    };
+    
+    memcpy(configState.reg, (const void *)&regConfig, sizeof(configState.reg));
+    
+    /* Pointer for indirect member access of structure */
+    const uint64_t *addrPtr = &prxConfig.pipeAddr.pipe0;
+    for(uint8_t i = 0; i < 6; i++, addrPtr++)
+    {
+        configState.pipeAddr[i] = *addrPtr;
+    }
+    configState.pipeStatus = pipeStatus;
+    configState.isPtx = false;
+    
+    return true;
+}
+
+
+/*
+ *  Flushes FIFOs and writes stored configuration, skipping registers which
+ *  already hold the required value
+ */
+static void ConfigApply(void)
+{
+    SpiSfr_t *spiSfr = configState.spiSfr;
+    
+    /* Flush TX + RX FIFO */
+    txData[0] = NRF_FLUSH_RX_CMD;
+    SpiReadWrite(spiSfr, rxData, txData, 1);
+    txData[0] = NRF_FLUSH_TX_CMD;
+    SpiReadWrite(spiSfr, rxData, txData, 1);
+    
+    /* Modify configuration registers */
+    ConfigWriteRegs(spiSfr, 0);
+    
+    uint64_t txData64 = 0;
+    uint64_t rxData64 = 0;
+    
+    /* Modify PIPE_x addresses */
+    for(uint8_t i = 0; i < 6; i++)
+    {
+        /* Non-zero address is valid */
+        if( (configState.pipeStatus >> i) & 0x01 )
+        {
+            /* 5-byte address for first two pipes, 1-byte for other pipes */
+            uint8_t size = (i < 2) ? 6 : 2;
+            uint64_t mask = (i < 2) ? 0xFFFFFFFFFF : 0xFF;
+            
+            txData64 = NRF_READ_CMD(NRF_RX_ADDR_P0_REG + i);
+            SpiReadWrite(spiSfr, &rxData64, &txData64, size);
+            
+            txData64 = ((configState.pipeAddr[i] & mask) << 8) | (NRF_WRITE_CMD(NRF_RX_ADDR_P0_REG + i));
+            if( ((rxData64 >> 8) & mask) != (configState.pipeAddr[i] & mask) )
+            {
+                SpiReadWrite(spiSfr, &rxData64, &txData64, size);
+            }
+        }
+        
+        rxPipeAddr[i] = txData64;   // Store all addresses into local array
+    }
+    
+#if NRF_SCK_CALIBRATION_ENABLE
+    /* Raise SCK to the highest frequency the wiring tolerates (registers
+     * written above serve as known values) */
+    SckCalibrate(spiSfr, configState.pinConfig.csPin);
+#endif
+}
+
+
+/*
+ *  Returns true once oscillator settle time (1.5 ms) after power-up has passed
+ */
+static bool ConfigIsSettled(void)
+{
+    if( configState.isSettling )
+    {
+        uint32_t delay = 1500 * (sysFreq / 1000000 / 2);
+        if( (_CP0_GET_COUNT() - configState.powerUpStamp) < delay )
+        {
+            return false;
+        }
+        configState.isSettling = false;
+    }
+    
+    return true;
+}
+
+
+/*
+ *  Concludes configuration (interrupt and role specific settings)
+ */
+static void ConfigEnd(void)
+{
+    /* Set timeout callback for interrupt mode */
+    if( configState.isPtx )
+    {
+        CoreTimerSetCallback(ISR_NrfTimeoutHandler_SendPayload);
+        isTimeoutEnabled = false;
+    }
+    /* PRX has no timeout, asynchronous configuration hands core timer back */
+    else if( coreTimerClbkPtr == ISR_NrfTimeoutHandler_Config )
+    {
+        CoreTimerSetCallback(configState.prevTimerClbkPtr);
+    }
+    
+    /* Configures interrupt SFRs (based on IRQ pin's PPS register code) */
+    InterruptSfrConfig(configState.pinConfig.irqPin);
+    
+    /* Disable current slave */
+    SPI_DisableSsState(configState.pinConfig.csPin);
+    
+    isConfigDone = true;
+}
+
+
+/*
+ *  Writes stored configuration registers from "firstIdx" on, skipping those
+ *  which already hold the required value, returns number of registers written
+ */
+static uint8_t ConfigWriteRegs(SpiSfr_t *spiSfr, uint8_t firstIdx)
+{
+    uint8_t count = 0;
+    
+    for(uint8_t i = firstIdx; i < 10; i++)
+    {
+        txData[0] = NRF_READ_CMD(configRegMap[i]);
+        txData[1] = 0x00;
+        SpiReadWrite(spiSfr, rxData, txData, 2);
+        
+        /* STATUS needs a write only to clear pending flags */
+        bool isMatch = (configRegMap[i] == NRF_STATUS_REG) ?
+                       !(rxData[1] & configState.reg[i]) :
+                       (rxData[1] == configState.reg[i]);
+        if( isMatch )
+        {
+            continue;
+        }
+        
+        txData[0] = NRF_WRITE_CMD(configRegMap[i]);
+        txData[1] = configState.reg[i];
+        SpiReadWrite(spiSfr, rxData, txData, 2);
+        count++;
+    }
+    
+    return count;
+}
+
+
+INLINE static void RadioRegWrite(NrfRadio_t *radio, uint8_t reg, uint8_t value)
+{
+    radio->txData[0] = NRF_WRITE_CMD(reg);
+    radio->txData[1] = value;
+    SPI_MasterReadWrite(radio->spiSfr, radio->rxData, radio->txData, 2);
+}
+
+
+INLINE static uint8_t RadioRegRead(NrfRadio_t *radio, uint8_t reg)
+{
+    radio->txData[0] = NRF_READ_CMD(reg);
+    radio->txData[1] = 0x00;
+    SPI_MasterReadWrite(radio->spiSfr, radio->rxData, radio->txData, 2);
+    
+    return radio->rxData[1];
+}
+
+
+/*
+ *  Writes 5-byte address register of second radio (LSByte first)
+ */
+static void RadioAddrWrite(NrfRadio_t *radio, uint8_t reg, uint64_t addr)
+{
+    uint8_t addrData[6] = { NRF_WRITE_CMD(reg) };
+    
+    for(uint8_t i = 0; i < 5; i++)
+    {
+        addrData[i + 1] = (uint8_t)(addr >> (8 * i));
+    }
+    
+    SPI_MasterReadWrite(radio->spiSfr, NULL, addrData, 6);
+}
+
+
+/*
+ *  Sets core timer callback, keeping track of it for a later restore
+ */
+INLINE static void CoreTimerSetCallback(void (*clbkPtr)(void))
+{
+    coreTimerClbkPtr = clbkPtr;
+    TMR_SetCoreTimerCallback(clbkPtr);
+}
+
+
+/*
+ *  Waits out the rest of RX PLL settle time started by the latest switch to
+ *  PRX, so CE or PRIM_RX never change while PLL is settling (returns at once
+ *  when settle time has passed)
+ */
+INLINE static void SwitchSettleWait(void)
+{
+    uint32_t settleTicks = NRF_PLL_SETTLE_US * (sysFreq / 1000000 / 2);
+    
+    while( (switchSettleEnd - _CP0_GET_COUNT() - 1) < settleTicks );
+}
+
+
+/*
+ *  Writes configuration register only if new value differs from stored one
+ */
+static void RegShadowWrite(SpiSfr_t *spiSfr, uint8_t regIdx, uint8_t value)
+{
+    if( configState.reg[regIdx] != value )
+    {
+        txData[0] = NRF_WRITE_CMD(configRegMap[regIdx]);
+        txData[1] = value;
+        SpiReadWrite(spiSfr, rxData, txData, 2);
+        
+        configState.reg[regIdx] = value;
+    }
+}
+
+
+/*
+ *  Core timer handler for asynchronous configuration (executed on every tick
+ *  until oscillator has settled, registers are already written)
+ */
+static void ISR_NrfTimeoutHandler_Config(void)
+{
+    CAPTURE_TICK(NRF_CAPTURE_TICK_CONFIG, configStep != CONFIG_STEP_IDLE);
+    
+    if( (configStep == CONFIG_STEP_SETTLE) && ConfigIsSettled() )
+    {
+        configStep = CONFIG_STEP_IDLE;
+        ConfigEnd();
+        
+        /* Sends queued while configuring */
+        if( opTx == OP_NONE )
+        {
+            OpTxKick();
+        }
+        
+        EVENT(NRF_CLBK_CONFIG_DONE, NRF_RX_NO_PIPE, 0, NRF_FLAG_NO_STATUS);
+        
+        /* Call user callback */
+        USER_CLBK(NRF_CLBK_CONFIG_DONE, userClbkConfigDone);
+    }
+}
+
+
+/*
+ *  Loads TX FIFO and sends data (ISR based)
+ */
+static bool SendPayload(NrfPayloadConfig_t payldConfig, void *rxPtr, void *txPtr, uint8_t txSize)
+{
+    /* Asynchronous configuration still in progress */
+    if( configStep != CONFIG_STEP_IDLE )
+    {
+        return false;
+    }
+    
+    BENCH_CALL(NRF_BENCH_SEND_PAYLOAD);
+    BENCH_BEGIN(NRF_BENCH_SEND_PAYLOAD);
+    
+    /* Reset status */
+    statusFlag = NRF_FLAG_NO_STATUS;
+    
+    /* Enable current slave */
+    SPI_EnableSsState(payldConfig.pinConfig.csPin);
+    
+    /* Configure ISR variables */
+    isrRxPtr = rxPtr;
+    isrPayldConfig = payldConfig;
+    
+    /* Configure ISR handler */
+    IsrHandlerPtrConfig(ISR_NRF_MODE_0);
+    
+#if NRF_LBT_ENABLE
+    /* Any deferred or listening send is superseded */
+    LbtCancel(payldConfig.spiSfr, payldConfig.pinConfig.cePin);
+#endif
+    
+#if NRF_RETRY_ENABLE
+    /* ARD of a timed out payload's rounds is still programmed */
+    RetryRestore(payldConfig.spiSfr);
+#endif
+    
+    /* Flush TX + RX FIFO */
+    txData[0] = NRF_FLUSH_TX_CMD;
+    SpiReadWrite(payldConfig.spiSfr, rxData, txData, 1);
+    txData[0] = NRF_FLUSH_RX_CMD;
+    SpiReadWrite(payldConfig.spiSfr, rxData, txData, 1);
+    
+    /* Clear device status - in case of previous MAX_RT */
+    txData[0] = NRF_WRITE_CMD(NRF_STATUS_REG);
+    txData[1] = NRF_MAX_RT_MASK | NRF_TX_DS_MASK | NRF_RX_DR_MASK;
+    SpiReadWrite(payldConfig.spiSfr, rxData, txData, 2); 
+    
+    uint64_t txData64 = 0;
+    
+    /* Configure RX_PIPE_0_ADDR for ACK payload */
+    txData64 = (payldConfig.pipeAddr << 8) | NRF_WRITE_CMD(NRF_RX_ADDR_P0_REG);
+    SpiReadWrite(payldConfig.spiSfr, rxData, &txData64, 6);
+    
+    /* Configure TX_ADDR */
+    txData64 = (payldConfig.pipeAddr << 8) | NRF_WRITE_CMD(NRF_TX_ADDR_REG);
+    SpiReadWrite(payldConfig.spiSfr, rxData, &txData64, 6);
+
+    /* Send command and then data directly from user buffer, which must stay
+     * valid until transmission starts (NRF_CLBK_TX_START) */
+    txSize = (txSize > 32) ? 32 : txSize;   // Max 32 bytes per payload
+    SpiCommandBegin(payldConfig.spiSfr, payldConfig.pinConfig.csPin, NRF_WRITE_TX_PL_CMD);
+    
+    /* Start transmission after packet upload */
+    SpiPayloadAsync(payldConfig.spiSfr, NULL, txPtr, txSize, ISR_NrfHandler_StartTransmission);
+
+    BENCH_END();
+    
+    return true;
+}
+
+
+/*
+ *  Allocates free operation record (OP_NONE if pool is exhausted)
+ */
+static uint8_t OpAlloc(void)
+{
+    uint8_t idx = OP_NONE;
+    
+    uint32_t intStatus = __builtin_disable_interrupts();
+    for(uint8_t i = 0; i < NRF_OP_POOL_SIZE; i++)
+    {
+        if( opPool[i].state == OP_STATE_FREE )
+        {
+            opPool[i].state = OP_STATE_PENDING;
+            opPool[i].result.status = NRF_FLAG_NO_STATUS;
+            opPool[i].result.arc = 0;
+            opPool[i].result.length = 0;
+            opPool[i].result.pipeNo = NRF_RX_NO_PIPE;
+            opPool[i].result.timestamp = 0;
+#if NRF_SCATTER_ENABLE
+            opPool[i].isScatter = false;
+#endif
+            idx = i;
+            break;
+        }
+    }
+    __builtin_mtc0(12, 0, intStatus);
+    
+    return idx;
+}
+
+
+/*
+ *  Builds handle from record index and its generation
+ */
+INLINE static NrfOpHandle_t OpHandle(uint8_t idx)
+{
+    return ((NrfOpHandle_t)opPool[idx].generation << 8) | (idx + 1);
+}
+
+
+/*
+ *  Returns record index of a live handle (OP_NONE if invalid or released)
+ */
+static uint8_t OpLookup(NrfOpHandle_t opHandle)
+{
+    uint8_t idx = (opHandle & 0xFF) - 1;
+    
+    if( (idx >= NRF_OP_POOL_SIZE) ||
+        (opPool[idx].generation != (uint16_t)(opHandle >> 8)) ||
+        (opPool[idx].state == OP_STATE_FREE) )
+    {
+        return OP_NONE;
+    }
+    
+    return idx;
+}
+
+
+/*
+ *  Stores final result of operation
+ */
+static void OpComplete(uint8_t idx, NrfStatusFlag_t status, uint8_t arc, uint8_t length, NrfRxPipeNo_t pipeNo)
+{
+    opPool[idx].result.status = status;
+    opPool[idx].result.arc = arc;
+    opPool[idx].result.length = length;
+    opPool[idx].result.pipeNo = pipeNo;
+    opPool[idx].result.timestamp = _CP0_GET_COUNT();
+    opPool[idx].state = OP_STATE_DONE;
+}
+
+
+/*
+ *  Allocates operation record for a single send and queues it in "txClass"
+ */
+static NrfOpHandle_t OpSend(NrfPayloadConfig_t payldConfig, void *rxPtr, void *txPtr, uint8_t txSize, NrfTxClass_t txClass)
+{
+    /* Asynchronous configuration still in progress */
+    if( configStep != CONFIG_STEP_IDLE )
+    {
+        return NRF_OP_INVALID;
+    }
+    
+    uint8_t idx = OpAlloc();
+    
+    /* Pool exhausted */
+    if( idx == OP_NONE )
+    {
+        return NRF_OP_INVALID;
+    }
+    
+    /* Arguments are kept until the send is started */
+    opPool[idx].payldConfig = payldConfig;
+    opPool[idx].rxPtr = rxPtr;
+    opPool[idx].txPtr = txPtr;
+    opPool[idx].txSize = txSize;
+    
+    OpEnqueue(idx, txClass);
+    
+    NrfOpHandle_t opHandle = OpHandle(idx);
+    OpTxStart();
+    
+    return opHandle;
+}
+
+
+/*
+ *  Appends allocated send to queue of its transmit class
+ */
+static void OpEnqueue(uint8_t idx, NrfTxClass_t txClass)
+{
+    opPool[idx].txClass = txClass;
+    opPool[idx].next = OP_NONE;
+    
+    uint32_t intStatus = __builtin_disable_interrupts();
+    opPool[idx].state = OP_STATE_QUEUED;
+    opPool[idx].queueStamp = _CP0_GET_COUNT();
+    if( opQueueTail[txClass] == OP_NONE )
+    {
+        opQueueHead[txClass] = idx;
+    }
+    else
+    {
+        opPool[opQueueTail[txClass]].next = idx;
+    }
+    opQueueTail[txClass] = idx;
+    txClassStats[txClass].queued++;
+    __builtin_mtc0(12, 0, intStatus);
+}
+
+
+/*
+ *  Starts the oldest queued send of the highest class (if no send is in
+ *  progress), a suspended scatter send goes on before further bulk sends
+ */
+static void OpTxStart(void)
+{
+    uint32_t intStatus = __builtin_disable_interrupts();
+    NrfTxClass_t txClass = NRF_TX_CLASS_URGENT;
+    uint8_t idx = opQueueHead[txClass];
+    
+    if( opTx != OP_NONE )
+    {
+        __builtin_mtc0(12, 0, intStatus);
+        return;
+    }
+    
+#if NRF_SCATTER_ENABLE
+    if( (idx == OP_NONE) && (opSuspended != OP_NONE) )
+    {
+        opTx = opSuspended;
+        opSuspended = OP_NONE;
+        __builtin_mtc0(12, 0, intStatus);
+        
+        ScatterResume(opPool[opTx].payldConfig);
+        return;
+    }
+#endif
+    
+    if( idx == OP_NONE )
+    {
+        txClass = NRF_TX_CLASS_BULK;
+        idx = opQueueHead[txClass];
+    }
+    
+    if( idx == OP_NONE )
+    {
+        __builtin_mtc0(12, 0, intStatus);
+        return;
+    }
+    
+    opQueueHead[txClass] = opPool[idx].next;
+    if( opQueueHead[txClass] == OP_NONE )
+    {
+        opQueueTail[txClass] = OP_NONE;
+    }
+    opTx = idx;
+    opPool[idx].state = OP_STATE_PENDING;
+    uint32_t delay = _CP0_GET_COUNT() - opPool[idx].queueStamp;
+    __builtin_mtc0(12, 0, intStatus);
+    
+#if NRF_SCATTER_ENABLE
+    if( opPool[idx].isScatter )
+    {
+        ScatterStart(opPool[idx].payldConfig, opPool[idx].txPtr, opPool[idx].txSize);
+    }
+    else
+#endif
+    if( !SendPayload(opPool[idx].payldConfig, opPool[idx].rxPtr, opPool[idx].txPtr, opPool[idx].txSize) )
+    {
+        /* Configuration started after queueing, send goes back to head of its
+         * class and is started again once configuration is done */
+        intStatus = __builtin_disable_interrupts();
+        opPool[idx].state = OP_STATE_QUEUED;
+        opPool[idx].next = opQueueHead[txClass];
+        opQueueHead[txClass] = idx;
+        if( opQueueTail[txClass] == OP_NONE )
+        {
+            opQueueTail[txClass] = idx;
+        }
+        opTx = OP_NONE;
+        __builtin_mtc0(12, 0, intStatus);
+        
+        return;
+    }
+    
+    /* Queueing delay of class */
+    intStatus = __builtin_disable_interrupts();
+    txClassStats[txClass].started++;
+    txClassStats[txClass].delaySum += delay;
+    if( delay > txClassStats[txClass].delayMax )
+    {
+        txClassStats[txClass].delayMax = delay;
+    }
+    __builtin_mtc0(12, 0, intStatus);
+}
+
+
+/*
+ *  Completes send in progress and schedules next queued send
+ */
+static void OpTxComplete(NrfStatusFlag_t status, uint8_t length)
+{
+    if( opTx == OP_NONE )
+    {
+        return;
+    }
+    
+    OpComplete(opTx, status, opArc, length, NRF_RX_NO_PIPE);
+    opTx = OP_NONE;
+    
+    /* May execute within scope of SPI ISR */
+    OpTxKick();
+}
+
+
+/*
+ *  Starts next queued send (if any) from INTx ISR raised in software
+ */
+static void OpTxKick(void)
+{
+    bool isQueued = (opQueueHead[NRF_TX_CLASS_URGENT] != OP_NONE) || (opQueueHead[NRF_TX_CLASS_BULK] != OP_NONE);
+#if NRF_SCATTER_ENABLE
+    isQueued = isQueued || (opSuspended != OP_NONE);
+#endif
+    if( isQueued )
+    {
+        isrHandlerPtr = ISR_NrfHandler_SendQueued;
+        icSfr->ICxIFS0.SET = NRF_INTxIF_MASK;
+        icSfr->ICxIEC0.SET = NRF_INTxIE_MASK;
+    }
+}
+
+
+/*
+ *  ISR handler for starting next queued send (raised by OpTxComplete())
+ */
+static void ISR_NrfHandler_SendQueued(void)
+{
+    /* Disable INTx interrupt source (re-enabled once transmission starts) */
+    icSfr->ICxIEC0.CLR = NRF_INTxIE_MASK;
+    icSfr->ICxIFS0.CLR = NRF_INTxIF_MASK;
+    
+    OpTxStart();
+}
+
+
+/*
+ *  Configures TX and RX ISR handler function pointers
+ */
+static void IsrHandlerPtrConfig(IsrNrfMode_t isrMode)
+{
+    switch( isrMode )
+    {
+        /* Standard nRF payload transmission */
+        case ISR_NRF_MODE_0:
+            isrHandlerPtr = ISR_NrfHandler_ReadAckPayload;
+            break;
+        /* Standard nRF payload reception */
+        case ISR_NRF_MODE_1:
+            isrHandlerPtr = ISR_NrfHandler_ReadPayload;
+            break;
+        default:
+            break;
+    }
+}
+
+
+/*
+ *  ISR handler for NRF_SendPayload()
+ */
+static void ISR_NrfHandler_ReadAckPayload(void)
+{
+    BENCH_CALL(NRF_BENCH_READ_ACK_PAYLOAD);
+    BENCH_BEGIN(NRF_BENCH_READ_ACK_PAYLOAD);
+    
+    /* Device responded, so timeout must not overwrite status */
+    isTimeoutEnabled = false;
+    
+    /* Read and clear nRF status */
+    txData[0] = NRF_WRITE_CMD(NRF_STATUS_REG);
+    txData[1] = NRF_MAX_RT_MASK | NRF_TX_DS_MASK | NRF_RX_DR_MASK;
+    SpiReadWrite(isrPayldConfig.spiSfr, rxData, txData, 2);
+    statusFlag = (rxData[0] & 0x70);
+    
+#if NRF_RETRY_ENABLE
+    /* MAX_RT starts another round with a new ARD (payload is kept in TX FIFO) */
+    if( RetryIsRearmed(isrPayldConfig.spiSfr, statusFlag) )
+    {
+        BENCH_END();
+        
+        /* Same payload, so start events are not fired again */
+        TxStart(false);
+        return;
+    }
+#endif
+    
+#if NRF_LBT_ENABLE
+    LbtComplete(isrPayldConfig.spiSfr, statusFlag);
+#endif
+    
+    /* Retransmission count for operation handle */
+    if( opTx != OP_NONE )
+    {
+        txData[0] = NRF_READ_CMD(NRF_OBSERVE_TX_REG);
+        txData[1] = 0x00;
+        SpiReadWrite(isrPayldConfig.spiSfr, rxData, txData, 2);
+        opArc = (rxData[1] & NRF_ARC_CNT_MASK) >> NRF_ARC_CNT_POS;
+    }
+    
+    /* Payload with ACK */
+    if( statusFlag == NRF_FLAG_ACK_PLD )
+    {
+        /* Payload width check */
+        txData[0] = NRF_READ_RX_PL_WID_CMD;
+        txData[1] = 0x00;
+        SpiReadWrite(isrPayldConfig.spiSfr, rxData, txData, 2);
+        isrPayldWidth = rxData[1];
+
+        /* Corrupted width must be discarded by flushing RX FIFO */
+        if( (isrPayldWidth > 32) || (isrRxPtr == NULL) )
+        {
+            txData[0] = NRF_FLUSH_RX_CMD;
+            SpiReadWrite(isrPayldConfig.spiSfr, rxData, txData, 1);
+            
+            isrPayldWidth = 0;
+            ISR_NrfHandler_SendPayloadCont();
+        }
+        /* Read payload directly into user buffer */
+        else
+        {
+            SpiCommandBegin(isrPayldConfig.spiSfr, isrPayldConfig.pinConfig.csPin, NRF_READ_RX_PL_CMD);
+            SpiPayloadAsync(isrPayldConfig.spiSfr, isrRxPtr, NULL, isrPayldWidth, ISR_NrfHandler_SendPayloadCont);
+        }
+    }
+    /* Link lost or successful send without ACK */
+    else
+    {
+        /* Disable INTx interrupt source */
+        icSfr->ICxIEC0.CLR = NRF_INTxIE_MASK;
+        icSfr->ICxIFS0.CLR = NRF_INTxIF_MASK;
+        
+        EVENT(NRF_CLBK_TX_ACK_PAYLOAD_RECEIVE, NRF_RX_NO_PIPE, 0, statusFlag);
+        OpTxComplete(statusFlag, 0);
+    }
+    
+    BENCH_END();
+    
+    /* Call user callback */
+    USER_CLBK(NRF_CLBK_TX_ACK_PAYLOAD_RECEIVE, userClbkReadAckPayload);
+}
+
+
+/*
+ *  Handles reading of RX FIFO during enabled reception
+ *  Initiated by the NRF_StartReception()
+ */
+static void ISR_NrfHandler_ReadPayload(void)
+{
+    BENCH_CALL(NRF_BENCH_READ_PAYLOAD);
+    BENCH_BEGIN(NRF_BENCH_READ_PAYLOAD);
+    
+#if NRF_DEDUP_ENABLE
+    bool isPayloadRead = false;
+#endif
+    
+    /* Read and clear nRF status */
+    txData[0] = NRF_WRITE_CMD(NRF_STATUS_REG);
+    txData[1] = NRF_MAX_RT_MASK | NRF_TX_DS_MASK | NRF_RX_DR_MASK;
+    SpiReadWrite(isrPayldConfig.spiSfr, rxData, txData, 2);
+    statusFlag = (rxData[0] & 0x70);
+    rxPipeNo = (rxData[0] & 0x0E) >> 1;
+    
+    /* Payload left in RX FIFO by earlier read (RX_DR already cleared) */
+    if( (statusFlag == NRF_FLAG_NO_RP) && (rxPipeNo <= NRF_RX_PIPE_5) )
+    {
+        statusFlag = NRF_FLAG_RX_DR;
+    }
+    
+    /* Payload in RX FIFO */
+    if( (statusFlag == NRF_FLAG_RX_DR) || (statusFlag == NRF_FLAG_ACK_PLD) )
+    {
+#if NRF_DEDUP_ENABLE
+        isPayloadRead = true;
+#endif
+        
+        /* Stop reception */
+        PIO_ClearPin(isrPayldConfig.pinConfig.cePin);
+        
+        /* Payload width check */
+        txData[0] = NRF_READ_RX_PL_WID_CMD;
+        txData[1] = 0x00;
+        SpiReadWrite(isrPayldConfig.spiSfr, rxData, txData, 2);
+        isrPayldWidth = rxData[1];
+
+        /* Corrupted width must be discarded by flushing RX FIFO */
+        if( (isrPayldWidth > 32) || (isrRxPtr == NULL) )
+        {
+            txData[0] = NRF_FLUSH_RX_CMD;
+            SpiReadWrite(isrPayldConfig.spiSfr, rxData, txData, 1);
+            
+            isrPayldWidth = 0;
+            ISR_NrfHandler_ReadPayloadCont();
+        }
+        /* Read payload directly into user buffer */
+        else
+        {
+            SpiCommandBegin(isrPayldConfig.spiSfr, isrPayldConfig.pinConfig.csPin, NRF_READ_RX_PL_CMD);
+            SpiPayloadAsync(isrPayldConfig.spiSfr, isrRxPtr, NULL, isrPayldWidth, ISR_NrfHandler_ReadPayloadCont);
+        }
+    }
+    /* PTX couldn't establish link */
+    else
+    {
+        /* Clear flag only */
+        icSfr->ICxIFS0.CLR = NRF_INTxIF_MASK;
+    }
+    
+    BENCH_END();
+    
+#if NRF_DEDUP_ENABLE
+    /* Called by ISR_NrfHandler_ReadPayloadCont() once past duplicate filter */
+    if( isPayloadRead )
+    {
+        return;
+    }
+#endif
+    
+    /* Call user callback */
+    USER_CLBK(NRF_CLBK_RX_PAYLOAD_RECEIVE, userClbkReadPayload);
+}
+
+
+/*
+ *  ISR handler for ISR_NrfHandler_SendPayload() (executed within scope of SPI
+ *  ISR), where the former is initially triggered by the NRF_SendPayload()
+ */
+static void ISR_NrfHandler_SendPayloadCont(void)
+{
+    PROFILE_BEGIN();
+    BENCH_BEGIN(NRF_BENCH_READ_ACK_PAYLOAD);
+    
+    /* Disable INTx interrupt source */
+    icSfr->ICxIEC0.CLR = NRF_INTxIE_MASK;
+    icSfr->ICxIFS0.CLR = NRF_INTxIF_MASK;
+    
+    /* Disable current slave */
+    SPI_EnableSsState(isrPayldConfig.pinConfig.csPin);
+    
+    /* ACK payload already landed in "isrRxPtr" */
+    TRACE(NRF_TRACE_PAYLOAD_READY, NRF_READ_RX_PL_CMD, isrPayldWidth, statusFlag);
+    
+    EVENT(NRF_CLBK_TX_ACK_PAYLOAD_RECEIVE, NRF_RX_PIPE_0, isrPayldWidth, statusFlag);
+    OpTxComplete(statusFlag, isrPayldWidth);
+    
+    PROFILE_END(NRF_PROFILE_SEND_PAYLOAD_CONT);
+    BENCH_END();
+}
+
+
+/*
+ *  ISR handler for ISR_NrfHandler_ReadPayload() (executed within scope of SPI
+ *  ISR), where the former is initially triggered by the NRF_StartReception()
+ */
+static void ISR_NrfHandler_ReadPayloadCont(void)
+{
+    PROFILE_BEGIN();
+    BENCH_BEGIN(NRF_BENCH_READ_PAYLOAD);
+    
+    /* Clear flag only */
+    icSfr->ICxIFS0.CLR = NRF_INTxIF_MASK;
+    
+    /* Payload already landed in "isrRxPtr" */
+    TRACE(NRF_TRACE_PAYLOAD_READY, NRF_READ_RX_PL_CMD, isrPayldWidth, statusFlag);
+    
+#if NRF_DEDUP_ENABLE
+    /* Retransmission of an accepted payload (its ACK was lost), dropped before
+     * any event, sink, operation or callback sees it */
+    if( (isrPayldWidth > 0) && DedupIsDuplicate(rxPipeNo, isrRxPtr[0]) )
+    {
+        statusFlag = NRF_FLAG_NO_STATUS;
+        rxPipeNo = NRF_RX_NO_PIPE;
+        PIO_SetPin(isrPayldConfig.pinConfig.cePin);
+        
+        PROFILE_END(NRF_PROFILE_READ_PAYLOAD_CONT);
+        BENCH_END();
+        return;
+    }
+#endif
+    
+    EVENT(NRF_CLBK_RX_PAYLOAD_RECEIVE, rxPipeNo, isrPayldWidth, statusFlag);
+    
+    /* Hand payload over before the buffer is reused by the next reception */
+    if( (rxSinkPtr != NULL) && (isrPayldWidth > 0) )
+    {
+        rxSinkPtr((const uint8_t *)isrRxPtr, isrPayldWidth, rxPipeNo);
+    }
+    
+    /* Receive operation done, reception is paused until the next one */
+    if( (opRx != OP_NONE) && (isrPayldWidth > 0) )
+    {
+        OpComplete(opRx, statusFlag, 0, isrPayldWidth, rxPipeNo);
+        opRx = OP_NONE;
+    }
+    /* Start new reception */
+    else
+    {
+        PIO_SetPin(isrPayldConfig.pinConfig.cePin);
+    }
+    
+    PROFILE_END(NRF_PROFILE_READ_PAYLOAD_CONT);
+    BENCH_END();
+    
+#if NRF_DEDUP_ENABLE
+    /* Call user callback (deferred by ISR_NrfHandler_ReadPayload()) */
+    USER_CLBK(NRF_CLBK_RX_PAYLOAD_RECEIVE, userClbkReadPayload);
+#endif
+}
+
+
+/*
+ *  ISR handler for NRF_SendPayload() (executed within scope of SPI ISR)
+ */
+static void ISR_NrfHandler_StartTransmission(void)
+{
+    TxStart(true);
+}
+
+
+/*
+ *  Starts transmission of loaded payload, "isStartEvent" is false for a
+ *  re-armed retry round of the same payload (NRF_CLBK_TX_START is not fired)
+ */
+static void TxStart(bool isStartEvent)
+{
+#if NRF_LBT_ENABLE
+    PROFILE_BEGIN();
+    BENCH_BEGIN(NRF_BENCH_SEND_PAYLOAD);
+    
+    /* Channel is sampled by core timer handler at the end of the listen
+     * window, which starts the send once it is clear (no wait within ISR) */
+    isLbtStartEvent = isStartEvent;
+    isLbtBlocking = false;
+    LbtListenStart(isrPayldConfig.spiSfr, isrPayldConfig.pinConfig.cePin);
+    
+    PROFILE_END(NRF_PROFILE_START_TRANSMISSION);
+    BENCH_END();
+#else
+    TxPulse(isStartEvent);
+#endif
+}
+
+
+/*
+ *  Pulses CE for a single transmission and arms timeout and INTx, start
+ *  events are fired once per payload
+ */
+static void TxPulse(bool isStartEvent)
+{
+    PROFILE_BEGIN();
+    BENCH_BEGIN(NRF_BENCH_SEND_PAYLOAD);
+    
+    /* Start transmission */
+    PIO_ClearPin(isrPayldConfig.pinConfig.cePin);  // Clear if not cleared yet
     PIO_SetPin(isrPayldConfig.pinConfig.cePin);
     TMR_DelayUs(15);
     PIO_ClearPin(isrPayldConfig.pinConfig.cePin);
     
-    /* Use Core timer for timeout of unresponsive device */
-    timeoutCount = 0;
-    isTimeoutEnabled = true;
+    /* Use Core timer for timeout of unresponsive device */
+    timeoutCount = 0;
+    isTimeoutEnabled = true;
+    
+    /* INTx interrupt source enabled */
+    icSfr->ICxIFS0.CLR = NRF_INTxIF_MASK;
+    icSfr->ICxIEC0.SET = NRF_INTxIE_MASK;
+    
+    PROFILE_END(NRF_PROFILE_START_TRANSMISSION);
+    BENCH_END();
+    
+    if( isStartEvent )
+    {
+        EVENT(NRF_CLBK_TX_START, NRF_RX_NO_PIPE, 0, NRF_FLAG_NO_STATUS);
+        
+        /* Call user callback */
+        USER_CLBK(NRF_CLBK_TX_START, userClbkStartTransmission);
+    }
+}
+
+/*
+ *  ISR handler for NRF_StoreAckPayload() (executed within scope of SPI ISR)
+ */
+static void ISR_NrfHandler_RestartReception(void)
+{    
+    PROFILE_BEGIN();
+    BENCH_BEGIN(NRF_BENCH_STORE_ACK_PAYLOAD);
+    
+    /* Continue reception if initially started by NRF_StartReception() */
+    if( icSfr->ICxIEC0.W & NRF_INTxIE_MASK )
+    {
+        PIO_SetPin(isrPayldConfig.pinConfig.cePin);
+    }
+    
+    /* Reception may be activated (if not already) */
+    isRxFifoLoading = false;
+    
+    if( opAck != OP_NONE )
+    {
+        OpComplete(opAck, NRF_FLAG_NO_STATUS, 0, opPool[opAck].txSize, opPool[opAck].result.pipeNo);
+        opAck = OP_NONE;
+    }
+    
+    PROFILE_END(NRF_PROFILE_RESTART_RECEPTION);
+    BENCH_END();
+}
+
+/*
+ *  ISR handler for timeout of NRF_SendPayload()
+ */
+static void ISR_NrfTimeoutHandler_SendPayload(void)
+{
+    /* Ticks without a running timeout only advance the count reset on send */
+#if NRF_LBT_ENABLE
+    CAPTURE_TICK(NRF_CAPTURE_TICK_SEND_PAYLOAD, isTimeoutEnabled || LBT_IS_PENDING());
+    
+    /* Listening or deferred send steps once its deadline has passed */
+    if( LBT_IS_PENDING() )
+    {
+        LbtStep();
+    }
+#else
+    CAPTURE_TICK(NRF_CAPTURE_TICK_SEND_PAYLOAD, isTimeoutEnabled);
+#endif
+    
+    timeoutCount++;
+    if( (timeoutCount > timeoutVal) && (isTimeoutEnabled == true) )
+    {
+        statusFlag = NRF_FLAG_NO_RP;    // No response status
+
+        /* Try clearing status even in case of unresponsive device */
+        txData[0] = NRF_WRITE_CMD(NRF_STATUS_REG);
+        txData[1] = NRF_MAX_RT_MASK | NRF_TX_DS_MASK | NRF_RX_DR_MASK;
+        SpiReadWrite(isrPayldConfig.spiSfr, rxData, txData, 2);
+
+        /* Disable current slave */
+        SPI_DisableSsState(isrPayldConfig.pinConfig.csPin);
+        
+        timeoutCount = 0;
+        isTimeoutEnabled = false;
+        
+        EVENT(NRF_CLBK_TX_TIMEOUT, NRF_RX_NO_PIPE, 0, NRF_FLAG_NO_RP);
+        OpTxComplete(NRF_FLAG_NO_RP, 0);
+    }
+    
+    /* Call user callback */
+    USER_CLBK(NRF_CLBK_TX_TIMEOUT, userClbkPayloadTimeout);
+}
+
+/*
+ *  Determines which external interrupt source is used based on pin code (which
+ *  triggers ISR) and configures interrupt SFRs
+ */
+INLINE static void InterruptSfrConfig(const uint32_t pinCode)
+{
+    /* Check which INTx is used by PPS register code */
+    uint8_t regCode = pinCode & 0xFF;
+    
+    icSfr->ICxIEC0.CLR = NRF_INTxIE_MASK;       // Disable source
+    
+    /* External interrupt INT0 */
+    if( regCode == 0xFF )
+    {
+        icSfr->ICxIPC0.CLR = (IC_INT0IS_MASK | IC_INT0IP_MASK);                                 // Clear (sub)priority
+        icSfr->ICxIPC0.SET = ((NRF_ICX_ISL << IC_INT0IS_POS) | (NRF_ICX_IPL << IC_INT0IP_POS)); // Set (sub)priority
+        icSfr->ICxINTCON.CLR = IC_INT0EP_MASK;  // Falling-edge triggered
+    }
+    /* External interrupt INT1 */
+    else if( regCode == 0x04 )
+    {
+        icSfr->ICxIPC1.CLR = (IC_INT1IS_MASK | IC_INT1IP_MASK);
+        icSfr->ICxIPC1.SET = ((NRF_ICX_ISL << IC_INT1IS_POS) | (NRF_ICX_IPL << IC_INT1IP_POS));
+        icSfr->ICxINTCON.CLR = IC_INT1EP_MASK;
+    }
+    /* External interrupt INT2 */
+    else if( regCode == 0x08 )
+    {
+        icSfr->ICxIPC2.CLR = (IC_INT2IS_MASK | IC_INT2IP_MASK);
+        icSfr->ICxIPC2.SET = ((NRF_ICX_ISL << IC_INT2IS_POS) | (NRF_ICX_IPL << IC_INT2IP_POS));
+        icSfr->ICxINTCON.CLR = IC_INT2EP_MASK;
+    }
+    /* External interrupt INT3 */
+    else if( regCode == 0x0C )
+    {
+        icSfr->ICxIPC3.CLR = (IC_INT3IS_MASK | IC_INT3IP_MASK);
+        icSfr->ICxIPC3.SET = ((NRF_ICX_ISL << IC_INT3IS_POS) | (NRF_ICX_IPL << IC_INT3IP_POS));
+        icSfr->ICxINTCON.CLR = IC_INT3EP_MASK;
+    }
+    /* External interrupt INT4 */
+    else if( regCode == 0x10 )
+    {
+        icSfr->ICxIPC4.CLR = (IC_INT4IS_MASK | IC_INT4IP_MASK);
+        icSfr->ICxIPC4.SET = ((NRF_ICX_ISL << IC_INT4IS_POS) | (NRF_ICX_IPL << IC_INT4IP_POS));
+        icSfr->ICxINTCON.CLR = IC_INT4EP_MASK;
+    }
+    /* False input */
+    else
+    {
+        
+    }
+    
+    icSfr->ICxIFS0.CLR = NRF_INTxIF_MASK;       // Clear flag
+}
+
+/*
+ *  Blocking SPI transfer (single point for all blocking nRF transactions)
+ */
+INLINE static void SpiReadWrite(SpiSfr_t *spiSfr, volatile void *rxPtr, volatile void *txPtr, uint32_t size)
+{
+#if NRF_BENCH_ENABLE
+    benchStats[benchPath].spiTransactions++;
+    benchStats[benchPath].spiBytes += size;
+#endif
+    
+#if NRF_CAPTURE_ENABLE
+    /* MOSI is kept before an overlapping receive buffer can overwrite it */
+    uint8_t mosiData[32];
+    memcpy(mosiData, (const void *)txPtr, size);
+#endif
+    
+#if NRF_TRACE_ENABLE
+    /* Payload phase of split transaction is traced under its command byte */
+    uint8_t command = splitCmd ? splitCmd : *(volatile uint8_t *)txPtr;
+#endif
+    
+#if NRF_REPLAY_ENABLE
+    (void)spiSfr;
+    ReplayTransaction((rxPtr != NULL) ? NRF_CAPTURE_SPI : NRF_CAPTURE_SPI_TX, rxPtr, txPtr, size);
+#else
+    SPI_MasterReadWrite(spiSfr, rxPtr, txPtr, size);
+#endif
+    CAPTURE_SPI(rxPtr, mosiData, size);
+    
+    TRACE(NRF_TRACE_SPI, command, size,
+          (splitCmd || (rxPtr == NULL)) ? 0xFF : *(volatile uint8_t *)rxPtr);
+}
+
+
+/*
+ *  Interrupt-based SPI transfer (single point for all non-blocking nRF
+ *  transactions), where "clbkPtr" is called from SPI ISR once done
+ */
+INLINE static void SpiWriteAsync(SpiSfr_t *spiSfr, volatile void *rxPtr, volatile void *txPtr, uint32_t size, void (*clbkPtr)(void))
+{
+#if NRF_BENCH_ENABLE
+    benchStats[benchPath].spiTransactions++;
+    benchStats[benchPath].spiBytes += size;
+#endif
+    
+#if NRF_TRACE_ENABLE
+    /* Completion is traced by a trampoline before the actual callback */
+    traceAsyncRxPtr = splitCmd ? NULL : rxPtr;
+    traceAsyncCmd = splitCmd ? splitCmd : *(volatile uint8_t *)txPtr;
+    traceAsyncSize = size;
+    traceAsyncClbkPtr = clbkPtr;
+    TraceRecord(NRF_TRACE_SPI_ASYNC, traceAsyncCmd, traceAsyncSize, 0xFF);
+    clbkPtr = ISR_NrfHandler_TraceSpiDone;
+#endif
+    
+#if NRF_CAPTURE_ENABLE
+    /* MISO is captured by a trampoline before the actual callback */
+    captureAsyncRxPtr = rxPtr;
+    captureAsyncSize = size;
+    captureAsyncClbkPtr = clbkPtr;
+    CaptureRecord(NRF_CAPTURE_SPI_ASYNC, captureAsyncSize, txPtr, NULL);
+    clbkPtr = ISR_NrfHandler_CaptureSpiDone;
+#endif
+    
+#if NRF_REPLAY_ENABLE
+    /* Completion is delivered by NRF_ReplayStep() from the recorded MISO */
+    replayAsyncRxPtr = rxPtr;
+    replayAsyncSize = size;
+    replayAsyncClbkPtr = clbkPtr;
+    (void)spiSfr;
+    ReplayTransaction(NRF_CAPTURE_SPI_ASYNC, NULL, txPtr, replayAsyncSize);
+#else
+    SPI_MasterWrite2(spiSfr, rxPtr, txPtr, size, clbkPtr);
+#endif
+}
+
+/*
+ *  Asserts CS and clocks in the command byte only, returning STATUS. The
+ *  payload phase follows under the same CS assertion, directly on the user
+ *  buffer, and is closed with SpiCommandEnd() (or SpiPayloadAsync())
+ */
+static uint8_t SpiCommandBegin(SpiSfr_t *spiSfr, uint32_t csPin, uint8_t command)
+{
+    /* CS is driven as GPIO, since SPI module would release it between phases */
+    SPI_DisableSsState(csPin);
+    PIO_ClearPin(csPin);
+    
+    txData[0] = command;
+    SpiReadWrite(spiSfr, rxData, txData, 1);
+    
+    splitCmd = command;
+    splitCsPin = csPin;
+    
+    return rxData[0];
+}
+
+
+/*
+ *  Releases CS after the payload phase of a split transaction
+ */
+static void SpiCommandEnd(void)
+{
+    splitCmd = 0x00;
+    
+    PIO_SetPin(splitCsPin);
+    SPI_EnableSsState(splitCsPin);
+}
+
+
+/*
+ *  Interrupt-based payload phase of a split transaction, where "clbkPtr" is
+ *  called from SPI ISR once CS is released. A read ("rxPtr" set) clocks out
+ *  dummy bytes, a write ("rxPtr" = NULL) discards MISO
+ */
+static void SpiPayloadAsync(SpiSfr_t *spiSfr, volatile void *rxPtr, volatile void *txPtr, uint32_t size, void (*clbkPtr)(void))
+{
+    splitClbkPtr = clbkPtr;
+    
+    if( rxPtr != NULL )
+    {
+        txPtr = (volatile void *)payloadFill;
+    }
+    
+#if NRF_SPI_BURST_WIDTH != 8
+    /* Leading 1-3 bytes go in 8-bit frames, then whole words in wide frames
+     * until CS is released */
+    uint8_t words = size / BURST_BYTES;
+    if( words > 0 )
+    {
+        uint8_t head = BurstHead(spiSfr, rxPtr, txPtr, size);
+        
+        burstSpiSfr = spiSfr;
+        burstRxPtr = (rxPtr != NULL) ? ((volatile uint8_t *)rxPtr + head) : NULL;
+        burstWords = words;
+        
+        SpiBurstMode(spiSfr, true);
+        SpiWriteAsync(spiSfr, (rxPtr != NULL) ? burstStage : NULL, (rxPtr != NULL) ? txPtr : burstStage,
+                      words * BURST_BYTES, ISR_NrfHandler_BurstDone);
+        return;
+    }
+#endif
+    
+    /* Nothing to clock out (empty payload) */
+    if( size == 0 )
+    {
+        ISR_NrfHandler_SplitDone();
+        return;
+    }
+    
+    SpiWriteAsync(spiSfr, rxPtr, txPtr, size, ISR_NrfHandler_SplitDone);
+}
+
+
+/*
+ *  ISR handler for SpiPayloadAsync() (executed within scope of SPI ISR)
+ */
+static void ISR_NrfHandler_SplitDone(void)
+{
+    SpiCommandEnd();
+    
+    splitClbkPtr();
+}
+
+
+/*
+ *  Blocking payload phase of a split transaction, a read ("rxPtr" set) clocks
+ *  out dummy bytes, a write ("rxPtr" = NULL) discards MISO
+ */
+static void SpiPayloadReadWrite(SpiSfr_t *spiSfr, volatile void *rxPtr, volatile void *txPtr, uint32_t size)
+{
+    if( rxPtr != NULL )
+    {
+        txPtr = (volatile void *)payloadFill;
+    }
+    
+#if NRF_SPI_BURST_WIDTH != 8
+    /* Leading 1-3 bytes go in 8-bit frames, then whole words in wide frames
+     * until CS is released */
+    uint8_t words = size / BURST_BYTES;
+    if( words > 0 )
+    {
+        uint8_t head = BurstHead(spiSfr, rxPtr, txPtr, size);
+        
+        SpiBurstMode(spiSfr, true);
+        SpiReadWrite(spiSfr, (rxPtr != NULL) ? burstStage : payloadSink, (rxPtr != NULL) ? txPtr : burstStage,
+                     words * BURST_BYTES);
+        SpiBurstMode(spiSfr, false);
+        
+        if( rxPtr != NULL )
+        {
+            BurstCopy((volatile uint8_t *)rxPtr + head, burstStage, words);
+        }
+        return;
+    }
+#endif
+    
+    /* Payloads shorter than a word (or all payloads) in 8-bit frames */
+    if( size > 0 )
+    {
+        SpiReadWrite(spiSfr, (rxPtr != NULL) ? rxPtr : payloadSink, txPtr, size);
+    }
+}
+
+#if NRF_SPI_BURST_WIDTH != 8
+
+/*
+ *  Switches SPI module between 8-bit and wide (burst) frames
+ */
+INLINE static void SpiBurstMode(SpiSfr_t *spiSfr, bool isEnabled)
+{
+    /* Frame width may only be changed while module is off, so it is written
+     * along with turning the module off or back on (CS is held as GPIO and SCK
+     * returns to its idle level, so the nRF sees no clock edges) */
+    if( isEnabled )
+    {
+        spiSfr->SPIxCON.CLR = SPI_ON_MASK;
+        spiSfr->SPIxCON.SET = BURST_MODE_MASK | SPI_ON_MASK;
+    }
+    else
+    {
+        spiSfr->SPIxCON.CLR = BURST_MODE_MASK | SPI_ON_MASK;
+        spiSfr->SPIxCON.SET = SPI_ON_MASK;
+    }
+}
+
+
+/*
+ *  Clocks the leading size % word bytes of a payload phase in 8-bit frames and
+ *  stages the whole words of a write in wire order, returns leading byte count
+ *  (caller buffers are only read, or written with received bytes)
+ */
+static uint8_t BurstHead(SpiSfr_t *spiSfr, volatile void *rxPtr, volatile void *txPtr, uint32_t size)
+{
+    uint8_t head = size % BURST_BYTES;
+    
+    if( head > 0 )
+    {
+        SpiReadWrite(spiSfr, (rxPtr != NULL) ? rxPtr : payloadSink, txPtr, head);
+    }
+    
+    if( rxPtr == NULL )
+    {
+        BurstCopy(burstStage, (volatile uint8_t *)txPtr + head, size / BURST_BYTES);
+    }
+    
+    return head;
+}
+
+
+/*
+ *  Copies whole words while reversing the bytes within each word, which turns
+ *  memory order into wire order and back (buffers need no alignment)
+ */
+INLINE static void BurstCopy(volatile uint8_t *dstPtr, volatile uint8_t *srcPtr, uint8_t words)
+{
+    for(uint8_t i = 0; i < (words * BURST_BYTES); i += BURST_BYTES)
+    {
+        for(uint8_t j = 0; j < BURST_BYTES; j++)
+        {
+            dstPtr[i + j] = srcPtr[i + BURST_BYTES - 1 - j];
+        }
+    }
+    
+    BENCH_COPY(words * BURST_BYTES);
+}
+
+
+/*
+ *  ISR handler for wide frame part of SpiPayloadAsync() (executed within scope
+ *  of SPI ISR), which ends the payload phase
+ */
+static void ISR_NrfHandler_BurstDone(void)
+{
+    SpiBurstMode(burstSpiSfr, false);
+    
+    /* Received words into memory order of caller buffer */
+    if( burstRxPtr != NULL )
+    {
+        BurstCopy(burstRxPtr, burstStage, burstWords);
+    }
+    
+    ISR_NrfHandler_SplitDone();
+}
+
+#endif
+
+#if NRF_TRACE_ENABLE
+
+/*
+ *  Stores a single trace record, overwriting the oldest one if ring is full
+ */
+INLINE static void TraceRecord(uint8_t event, uint8_t command, uint8_t length, uint8_t status)
+{
+    /* Records are written from multiple interrupt levels: the slot is reserved
+     * atomically (LL/SC), so a nesting level writes its own slot and the
+     * record needs no critical section */
+    uint32_t slot = __sync_fetch_and_add(&traceHead, 1);
+    NrfTraceRecord_t *recPtr = &traceRing[slot & (NRF_TRACE_DEPTH - 1)];
+    recPtr->timestamp = _CP0_GET_COUNT();
+    recPtr->event = event;
+    recPtr->command = command;
+    recPtr->length = length;
+    recPtr->status = status;
+}
+
+
+/*
+ *  ISR handler for traced SpiWriteAsync() (executed within scope of SPI ISR)
+ */
+static void ISR_NrfHandler_TraceSpiDone(void)
+{
+    uint8_t status = (traceAsyncRxPtr != NULL) ? traceAsyncRxPtr[0] : 0xFF;
+    TraceRecord(NRF_TRACE_SPI_DONE, traceAsyncCmd, traceAsyncSize, status);
+    
+    traceAsyncClbkPtr();
+}
+
+#endif
+
+#if NRF_ISR_PROFILE_ENABLE
+
+/*
+ *  Adds a single latency or execution time sample to the statistics
+ */
+static void ProfileRecord(NrfProfileSel_t sel, uint32_t ticks)
+{
+    /* Bin index is the bit length of "ticks / 64" */
+    uint32_t scaled = ticks >> 6;
+    uint8_t bin = scaled ? (32 - __builtin_clz(scaled)) : 0;
+    bin = (bin < NRF_PROFILE_BINS) ? bin : (NRF_PROFILE_BINS - 1);
+    
+    /* Samples are recorded from multiple interrupt levels */
+    uint32_t intStatus = __builtin_disable_interrupts();
+    if( (isrProfile[sel].count == 0) || (ticks < isrProfile[sel].min) )
+    {
+        isrProfile[sel].min = ticks;
+    }
+    if( ticks > isrProfile[sel].max )
+    {
+        isrProfile[sel].max = ticks;
+    }
+    isrProfile[sel].count++;
+    isrProfile[sel].sum += ticks;
+    isrProfile[sel].histogram[bin]++;
+    __builtin_mtc0(12, 0, intStatus);
+}
+
+
+/*
+ *  Returns profile selector of INTx handler
+ */
+static NrfProfileSel_t ProfileHandlerSel(void (*handlerPtr)(void))
+{
+    if( handlerPtr == ISR_NrfHandler_ReadAckPayload )
+    {
+        return NRF_PROFILE_READ_ACK_PAYLOAD;
+    }
+    if( handlerPtr == ISR_NrfHandler_SendQueued )
+    {
+        return NRF_PROFILE_SEND_QUEUED;
+    }
+#if NRF_SCATTER_ENABLE
+    if( handlerPtr == ISR_NrfHandler_Scatter )
+    {
+        return NRF_PROFILE_SCATTER;
+    }
+#endif
+    
+    return NRF_PROFILE_READ_PAYLOAD;
+}
+
+#endif
+
+#if NRF_SCK_CALIBRATION_ENABLE
+
+/*
+ *  Steps SCK up from user configured frequency while test patterns pass, then
+ *  backs off by NRF_SCK_MARGIN_STEPS
+ */
+static void SckCalibrate(SpiSfr_t *spiSfr, uint32_t csPin)
+{
+    uint32_t pbFreq = OSC_GetPbFreq();
+    uint32_t brg = spiSfr->SPIxBRG.W;
+    
+    /* Fastest allowed SCK = PBCLK / (2 * (BRG + 1)) <= NRF_SCK_MAX_FREQ */
+    uint32_t brgMin = (pbFreq + 2 * NRF_SCK_MAX_FREQ - 1) / (2 * NRF_SCK_MAX_FREQ) - 1;
+    
+    sckSpiSfr = spiSfr;
+    sckCsPin = csPin;
+    sckBrgLimit = brg;
+    
+    /* Keep user configured SCK if even that one fails */
+    if( !SckPatternTest(spiSfr, brg) )
+    {
+        return;
+    }
+    
+    uint32_t brgPassed = brg;
+    while( brg > brgMin )
+    {
+        if( !SckPatternTest(spiSfr, --brg) )
+        {
+            break;
+        }
+        brgPassed = brg;
+    }
+    
+    /* Safety margin */
+    brgPassed += NRF_SCK_MARGIN_STEPS;
+    SpiSetBrg(spiSfr, (brgPassed > sckBrgLimit) ? sckBrgLimit : brgPassed);
+}
+
+
+/*
+ *  Tests SCK of baud rate "brg", which only ever clocks reads: SETUP_AW (known
+ *  from configuration) is probed first, then test patterns written into
+ *  TX_ADDR at user configured SCK are read back. TX_ADDR is restored and SCK
+ *  is left at "brg"
+ */
+static bool SckPatternTest(SpiSfr_t *spiSfr, uint32_t brg)
+{
+    static const uint8_t pattern[4][5] = {
+        { 0x55, 0x55, 0x55, 0x55, 0x55 },       // Alternating bits
+        { 0xAA, 0xAA, 0xAA, 0xAA, 0xAA },
+        { 0x00, 0xFF, 0x00, 0xFF, 0x00 },       // Full swing between bytes
+        { 0x81, 0x42, 0x24, 0x18, 0xE7 }        // Mixed edges
+    };
+    uint8_t txBuf[6];
+    uint8_t rxBuf[6];
+    uint8_t savedAddr[6];
+    bool isPassed = true;
+    
+    /* Read-only probe, a corrupted clock fails here before any write */
+    SpiSetBrg(spiSfr, brg);
+    txBuf[0] = NRF_READ_CMD(NRF_SETUP_AW_REG);
+    txBuf[1] = 0x00;
+    SpiReadWrite(spiSfr, rxBuf, txBuf, 2);
+    if( rxBuf[1] != configState.reg[REG_IDX_SETUP_AW] )
+    {
+        return false;
+    }
+    
+    SpiSetBrg(spiSfr, sckBrgLimit);
+    txBuf[0] = NRF_READ_CMD(NRF_TX_ADDR_REG);
+    SpiReadWrite(spiSfr, savedAddr, txBuf, 6);
+    
+    for(uint8_t i = 0; isPassed && (i < 4); i++)
+    {
+        SpiSetBrg(spiSfr, sckBrgLimit);
+        txBuf[0] = NRF_WRITE_CMD(NRF_TX_ADDR_REG);
+        memcpy(&txBuf[1], pattern[i], 5);
+        SpiReadWrite(spiSfr, rxBuf, txBuf, 6);
+        
+        SpiSetBrg(spiSfr, brg);
+        txBuf[0] = NRF_READ_CMD(NRF_TX_ADDR_REG);
+        SpiReadWrite(spiSfr, rxBuf, txBuf, 6);
+        
+        isPassed = (memcmp(&rxBuf[1], pattern[i], 5) == 0);
+    }
+    
+    /* Previous TX_ADDR back (the STATUS byte is replaced by the command) */
+    SpiSetBrg(spiSfr, sckBrgLimit);
+    savedAddr[0] = NRF_WRITE_CMD(NRF_TX_ADDR_REG);
+    SpiReadWrite(spiSfr, rxBuf, savedAddr, 6);
+    SpiSetBrg(spiSfr, brg);
+    
+    return isPassed;
+}
+
+
+/*
+ *  Changes SPI baud rate (module is briefly turned off)
+ */
+INLINE static void SpiSetBrg(SpiSfr_t *spiSfr, uint32_t brg)
+{
+    spiSfr->SPIxCON.CLR = SPI_ON_MASK;
+    spiSfr->SPIxBRG.W = brg;
+    spiSfr->SPIxCON.SET = SPI_ON_MASK;
+}
+
+#endif
+
+#if NRF_EVENT_ENABLE
+
+/*
+ *  Records event for deferred dispatch (events without handler are skipped)
+ */
+static void EventPost(NrfUserCallback_t kind, NrfRxPipeNo_t pipeNo, uint8_t length, NrfStatusFlag_t status)
+{
+    if( eventHandler[kind] == NULL )
+    {
+        return;
+    }
+    
+    uint32_t intStatus = __builtin_disable_interrupts();
+    
+    /* Newest event is dropped on full queue */
+    if( (eventHead - eventTail) >= NRF_EVENT_DEPTH )
+    {
+        eventDropped++;
+        __builtin_mtc0(12, 0, intStatus);
+        return;
+    }
+    
+    NrfEvent_t *event = &eventRing[eventHead & (NRF_EVENT_DEPTH - 1)];
+    event->timestamp = _CP0_GET_COUNT();
+    event->kind = kind;
+    event->pipeNo = pipeNo;
+    event->length = length;
+    event->status = status;
+    eventHead++;
+    __builtin_mtc0(12, 0, intStatus);
+    
+#if NRF_EVENT_SWI_ENABLE
+    /* Request Core Software Interrupt 0 */
+    _CP0_BIS_CAUSE(_CP0_CAUSE_IP0_MASK);
+#endif
+}
+
+
+/*
+ *  Records a user callback call for deferred dispatch (the call is dropped
+ *  and counted once 255 calls of its type are pending)
+ */
+static void EventDeferCallback(NrfUserCallback_t kind)
+{
+    uint32_t intStatus = __builtin_disable_interrupts();
+    
+    if( clbkPending[kind] == UINT8_MAX )
+    {
+        eventDropped++;
+        __builtin_mtc0(12, 0, intStatus);
+        return;
+    }
+    
+    clbkPending[kind]++;
+    __builtin_mtc0(12, 0, intStatus);
+    
+#if NRF_EVENT_SWI_ENABLE
+    /* Request Core Software Interrupt 0 */
+    _CP0_BIS_CAUSE(_CP0_CAUSE_IP0_MASK);
+#endif
+}
+
+
+/*
+ *  Returns user callback set for a certain type of operation
+ */
+static void (*EventUserCallback(NrfUserCallback_t kind))(void)
+{
+    switch( kind )
+    {
+        case NRF_CLBK_RX_PAYLOAD_RECEIVE:
+            return userClbkReadPayload;
+        case NRF_CLBK_TX_ACK_PAYLOAD_RECEIVE:
+            return userClbkReadAckPayload;
+        case NRF_CLBK_TX_START:
+            return userClbkStartTransmission;
+        case NRF_CLBK_TX_TIMEOUT:
+            return userClbkPayloadTimeout;
+        case NRF_CLBK_CONFIG_DONE:
+            return userClbkConfigDone;
+        default:
+            return NULL;
+    }
+}
+
+
+/*
+ *  Enables Core Software Interrupt 0 for event dispatch
+ */
+INLINE static void EventSwiEnable(void)
+{
+#if NRF_EVENT_SWI_ENABLE
+    icSfr->ICxIPC0.CLR = (IC_CS0IS_MASK | IC_CS0IP_MASK);
+    icSfr->ICxIPC0.SET = ((NRF_EVENT_ICX_ISL << IC_CS0IS_POS) | (NRF_EVENT_ICX_IPL << IC_CS0IP_POS));
+    icSfr->ICxIEC0.SET = IC_CS0IE_MASK;
+#endif
+}
+
+#endif
+
+#if NRF_DEDUP_ENABLE
+
+/*
+ *  Checks sequence number (first payload byte) against the window of the
+ *  source behind "pipeNo", returns true for an already accepted payload
+ */
+static bool DedupIsDuplicate(NrfRxPipeNo_t pipeNo, uint8_t seq)
+{
+    /* Full address (PIPE_2-5 share upper bytes with PIPE_1), "rxPipeAddr"
+     * holds the write command in its low byte */
+    uint64_t addr = rxPipeAddr[pipeNo] >> 8;
+    if( pipeNo >= NRF_RX_PIPE_2 )
+    {
+        addr = ((rxPipeAddr[NRF_RX_PIPE_1] >> 8) & 0xFFFFFFFF00) | (addr & 0xFF);
+    }
+    
+    /* Fold address into table index */
+    uint32_t hash = (uint32_t)addr ^ (uint32_t)(addr >> 32);
+    hash ^= hash >> 16;
+    hash ^= hash >> 8;
+    
+    uint32_t now = _CP0_GET_COUNT();
+    uint32_t victimAge = 0;
+    uint8_t victim = hash & (NRF_DEDUP_SLOTS - 1);
+    
+    for(uint8_t i = 0; i < NRF_DEDUP_PROBES; i++)
+    {
+        uint8_t idx = (hash + i) & (NRF_DEDUP_SLOTS - 1);
+        
+        /* Slots are never freed one by one, so a free slot ends the search */
+        if( dedupTable[idx].window == 0 )
+        {
+            victim = idx;
+            victimAge = UINT32_MAX;
+            break;
+        }
+        
+        if( dedupTable[idx].addr == addr )
+        {
+            int32_t diff = (int8_t)(seq - dedupTable[idx].lastSeq);
+            dedupTable[idx].stamp = now;
+            
+            /* Newer sequence slides the window */
+            if( diff > 0 )
+            {
+                dedupTable[idx].window = (diff < NRF_DEDUP_WINDOW) ? ((dedupTable[idx].window << diff) | 0x01) : 0x01;
+                dedupTable[idx].lastSeq = seq;
+            }
+            /* Older sequence within window (retransmission or reordering) */
+            else if( -diff < NRF_DEDUP_WINDOW )
+            {
+                uint32_t mask = (uint32_t)0x01 << -diff;
+                if( dedupTable[idx].window & mask )
+                {
+                    dedupStats.duplicates++;
+                    return true;
+                }
+                dedupTable[idx].window |= mask;
+            }
+            /* Far behind window, source restarted its sequence */
+            else
+            {
+                dedupTable[idx].window = 0x01;
+                dedupTable[idx].lastSeq = seq;
+                dedupStats.resyncs++;
+            }
+            
+            dedupStats.accepted++;
+            return false;
+        }
+        
+        if( (now - dedupTable[idx].stamp) >= victimAge )
+        {
+            victim = idx;
+            victimAge = now - dedupTable[idx].stamp;
+        }
+    }
+    
+    /* Unknown source replaces the least recently seen one */
+    if( dedupTable[victim].window != 0 )
+    {
+        dedupStats.evictions++;
+    }
+    dedupTable[victim].addr = addr;
+    dedupTable[victim].window = 0x01;
+    dedupTable[victim].stamp = now;
+    dedupTable[victim].lastSeq = seq;
+    dedupStats.accepted++;
+    
+    return false;
+}
+
+#endif
+
+#if NRF_LBT_ENABLE
+
+/*
+ *  Accounts channel sample taken before a send (TX FIFO loaded, CE low),
+ *  returns false if the send must be deferred
+ */
+static bool LbtIsClear(bool isBusy)
+{
+    lbtStats.checks++;
+    
+    if( isBusy )
+    {
+        lbtStats.deferrals++;
+        
+        if( lbtDeferCount < NRF_LBT_MAX_DEFERRALS )
+        {
+            lbtDeferCount++;
+            return false;
+        }
+        
+        lbtStats.forced++;
+    }
+    
+    isLbtDeferred = (lbtDeferCount != 0);
+    lbtDeferCount = 0;
+    
+    return true;
+}
+
+
+/*
+ *  Turns receiver on with all pipes disabled (nothing is acknowledged or
+ *  stored) and sets the deadline of the single RPD sample, NRF_LBT_WINDOW_US
+ *  after RPD is valid (LBT_RPD_SETTLE_US)
+ */
+static void LbtListenStart(SpiSfr_t *spiSfr, uint32_t cePin)
+{
+    txData[0] = NRF_WRITE_CMD(NRF_EN_RXADDR_REG);
+    txData[1] = 0x00;
+    SpiReadWrite(spiSfr, rxData, txData, 2);
+    txData[0] = NRF_WRITE_CMD(NRF_CONFIG_REG);
+    txData[1] = configState.reg[REG_IDX_CONFIG] | NRF_PRIM_RX_MASK;
+    SpiReadWrite(spiSfr, rxData, txData, 2);
+    
+    PIO_SetPin(cePin);
+    
+    lbtSpiSfr = spiSfr;
+    lbtCePin = cePin;
+    lbtDeadline = _CP0_GET_COUNT() + (LBT_RPD_SETTLE_US + NRF_LBT_WINDOW_US) * (sysFreq / 1000000 / 2);
+    isLbtListening = true;
+    
+    if( !isLbtBlocking )
+    {
+        LbtArm(lbtDeadline);
+    }
+}
+
+
+/*
+ *  Pulls core timer compare in to "deadline" if the next tick comes later, so
+ *  the handler steps listening on time rather than up to a tick late. The
+ *  timer library reloads compare from there, the tick period is unchanged
+ */
+static void LbtArm(uint32_t deadline)
+{
+    uint32_t intStatus = __builtin_disable_interrupts();
+    
+    /* Compare written only ahead of count (no wait for a wrap-around) */
+    uint32_t ahead = deadline - _CP0_GET_COUNT();
+    if( ((int32_t)ahead > (int32_t)(sysFreq / 1000000 / 2)) &&
+        ((int32_t)(_CP0_GET_COMPARE() - deadline) > 0) )
+    {
+        _CP0_SET_COMPARE(deadline);
+    }
+    
+    __builtin_mtc0(12, 0, intStatus);
+}
+
+
+/*
+ *  Reads Received Power Detector, returns true on a carrier above -64 dBm
+ */
+static bool LbtSample(SpiSfr_t *spiSfr)
+{
+    txData[0] = NRF_READ_CMD(NRF_RPD_REG);
+    txData[1] = 0x00;
+    SpiReadWrite(spiSfr, rxData, txData, 2);
+    
+    return (rxData[1] & NRF_RPD_MASK) ? true : false;
+}
+
+
+/*
+ *  Turns receiver off and restores PTX registers from shadow
+ */
+static void LbtListenStop(SpiSfr_t *spiSfr, uint32_t cePin)
+{
+    PIO_ClearPin(cePin);
+    
+    txData[0] = NRF_WRITE_CMD(NRF_CONFIG_REG);
+    txData[1] = configState.reg[REG_IDX_CONFIG];
+    SpiReadWrite(spiSfr, rxData, txData, 2);
+    txData[0] = NRF_WRITE_CMD(NRF_EN_RXADDR_REG);
+    txData[1] = configState.reg[REG_IDX_EN_RXADDR];
+    SpiReadWrite(spiSfr, rxData, txData, 2);
+}
+
+
+/*
+ *  Steps listen-before-talk of current payload once lbtDeadline has passed
+ *  (core timer handler, or polled by blocking send). A deferred send listens
+ *  again. A listening one takes its RPD sample (RPD is a snapshot, one sample
+ *  per listen) and then either starts the send or defers it
+ */
+static void LbtStep(void)
+{
+    if( (int32_t)(_CP0_GET_COUNT() - lbtDeadline) < 0 )
+    {
+        return;
+    }
+    
+    if( isLbtBackoff )
+    {
+        isLbtBackoff = false;
+        LbtListenStart(lbtSpiSfr, lbtCePin);
+        return;
+    }
+    
+    bool isBusy = LbtSample(lbtSpiSfr);
+    
+    isLbtListening = false;
+    LbtListenStop(lbtSpiSfr, lbtCePin);
+    
+    /* Busy channel defers the send by a random number of slots */
+    if( !LbtIsClear(isBusy) )
+    {
+        lbtDeadline = _CP0_GET_COUNT() + LbtBackoff() * LBT_SLOT_US * (sysFreq / 1000000 / 2);
+        isLbtBackoff = true;
+        return;
+    }
+    
+    /* Blocking send pulses CE once stepping stops */
+    if( !isLbtBlocking )
+    {
+        TxPulse(isLbtStartEvent);
+    }
+}
+
+
+/*
+ *  Drops deferred send or stops listening of superseded one
+ */
+static void LbtCancel(SpiSfr_t *spiSfr, uint32_t cePin)
+{
+    uint32_t intStatus = __builtin_disable_interrupts();
+    
+    if( isLbtListening )
+    {
+        isLbtListening = false;
+        LbtListenStop(spiSfr, cePin);
+    }
+    
+    isLbtBackoff = false;
+    lbtDeferCount = 0;
+    isLbtDeferred = false;
+    
+    __builtin_mtc0(12, 0, intStatus);
+}
+
+
+/*
+ *  Draws a backoff in core timer callback periods from a window doubling with
+ *  each deferral of the payload (up to NRF_LBT_MAX_BACKOFF)
+ */
+static uint32_t LbtBackoff(void)
+{
+    uint32_t window = NRF_LBT_MAX_BACKOFF;
+    if( (lbtDeferCount < 31) && ((0x01u << lbtDeferCount) < window) )
+    {
+        window = 0x01u << lbtDeferCount;
+    }
+    
+    return 1 + (RandomDraw() & (window - 1));
+}
+
+
+/*
+ *  Accounts a deferred payload acknowledged without retransmission as a
+ *  collision avoided
+ */
+static void LbtComplete(SpiSfr_t *spiSfr, NrfStatusFlag_t status)
+{
+    if( isLbtDeferred && (status & NRF_FLAG_TX_DS) )
+    {
+        txData[0] = NRF_READ_CMD(NRF_OBSERVE_TX_REG);
+        txData[1] = 0x00;
+        SpiReadWrite(spiSfr, rxData, txData, 2);
+        
+        if( ((rxData[1] & NRF_ARC_CNT_MASK) >> NRF_ARC_CNT_POS) == 0 )
+        {
+            lbtStats.avoided++;
+        }
+    }
+    
+    isLbtDeferred = false;
+}
+
+#endif
+
+#if NRF_RETRY_ENABLE
+
+/*
+ *  Concludes a round of hardware retransmits. On MAX_RT, another round is
+ *  armed with a randomized ARD and REUSE_TX_PL (returns true, caller pulses
+ *  CE), otherwise the configured ARD is restored
+ */
+static bool RetryIsRearmed(SpiSfr_t *spiSfr, NrfStatusFlag_t status)
+{
+    uint8_t setupRetr = configState.reg[REG_IDX_SETUP_RETR];
+    
+    /* Unresponsive device, no round took place */
+    if( (status & (NRF_FLAG_TX_DS | NRF_FLAG_MAX_RT)) == 0 )
+    {
+        RetryRestore(spiSfr);
+        return false;
+    }
+    
+    if( status & NRF_FLAG_TX_DS )
+    {
+        txData[0] = NRF_READ_CMD(NRF_OBSERVE_TX_REG);
+        txData[1] = 0x00;
+        SpiReadWrite(spiSfr, rxData, txData, 2);
+        retryStats.attempts += ((rxData[1] & NRF_ARC_CNT_MASK) >> NRF_ARC_CNT_POS) + 1;
+        retryStats.payloads++;
+        
+        if( retryRound != 0 )
+        {
+            retryStats.recovered++;
+            retryStats.ardRecovered[retryArd]++;
+        }
+        
+        RetryRestore(spiSfr);
+        return false;
+    }
+    
+    /* Every retransmit of the round was spent */
+    retryStats.attempts += ((setupRetr & NRF_ARC_MASK) >> NRF_ARC_POS) + 1;
+    
+    if( retryRound >= NRF_RETRY_ROUNDS )
+    {
+        retryStats.payloads++;
+        retryStats.exhausted++;
+        RetryRestore(spiSfr);
+        return false;
+    }
+    
+    /* ARD is drawn above the configured one from a window doubling per round,
+     * so nodes that collided in lockstep retransmit apart */
+    uint8_t ardBase = (setupRetr & NRF_ARD_MASK) >> NRF_ARD_POS;
+    uint8_t ard = ardBase + (RandomDraw() & ((0x04 << retryRound) - 1));
+    retryArd = (ard > 15) ? 15 : ard;
+    retryRound++;
+    retryStats.rounds++;
+    retryStats.ardRounds[retryArd]++;
+    
+    txData[0] = NRF_WRITE_CMD(NRF_SETUP_RETR_REG);
+    txData[1] = (setupRetr & ~NRF_ARD_MASK) | (retryArd << NRF_ARD_POS);
+    SpiReadWrite(spiSfr, rxData, txData, 2);
+    
+    /* MAX_RT must be cleared before the next pulse */
+    txData[0] = NRF_WRITE_CMD(NRF_STATUS_REG);
+    txData[1] = NRF_MAX_RT_MASK;
+    SpiReadWrite(spiSfr, rxData, txData, 2);
+    
+    txData[0] = NRF_REUSE_TX_PL_CMD;
+    SpiReadWrite(spiSfr, rxData, txData, 1);
+    
+    return true;
+}
+
+
+/*
+ *  Writes back configured SETUP_RETR after added rounds
+ */
+static void RetryRestore(SpiSfr_t *spiSfr)
+{
+    if( retryRound != 0 )
+    {
+        txData[0] = NRF_WRITE_CMD(NRF_SETUP_RETR_REG);
+        txData[1] = configState.reg[REG_IDX_SETUP_RETR];
+        SpiReadWrite(spiSfr, rxData, txData, 2);
+        
+        retryRound = 0;
+    }
+}
+
+#endif
+
+#if NRF_LBT_ENABLE || NRF_RETRY_ENABLE
+
+/*
+ *  Draws a pseudo-random number (xorshift32, stirred with core timer so that
+ *  nodes running in lockstep draw apart)
+ */
+static uint32_t RandomDraw(void)
+{
+    randomSeed = (randomSeed ^ _CP0_GET_COUNT()) | 0x01;
+    randomSeed ^= randomSeed << 13;
+    randomSeed ^= randomSeed >> 17;
+    randomSeed ^= randomSeed << 5;
+    
+    return randomSeed;
+}
+
+#endif
+
+#if NRF_HEALTH_ENABLE
+
+/*
+ *  Reads back key registers and checks them against configuration state (a
+ *  reset device reads its defaults, an unpowered one reads all 0x00 or 0xFF)
+ */
+static bool HealthIsIntact(SpiSfr_t *spiSfr)
+{
+    static const uint8_t checkIdx[3] = { REG_IDX_CONFIG, REG_IDX_RF_CH, REG_IDX_SETUP_AW };
+    
+    for(uint8_t i = 0; i < 3; i++)
+    {
+        txData[0] = NRF_READ_CMD(configRegMap[checkIdx[i]]);
+        txData[1] = 0x00;
+        SpiReadWrite(spiSfr, rxData, txData, 2);
+        
+        if( rxData[1] != configState.reg[checkIdx[i]] )
+        {
+            return false;
+        }
+    }
+    
+    /* PIPE_0 address is rewritten by every PTX send, checked in PRX only */
+    if( !configState.isPtx && (configState.reg[REG_IDX_EN_RXADDR] & 0x01) )
+    {
+        txData[0] = NRF_READ_CMD(NRF_RX_ADDR_P0_REG);
+        txData[1] = 0x00;
+        SpiReadWrite(spiSfr, rxData, txData, 2);
+        
+        if( rxData[1] != (uint8_t)(rxPipeAddr[0] >> 8) )
+        {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+
+/*
+ *  Rewrites configuration registers (except STATUS, so that pending flags are
+ *  kept) and addresses of enabled pipes that differ, returns number written
+ */
+static uint8_t HealthRestore(SpiSfr_t *spiSfr)
+{
+    uint8_t count = ConfigWriteRegs(spiSfr, REG_IDX_CONFIG);
+    
+    uint64_t txData64;
+    uint64_t rxData64 = 0;
+    
+    for(uint8_t i = 0; i < 6; i++)
+    {
+        if( !((configState.reg[REG_IDX_EN_RXADDR] >> i) & 0x01) || ((i == 0) && configState.isPtx) )
+        {
+            continue;
+        }
+        
+        /* 5-byte address for first two pipes, 1-byte for other pipes */
+        uint8_t size = (i < 2) ? 6 : 2;
+        uint64_t mask = (i < 2) ? 0xFFFFFFFFFF : 0xFF;
+        
+        txData64 = NRF_READ_CMD(NRF_RX_ADDR_P0_REG + i);
+        SpiReadWrite(spiSfr, &rxData64, &txData64, size);
+        
+        if( ((rxData64 >> 8) & mask) != ((rxPipeAddr[i] >> 8) & mask) )
+        {
+            txData64 = (rxPipeAddr[i] & (mask << 8)) | NRF_WRITE_CMD(NRF_RX_ADDR_P0_REG + i);
+            SpiReadWrite(spiSfr, &rxData64, &txData64, size);
+            count++;
+        }
+    }
+    
+    return count;
+}
+
+#endif
+
+#if NRF_SCATTER_ENABLE
+
+/*
+ *  Sorts scatter items by address and starts the first payload (executed by
+ *  OpTxStart(), the following payloads are driven by ISR_NrfHandler_Scatter())
+ */
+static void ScatterStart(NrfPayloadConfig_t payldConfig, NrfScatterItem_t *items, uint8_t count)
+{
+    BENCH_BEGIN(NRF_BENCH_SEND_PAYLOAD);
+    
+    /* Insertion sort keeps given order of equal addresses, so neighbours share
+     * upper address bytes and payloads of one address follow each other */
+    for(uint8_t i = 0; i < count; i++)
+    {
+        uint64_t addr = items[i].addr & 0xFFFFFFFFFF;
+        uint8_t j = i;
+        
+        while( (j > 0) && ((items[scatterOrder[j - 1]].addr & 0xFFFFFFFFFF) > addr) )
+        {
+            scatterOrder[j] = scatterOrder[j - 1];
+            j--;
+        }
+        scatterOrder[j] = i;
+        
+        items[i].status = NRF_FLAG_NO_RP;
+        items[i].arc = 0;
+    }
+    
+    scatterItems = items;
+    scatterCount = count;
+    scatterPos = 0;
+    scatterDelivered = 0;
+    scatterArc = 0;
+    
+    BENCH_END();
+    
+    ScatterResume(payldConfig);
+}
+
+
+/*
+ *  Starts scatter send from "scatterPos" on, with the device in any state left
+ *  by the previous send (at start or after preemption by an urgent send)
+ */
+static void ScatterResume(NrfPayloadConfig_t payldConfig)
+{
+    BENCH_BEGIN(NRF_BENCH_SEND_PAYLOAD);
+    
+    /* Handler must not see a half loaded TX FIFO, INTx stays disabled until
+     * the transmission starts (other interrupts are served meanwhile) */
+    icSfr->ICxIEC0.CLR = NRF_INTxIE_MASK;
+    
+    /* Hand device over to scatter handler */
+    uint32_t intStatus = __builtin_disable_interrupts();
+    
+    statusFlag = NRF_FLAG_NO_STATUS;
+    isrRxPtr = NULL;
+    isrPayldConfig = payldConfig;
+    isrHandlerPtr = ISR_NrfHandler_Scatter;
+    
+    __builtin_mtc0(12, 0, intStatus);
+    
+    SPI_EnableSsState(payldConfig.pinConfig.csPin);
+    
+#if NRF_LBT_ENABLE
+    /* Any deferred or listening send is superseded */
+    LbtCancel(payldConfig.spiSfr, payldConfig.pinConfig.cePin);
+#endif
+    
+#if NRF_RETRY_ENABLE
+    /* ARD of a timed out payload's rounds is still programmed */
+    RetryRestore(payldConfig.spiSfr);
+#endif
+    
+    /* Flush TX + RX FIFO and clear status, once for the whole list (or its
+     * remainder) */
+    txData[0] = NRF_FLUSH_TX_CMD;
+    SpiReadWrite(payldConfig.spiSfr, rxData, txData, 1);
+    txData[0] = NRF_FLUSH_RX_CMD;
+    SpiReadWrite(payldConfig.spiSfr, rxData, txData, 1);
+    txData[0] = NRF_WRITE_CMD(NRF_STATUS_REG);
+    txData[1] = NRF_MAX_RT_MASK | NRF_TX_DS_MASK | NRF_RX_DR_MASK;
+    SpiReadWrite(payldConfig.spiSfr, rxData, txData, 2);
+    
+    /* Address registers are unknown after another send */
+    scatterLoaded = 0;
+    isScatterAddrValid = false;
+    opArc = (scatterArc > 0xFF) ? 0xFF : scatterArc;
+    
+    /* FIFO is filled before the first payload starts (which enables INTx),
+     * later ones are uploaded by the handler while a payload is on air */
+    ScatterLoad(payldConfig.spiSfr, 3);
+    TxStart(scatterPos == 0);       // Start event once per list, not on resumption
+    
+    BENCH_END();
+}
+
+
+/*
+ *  Uploads payloads of following items until TX FIFO holds "maxLoaded", where
+ *  address changes only on empty FIFO (all queued payloads share TX_ADDR)
+ */
+static void ScatterLoad(SpiSfr_t *spiSfr, uint8_t maxLoaded)
+{
+    while( (scatterLoaded < maxLoaded) && ((scatterPos + scatterLoaded) < scatterCount) )
+    {
+        NrfScatterItem_t *item = &scatterItems[scatterOrder[scatterPos + scatterLoaded]];
+        
+        if( !isScatterAddrValid || ((item->addr & 0xFFFFFFFFFF) != scatterAddr) )
+        {
+            if( scatterLoaded != 0 )
+            {
+                return;
+            }
+            ScatterWriteAddr(spiSfr, item->addr & 0xFFFFFFFFFF);
+        }
+        
+        uint8_t txSize = (item->txSize > 32) ? 32 : item->txSize;
+        SpiCommandBegin(spiSfr, isrPayldConfig.pinConfig.csPin, NRF_WRITE_TX_PL_CMD);
+        SpiPayloadReadWrite(spiSfr, NULL, item->txPtr, txSize);
+        SpiCommandEnd();
+        
+        scatterLoaded++;
+    }
+}
+
+
+/*
+ *  Writes full RX_ADDR_P0 (for ACK) and TX_ADDR (a write cut short by CS
+ *  release is not guaranteed to leave the upper bytes unchanged)
+ */
+static void ScatterWriteAddr(SpiSfr_t *spiSfr, uint64_t addr)
+{
+    uint64_t txData64;
+    uint64_t rxData64;
+    
+    txData64 = (addr << 8) | NRF_WRITE_CMD(NRF_RX_ADDR_P0_REG);
+    SpiReadWrite(spiSfr, &rxData64, &txData64, 6);
+    txData64 = (addr << 8) | NRF_WRITE_CMD(NRF_TX_ADDR_REG);
+    SpiReadWrite(spiSfr, &rxData64, &txData64, 6);
     
-    /* INTx interrupt source enabled */
+    scatterAddr = addr;
+    isScatterAddrValid = true;
+}
+
+
+/*
+ *  ISR handler for NRF_SendScatterOp(), concludes payload on air and starts
+ *  the next one (ACK payloads are discarded, MAX_RT is final as software
+ *  retry rounds are not supported for scatter items)
+ */
+static void ISR_NrfHandler_Scatter(void)
+{
+    BENCH_BEGIN(NRF_BENCH_READ_ACK_PAYLOAD);
+    
+    /* Edge triggered, so flag is cleared while transmission may be deferred */
     icSfr->ICxIFS0.CLR = NRF_INTxIF_MASK;
-    icSfr->ICxIEC0.SET = NRF_INTxIE_MASK;
     
-    /* Call user callback */
-    if (userClbkStartTransmission != NULL) {
-        userClbkStartTransmission();
+    /* Device responded, so timeout must not overwrite status */
+    isTimeoutEnabled = false;
+    
+    /* Read and clear nRF status */
+    txData[0] = NRF_WRITE_CMD(NRF_STATUS_REG);
+    txData[1] = NRF_MAX_RT_MASK | NRF_TX_DS_MASK | NRF_RX_DR_MASK;
+    SpiReadWrite(isrPayldConfig.spiSfr, rxData, txData, 2);
+    statusFlag = (rxData[0] & 0x70);
+    
+#if NRF_LBT_ENABLE
+    LbtComplete(isrPayldConfig.spiSfr, statusFlag);
+#endif
+    
+    txData[0] = NRF_READ_CMD(NRF_OBSERVE_TX_REG);
+    txData[1] = 0x00;
+    SpiReadWrite(isrPayldConfig.spiSfr, rxData, txData, 2);
+    
+    NrfScatterItem_t *item = &scatterItems[scatterOrder[scatterPos]];
+    item->arc = (rxData[1] & NRF_ARC_CNT_MASK) >> NRF_ARC_CNT_POS;
+    scatterArc += item->arc;
+    opArc = (scatterArc > 0xFF) ? 0xFF : scatterArc;
+    scatterPos++;
+    
+    if( statusFlag & NRF_FLAG_TX_DS )
+    {
+        item->status = NRF_FLAG_TX_DS;
+        scatterDelivered++;
+        scatterLoaded--;
+        
+        if( statusFlag & NRF_FLAG_RX_DR )
+        {
+            txData[0] = NRF_FLUSH_RX_CMD;
+            SpiReadWrite(isrPayldConfig.spiSfr, rxData, txData, 1);
+        }
+    }
+    /* Failed payload blocks FIFO top, payloads behind it are uploaded again */
+    else
+    {
+        item->status = NRF_FLAG_MAX_RT;
+        scatterLoaded = 0;
+        
+        txData[0] = NRF_FLUSH_TX_CMD;
+        SpiReadWrite(isrPayldConfig.spiSfr, rxData, txData, 1);
+    }
+    
+    /* All destinations concluded */
+    if( scatterPos >= scatterCount )
+    {
+        /* Disable INTx interrupt source */
+        icSfr->ICxIEC0.CLR = NRF_INTxIE_MASK;
+        
+        statusFlag = (scatterDelivered == scatterCount) ? NRF_FLAG_TX_DS : NRF_FLAG_MAX_RT;
+        EVENT(NRF_CLBK_TX_ACK_PAYLOAD_RECEIVE, NRF_RX_NO_PIPE, 0, statusFlag);
+        OpTxComplete(statusFlag, scatterDelivered);
+        
+        BENCH_END();
+        
+        /* Call user callback */
+        USER_CLBK(NRF_CLBK_TX_ACK_PAYLOAD_RECEIVE, userClbkReadAckPayload);
+        return;
+    }
+    
+    /* Urgent send takes over at packet boundary, payloads loaded behind the
+     * concluded one are uploaded again on resumption */
+    if( opQueueHead[NRF_TX_CLASS_URGENT] != OP_NONE )
+    {
+        icSfr->ICxIEC0.CLR = NRF_INTxIE_MASK;
+        
+        opSuspended = opTx;
+        opTx = OP_NONE;
+        txClassStats[NRF_TX_CLASS_BULK].preempted++;
+        
+        BENCH_END();
+        
+        OpTxStart();
+        return;
     }
+    
+    ScatterLoad(isrPayldConfig.spiSfr, 1);
+    TxStart(false);
+    ScatterLoad(isrPayldConfig.spiSfr, 3);
+    
+    BENCH_END();
 }
 
+#endif
+
+#if NRF_CAPTURE_ENABLE
+
 /*
- *  ISR handler for NRF_StoreAckPayload() (executed within scope of SPI ISR)
+ *  Appends a single record to capture ring, the record is dropped (and
+ *  reported by a gap record later) if it doesn't fit
  */
-static void ISR_NrfHandler_RestartReception(void)
-{    
-    /* Continue reception if initially started by NRF_StartReception() */
-    if( icSfr->ICxIEC0.W & NRF_INTxIE_MASK )
+static void CaptureRecord(uint8_t type, uint8_t length, volatile void *mosiPtr, volatile void *misoPtr)
+{
+    /* Records are written from multiple interrupt levels */
+    uint32_t intStatus = __builtin_disable_interrupts();
+    
+    if( !isCaptureStarted )
     {
-        PIO_SetPin(isrPayldConfig.pinConfig.cePin);
+        CaptureBegin();
     }
     
-    /* Reception may be activated (if not already) */
-    isRxFifoLoading = false;
+    uint32_t now = _CP0_GET_COUNT();
+    uint32_t delta = now - captureStamp;
+    
+    /* Pending gap record takes the delta, record follows it at once */
+    uint32_t gapSize = (captureLost != 0) ? (1 + CaptureVarintSize(delta) + CaptureVarintSize(captureLost)) : 0;
+    uint32_t size = gapSize + 1 + ((captureLost != 0) ? 1 : CaptureVarintSize(delta)) +
+                    ((type != NRF_CAPTURE_IRQ) ? 1 : 0) +
+                    ((mosiPtr != NULL) ? length : 0) + ((misoPtr != NULL) ? length : 0);
+    
+    if( size > (NRF_CAPTURE_SIZE - (captureHead - captureTail)) )
+    {
+        captureLost++;
+        captureLostTotal++;
+        __builtin_mtc0(12, 0, intStatus);
+        return;
+    }
+    
+    if( captureLost != 0 )
+    {
+        CAPTURE_PUT(NRF_CAPTURE_GAP);
+        CaptureVarint(delta);
+        CaptureVarint(captureLost);
+        captureLost = 0;
+        delta = 0;
+    }
+    
+    CAPTURE_PUT(type);
+    CaptureVarint(delta);
+    
+    if( type != NRF_CAPTURE_IRQ )
+    {
+        CAPTURE_PUT(length);
+    }
+    for(uint8_t i = 0; (mosiPtr != NULL) && (i < length); i++)
+    {
+        CAPTURE_PUT(((volatile uint8_t *)mosiPtr)[i]);
+    }
+    for(uint8_t i = 0; (misoPtr != NULL) && (i < length); i++)
+    {
+        CAPTURE_PUT(((volatile uint8_t *)misoPtr)[i]);
+    }
+    
+    captureStamp = now;
+    
+    __builtin_mtc0(12, 0, intStatus);
 }
 
+
 /*
- *  ISR handler for timeout of NRF_SendPayload()
+ *  Empties capture ring and writes stream header (interrupts disabled by
+ *  caller)
  */
-static void ISR_NrfTimeoutHandler_SendPayload(void)
+static void CaptureBegin(void)
 {
-    timeoutCount++;
-    if( (timeoutCount > timeoutVal) && (isTimeoutEnabled == true) )
+    uint32_t tickFreq = OSC_GetSysFreq() / 2;
+    
+    captureHead = 0;
+    captureTail = 0;
+    captureLost = 0;
+    
+    CAPTURE_PUT(NRF_CAPTURE_START);
+    CAPTURE_PUT(NRF_CAPTURE_VERSION);
+    for(uint8_t i = 0; i < 4; i++)
     {
-        statusFlag = NRF_FLAG_NO_RP;    // No response status
+        CAPTURE_PUT((uint8_t)(tickFreq >> (8 * i)));
+    }
+    CAPTURE_PUT(NRF_SPI_BURST_WIDTH);
+    
+    captureStamp = _CP0_GET_COUNT();
+    isCaptureStarted = true;
+}
 
-        /* Try clearing status even in case of unresponsive device */
-        txData[0] = NRF_WRITE_CMD(NRF_STATUS_REG);
-        txData[1] = NRF_MAX_RT_MASK | NRF_TX_DS_MASK | NRF_RX_DR_MASK;
-        SPI_MasterReadWrite(isrPayldConfig.spiSfr, rxData, txData, 2);
 
-        /* Disable current slave */
-        SPI_DisableSsState(isrPayldConfig.pinConfig.csPin);
-        
-        timeoutCount = 0;
-        isTimeoutEnabled = false;
+/*
+ *  Returns LEB128 encoded size of "value"
+ */
+INLINE static uint8_t CaptureVarintSize(uint32_t value)
+{
+    uint8_t size = 1;
+    
+    while( value >= 0x80 )
+    {
+        value >>= 7;
+        size++;
     }
     
-    /* Call user callback */
-    if (userClbkPayloadTimeout != NULL) {
-        userClbkPayloadTimeout();
+    return size;
+}
+
+
+/*
+ *  Appends "value" LEB128 encoded (7 bits per byte, LS group first)
+ */
+INLINE static void CaptureVarint(uint32_t value)
+{
+    while( value >= 0x80 )
+    {
+        CAPTURE_PUT((uint8_t)(value | 0x80));
+        value >>= 7;
     }
+    
+    CAPTURE_PUT((uint8_t)value);
 }
 
+
 /*
- *  Determines which external interrupt source is used based on pin code (which
- *  triggers ISR) and configures interrupt SFRs
+ *  ISR handler for captured SpiWriteAsync() (executed within scope of SPI ISR)
  */
-INLINE static void InterruptSfrConfig(const uint32_t pinCode)
+static void ISR_NrfHandler_CaptureSpiDone(void)
 {
-    /* Check which INTx is used by PPS register code */
-    uint8_t regCode = pinCode & 0xFF;
+    CaptureRecord(NRF_CAPTURE_SPI_DONE, (captureAsyncRxPtr != NULL) ? captureAsyncSize : 0, NULL, captureAsyncRxPtr);
     
-    icSfr->ICxIEC0.CLR = NRF_INTxIE_MASK;       // Disable source
+    captureAsyncClbkPtr();
+}
+
+#endif
+
+#if NRF_REPLAY_ENABLE
+
+/*
+ *  Parses record at replay position, returns false at the end of stream (or at
+ *  a truncated or unknown record)
+ */
+static bool ReplayParse(ReplayRecord_t *rec)
+{
+    const uint8_t *bytePtr = replayPtr;
     
-    /* External interrupt INT0 */
-    if( regCode == 0xFF )
+    if( (bytePtr == NULL) || (bytePtr >= replayEnd) )
     {
-        icSfr->ICxIPC0.CLR = (IC_INT0IS_MASK | IC_INT0IP_MASK);                                 // Clear (sub)priority
-        icSfr->ICxIPC0.SET = ((NRF_ICX_IPL << IC_INT0IS_POS) | (NRF_ICX_ISL << IC_INT0IP_POS)); // Set (sub)priority
-        icSfr->ICxINTCON.CLR = IC_INT0EP_MASK;  // Falling-edge triggered
+        return false;
     }
-    /* External interrupt INT1 */
-    else if( regCode == 0x04 )
+    
+    rec->type = *bytePtr++;
+    rec->length = 0;
+    rec->lost = 0;
+    rec->mosiPtr = NULL;
+    rec->misoPtr = NULL;
+    
+    if( !ReplayVarint(&bytePtr, &rec->delta) )
     {
-        icSfr->ICxIPC1.CLR = (IC_INT1IS_MASK | IC_INT1IP_MASK);
-        icSfr->ICxIPC1.SET = ((NRF_ICX_IPL << IC_INT1IS_POS) | (NRF_ICX_ISL << IC_INT1IP_POS));
-        icSfr->ICxINTCON.CLR = IC_INT1EP_MASK;
+        return false;
     }
-    /* External interrupt INT2 */
-    else if( regCode == 0x08 )
+    
+    switch( rec->type )
     {
-        icSfr->ICxIPC2.CLR = (IC_INT2IS_MASK | IC_INT2IP_MASK);
-        icSfr->ICxIPC2.SET = ((NRF_ICX_IPL << IC_INT2IS_POS) | (NRF_ICX_ISL << IC_INT2IP_POS));
-        icSfr->ICxINTCON.CLR = IC_INT2EP_MASK;
+        case NRF_CAPTURE_IRQ:
+            break;
+            
+        case NRF_CAPTURE_GAP:
+            if( !ReplayVarint(&bytePtr, &rec->lost) )
+            {
+                return false;
+            }
+            break;
+            
+        case NRF_CAPTURE_SPI:
+        case NRF_CAPTURE_SPI_TX:
+        case NRF_CAPTURE_SPI_ASYNC:
+        case NRF_CAPTURE_SPI_DONE:
+        case NRF_CAPTURE_TICK:
+            if( bytePtr >= replayEnd )
+            {
+                return false;
+            }
+            rec->length = *bytePtr++;
+            break;
+            
+        default:
+            return false;
     }
-    /* External interrupt INT3 */
-    else if( regCode == 0x0C )
+    
+    /* Body bytes */
+    uint32_t bodySize = 0;
+    if( (rec->type == NRF_CAPTURE_SPI) || (rec->type == NRF_CAPTURE_SPI_TX) || (rec->type == NRF_CAPTURE_SPI_ASYNC) )
     {
-        icSfr->ICxIPC3.CLR = (IC_INT3IS_MASK | IC_INT3IP_MASK);
-        icSfr->ICxIPC3.SET = ((NRF_ICX_IPL << IC_INT3IS_POS) | (NRF_ICX_ISL << IC_INT3IP_POS));
-        icSfr->ICxINTCON.CLR = IC_INT3EP_MASK;
+        rec->mosiPtr = bytePtr;
+        bodySize += rec->length;
     }
-    /* External interrupt INT4 */
-    else if( regCode == 0x10 )
+    if( (rec->type == NRF_CAPTURE_SPI) || (rec->type == NRF_CAPTURE_SPI_DONE) )
     {
-        icSfr->ICxIPC4.CLR = (IC_INT4IS_MASK | IC_INT4IP_MASK);
-        icSfr->ICxIPC4.SET = ((NRF_ICX_IPL << IC_INT4IS_POS) | (NRF_ICX_ISL << IC_INT4IP_POS));
-        icSfr->ICxINTCON.CLR = IC_INT4EP_MASK;
+        rec->misoPtr = bytePtr + bodySize;
+        bodySize += rec->length;
     }
-    /* False input */
-    else
+    
+    if( bodySize > (uint32_t)(replayEnd - bytePtr) )
+    {
+        return false;
+    }
+    
+    rec->nextPtr = bytePtr + bodySize;
+    
+    return true;
+}
+
+
+/*
+ *  Decodes LEB128 value, returns false if stream ends within it
+ */
+static bool ReplayVarint(const uint8_t **bytePtr, uint32_t *value)
+{
+    *value = 0;
+    
+    for(uint8_t shift = 0; (shift < 35) && (*bytePtr < replayEnd); shift += 7)
+    {
+        uint8_t byte = *(*bytePtr)++;
+        *value |= (uint32_t)(byte & 0x7F) << shift;
+        
+        if( (byte & 0x80) == 0 )
+        {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+
+/*
+ *  Serves a driver SPI transaction from the stream: MOSI is checked against
+ *  the recording and recorded MISO is returned. A transaction the recording
+ *  doesn't continue with leaves the stream in place and reads an idle bus
+ */
+static void ReplayTransaction(uint8_t type, volatile uint8_t *rxPtr, volatile uint8_t *txPtr, uint8_t length)
+{
+    uint32_t now = _CP0_GET_COUNT();
+    ReplayRecord_t rec;
+    bool isMatch = false;
+    
+    /* Capture gaps between transactions are passed silently */
+    while( ReplayParse(&rec) && (rec.type == NRF_CAPTURE_GAP) )
+    {
+        replayPtr = rec.nextPtr;
+        replayStats.records++;
+        replayStats.gaps++;
+    }
+    
+    if( ReplayParse(&rec) && (rec.type == type) && (rec.length == length) )
     {
+        isMatch = true;
+        for(uint8_t i = 0; i < length; i++)
+        {
+            isMatch &= (txPtr[i] == rec.mosiPtr[i]);
+            
+            if( rxPtr != NULL )
+            {
+                rxPtr[i] = (rec.misoPtr != NULL) ? rec.misoPtr[i] : 0xFF;
+            }
+        }
+        
+        /* Distance to previous record, replayed against recorded */
+        uint32_t ticks = now - replayStamp;
+        uint32_t delta = (ticks > rec.delta) ? (ticks - rec.delta) : (rec.delta - ticks);
         
+        replayStats.transactions++;
+        replayStats.recordedTicks += rec.delta;
+        replayStats.replayedTicks += ticks;
+        if( delta > replayStats.deltaMax )
+        {
+            replayStats.deltaMax = delta;
+        }
+        
+        replayPtr = rec.nextPtr;
+        replayStats.records++;
+    }
+    else
+    {
+        for(uint8_t i = 0; (rxPtr != NULL) && (i < length); i++)
+        {
+            rxPtr[i] = 0xFF;
+        }
     }
     
-    icSfr->ICxIFS0.CLR = NRF_INTxIF_MASK;       // Clear flag
+    if( !isMatch )
+    {
+        ReplayMismatch();
+    }
+    
+    replayStamp = now;
 }
 
+
+/*
+ *  Counts a divergence from the recording
+ */
+static void ReplayMismatch(void)
+{
+    if( replayStats.mismatches++ == 0 )
+    {
+        replayStats.firstMismatch = replayStats.records;
+    }
+}
+
+#endif
+
 /******************************************************************************/
 /*-----------------------------ISR  Definition--------------------------------*/
 /******************************************************************************/
@@ -959,8 +5172,56 @@ INLINE static void InterruptSfrConfig(const uint32_t pinCode)
  */
 void __ISR(NRF_ISR_VECTOR, NRF_ISR_IPL) ISR_Nrf(void)
 {
+    PROFILE_BEGIN();
+    TRACE(NRF_TRACE_ISR_ENTRY, 0x00, 0, 0xFF);
+    
+#if NRF_ISR_PROFILE_ENABLE
+    /* Flag was raised by NRF_ProbeIsrLatency() */
+    if( isProbePending )
+    {
+        ProfileRecord(NRF_PROFILE_IRQ_LATENCY, profileStart - probeStamp);
+        isProbePending = false;
+        
+        /* Restore source state from before the probe */
+        if( !isProbeIecSet )
+        {
+            icSfr->ICxIEC0.CLR = NRF_INTxIE_MASK;
+        }
+        
+        /* No nRF event behind the flag (IRQ line is active-low) */
+        if( PIO_ReadPin(irqPin) )
+        {
+            icSfr->ICxIFS0.CLR = NRF_INTxIF_MASK;
+        }
+    }
+#endif
+    
     if( (icSfr->ICxIEC0.W & NRF_INTxIE_MASK) && (icSfr->ICxIFS0.W & NRF_INTxIF_MASK) )
     {   
-        isrHandlerPtr();
+        CAPTURE_IRQ();
+        
+        /* Handler may be reconfigured by a user callback */
+        void (*handlerPtr)(void) = isrHandlerPtr;
+        handlerPtr();
+        
+        PROFILE_END(ProfileHandlerSel(handlerPtr));
     } 
-}
\ No newline at end of file
+    
+    TRACE(NRF_TRACE_ISR_EXIT, 0x00, 0, 0xFF);
+}
+
+
+#if NRF_EVENT_ENABLE && NRF_EVENT_SWI_ENABLE
+
+/*
+ *  Software ISR for deferred event dispatch (runs below INTx priority)
+ */
+void __ISR(NRF_EVENT_VECTOR, NRF_EVENT_IPL) ISR_NrfEvent(void)
+{
+    _CP0_BIC_CAUSE(_CP0_CAUSE_IP0_MASK);
+    icSfr->ICxIFS0.CLR = IC_CS0IF_MASK;
+    
+    NRF_ProcessEvents();
+}
+
+#endif
\ No newline at end of file
@@ -24,9 +24,8 @@
 /* NOTE: Vectors of same priority and sub-priority are services in their
  *       natural order */
 
-/* User-defined (sub)priority levels (IPL: 0-7, ISL: 0-3) */
-#define NRF_ISR_IPL     IPL1SOFT
-#define NRF_ICX_IPL     1
+/* User-defined (sub)priority levels (IPL: 0-7, ISL: 0-3), NRF_ISR_IPL and
+ * NRF_ICX_IPL follow the event queue options below */
 #define NRF_ICX_ISL     1
 
 /******************************************************************************/
@@ -72,6 +71,205 @@
 
 #endif
 
+/******************************Optional features*******************************/
+
+/* NOTE: Optional features are disabled (0) by default and compile to nothing.
+ *       Each switch may also be overridden from the command line (-Dxxx=1) */
+
+/* Per-path SPI and CPU cost counters, see NRF_ReadBenchStats() */
+#ifndef NRF_BENCH_ENABLE
+#define NRF_BENCH_ENABLE        0
+#endif
+
+/* SPI command and ISR event trace ring, see NRF_ReadTrace() */
+#ifndef NRF_TRACE_ENABLE
+#define NRF_TRACE_ENABLE        0
+#endif
+
+/* Number of trace records kept (must be a power of two) */
+#ifndef NRF_TRACE_DEPTH
+#define NRF_TRACE_DEPTH         64
+#endif
+
+/* ISR latency and execution time statistics, see NRF_ReadIsrProfile() */
+#ifndef NRF_ISR_PROFILE_ENABLE
+#define NRF_ISR_PROFILE_ENABLE  0
+#endif
+
+/* Histogram bins: bin 0 < 64 ticks, bin i < 64 << i ticks, last bin open */
+#define NRF_PROFILE_BINS        8
+
+/* SPI frame width (8, 16 or 32 bits) used for whole words of W_TX_PAYLOAD,
+ * R_RX_PAYLOAD and W_ACK_PAYLOAD payloads (commands and leading 1-3 bytes
+ * always use 8-bit frames) */
+#ifndef NRF_SPI_BURST_WIDTH
+#define NRF_SPI_BURST_WIDTH     8
+#endif
+
+/* Number of operation records shared by all pending and unreleased handles,
+ * see NRF_SendPayloadOp() */
+#ifndef NRF_OP_POOL_SIZE
+#define NRF_OP_POOL_SIZE        8
+#endif
+
+/* Handle value returned when no operation could be started */
+#define NRF_OP_INVALID          ((NrfOpHandle_t)0)
+
+/* Deferred event queue for user handlers, see NRF_SetEventHandler() */
+#ifndef NRF_EVENT_ENABLE
+#define NRF_EVENT_ENABLE        0
+#endif
+
+/* Number of queued events (must be a power of two) */
+#ifndef NRF_EVENT_DEPTH
+#define NRF_EVENT_DEPTH         16
+#endif
+
+/* Events are dispatched from Core Software Interrupt 0 (1) or only by
+ * NRF_ProcessEvents() from main loop (0) */
+#ifndef NRF_EVENT_SWI_ENABLE
+#define NRF_EVENT_SWI_ENABLE    0
+#endif
+
+/* Software interrupt priority (NRF_EVENT_ICX_IPL must be lower than
+ * NRF_ICX_IPL, NRF_EVENT_IPL must equal NRF_EVENT_ICX_IPL) */
+#define NRF_EVENT_VECTOR        _CORE_SOFTWARE_0_VECTOR
+#define NRF_EVENT_IPL           IPL1SOFT
+#define NRF_EVENT_ICX_IPL       1
+#define NRF_EVENT_ICX_ISL       0
+
+/* INTx priority 1, raised to 2 only with the software interrupt so deferred
+ * events never run at INTx priority */
+#if NRF_EVENT_ENABLE && NRF_EVENT_SWI_ENABLE
+#define NRF_ISR_IPL             IPL2SOFT
+#define NRF_ICX_IPL             2
+#else
+#define NRF_ISR_IPL             IPL1SOFT
+#define NRF_ICX_IPL             1
+#endif
+
+/* SCK calibration at configuration time, see NRF_ReadSckFreq() */
+#ifndef NRF_SCK_CALIBRATION_ENABLE
+#define NRF_SCK_CALIBRATION_ENABLE  0
+#endif
+
+/* Upper SCK limit for calibration (nRF24L01+ maximum is 10 MHz) */
+#ifndef NRF_SCK_MAX_FREQ
+#define NRF_SCK_MAX_FREQ        10000000
+#endif
+
+/* Baud rate steps backed off from the fastest passing SCK as safety margin */
+#ifndef NRF_SCK_MARGIN_STEPS
+#define NRF_SCK_MARGIN_STEPS    1
+#endif
+
+/* PRX duplicate filter on first payload byte (sequence number), see
+ * NRF_ReadDedupStats() */
+#ifndef NRF_DEDUP_ENABLE
+#define NRF_DEDUP_ENABLE        0
+#endif
+
+/* Sources (pipe addresses) tracked at once (must be a power of two) */
+#ifndef NRF_DEDUP_SLOTS
+#define NRF_DEDUP_SLOTS         16
+#endif
+
+/* Table slots probed per payload (bounds ISR time), the least recently seen
+ * source is replaced when none of them matches */
+#ifndef NRF_DEDUP_PROBES
+#define NRF_DEDUP_PROBES        4
+#endif
+
+/* Sequence numbers remembered behind the newest one of each source */
+#define NRF_DEDUP_WINDOW        32
+
+/* Binary record of every SPI exchange, INTx entry and timing core timer tick,
+ * see NRF_ReadCapture() */
+#ifndef NRF_CAPTURE_ENABLE
+#define NRF_CAPTURE_ENABLE      0
+#endif
+
+/* Capture ring size in bytes (must be a power of two) */
+#ifndef NRF_CAPTURE_SIZE
+#define NRF_CAPTURE_SIZE        2048
+#endif
+
+/* Driver runs against a captured stream instead of SPI, see NRF_ReplayLoad()
+ * (excludes NRF_CAPTURE_ENABLE) */
+#ifndef NRF_REPLAY_ENABLE
+#define NRF_REPLAY_ENABLE       0
+#endif
+
+/* PTX listen-before-talk: received power is sampled before every send and a
+ * busy channel defers it, see NRF_ReadLbtStats() */
+#ifndef NRF_LBT_ENABLE
+#define NRF_LBT_ENABLE          0
+#endif
+
+/* Listen time from RPD valid (170 us after entering RX) to the RPD sample */
+#ifndef NRF_LBT_WINDOW_US
+#define NRF_LBT_WINDOW_US       100
+#endif
+
+/* Upper limit of the doubling backoff window in core timer callback periods
+ * (1 ms, must be a power of two) */
+#ifndef NRF_LBT_MAX_BACKOFF
+#define NRF_LBT_MAX_BACKOFF     16
+#endif
+
+/* Deferrals of one payload after which it is sent regardless of channel */
+#ifndef NRF_LBT_MAX_DEFERRALS
+#define NRF_LBT_MAX_DEFERRALS   8
+#endif
+
+/* Software-managed retransmission: MAX_RT starts another round of hardware
+ * retransmits with a randomized ARD, see NRF_ReadRetryStats() */
+#ifndef NRF_RETRY_ENABLE
+#define NRF_RETRY_ENABLE        0
+#endif
+
+/* Rounds added after the first MAX_RT of a payload */
+#ifndef NRF_RETRY_ROUNDS
+#define NRF_RETRY_ROUNDS        3
+#endif
+
+/* Register health check against configuration shadow with restoration of
+ * differing registers, see NRF_CheckHealth() */
+#ifndef NRF_HEALTH_ENABLE
+#define NRF_HEALTH_ENABLE       0
+#endif
+
+/* Multi-destination send of address-sorted payloads as a single operation,
+ * see NRF_SendScatterOp() (items are not retried by NRF_RETRY_ENABLE) */
+#ifndef NRF_SCATTER_ENABLE
+#define NRF_SCATTER_ENABLE      0
+#endif
+
+/* Most destinations per scatter send (up to 255) */
+#ifndef NRF_SCATTER_MAX_ITEMS
+#define NRF_SCATTER_MAX_ITEMS   64
+#endif
+
+/* Capture stream format version */
+#define NRF_CAPTURE_VERSION     1
+
+/* NOTE: Capture stream layout (multi-byte values little-endian)
+ *       Stream starts with NRF_CAPTURE_START record:
+ *       [0]      0x00
+ *       [1]      NRF_CAPTURE_VERSION
+ *       [2-5]    Core timer frequency in Hz
+ *       [6]      NRF_SPI_BURST_WIDTH
+ *       Every following record is [type][delta][body], "delta" being core
+ *       timer ticks since previous record (LEB128, 1-5 bytes), body by type:
+ *       NRF_CAPTURE_SPI         [len][MOSI x len][MISO x len]
+ *       NRF_CAPTURE_SPI_TX      [len][MOSI x len] (MISO discarded by driver)
+ *       NRF_CAPTURE_SPI_ASYNC   [len][MOSI x len]
+ *       NRF_CAPTURE_SPI_DONE    [len][MISO x len] (len 0 if discarded)
+ *       NRF_CAPTURE_IRQ         (none)
+ *       NRF_CAPTURE_TICK        [timer handler, NrfCaptureTick_t]
+ *       NRF_CAPTURE_GAP         [records lost on full ring (LEB128)]
+ *       Buffers of wide SPI frames are recorded as laid out in memory */
+
 /******************************************************************************/
 /*----------------------------Enumeration Types-------------------------------*/
 /******************************************************************************/
@@ -298,12 +496,117 @@ typedef enum {
     NRF_CLBK_TX_ACK_PAYLOAD_RECEIVE = 1,
     NRF_CLBK_TX_START = 3,
     NRF_CLBK_TX_TIMEOUT = 4,
+    NRF_CLBK_CONFIG_DONE = 5,
 } NrfUserCallback_t;
 
+/* Transmit classes of queued sends, urgent sends start before any bulk send */
+typedef enum {
+    NRF_TX_CLASS_BULK = 0,          // NRF_SendPayloadOp(), NRF_SendScatterOp()
+    NRF_TX_CLASS_URGENT = 1,        // NRF_SendUrgentOp()
+    NRF_TX_CLASS_COUNT = 2
+} NrfTxClass_t;
+
+typedef enum {
+    NRF_BENCH_SEND_PAYLOAD = 0,
+    NRF_BENCH_SEND_RECEIVE_PAYLOAD = 1,
+    NRF_BENCH_READ_PAYLOAD = 2,
+    NRF_BENCH_STORE_ACK_PAYLOAD = 3,
+    NRF_BENCH_READ_ACK_PAYLOAD = 4,
+    NRF_BENCH_PATH_COUNT = 5
+} NrfBenchPath_t;
+
+typedef enum {
+    NRF_TRACE_SPI = 0,              // Blocking SPI transaction concluded
+    NRF_TRACE_SPI_ASYNC = 1,        // Interrupt-based SPI transaction started
+    NRF_TRACE_SPI_DONE = 2,         // Interrupt-based SPI transaction concluded
+    NRF_TRACE_ISR_ENTRY = 3,        // INTx ISR entered (IRQ line asserted)
+    NRF_TRACE_ISR_EXIT = 4,         // INTx ISR left
+    NRF_TRACE_PAYLOAD_READY = 5     // Payload copied into user RX buffer
+} NrfTraceEvent_t;
+
+typedef enum {
+    NRF_PROFILE_IRQ_LATENCY = 0,            // INTx flag set to ISR entry
+    NRF_PROFILE_READ_ACK_PAYLOAD = 1,       // INTx handlers (incl. user callback)
+    NRF_PROFILE_READ_PAYLOAD = 2,
+    NRF_PROFILE_SEND_PAYLOAD_CONT = 3,      // SPI ISR continuations
+    NRF_PROFILE_READ_PAYLOAD_CONT = 4,
+    NRF_PROFILE_START_TRANSMISSION = 5,
+    NRF_PROFILE_RESTART_RECEPTION = 6,
+    NRF_PROFILE_SEND_QUEUED = 7,            // INTx handlers raised by driver
+    NRF_PROFILE_SCATTER = 8,
+    NRF_PROFILE_COUNT = 9
+} NrfProfileSel_t;
+
+typedef enum {
+    NRF_HEALTH_OK = 0,              // Key registers hold configured values
+    NRF_HEALTH_RESTORED = 1,        // Registers differed and were rewritten
+    NRF_HEALTH_BUSY = 2,            // Configuration or transfer in progress, not checked
+    NRF_HEALTH_NO_RP = 3            // Device not responding
+} NrfHealthResult_t;
+
+typedef enum {
+    NRF_CAPTURE_START = 0,          // Stream header
+    NRF_CAPTURE_SPI = 1,            // Blocking SPI transaction
+    NRF_CAPTURE_SPI_TX = 2,         // Blocking SPI transaction without MISO
+    NRF_CAPTURE_SPI_ASYNC = 3,      // Interrupt-based SPI transaction started
+    NRF_CAPTURE_SPI_DONE = 4,       // Interrupt-based SPI transaction concluded
+    NRF_CAPTURE_IRQ = 5,            // INTx ISR entered with nRF IRQ pending
+    NRF_CAPTURE_TICK = 6,           // Core timer tick with a timeout running
+    NRF_CAPTURE_GAP = 7             // Records lost before this one
+} NrfCaptureType_t;
+
+typedef enum {
+    NRF_CAPTURE_TICK_SEND_PAYLOAD = 0,  // Payload send timeout
+    NRF_CAPTURE_TICK_CONFIG = 1         // Asynchronous configuration
+} NrfCaptureTick_t;
+
+typedef enum {
+    NRF_REPLAY_STEP = 0,            // Recorded IRQ, SPI completion or tick delivered
+    NRF_REPLAY_WAIT = 1,            // Next record is a transaction started by driver API
+    NRF_REPLAY_END = 2              // Stream exhausted
+} NrfReplayResult_t;
+
 /******************************************************************************/
 /*-----------------------------Data Structures--------------------------------*/
 /******************************************************************************/
 
+/* Deferred driver event, kind matches user callback type */
+typedef struct {
+    uint32_t            timestamp;      // Core timer count when recorded
+    NrfUserCallback_t   kind;
+    NrfRxPipeNo_t       pipeNo;         // NRF_RX_NO_PIPE if not applicable
+    uint8_t             length;         // Payload length (0 if none)
+    NrfStatusFlag_t     status;
+} NrfEvent_t;
+
+/* Deferred event handler */
+typedef void (*NrfEventHandler_t)(const NrfEvent_t *event, void *context);
+
+/* Receive sink, called from ISR with each received payload */
+typedef void (*NrfRxSink_t)(const uint8_t *payldPtr, uint8_t length, NrfRxPipeNo_t pipeNo);
+
+/* Operation handle (record index and its generation) */
+typedef uint32_t NrfOpHandle_t;
+
+/* Final result of a single operation (see NRF_PollOp()) */
+typedef struct {
+    NrfStatusFlag_t status;         // NRF_FLAG_NO_STATUS for ACK payload load
+    uint8_t         arc;            // Retransmissions of sent payload
+    uint8_t         length;         // ACK payload, received or loaded length
+    NrfRxPipeNo_t   pipeNo;         // Receiving or loaded pipe
+    uint32_t        timestamp;      // Core timer count at completion
+} NrfOpResult_t;
+
+/* Send queue counters of a transmit class, delays in core timer ticks from
+ * queueing until the send starts (see NRF_SendUrgentOp()) */
+typedef struct {
+    uint32_t    queued;
+    uint32_t    started;
+    uint32_t    preempted;          // Scatter sends suspended for urgent sends
+    uint32_t    delayMean;
+    uint32_t    delayMax;
+} NrfTxClassStats_t;
+
 /* Pin settings for nRF device (SPI pins handled by SpiStandardConfig_t type) */
 typedef struct {
     uint32_t    cePin;
@@ -350,18 +653,125 @@ typedef struct {
     uint64_t                pipeAddr;       // Only for PTX
 } NrfPayloadConfig_t;
 
+/* Second radio on its own SPI module, driven by an add-on module (see
+ * NRF_RadioConfigPtx()), it shares no state with the driver radio */
+typedef struct {
+    SpiSfr_t           *spiSfr;
+    NrfPinConfig_t      pinConfig;
+    volatile uint8_t    txData[2];
+    volatile uint8_t    rxData[2];
+} NrfRadio_t;
+
+/* Accumulated cost of a single API path (see NrfBenchPath_t) */
+typedef struct {
+    uint32_t    calls;
+    uint32_t    spiTransactions;
+    uint32_t    spiBytes;
+    uint32_t    copyIterations;     // Byte copies between user and driver buffers
+    uint32_t    coreTicks;          // CPU time in driver code (1 tick = 2 SYSCLK)
+} NrfBenchStats_t;
+
+/* Single trace ring entry (see NrfTraceEvent_t) */
+typedef struct {
+    uint32_t    timestamp;          // Core timer count
+    uint8_t     event;              // NrfTraceEvent_t
+    uint8_t     command;            // nRF command byte (opcode and register)
+    uint8_t     length;             // Transaction or payload length in bytes
+    uint8_t     status;             // nRF STATUS byte (0xFF if not clocked in)
+} NrfTraceRecord_t;
+
+/* Latency or execution time statistics in core timer ticks (see NrfProfileSel_t) */
+typedef struct {
+    uint32_t    count;
+    uint32_t    min;
+    uint32_t    max;
+    uint32_t    mean;
+    uint32_t    histogram[NRF_PROFILE_BINS];
+} NrfIsrProfile_t;
+
+/* Duplicate filter counters (see NRF_ReadDedupStats()) */
+typedef struct {
+    uint32_t    accepted;           // Payloads passed on
+    uint32_t    duplicates;         // Payloads dropped as retransmissions
+    uint32_t    resyncs;            // Sequence jumped behind window (source restarted)
+    uint32_t    evictions;          // Sources replaced on full table
+} NrfDedupStats_t;
+
+/* Listen-before-talk counters (see NRF_ReadLbtStats()) */
+typedef struct {
+    uint32_t    checks;             // Channel samples taken
+    uint32_t    deferrals;          // Samples that found the channel busy
+    uint32_t    forced;             // Payloads sent busy after NRF_LBT_MAX_DEFERRALS
+    uint32_t    avoided;            // Deferred payloads then acknowledged at first attempt
+} NrfLbtStats_t;
+
+/* Software retransmission counters (see NRF_ReadRetryStats()), ARD index is
+ * the SETUP_RETR field value (250 us steps) */
+typedef struct {
+    uint32_t    payloads;           // Sends concluded with TX_DS or final MAX_RT
+    uint32_t    attempts;           // Transmissions incl. hardware retransmits
+    uint32_t    rounds;             // Rounds started after MAX_RT
+    uint32_t    recovered;          // Payloads delivered in an added round
+    uint32_t    exhausted;          // Payloads lost after NRF_RETRY_ROUNDS rounds
+    uint32_t    ardRounds[16];      // Added rounds by drawn ARD
+    uint32_t    ardRecovered[16];   // Added rounds by drawn ARD that delivered
+} NrfRetryStats_t;
+
+/* Health check counters (see NRF_CheckHealth()), recovery time in core timer
+ * ticks from detection to restored registers (power-up settling included) */
+typedef struct {
+    uint32_t    checks;
+    uint32_t    detections;         // Checks that found differing registers
+    uint32_t    restoredRegs;       // Registers and pipe addresses rewritten
+    uint32_t    unresponsive;       // Checks without device response
+    uint32_t    recoveryLast;
+    uint32_t    recoveryMax;
+} NrfHealthStats_t;
+
+/* Single destination of scatter send (see NRF_SendScatterOp()), "status" and
+ * "arc" are written once its payload concludes */
+typedef struct {
+    uint64_t            addr;
+    void               *txPtr;
+    uint8_t             txSize;
+    NrfStatusFlag_t     status;     // NRF_FLAG_NO_RP until concluded
+    uint8_t             arc;
+} NrfScatterItem_t;
+
+/* Replay results, timing compares each driver transaction's distance to the
+ * previous record against the recorded one (core timer ticks) */
+typedef struct {
+    uint32_t    records;            // Records consumed
+    uint32_t    mismatches;         // Driver transactions differing from recording
+    uint32_t    firstMismatch;      // Record index of first mismatch (UINT32_MAX if none)
+    uint32_t    gaps;               // Capture gaps passed (replay may diverge after)
+    uint32_t    transactions;       // Driver transactions timed
+    uint32_t    recordedTicks;      // Sum of recorded distances
+    uint32_t    replayedTicks;      // Sum of replayed distances
+    uint32_t    deltaMax;           // Largest distance difference of one transaction
+} NrfReplayStats_t;
+
 /******************************************************************************/
 /*---------------------------- Function Prototypes----------------------------*/
 /******************************************************************************/
 
+/* NOTE: Payloads are not staged in driver buffers. "txPtr" of NRF_Send*(),
+ *       NRF_StoreAckPayload() and NRF_Send*Op() is clocked out directly, so it
+ *       must stay valid and unmodified until transmission starts
+ *       (NRF_CLBK_TX_START) or the FIFO upload ends (NRF_IsRxFifoLoading()).
+ *       "rxPtr" is written directly by the SPI transfer. With wide frames
+ *       (NRF_SPI_BURST_WIDTH) words pass through a byte-swapping staging
+ *       buffer, "txPtr" is only read and may point to flash */
 /* PTX functions */
 bool NRF_ConfigPtxSfr(const NrfPtxConfig_t ptxConfig);
+bool NRF_ConfigPtxSfrAsync(const NrfPtxConfig_t ptxConfig);
 bool NRF_SendReceivePayload(NrfPayloadConfig_t payldConfig, void *rxPtr, void *txPtr, uint8_t txSize);
 bool NRF_SendPayload(NrfPayloadConfig_t payldConfig, void *rxPtr, void *txPtr, uint8_t txSize);
 INLINE NrfPayloadConfig_t NRF_ConfigPtxPayloadStruct(NrfPtxConfig_t ptxConfig, const uint64_t pipeAddr);
 
 /* PRX functions */
 bool NRF_ConfigPrxSfr(const NrfPrxConfig_t prxConfig);
+bool NRF_ConfigPrxSfrAsync(const NrfPrxConfig_t prxConfig);
 bool NRF_StoreAckPayload(NrfPayloadConfig_t payldConfig, NrfRxPipeNo_t pipeNo, void *txPtr, uint8_t txSize);
 bool NRF_StartReception(NrfPayloadConfig_t payldConfig, void *rxPtr);
 bool NRF_StopReception(NrfPayloadConfig_t payldConfig);
@@ -372,8 +782,108 @@ INLINE NrfPayloadConfig_t NRF_ConfigPrxPayloadStruct(NrfPrxConfig_t prxConfig);
 
 /* PTX and PRX functions */
 NrfStatusFlag_t NRF_ReadStatus(void);
+bool NRF_IsConfigDone(void);
+bool NRF_SwitchToPrx(NrfPayloadConfig_t payldConfig, const uint64_t rxAddr, void *rxPtr);
+bool NRF_SwitchToPtx(NrfPayloadConfig_t payldConfig);
+uint32_t NRF_ReadSwitchEstimate(void);
+
+/* Operation handle functions */
+NrfOpHandle_t NRF_SendPayloadOp(NrfPayloadConfig_t payldConfig, void *rxPtr, void *txPtr, uint8_t txSize);
+NrfOpHandle_t NRF_StoreAckPayloadOp(NrfPayloadConfig_t payldConfig, NrfRxPipeNo_t pipeNo, void *txPtr, uint8_t txSize);
+NrfOpHandle_t NRF_ReceivePayloadOp(NrfPayloadConfig_t payldConfig, void *rxPtr);
+bool NRF_PollOp(NrfOpHandle_t opHandle, NrfOpResult_t *result);
+bool NRF_WaitOp(NrfOpHandle_t opHandle, NrfOpResult_t *result, uint32_t timeoutMs);
+bool NRF_ReleaseOp(NrfOpHandle_t opHandle);
+NrfOpHandle_t NRF_SendUrgentOp(NrfPayloadConfig_t payldConfig, void *rxPtr, void *txPtr, uint8_t txSize);
+bool NRF_ReadTxClassStats(NrfTxClass_t txClass, NrfTxClassStats_t *stats);
+void NRF_ResetTxClassStats(void);
 void NRF_SetUserCallback(NrfUserCallback_t cType, void (*fPtr)(void));
 void NRF_ReleaseUserCallback(NrfUserCallback_t cType);
+void NRF_SetRxSink(NrfRxSink_t sinkPtr);
+
+/* Second radio functions */
+bool NRF_RadioConfigPtx(NrfRadio_t *radio, const NrfPtxConfig_t ptxConfig, const uint64_t txAddr);
+uint8_t NRF_RadioClearFlags(NrfRadio_t *radio, uint8_t flagMask);
+bool NRF_RadioIsTxFifoEmpty(NrfRadio_t *radio);
+void NRF_RadioWriteTx(NrfRadio_t *radio, uint8_t *frame, uint8_t length);
+void NRF_RadioFlushTx(NrfRadio_t *radio);
+void NRF_RadioSetCe(NrfRadio_t *radio, bool isHigh);
+
+#if NRF_BENCH_ENABLE
+/* Benchmark functions */
+bool NRF_ReadBenchStats(NrfBenchPath_t path, NrfBenchStats_t *stats);
+void NRF_ResetBenchStats(void);
+#endif
+
+#if NRF_TRACE_ENABLE
+/* Trace functions */
+uint32_t NRF_ReadTrace(NrfTraceRecord_t *bufPtr, uint32_t maxCount);
+void NRF_ClearTrace(void);
+#endif
+
+#if NRF_ISR_PROFILE_ENABLE
+/* ISR profiling functions */
+bool NRF_ProbeIsrLatency(void);
+bool NRF_ReadIsrProfile(NrfProfileSel_t sel, NrfIsrProfile_t *profile);
+void NRF_ResetIsrProfile(void);
+#endif
+
+#if NRF_EVENT_ENABLE
+/* Deferred event functions */
+bool NRF_SetEventHandler(NrfUserCallback_t cType, NrfEventHandler_t handler, void *context);
+uint32_t NRF_ProcessEvents(void);
+uint32_t NRF_ReadDroppedEvents(void);
+#endif
+
+#if NRF_SCK_CALIBRATION_ENABLE
+/* SCK calibration functions */
+uint32_t NRF_ReadSckFreq(void);
+bool NRF_CheckSckFreq(void);
+#endif
+
+#if NRF_DEDUP_ENABLE
+/* Duplicate filter functions */
+void NRF_ReadDedupStats(NrfDedupStats_t *stats);
+void NRF_ResetDedup(void);
+#endif
+
+#if NRF_LBT_ENABLE
+/* Listen-before-talk functions */
+void NRF_ReadLbtStats(NrfLbtStats_t *stats);
+void NRF_ResetLbtStats(void);
+#endif
+
+#if NRF_RETRY_ENABLE
+/* Software retransmission functions */
+void NRF_ReadRetryStats(NrfRetryStats_t *stats);
+void NRF_ResetRetryStats(void);
+#endif
+
+#if NRF_HEALTH_ENABLE
+/* Health check functions */
+NrfHealthResult_t NRF_CheckHealth(void);
+void NRF_ReadHealthStats(NrfHealthStats_t *stats);
+void NRF_ResetHealthStats(void);
+#endif
+
+#if NRF_SCATTER_ENABLE
+/* Scatter send */
+NrfOpHandle_t NRF_SendScatterOp(NrfPayloadConfig_t payldConfig, NrfScatterItem_t *items, uint8_t count);
+#endif
+
+#if NRF_CAPTURE_ENABLE
+/* Capture functions */
+uint32_t NRF_ReadCapture(uint8_t *bufPtr, uint32_t maxSize);
+void NRF_ClearCapture(void);
+uint32_t NRF_ReadCaptureLost(void);
+#endif
+
+#if NRF_REPLAY_ENABLE
+/* Replay functions */
+bool NRF_ReplayLoad(const uint8_t *streamPtr, uint32_t size);
+NrfReplayResult_t NRF_ReplayStep(void);
+void NRF_ReadReplayStats(NrfReplayStats_t *stats);
+#endif
 
 /******************************************************************************/
 /*-----------------------------Function In-lines------------------------------*/
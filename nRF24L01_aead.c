@@ -0,0 +1,358 @@
+#include "nRF24L01_aead.h"
+
+/** Standard libs **/
+#include <string.h>
+
+/******************************************************************************/
+/*--------------------------------Local Macros--------------------------------*/
+/******************************************************************************/
+
+#define ROTL32(v, n)            (((v) << (n)) | ((v) >> (32 - (n))))
+
+#define CHACHA_QR(a, b, c, d)   do {                                        \
+                                    a += b; d ^= a; d = ROTL32(d, 16);      \
+                                    c += d; b ^= c; b = ROTL32(b, 12);      \
+                                    a += b; d ^= a; d = ROTL32(d, 8);       \
+                                    c += d; b ^= c; b = ROTL32(b, 7);       \
+                                } while(0)
+
+/* Padded ciphertext and length block */
+#define AEAD_MAC_SIZE           (((NRF_AEAD_MAX_DATA + 15) & ~15) + 16)
+
+#define POLY_MASK26             0x3FFFFFF
+
+/******************************************************************************/
+/*------------------------Local Function Prototypes---------------------------*/
+/******************************************************************************/
+
+static void AeadMaterial(NrfAeadCtx_t *ctx, uint32_t counter);
+static void ChachaBlock(const NrfAeadCtx_t *ctx, uint32_t counter, uint32_t block, uint8_t *outPtr);
+static void AeadTag(const uint8_t *polyKey, const uint8_t *cipherPtr, uint8_t size, uint8_t *tagPtr);
+static void Poly1305(const uint8_t *key, const uint8_t *msgPtr, uint8_t blocks, uint8_t *tagPtr);
+static inline uint32_t Le32Read(const uint8_t *bufPtr);
+static inline void Le32Write(uint8_t *bufPtr, uint32_t value);
+
+
+/******************************************************************************/
+/*----------------------External Function Definitions-------------------------*/
+/******************************************************************************/
+
+/*
+ *  Initializes one direction of a link with a 32-byte key and direction salt
+ */
+extern void NRF_AeadInit(NrfAeadCtx_t *ctx, const uint8_t *keyPtr, uint32_t salt)
+{
+    memset(ctx, 0, sizeof(NrfAeadCtx_t));
+    
+    for(uint8_t i = 0; i < 8; i++)
+    {
+        ctx->key[i] = Le32Read(&keyPtr[4 * i]);
+    }
+    ctx->salt = salt;
+}
+
+
+/*
+ *  Generates one-time material of the next frame (call while the radio is busy,
+ *  e.g. during air time of the previous frame)
+ */
+extern void NRF_AeadPrecompute(NrfAeadCtx_t *ctx)
+{
+    if( ctx->isPrecomputed && (ctx->preCounter == ctx->counter) )
+    {
+        return;
+    }
+    
+    uint32_t start = _CP0_GET_COUNT();
+    AeadMaterial(ctx, ctx->counter);
+    ctx->precomputeTicks += _CP0_GET_COUNT() - start;
+}
+
+
+/*
+ *  Encrypts and authenticates plaintext into "framePtr" (frame size is
+ *  plaintext size + NRF_AEAD_OVERHEAD)
+ */
+extern bool NRF_AeadSeal(NrfAeadCtx_t *ctx, const void *plainPtr, uint8_t plainSize, uint8_t *framePtr, uint8_t *frameSizePtr)
+{
+    /* Counter exhausted (re-key required) */
+    if( (plainSize > NRF_AEAD_MAX_DATA) || (ctx->counter == 0xFFFFFFFF) )
+    {
+        return false;
+    }
+    
+    uint32_t start = _CP0_GET_COUNT();
+    
+    if( !ctx->isPrecomputed || (ctx->preCounter != ctx->counter) )
+    {
+        AeadMaterial(ctx, ctx->counter);
+        ctx->coldFrames++;
+    }
+    
+    const uint8_t *srcPtr = plainPtr;
+    uint8_t *cipherPtr = &framePtr[4];
+    
+    Le32Write(framePtr, ctx->counter);
+    for(uint8_t i = 0; i < plainSize; i++)
+    {
+        cipherPtr[i] = srcPtr[i] ^ ctx->keystream[i];
+    }
+    
+    uint8_t tag[16];
+    AeadTag(ctx->polyKey, cipherPtr, plainSize, tag);
+    memcpy(&cipherPtr[plainSize], tag, NRF_AEAD_TAG_SIZE);
+    
+    /* Material is never used twice for sealing */
+    ctx->isPrecomputed = false;
+    ctx->counter++;
+    ctx->frames++;
+    ctx->criticalTicks += _CP0_GET_COUNT() - start;
+    
+    *frameSizePtr = plainSize + NRF_AEAD_OVERHEAD;
+    return true;
+}
+
+
+/*
+ *  Authenticates and decrypts frame into "plainPtr", returns false for
+ *  forged, malformed or replayed (not newer than last accepted) frames
+ */
+extern bool NRF_AeadOpen(NrfAeadCtx_t *ctx, const uint8_t *framePtr, uint8_t frameSize, void *plainPtr, uint8_t *plainSizePtr)
+{
+    if( (frameSize < NRF_AEAD_OVERHEAD) || (frameSize > 32) )
+    {
+        ctx->rejected++;
+        return false;
+    }
+    
+    uint32_t start = _CP0_GET_COUNT();
+    uint32_t counter = Le32Read(framePtr);
+    uint8_t size = frameSize - NRF_AEAD_OVERHEAD;
+    const uint8_t *cipherPtr = &framePtr[4];
+    
+    if( (counter < ctx->counter) || (counter == 0xFFFFFFFF) )
+    {
+        ctx->rejected++;
+        return false;
+    }
+    
+    /* Frames were lost, precomputed material is stale */
+    if( !ctx->isPrecomputed || (ctx->preCounter != counter) )
+    {
+        AeadMaterial(ctx, counter);
+        ctx->coldFrames++;
+    }
+    
+    uint8_t tag[16];
+    uint8_t diff = 0;
+    AeadTag(ctx->polyKey, cipherPtr, size, tag);
+    
+    /* Constant time compare */
+    for(uint8_t i = 0; i < NRF_AEAD_TAG_SIZE; i++)
+    {
+        diff |= tag[i] ^ cipherPtr[size + i];
+    }
+    
+    if( diff != 0 )
+    {
+        ctx->rejected++;
+        return false;
+    }
+    
+    uint8_t *dstPtr = plainPtr;
+    for(uint8_t i = 0; i < size; i++)
+    {
+        dstPtr[i] = cipherPtr[i] ^ ctx->keystream[i];
+    }
+    
+    ctx->counter = counter + 1;
+    ctx->frames++;
+    ctx->criticalTicks += _CP0_GET_COUNT() - start;
+    *plainSizePtr = size;
+    
+    /* Next frame can't arrive before this one is handled */
+    NRF_AeadPrecompute(ctx);
+    
+    return true;
+}
+
+
+/*
+ *  Seals plaintext into "framePtr" and queues it for sending, then generates
+ *  material of the next frame while this one is on air ("framePtr" must stay
+ *  valid until the operation completes)
+ */
+extern NrfOpHandle_t NRF_AeadSendPayloadOp(NrfAeadCtx_t *ctx, NrfPayloadConfig_t payldConfig, void *rxPtr, uint8_t *framePtr, const void *plainPtr, uint8_t plainSize)
+{
+    uint8_t frameSize;
+    
+    if( !NRF_AeadSeal(ctx, plainPtr, plainSize, framePtr, &frameSize) )
+    {
+        return NRF_OP_INVALID;
+    }
+    
+    NrfOpHandle_t opHandle = NRF_SendPayloadOp(payldConfig, rxPtr, framePtr, frameSize);
+    NRF_AeadPrecompute(ctx);
+    
+    return opHandle;
+}
+
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+/*
+ *  Generates Poly1305 key (block 0) and keystream (block 1) of a frame
+ */
+static void AeadMaterial(NrfAeadCtx_t *ctx, uint32_t counter)
+{
+    uint8_t block[64];
+    
+    ChachaBlock(ctx, counter, 0, block);
+    memcpy(ctx->polyKey, block, 32);
+    ChachaBlock(ctx, counter, 1, block);
+    memcpy(ctx->keystream, block, NRF_AEAD_MAX_DATA);
+    
+    ctx->preCounter = counter;
+    ctx->isPrecomputed = true;
+}
+
+
+/*
+ *  Computes a single ChaCha20 block (RFC 8439, 96-bit nonce)
+ */
+static void ChachaBlock(const NrfAeadCtx_t *ctx, uint32_t counter, uint32_t block, uint8_t *outPtr)
+{
+    uint32_t in[16] = {
+        0x61707865, 0x3320646E, 0x79622D32, 0x6B206574,
+        ctx->key[0], ctx->key[1], ctx->key[2], ctx->key[3],
+        ctx->key[4], ctx->key[5], ctx->key[6], ctx->key[7],
+        block, ctx->salt, counter, 0
+    };
+    uint32_t x[16];
+    
+    memcpy(x, in, sizeof(x));
+    
+    for(uint8_t i = 0; i < 10; i++)
+    {
+        CHACHA_QR(x[0], x[4], x[8],  x[12]);
+        CHACHA_QR(x[1], x[5], x[9],  x[13]);
+        CHACHA_QR(x[2], x[6], x[10], x[14]);
+        CHACHA_QR(x[3], x[7], x[11], x[15]);
+        CHACHA_QR(x[0], x[5], x[10], x[15]);
+        CHACHA_QR(x[1], x[6], x[11], x[12]);
+        CHACHA_QR(x[2], x[7], x[8],  x[13]);
+        CHACHA_QR(x[3], x[4], x[9],  x[14]);
+    }
+    
+    for(uint8_t i = 0; i < 16; i++)
+    {
+        Le32Write(&outPtr[4 * i], x[i] + in[i]);
+    }
+}
+
+
+/*
+ *  Computes Poly1305 tag of the ciphertext (padded, followed by lengths)
+ */
+static void AeadTag(const uint8_t *polyKey, const uint8_t *cipherPtr, uint8_t size, uint8_t *tagPtr)
+{
+    uint8_t macData[AEAD_MAC_SIZE] = {0};
+    uint8_t padded = (size + 15) & ~15;
+    
+    memcpy(macData, cipherPtr, size);
+    
+    /* Associated data length (0) and ciphertext length as 64-bit values */
+    Le32Write(&macData[padded + 8], size);
+    
+    Poly1305(polyKey, macData, (padded / 16) + 1, tagPtr);
+}
+
+
+/*
+ *  Computes Poly1305 over full 16-byte blocks (26-bit limbs, 32x32 multiplies)
+ */
+static void Poly1305(const uint8_t *key, const uint8_t *msgPtr, uint8_t blocks, uint8_t *tagPtr)
+{
+    uint32_t r0 = (Le32Read(&key[0])) & 0x3FFFFFF;
+    uint32_t r1 = (Le32Read(&key[3]) >> 2) & 0x3FFFF03;
+    uint32_t r2 = (Le32Read(&key[6]) >> 4) & 0x3FFC0FF;
+    uint32_t r3 = (Le32Read(&key[9]) >> 6) & 0x3F03FFF;
+    uint32_t r4 = (Le32Read(&key[12]) >> 8) & 0x00FFFFF;
+    uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+    uint32_t h0 = 0, h1 = 0, h2 = 0, h3 = 0, h4 = 0;
+    uint32_t c;
+    
+    for(; blocks > 0; blocks--, msgPtr += 16)
+    {
+        h0 += (Le32Read(&msgPtr[0])) & POLY_MASK26;
+        h1 += (Le32Read(&msgPtr[3]) >> 2) & POLY_MASK26;
+        h2 += (Le32Read(&msgPtr[6]) >> 4) & POLY_MASK26;
+        h3 += (Le32Read(&msgPtr[9]) >> 6) & POLY_MASK26;
+        h4 += (Le32Read(&msgPtr[12]) >> 8) | (1 << 24);
+        
+        uint64_t d0 = (uint64_t)h0 * r0 + (uint64_t)h1 * s4 + (uint64_t)h2 * s3 + (uint64_t)h3 * s2 + (uint64_t)h4 * s1;
+        uint64_t d1 = (uint64_t)h0 * r1 + (uint64_t)h1 * r0 + (uint64_t)h2 * s4 + (uint64_t)h3 * s3 + (uint64_t)h4 * s2;
+        uint64_t d2 = (uint64_t)h0 * r2 + (uint64_t)h1 * r1 + (uint64_t)h2 * r0 + (uint64_t)h3 * s4 + (uint64_t)h4 * s3;
+        uint64_t d3 = (uint64_t)h0 * r3 + (uint64_t)h1 * r2 + (uint64_t)h2 * r1 + (uint64_t)h3 * r0 + (uint64_t)h4 * s4;
+        uint64_t d4 = (uint64_t)h0 * r4 + (uint64_t)h1 * r3 + (uint64_t)h2 * r2 + (uint64_t)h3 * r1 + (uint64_t)h4 * r0;
+        
+        c = (uint32_t)(d0 >> 26); h0 = (uint32_t)d0 & POLY_MASK26;
+        d1 += c; c = (uint32_t)(d1 >> 26); h1 = (uint32_t)d1 & POLY_MASK26;
+        d2 += c; c = (uint32_t)(d2 >> 26); h2 = (uint32_t)d2 & POLY_MASK26;
+        d3 += c; c = (uint32_t)(d3 >> 26); h3 = (uint32_t)d3 & POLY_MASK26;
+        d4 += c; c = (uint32_t)(d4 >> 26); h4 = (uint32_t)d4 & POLY_MASK26;
+        h0 += c * 5; c = h0 >> 26; h0 &= POLY_MASK26;
+        h1 += c;
+    }
+    
+    /* Full carry */
+    c = h1 >> 26; h1 &= POLY_MASK26;
+    h2 += c; c = h2 >> 26; h2 &= POLY_MASK26;
+    h3 += c; c = h3 >> 26; h3 &= POLY_MASK26;
+    h4 += c; c = h4 >> 26; h4 &= POLY_MASK26;
+    h0 += c * 5; c = h0 >> 26; h0 &= POLY_MASK26;
+    h1 += c;
+    
+    /* h - p, selected in constant time if not negative */
+    uint32_t g0 = h0 + 5; c = g0 >> 26; g0 &= POLY_MASK26;
+    uint32_t g1 = h1 + c; c = g1 >> 26; g1 &= POLY_MASK26;
+    uint32_t g2 = h2 + c; c = g2 >> 26; g2 &= POLY_MASK26;
+    uint32_t g3 = h3 + c; c = g3 >> 26; g3 &= POLY_MASK26;
+    uint32_t g4 = h4 + c - (1 << 26);
+    
+    uint32_t mask = (g4 >> 31) - 1;
+    h0 = (h0 & ~mask) | (g0 & mask);
+    h1 = (h1 & ~mask) | (g1 & mask);
+    h2 = (h2 & ~mask) | (g2 & mask);
+    h3 = (h3 & ~mask) | (g3 & mask);
+    h4 = (h4 & ~mask) | (g4 & mask);
+    
+    /* h + s mod 2^128 */
+    uint64_t f;
+    f = (uint64_t)(h0 | (h1 << 26)) + Le32Read(&key[16]);
+    Le32Write(&tagPtr[0], (uint32_t)f);
+    f = (uint64_t)((h1 >> 6) | (h2 << 20)) + Le32Read(&key[20]) + (f >> 32);
+    Le32Write(&tagPtr[4], (uint32_t)f);
+    f = (uint64_t)((h2 >> 12) | (h3 << 14)) + Le32Read(&key[24]) + (f >> 32);
+    Le32Write(&tagPtr[8], (uint32_t)f);
+    f = (uint64_t)((h3 >> 18) | (h4 << 8)) + Le32Read(&key[28]) + (f >> 32);
+    Le32Write(&tagPtr[12], (uint32_t)f);
+}
+
+
+static inline uint32_t Le32Read(const uint8_t *bufPtr)
+{
+    return (uint32_t)bufPtr[0] | ((uint32_t)bufPtr[1] << 8) |
+           ((uint32_t)bufPtr[2] << 16) | ((uint32_t)bufPtr[3] << 24);
+}
+
+
+static inline void Le32Write(uint8_t *bufPtr, uint32_t value)
+{
+    bufPtr[0] = (uint8_t)value;
+    bufPtr[1] = (uint8_t)(value >> 8);
+    bufPtr[2] = (uint8_t)(value >> 16);
+    bufPtr[3] = (uint8_t)(value >> 24);
+}
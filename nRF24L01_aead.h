@@ -0,0 +1,72 @@
+#ifndef NRF24L01_AEAD_H
+#define	NRF24L01_AEAD_H
+
+
+/******************************************************************************/
+/*----------------------------------Includes----------------------------------*/
+/******************************************************************************/
+
+/** Custom libs **/
+#include "nRF24L01.h"
+
+/******************************************************************************/
+/*---------------------------------MACROS-------------------------------------*/
+/******************************************************************************/
+
+/* Transmitted Poly1305 tag bytes (truncated, 4-16) */
+#ifndef NRF_AEAD_TAG_SIZE
+#define NRF_AEAD_TAG_SIZE       8
+#endif
+
+#if (NRF_AEAD_TAG_SIZE < 4) || (NRF_AEAD_TAG_SIZE > 16)
+    #error "NRF_AEAD_TAG_SIZE must be 4-16"
+#endif
+
+/* Frame counter and tag added to every payload */
+#define NRF_AEAD_OVERHEAD       (4 + NRF_AEAD_TAG_SIZE)
+
+/* Maximum plaintext size of a single frame */
+#define NRF_AEAD_MAX_DATA       (32 - NRF_AEAD_OVERHEAD)
+
+/* NOTE: Frame layout (ChaCha20-Poly1305 as in RFC 8439, no associated data)
+ *       [0-3]  Frame counter (little-endian), nonce = salt | counter | 0
+ *       [..]   Ciphertext
+ *       [..]   First NRF_AEAD_TAG_SIZE bytes of Poly1305 tag */
+
+/******************************************************************************/
+/*-----------------------------Data Structures--------------------------------*/
+/******************************************************************************/
+
+/* Encryption state of a single link direction (TX or RX side). Both
+ * directions of a link must use different salts under the same key */
+typedef struct {
+    uint32_t    key[8];
+    uint32_t    salt;
+    uint32_t    counter;                    // Next counter to seal (TX) or lowest accepted (RX)
+
+    /* One-time material of frame "preCounter" (see NRF_AeadPrecompute()) */
+    bool        isPrecomputed;
+    uint32_t    preCounter;
+    uint8_t     polyKey[32];
+    uint8_t     keystream[NRF_AEAD_MAX_DATA];
+
+    /* Statistics in core timer ticks (1 tick = 2 SYSCLK) */
+    uint32_t    frames;                     // Sealed or opened frames
+    uint32_t    rejected;                   // Replayed, malformed or forged frames
+    uint32_t    criticalTicks;              // Seal/open time spent on sending/receiving path
+    uint32_t    precomputeTicks;            // Keystream time spent off the critical path
+    uint32_t    coldFrames;                 // Frames without precomputed keystream
+} NrfAeadCtx_t;
+
+/******************************************************************************/
+/*---------------------------- Function Prototypes----------------------------*/
+/******************************************************************************/
+
+void NRF_AeadInit(NrfAeadCtx_t *ctx, const uint8_t *keyPtr, uint32_t salt);
+void NRF_AeadPrecompute(NrfAeadCtx_t *ctx);
+bool NRF_AeadSeal(NrfAeadCtx_t *ctx, const void *plainPtr, uint8_t plainSize, uint8_t *framePtr, uint8_t *frameSizePtr);
+bool NRF_AeadOpen(NrfAeadCtx_t *ctx, const uint8_t *framePtr, uint8_t frameSize, void *plainPtr, uint8_t *plainSizePtr);
+NrfOpHandle_t NRF_AeadSendPayloadOp(NrfAeadCtx_t *ctx, NrfPayloadConfig_t payldConfig, void *rxPtr, uint8_t *framePtr, const void *plainPtr, uint8_t plainSize);
+
+
+#endif	/* NRF24L01_AEAD_H */
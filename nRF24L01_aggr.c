@@ -0,0 +1,205 @@
+#include "nRF24L01_aggr.h"
+
+/** Standard libs **/
+#include <string.h>
+
+/******************************************************************************/
+/*--------------------------------Local Macros--------------------------------*/
+/******************************************************************************/
+
+/* Smallest message takes two bytes (length and data) */
+#define AGGR_MIN_MSG_BYTES      2
+
+/******************************************************************************/
+/*------------------------Local Function Prototypes---------------------------*/
+/******************************************************************************/
+
+static void AggrReap(NrfAggrCtx_t *ctx);
+
+
+/******************************************************************************/
+/*----------------------External Function Definitions-------------------------*/
+/******************************************************************************/
+
+/*
+ *  Initializes aggregation of messages for a single destination ("latencyUs"
+ *  bounds how long the first message of a frame may wait for others)
+ */
+extern void NRF_AggrInit(NrfAggrCtx_t *ctx, NrfPayloadConfig_t payldConfig, void *ackPtr, uint32_t latencyUs)
+{
+    memset(ctx, 0, sizeof(NrfAggrCtx_t));
+    ctx->payldConfig = payldConfig;
+    ctx->ackPtr = ackPtr;
+    ctx->latencyTicks = latencyUs * (OSC_GetSysFreq() / 1000000 / 2);
+    ctx->opHandle = NRF_OP_INVALID;
+}
+
+
+/*
+ *  Appends message to the active frame, returns false if message is too long
+ *  or both frames are busy (call NRF_AggrTask() and retry)
+ */
+extern bool NRF_AggrPush(NrfAggrCtx_t *ctx, const void *msgPtr, uint8_t msgSize)
+{
+    if( (msgSize == 0) || (msgSize > NRF_AGGR_MAX_MSG_SIZE) )
+    {
+        return false;
+    }
+    
+    /* Message doesn't fit, active frame has to go first */
+    if( (ctx->size[ctx->active] + 1 + msgSize) > NRF_AGGR_FRAME_SIZE )
+    {
+        AggrReap(ctx);
+        if( !NRF_AggrFlush(ctx) )
+        {
+            return false;
+        }
+    }
+    
+    uint8_t act = ctx->active;
+    
+    if( ctx->size[act] == 0 )
+    {
+        ctx->firstStamp = _CP0_GET_COUNT();
+    }
+    
+    ctx->frame[act][ctx->size[act]++] = msgSize;
+    memcpy(&ctx->frame[act][ctx->size[act]], msgPtr, msgSize);
+    ctx->size[act] += msgSize;
+    ctx->count[act]++;
+    
+    /* Full frame or zero latency bound is sent right away */
+    NRF_AggrTask(ctx);
+    
+    return true;
+}
+
+
+/*
+ *  Sends active frame now, returns false if previous frame is still in flight
+ *  or the operation pool is exhausted (frame stays buffered)
+ */
+extern bool NRF_AggrFlush(NrfAggrCtx_t *ctx)
+{
+    uint8_t act = ctx->active;
+    
+    if( ctx->size[act] == 0 )
+    {
+        return true;
+    }
+    
+    /* Single frame in flight, the other one keeps collecting messages */
+    if( ctx->opHandle != NRF_OP_INVALID )
+    {
+        return false;
+    }
+    
+    NrfOpHandle_t opHandle = NRF_SendPayloadOp(ctx->payldConfig, ctx->ackPtr, ctx->frame[act], ctx->size[act]);
+    if( opHandle == NRF_OP_INVALID )
+    {
+        return false;
+    }
+    
+    ctx->opHandle = opHandle;
+    ctx->active = act ^ 1;
+    ctx->size[ctx->active] = 0;
+    ctx->count[ctx->active] = 0;
+    
+    return true;
+}
+
+
+/*
+ *  Collects result of the frame in flight and sends active frame once it is
+ *  full or its latency bound expired (call periodically from main loop)
+ */
+extern void NRF_AggrTask(NrfAggrCtx_t *ctx)
+{
+    AggrReap(ctx);
+    
+    uint8_t act = ctx->active;
+    
+    if( ctx->size[act] == 0 )
+    {
+        return;
+    }
+    
+    if( (ctx->size[act] > (NRF_AGGR_FRAME_SIZE - AGGR_MIN_MSG_BYTES)) ||
+        ((_CP0_GET_COUNT() - ctx->firstStamp) >= ctx->latencyTicks) )
+    {
+        NRF_AggrFlush(ctx);
+    }
+}
+
+
+/*
+ *  Returns true if no message is buffered or in flight
+ */
+extern bool NRF_AggrIsIdle(NrfAggrCtx_t *ctx)
+{
+    AggrReap(ctx);
+    
+    return (ctx->opHandle == NRF_OP_INVALID) && (ctx->size[ctx->active] == 0);
+}
+
+
+/*
+ *  Returns size and location of the next message in a received frame (0 at
+ *  the end of frame). Set "*offsetPtr" to 0 before the first call
+ */
+extern uint8_t NRF_AggrSplit(const uint8_t *framePtr, uint8_t frameSize, uint8_t *offsetPtr, const uint8_t **msgPtr)
+{
+    uint8_t offset = *offsetPtr;
+    
+    if( offset >= frameSize )
+    {
+        return 0;
+    }
+    
+    uint8_t msgSize = framePtr[offset];
+    
+    /* Padding or truncated message ends the frame */
+    if( (msgSize == 0) || (msgSize > (frameSize - offset - 1)) )
+    {
+        *offsetPtr = frameSize;
+        return 0;
+    }
+    
+    *msgPtr = &framePtr[offset + 1];
+    *offsetPtr = offset + 1 + msgSize;
+    
+    return msgSize;
+}
+
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+/*
+ *  Releases completed frame in flight and accounts its messages
+ */
+static void AggrReap(NrfAggrCtx_t *ctx)
+{
+    if( (ctx->opHandle == NRF_OP_INVALID) || !NRF_PollOp(ctx->opHandle, &ctx->lastResult) )
+    {
+        return;
+    }
+    
+    uint8_t sent = ctx->active ^ 1;
+    
+    /* TX_DS is set for plain and ACK payload acknowledgments */
+    if( ctx->lastResult.status & NRF_FLAG_TX_DS )
+    {
+        ctx->framesSent++;
+        ctx->msgsSent += ctx->count[sent];
+    }
+    else
+    {
+        ctx->framesLost++;
+        ctx->msgsLost += ctx->count[sent];
+    }
+    
+    NRF_ReleaseOp(ctx->opHandle);
+    ctx->opHandle = NRF_OP_INVALID;
+}
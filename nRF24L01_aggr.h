@@ -0,0 +1,68 @@
+#ifndef NRF24L01_AGGR_H
+#define	NRF24L01_AGGR_H
+
+
+/******************************************************************************/
+/*----------------------------------Includes----------------------------------*/
+/******************************************************************************/
+
+/** Custom libs **/
+#include "nRF24L01.h"
+
+/******************************************************************************/
+/*---------------------------------MACROS-------------------------------------*/
+/******************************************************************************/
+
+/* Maximum aggregated frame size (nRF payload limit) */
+#define NRF_AGGR_FRAME_SIZE     32
+
+/* Maximum size of a single message (one length byte per message) */
+#define NRF_AGGR_MAX_MSG_SIZE   (NRF_AGGR_FRAME_SIZE - 1)
+
+/* NOTE: Frame layout
+ *       [0]    Length of first message (1-31)
+ *       [..]   Message bytes, followed by next length byte and so on
+ *       Zero length byte (padding of fixed width payloads) ends the frame */
+
+/******************************************************************************/
+/*-----------------------------Data Structures--------------------------------*/
+/******************************************************************************/
+
+/* Aggregation state of a single destination. Messages are collected in one
+ * buffer while the other one is being sent */
+typedef struct {
+    NrfPayloadConfig_t  payldConfig;
+    void               *ackPtr;                             // ACK payload buffer (NULL = discarded)
+    uint32_t            latencyTicks;                       // Flush bound in core timer ticks
+
+    uint8_t             frame[2][NRF_AGGR_FRAME_SIZE];
+    uint8_t             size[2];
+    uint8_t             count[2];                           // Messages in frame
+    uint8_t             active;                             // Frame collecting messages
+    uint32_t            firstStamp;                         // Core timer count of first message in active frame
+    NrfOpHandle_t       opHandle;                           // Frame being sent (NRF_OP_INVALID if none)
+
+    /* Statistics */
+    uint32_t            framesSent;
+    uint32_t            framesLost;                         // MAX_RT or timeout (messages are dropped)
+    uint32_t            msgsSent;
+    uint32_t            msgsLost;
+    NrfOpResult_t       lastResult;
+} NrfAggrCtx_t;
+
+/******************************************************************************/
+/*---------------------------- Function Prototypes----------------------------*/
+/******************************************************************************/
+
+/* PTX functions */
+void NRF_AggrInit(NrfAggrCtx_t *ctx, NrfPayloadConfig_t payldConfig, void *ackPtr, uint32_t latencyUs);
+bool NRF_AggrPush(NrfAggrCtx_t *ctx, const void *msgPtr, uint8_t msgSize);
+bool NRF_AggrFlush(NrfAggrCtx_t *ctx);
+void NRF_AggrTask(NrfAggrCtx_t *ctx);
+bool NRF_AggrIsIdle(NrfAggrCtx_t *ctx);
+
+/* PRX functions */
+uint8_t NRF_AggrSplit(const uint8_t *framePtr, uint8_t frameSize, uint8_t *offsetPtr, const uint8_t **msgPtr);
+
+
+#endif	/* NRF24L01_AGGR_H */
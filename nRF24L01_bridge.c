@@ -0,0 +1,255 @@
+#include "nRF24L01_bridge.h"
+
+/** Standard libs **/
+#include <string.h>
+
+/******************************************************************************/
+/*--------------------------Local Data Variables------------------------------*/
+/******************************************************************************/
+
+/* Payloads kept in TX radio FIFO at once. FIFO_STATUS only tells empty or
+ * full, with two loaded a non-empty FIFO holds exactly one after TX_DS */
+#define BRIDGE_TX_FIFO_DEPTH    2
+
+#define BRIDGE_QUEUE_MASK       (NRF_BRIDGE_QUEUE_DEPTH - 1)
+
+#if (NRF_BRIDGE_QUEUE_DEPTH & BRIDGE_QUEUE_MASK) != 0
+    #error "NRF_BRIDGE_QUEUE_DEPTH must be a power of two"
+#endif
+
+/* Queue slot holds complete W_TX_PAYLOAD transaction (command + payload, see
+ * NRF_RadioWriteTx()) */
+typedef struct {
+    uint32_t    stamp;              // Core timer count when payload was received
+    uint8_t     length;
+    uint8_t     frame[33];
+} BridgeSlot_t;
+
+/** Forwarding queue (free-running indexes, wrapped with BRIDGE_QUEUE_MASK) **/
+static BridgeSlot_t bridgeQueue[NRF_BRIDGE_QUEUE_DEPTH];
+static volatile uint32_t queueTail;     // Next free slot (RX path)
+static volatile uint32_t queueLoad;     // Next slot loaded into TX FIFO (TX ISR)
+static volatile uint32_t queueHead;     // Oldest slot awaiting ACK (TX ISR)
+
+/** TX radio (owned by ISR_NrfBridge() once started) **/
+static NrfRadio_t txRadio;
+static volatile bool isBridgeActive = false;
+
+/** Statistics **/
+static volatile NrfBridgeStats_t bridgeStats;
+static volatile uint64_t latencySum;
+
+/** Pointer to Interrupt Controller **/
+static IcSfr_t *const icSfr = &IC_MODULE;
+
+/******************************************************************************/
+/*------------------------Local Function Prototypes---------------------------*/
+/******************************************************************************/
+
+static void BridgeSink(const uint8_t *payldPtr, uint8_t length, NrfRxPipeNo_t pipeNo);
+static void BridgeComplete(uint32_t now);
+
+
+/******************************************************************************/
+/*----------------------External Function Definitions-------------------------*/
+/******************************************************************************/
+
+/*
+ *  Configures second radio as a permanent PTX on its own channel and forwards
+ *  every payload received by the driver radio (configured as PRX beforehand)
+ */
+extern bool NRF_BridgeStart(const NrfPtxConfig_t txConfig, const uint64_t txAddr)
+{
+    NRF_BridgeStop();
+    
+    /* TX radio takes the driver's PTX register values */
+    if( !NRF_RadioConfigPtx(&txRadio, txConfig, txAddr) )
+    {
+        return false;
+    }
+    
+    queueTail = queueLoad = queueHead = 0;
+    NRF_BridgeResetStats();
+    
+    /* Standby-II: each payload loaded into TX FIFO is sent right away */
+    NRF_RadioSetCe(&txRadio, true);
+    
+    /* Configure TX radio INTx */
+    icSfr->ICxIEC0.CLR = NRF_BRIDGE_INTxIE_MASK;
+    icSfr->NRF_BRIDGE_ICxIPC.CLR = NRF_BRIDGE_IPC_MASK;
+    icSfr->NRF_BRIDGE_ICxIPC.SET = NRF_BRIDGE_IPC_VALUE;
+    icSfr->ICxINTCON.CLR = NRF_BRIDGE_INTxEP_MASK;      // Falling-edge triggered
+    icSfr->ICxIFS0.CLR = NRF_BRIDGE_INTxIF_MASK;
+    icSfr->ICxIEC0.SET = NRF_BRIDGE_INTxIE_MASK;
+    
+    isBridgeActive = true;
+    NRF_SetRxSink(BridgeSink);
+    
+    return true;
+}
+
+
+/*
+ *  Stops forwarding (queued payloads are discarded)
+ */
+extern void NRF_BridgeStop(void)
+{
+    if( !isBridgeActive )
+    {
+        return;
+    }
+    
+    NRF_SetRxSink(NULL);
+    isBridgeActive = false;
+    
+    icSfr->ICxIEC0.CLR = NRF_BRIDGE_INTxIE_MASK;
+    icSfr->ICxIFS0.CLR = NRF_BRIDGE_INTxIF_MASK;
+    
+    NRF_RadioSetCe(&txRadio, false);
+    NRF_RadioFlushTx(&txRadio);
+}
+
+
+/*
+ *  Reads forwarding statistics
+ */
+extern void NRF_BridgeReadStats(NrfBridgeStats_t *stats)
+{
+    uint32_t intStatus = __builtin_disable_interrupts();
+    
+    *stats = bridgeStats;
+    stats->latencyMean = (bridgeStats.forwarded != 0) ? (uint32_t)(latencySum / bridgeStats.forwarded) : 0;
+    
+    __builtin_mtc0(12, 0, intStatus);
+}
+
+
+/*
+ *  Resets forwarding statistics
+ */
+extern void NRF_BridgeResetStats(void)
+{
+    uint32_t intStatus = __builtin_disable_interrupts();
+    
+    memset((void *)&bridgeStats, 0, sizeof(bridgeStats));
+    bridgeStats.latencyMin = UINT32_MAX;
+    latencySum = 0;
+    
+    __builtin_mtc0(12, 0, intStatus);
+}
+
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+/*
+ *  RX radio sink (executed within scope of driver ISR), queues payload and
+ *  wakes TX radio ISR to load it
+ */
+static void BridgeSink(const uint8_t *payldPtr, uint8_t length, NrfRxPipeNo_t pipeNo)
+{
+    (void)pipeNo;
+    
+    uint32_t tail = queueTail;
+    
+    /* Statistics are shared with TX radio ISR (possibly of other priority) */
+    uint32_t intStatus = __builtin_disable_interrupts();
+    
+    bridgeStats.received++;
+    
+    /* Queue full, TX radio can't keep up */
+    bool isFull = ((tail - queueHead) >= NRF_BRIDGE_QUEUE_DEPTH);
+    if( isFull )
+    {
+        bridgeStats.dropped++;
+    }
+    
+    __builtin_mtc0(12, 0, intStatus);
+    
+    if( isFull )
+    {
+        return;
+    }
+    
+    BridgeSlot_t *slot = &bridgeQueue[tail & BRIDGE_QUEUE_MASK];
+    slot->stamp = _CP0_GET_COUNT();
+    slot->length = length;
+    memcpy(&slot->frame[1], payldPtr, length);
+    
+    queueTail = tail + 1;
+    
+    /* Idle TX radio raises no IRQ edge by itself */
+    icSfr->ICxIFS0.SET = NRF_BRIDGE_INTxIF_MASK;
+}
+
+
+/*
+ *  Accounts acknowledged payload at head of queue
+ */
+static void BridgeComplete(uint32_t now)
+{
+    uint32_t latency = now - bridgeQueue[queueHead & BRIDGE_QUEUE_MASK].stamp;
+    
+    bridgeStats.forwarded++;
+    latencySum += latency;
+    
+    if( latency < bridgeStats.latencyMin )
+    {
+        bridgeStats.latencyMin = latency;
+    }
+    if( latency > bridgeStats.latencyMax )
+    {
+        bridgeStats.latencyMax = latency;
+    }
+    
+    queueHead++;
+}
+
+
+/******************************************************************************/
+/*-----------------------------Interrupt Routines-----------------------------*/
+/******************************************************************************/
+
+/*
+ *  TX radio ISR: retires acknowledged or failed payloads and tops up TX FIFO
+ *  from forwarding queue (triggered by TX radio IRQ or by BridgeSink())
+ */
+void __ISR(NRF_BRIDGE_ISR_VECTOR, NRF_BRIDGE_ISR_IPL) ISR_NrfBridge(void)
+{
+    uint32_t now = _CP0_GET_COUNT();
+    
+    icSfr->ICxIFS0.CLR = NRF_BRIDGE_INTxIF_MASK;
+    
+    /* Read status and clear TX flags (IRQ pin is released) */
+    uint8_t status = NRF_RadioClearFlags(&txRadio, NRF_MAX_RT_MASK | NRF_TX_DS_MASK);
+    
+    if( status & NRF_TX_DS_MASK )
+    {
+        /* Several payloads may have been sent since last IRQ, retire all but
+         * the ones still in TX FIFO */
+        uint32_t inFifo = NRF_RadioIsTxFifoEmpty(&txRadio) ? 0 : 1;
+        
+        while( (queueLoad - queueHead) > inFifo )
+        {
+            BridgeComplete(now);
+        }
+    }
+    
+    /* Payload at head of TX FIFO keeps being retried, drop whole FIFO */
+    if( status & NRF_MAX_RT_MASK )
+    {
+        NRF_RadioFlushTx(&txRadio);
+        
+        bridgeStats.lost += queueLoad - queueHead;
+        queueHead = queueLoad;
+    }
+    
+    /* Load queued payloads while TX FIFO has room */
+    while( (queueLoad != queueTail) && ((queueLoad - queueHead) < BRIDGE_TX_FIFO_DEPTH) )
+    {
+        BridgeSlot_t *slot = &bridgeQueue[queueLoad & BRIDGE_QUEUE_MASK];
+        NRF_RadioWriteTx(&txRadio, slot->frame, slot->length);
+        queueLoad++;
+    }
+}
@@ -0,0 +1,125 @@
+#ifndef NRF24L01_BRIDGE_H
+#define	NRF24L01_BRIDGE_H
+
+
+/******************************************************************************/
+/*----------------------------------Includes----------------------------------*/
+/******************************************************************************/
+
+/** Custom libs **/
+#include "nRF24L01.h"
+
+/******************************************************************************/
+/*---------------------------------MACROS-------------------------------------*/
+/******************************************************************************/
+
+/**************************Interrupt vector priority***************************/
+
+/* NOTE: IPL = 0 means interrupt disabled. ISR_IPL level must equal ICX_IPL */
+/* NOTE: RX path only appends to forwarding queue and TX radio ISR only removes
+ *       from it, statistics shared by both are updated in a short critical
+ *       section, so both radios may run at different priority levels */
+
+/* User-defined (sub)priority levels (IPL: 0-7, ISL: 0-3) */
+#define NRF_BRIDGE_ISR_IPL      IPL1SOFT
+#define NRF_BRIDGE_ICX_IPL      1
+#define NRF_BRIDGE_ICX_ISL      0
+
+/******************************************************************************/
+
+/* User-defined External Interrupt INTx vector of TX radio (must differ from
+ * the driver INTx vector, used by the RX radio) */
+#define BRIDGE_INT3_ISR_MACRO
+
+
+/* Macro used by the ISR definition in bridge module */
+#if defined BRIDGE_INT0_ISR_MACRO
+
+    #define NRF_BRIDGE_ISR_VECTOR   EXTERNAL_0_VECTOR
+    #define NRF_BRIDGE_INTxIF_MASK  IC_INT0IF_MASK
+    #define NRF_BRIDGE_INTxIE_MASK  IC_INT0IE_MASK
+    #define NRF_BRIDGE_ICxIPC       ICxIPC0
+    #define NRF_BRIDGE_IPC_MASK     (IC_INT0IS_MASK | IC_INT0IP_MASK)
+    #define NRF_BRIDGE_IPC_VALUE    ((NRF_BRIDGE_ICX_ISL << IC_INT0IS_POS) | (NRF_BRIDGE_ICX_IPL << IC_INT0IP_POS))
+    #define NRF_BRIDGE_INTxEP_MASK  IC_INT0EP_MASK
+
+#elif defined BRIDGE_INT1_ISR_MACRO
+
+    #define NRF_BRIDGE_ISR_VECTOR   EXTERNAL_1_VECTOR
+    #define NRF_BRIDGE_INTxIF_MASK  IC_INT1IF_MASK
+    #define NRF_BRIDGE_INTxIE_MASK  IC_INT1IE_MASK
+    #define NRF_BRIDGE_ICxIPC       ICxIPC1
+    #define NRF_BRIDGE_IPC_MASK     (IC_INT1IS_MASK | IC_INT1IP_MASK)
+    #define NRF_BRIDGE_IPC_VALUE    ((NRF_BRIDGE_ICX_ISL << IC_INT1IS_POS) | (NRF_BRIDGE_ICX_IPL << IC_INT1IP_POS))
+    #define NRF_BRIDGE_INTxEP_MASK  IC_INT1EP_MASK
+
+#elif defined BRIDGE_INT2_ISR_MACRO
+
+    #define NRF_BRIDGE_ISR_VECTOR   EXTERNAL_2_VECTOR
+    #define NRF_BRIDGE_INTxIF_MASK  IC_INT2IF_MASK
+    #define NRF_BRIDGE_INTxIE_MASK  IC_INT2IE_MASK
+    #define NRF_BRIDGE_ICxIPC       ICxIPC2
+    #define NRF_BRIDGE_IPC_MASK     (IC_INT2IS_MASK | IC_INT2IP_MASK)
+    #define NRF_BRIDGE_IPC_VALUE    ((NRF_BRIDGE_ICX_ISL << IC_INT2IS_POS) | (NRF_BRIDGE_ICX_IPL << IC_INT2IP_POS))
+    #define NRF_BRIDGE_INTxEP_MASK  IC_INT2EP_MASK
+
+#elif defined BRIDGE_INT3_ISR_MACRO
+
+    #define NRF_BRIDGE_ISR_VECTOR   EXTERNAL_3_VECTOR
+    #define NRF_BRIDGE_INTxIF_MASK  IC_INT3IF_MASK
+    #define NRF_BRIDGE_INTxIE_MASK  IC_INT3IE_MASK
+    #define NRF_BRIDGE_ICxIPC       ICxIPC3
+    #define NRF_BRIDGE_IPC_MASK     (IC_INT3IS_MASK | IC_INT3IP_MASK)
+    #define NRF_BRIDGE_IPC_VALUE    ((NRF_BRIDGE_ICX_ISL << IC_INT3IS_POS) | (NRF_BRIDGE_ICX_IPL << IC_INT3IP_POS))
+    #define NRF_BRIDGE_INTxEP_MASK  IC_INT3EP_MASK
+
+#elif defined BRIDGE_INT4_ISR_MACRO
+
+    #define NRF_BRIDGE_ISR_VECTOR   EXTERNAL_4_VECTOR
+    #define NRF_BRIDGE_INTxIF_MASK  IC_INT4IF_MASK
+    #define NRF_BRIDGE_INTxIE_MASK  IC_INT4IE_MASK
+    #define NRF_BRIDGE_ICxIPC       ICxIPC4
+    #define NRF_BRIDGE_IPC_MASK     (IC_INT4IS_MASK | IC_INT4IP_MASK)
+    #define NRF_BRIDGE_IPC_VALUE    ((NRF_BRIDGE_ICX_ISL << IC_INT4IS_POS) | (NRF_BRIDGE_ICX_IPL << IC_INT4IP_POS))
+    #define NRF_BRIDGE_INTxEP_MASK  IC_INT4EP_MASK
+
+#else
+
+    #error "Define INTx vector for nRF24L01_bridge.c"
+
+#endif
+
+/*******************************Bridge settings********************************/
+
+/* Forwarding queue slots shared by RX and TX radio (must be a power of two) */
+#ifndef NRF_BRIDGE_QUEUE_DEPTH
+#define NRF_BRIDGE_QUEUE_DEPTH  8
+#endif
+
+/******************************************************************************/
+/*-----------------------------Data Structures--------------------------------*/
+/******************************************************************************/
+
+/* Forwarding statistics, latency from payload read on RX radio to its
+ * acknowledgment on TX radio in core timer ticks (1 tick = 2 SYSCLK) */
+typedef struct {
+    uint32_t    received;           // Payloads handed over by RX radio
+    uint32_t    forwarded;          // Payloads acknowledged on TX radio
+    uint32_t    dropped;            // Payloads dropped on full queue
+    uint32_t    lost;               // Payloads flushed after MAX_RT
+    uint32_t    latencyMin;
+    uint32_t    latencyMax;
+    uint32_t    latencyMean;
+} NrfBridgeStats_t;
+
+/******************************************************************************/
+/*---------------------------- Function Prototypes----------------------------*/
+/******************************************************************************/
+
+bool NRF_BridgeStart(const NrfPtxConfig_t txConfig, const uint64_t txAddr);
+void NRF_BridgeStop(void);
+void NRF_BridgeReadStats(NrfBridgeStats_t *stats);
+void NRF_BridgeResetStats(void);
+
+
+#endif	/* NRF24L01_BRIDGE_H */
@@ -0,0 +1,278 @@
+#include "nRF24L01_codec.h"
+
+/** Standard libs **/
+#include <string.h>
+
+/******************************************************************************/
+/*--------------------------------Local Macros--------------------------------*/
+/******************************************************************************/
+
+#define CODEC_KEY_MASK          0x80
+#define CODEC_SEQ_MASK          0x7F
+
+/* Worst case varint size of a 32-bit value */
+#define CODEC_VARINT_MAX        5
+
+/******************************************************************************/
+/*------------------------Local Function Prototypes---------------------------*/
+/******************************************************************************/
+
+static inline uint8_t VarintWrite(uint8_t *bufPtr, int32_t value);
+static inline uint8_t VarintRead(const uint8_t *bufPtr, uint8_t size, int32_t *valuePtr);
+
+
+/******************************************************************************/
+/*----------------------External Function Definitions-------------------------*/
+/******************************************************************************/
+
+/*
+ *  Initializes codec state of a link (first packet is always a key packet)
+ */
+extern bool NRF_CodecInit(NrfCodecCtx_t *ctx, uint8_t fieldCount, uint8_t keyInterval)
+{
+    if( (fieldCount == 0) || (fieldCount > NRF_CODEC_MAX_FIELDS) )
+    {
+        return false;
+    }
+
+    memset(ctx, 0, sizeof(NrfCodecCtx_t));
+    ctx->fieldCount = fieldCount;
+    ctx->keyInterval = keyInterval;
+
+    return true;
+}
+
+
+/*
+ *  Encodes as many samples as fit into a single payload, returns number of
+ *  samples encoded (0 if none) and payload size via "sizePtr"
+ */
+extern uint8_t NRF_CodecEncode(NrfCodecCtx_t *ctx, const int32_t *samples, uint8_t sampleCount, uint8_t *bufPtr, uint8_t *sizePtr)
+{
+    uint8_t fields = ctx->fieldCount;
+    uint8_t size = 0;
+    uint8_t count = 0;
+
+    /* Key packet without reference or periodically, so decoder resyncs */
+    bool isKey = !ctx->isRefValid ||
+                 ((ctx->keyInterval != 0) && (ctx->sinceKey >= ctx->keyInterval));
+
+    bufPtr[size++] = (isKey ? CODEC_KEY_MASK : 0x00) | (ctx->seq & CODEC_SEQ_MASK);
+    if( !isKey )
+    {
+        bufPtr[size++] = ctx->refSeq;
+    }
+
+    const int32_t *prevPtr = isKey ? NULL : ctx->ref;
+    uint8_t sampleBuf[NRF_CODEC_MAX_FIELDS * CODEC_VARINT_MAX];
+
+    for(; count < sampleCount; count++)
+    {
+        const int32_t *samplePtr = &samples[count * fields];
+        uint8_t sampleSize = 0;
+
+        /* Delta against previous sample (wrapping arithmetic) */
+        for(uint8_t i = 0; i < fields; i++)
+        {
+            uint32_t prev = (prevPtr != NULL) ? (uint32_t)prevPtr[i] : 0;
+            sampleSize += VarintWrite(&sampleBuf[sampleSize], (int32_t)((uint32_t)samplePtr[i] - prev));
+        }
+
+        /* Sample doesn't fit anymore */
+        if( (size + sampleSize) > NRF_CODEC_PAYLOAD_SIZE )
+        {
+            break;
+        }
+
+        memcpy(&bufPtr[size], sampleBuf, sampleSize);
+        size += sampleSize;
+        prevPtr = samplePtr;
+    }
+
+    if( count == 0 )
+    {
+        *sizePtr = 0;
+        return 0;
+    }
+
+    /* Last sample becomes reference once this packet is acknowledged */
+    memcpy(ctx->pend, prevPtr, fields * sizeof(int32_t));
+    ctx->pendSeq = ctx->seq & CODEC_SEQ_MASK;
+    ctx->isPending = true;
+    ctx->seq++;
+    ctx->sinceKey = isKey ? 0 : (ctx->sinceKey + 1);
+
+    *sizePtr = size;
+    return count;
+}
+
+
+/*
+ *  Reports outcome of the last encoded packet (acknowledged packet becomes
+ *  delta reference, lost packet leaves reference unchanged)
+ */
+extern void NRF_CodecConfirm(NrfCodecCtx_t *ctx, bool isAcked)
+{
+    if( isAcked && ctx->isPending )
+    {
+        memcpy(ctx->ref, ctx->pend, ctx->fieldCount * sizeof(int32_t));
+        ctx->refSeq = ctx->pendSeq;
+        ctx->isRefValid = true;
+    }
+
+    ctx->isPending = false;
+}
+
+
+/*
+ *  Forces next packet to be a key packet (e.g. on decoder request)
+ */
+extern void NRF_CodecResync(NrfCodecCtx_t *ctx)
+{
+    ctx->isRefValid = false;
+}
+
+
+/*
+ *  Decodes payload into "samples", returns number of samples decoded (0 if
+ *  payload is malformed or its reference is unknown - wait for key packet)
+ */
+extern uint8_t NRF_CodecDecode(NrfCodecCtx_t *ctx, const uint8_t *bufPtr, uint8_t size, int32_t *samples, uint8_t maxSamples)
+{
+    uint8_t fields = ctx->fieldCount;
+    uint8_t pos = 0;
+    uint8_t count = 0;
+
+    if( size < 1 )
+    {
+        return 0;
+    }
+
+    bool isKey = bufPtr[pos] & CODEC_KEY_MASK;
+    uint8_t seq = bufPtr[pos++] & CODEC_SEQ_MASK;
+    const int32_t *prevPtr = NULL;
+
+    /* Look up reference among decoded packets */
+    if( !isKey )
+    {
+        if( size < 2 )
+        {
+            return 0;
+        }
+
+        uint8_t refSeq = bufPtr[pos++];
+        for(uint8_t i = 0; i < ctx->histCount; i++)
+        {
+            if( ctx->histSeq[i] == refSeq )
+            {
+                prevPtr = ctx->hist[i];
+                break;
+            }
+        }
+
+        if( prevPtr == NULL )
+        {
+            return 0;
+        }
+    }
+
+    while( (pos < size) && (count < maxSamples) )
+    {
+        int32_t *samplePtr = &samples[count * fields];
+
+        for(uint8_t i = 0; i < fields; i++)
+        {
+            int32_t delta;
+            uint8_t len = VarintRead(&bufPtr[pos], size - pos, &delta);
+
+            /* Truncated sample */
+            if( len == 0 )
+            {
+                return 0;
+            }
+            pos += len;
+
+            uint32_t prev = (prevPtr != NULL) ? (uint32_t)prevPtr[i] : 0;
+            samplePtr[i] = (int32_t)(prev + (uint32_t)delta);
+        }
+
+        prevPtr = samplePtr;
+        count++;
+    }
+
+    /* Trailing bytes (more samples than "maxSamples") or empty packet */
+    if( (pos != size) || (count == 0) )
+    {
+        return 0;
+    }
+
+    /* Remember last sample as possible future reference */
+    uint8_t slot = ctx->histNext;
+    for(uint8_t i = 0; i < ctx->histCount; i++)
+    {
+        if( ctx->histSeq[i] == seq )
+        {
+            slot = i;       // Retransmitted sequence replaces its old entry
+            break;
+        }
+    }
+
+    ctx->histSeq[slot] = seq;
+    memcpy(ctx->hist[slot], prevPtr, fields * sizeof(int32_t));
+
+    if( slot == ctx->histNext )
+    {
+        ctx->histNext = (ctx->histNext + 1) % NRF_CODEC_HISTORY;
+        if( ctx->histCount < NRF_CODEC_HISTORY )
+        {
+            ctx->histCount++;
+        }
+    }
+
+    return count;
+}
+
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+/*
+ *  Writes zigzag varint, returns number of bytes written
+ */
+static inline uint8_t VarintWrite(uint8_t *bufPtr, int32_t value)
+{
+    uint32_t zigzag = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+    uint8_t len = 0;
+
+    while( zigzag >= 0x80 )
+    {
+        bufPtr[len++] = (uint8_t)zigzag | 0x80;
+        zigzag >>= 7;
+    }
+    bufPtr[len++] = (uint8_t)zigzag;
+
+    return len;
+}
+
+
+/*
+ *  Reads zigzag varint, returns number of bytes read (0 if truncated)
+ */
+static inline uint8_t VarintRead(const uint8_t *bufPtr, uint8_t size, int32_t *valuePtr)
+{
+    uint32_t zigzag = 0;
+
+    for(uint8_t i = 0; (i < size) && (i < CODEC_VARINT_MAX); i++)
+    {
+        zigzag |= (uint32_t)(bufPtr[i] & 0x7F) << (7 * i);
+
+        if( !(bufPtr[i] & 0x80) )
+        {
+            *valuePtr = (int32_t)((zigzag >> 1) ^ -(zigzag & 0x01));
+            return i + 1;
+        }
+    }
+
+    return 0;
+}
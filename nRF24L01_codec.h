@@ -0,0 +1,75 @@
+#ifndef NRF24L01_CODEC_H
+#define	NRF24L01_CODEC_H
+
+
+/******************************************************************************/
+/*----------------------------------Includes----------------------------------*/
+/******************************************************************************/
+
+/** Standard libs **/
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************/
+/*---------------------------------MACROS-------------------------------------*/
+/******************************************************************************/
+
+/* Maximum number of numeric fields per sample */
+#ifndef NRF_CODEC_MAX_FIELDS
+#define NRF_CODEC_MAX_FIELDS    8
+#endif
+
+/* Decoded packets remembered as delta references (covers lost ACKs) */
+#ifndef NRF_CODEC_HISTORY
+#define NRF_CODEC_HISTORY       4
+#endif
+
+/* Maximum encoded packet size (nRF payload limit) */
+#define NRF_CODEC_PAYLOAD_SIZE  32
+
+/* NOTE: Packet layout (all values zigzag varints, LSB group first)
+ *       [0]    KEY flag (bit 7) | sequence number (bits 6-0)
+ *       [1]    Reference sequence number (delta packets only)
+ *       [..]   Samples, each field as delta against the same field of the
+ *              previous sample (first sample against reference, or against
+ *              zero in key packets) */
+
+/******************************************************************************/
+/*-----------------------------Data Structures--------------------------------*/
+/******************************************************************************/
+
+/* Codec state of a single link (one per destination on PTX, per source on
+ * PRX). Encoder and decoder halves are independent */
+typedef struct {
+    uint8_t     fieldCount;
+    uint8_t     keyInterval;                            // Packets between forced key packets (0 = never)
+
+    /* Encoder state */
+    uint8_t     seq;                                    // Sequence number of next packet
+    uint8_t     sinceKey;                               // Packets since last key packet
+    bool        isRefValid;
+    uint8_t     refSeq;
+    int32_t     ref[NRF_CODEC_MAX_FIELDS];              // Last sample of last acknowledged packet
+    bool        isPending;
+    uint8_t     pendSeq;
+    int32_t     pend[NRF_CODEC_MAX_FIELDS];             // Last sample of packet awaiting ACK
+
+    /* Decoder state */
+    uint8_t     histCount;
+    uint8_t     histNext;
+    uint8_t     histSeq[NRF_CODEC_HISTORY];
+    int32_t     hist[NRF_CODEC_HISTORY][NRF_CODEC_MAX_FIELDS];  // Last sample of decoded packets
+} NrfCodecCtx_t;
+
+/******************************************************************************/
+/*---------------------------- Function Prototypes----------------------------*/
+/******************************************************************************/
+
+bool NRF_CodecInit(NrfCodecCtx_t *ctx, uint8_t fieldCount, uint8_t keyInterval);
+uint8_t NRF_CodecEncode(NrfCodecCtx_t *ctx, const int32_t *samples, uint8_t sampleCount, uint8_t *bufPtr, uint8_t *sizePtr);
+void NRF_CodecConfirm(NrfCodecCtx_t *ctx, bool isAcked);
+void NRF_CodecResync(NrfCodecCtx_t *ctx);
+uint8_t NRF_CodecDecode(NrfCodecCtx_t *ctx, const uint8_t *bufPtr, uint8_t size, int32_t *samples, uint8_t maxSamples);
+
+
+#endif	/* NRF24L01_CODEC_H */
@@ -0,0 +1,445 @@
+#include "nRF24L01_fec.h"
+
+/** Standard libs **/
+#include <string.h>
+
+/******************************************************************************/
+/*--------------------------------Local Macros--------------------------------*/
+/******************************************************************************/
+
+/* GF(256) generator polynomial x^8 + x^4 + x^3 + x^2 + 1 */
+#define GF_POLY                 0x11D
+
+#define FEC_HEADER_SIZE         2
+
+/******************************************************************************/
+/*--------------------------Local Data Variables------------------------------*/
+/******************************************************************************/
+
+/** GF(256) tables (exponent table doubled, so log sums need no modulo) **/
+static uint8_t gfExp[512];
+static uint8_t gfLog[256];
+static bool isGfReady = false;
+
+/******************************************************************************/
+/*------------------------Local Function Prototypes---------------------------*/
+/******************************************************************************/
+
+static void GfInit(void);
+static inline uint8_t GfMul(uint8_t a, uint8_t b);
+static inline uint8_t GfInv(uint8_t a);
+static void GfMulAdd(uint8_t *dstPtr, const uint8_t *srcPtr, uint8_t coef, uint8_t size);
+static void FecCloseGroup(NrfFecCtx_t *ctx);
+static void FecRecover(NrfFecCtx_t *ctx);
+
+
+/******************************************************************************/
+/*----------------------External Function Definitions-------------------------*/
+/******************************************************************************/
+
+/*
+ *  Initializes stream with groups of "dataFrames" (N) protected by
+ *  "parityFrames" (K), decoder hands data over to "handler" (NULL on encoder)
+ */
+extern bool NRF_FecInit(NrfFecCtx_t *ctx, uint8_t dataFrames, uint8_t parityFrames, NrfFecHandler_t handler, void *context)
+{
+    if( (dataFrames == 0) || (dataFrames > NRF_FEC_MAX_DATA_FRAMES) ||
+        (parityFrames == 0) || (parityFrames > NRF_FEC_MAX_PARITY_FRAMES) )
+    {
+        return false;
+    }
+    
+    GfInit();
+    
+    memset(ctx, 0, sizeof(NrfFecCtx_t));
+    ctx->dataFrames = dataFrames;
+    ctx->parityFrames = parityFrames;
+    ctx->handler = handler;
+    ctx->context = context;
+    ctx->stats.redundancyPct = (parityFrames * 100) / dataFrames;
+    
+    /* Cauchy matrix 1 / (x_j + y_i), columns scaled so that row 0 is all ones
+     * (scaling keeps every square sub-matrix invertible) */
+    for(uint8_t i = 0; i < dataFrames; i++)
+    {
+        uint8_t y = parityFrames + i;
+        uint8_t scale = y;                  // Inverse of row 0 coefficient 1 / (0 + y)
+        
+        for(uint8_t j = 0; j < parityFrames; j++)
+        {
+            ctx->coef[j][i] = GfMul(GfInv(j ^ y), scale);
+        }
+    }
+    
+    return true;
+}
+
+
+/*
+ *  Builds data frame into "framePtr", returns frame size (0 if data is too
+ *  long or parity frames of the group are not taken yet, see NRF_FecParity())
+ */
+extern uint8_t NRF_FecEncode(NrfFecCtx_t *ctx, const void *dataPtr, uint8_t size, uint8_t *framePtr)
+{
+    if( (size > NRF_FEC_MAX_DATA_SIZE) || (ctx->txIndex >= ctx->dataFrames) )
+    {
+        return 0;
+    }
+    
+    uint8_t *blockPtr = &framePtr[FEC_HEADER_SIZE - 1];
+    
+    framePtr[0] = ctx->txGroup;
+    framePtr[1] = ctx->txIndex;
+    memcpy(&framePtr[FEC_HEADER_SIZE], dataPtr, size);
+    
+    /* Protected block is length byte + data (index byte borrowed for length) */
+    blockPtr[0] = size;
+    for(uint8_t j = 0; j < ctx->parityFrames; j++)
+    {
+        GfMulAdd(ctx->txParity[j], blockPtr, ctx->coef[j][ctx->txIndex], size + 1);
+    }
+    framePtr[1] = ctx->txIndex;
+    
+    if( (size + 1) > ctx->txParitySize )
+    {
+        ctx->txParitySize = size + 1;
+    }
+    
+    ctx->txIndex++;
+    
+    return size + FEC_HEADER_SIZE;
+}
+
+
+/*
+ *  Builds next parity frame of a complete group into "framePtr", returns
+ *  frame size (0 if no parity frame is due)
+ */
+extern uint8_t NRF_FecParity(NrfFecCtx_t *ctx, uint8_t *framePtr)
+{
+    if( ctx->txIndex < ctx->dataFrames )
+    {
+        return 0;
+    }
+    
+    uint8_t size = ctx->txParitySize;
+    
+    framePtr[0] = ctx->txGroup;
+    framePtr[1] = ctx->txIndex;
+    memcpy(&framePtr[FEC_HEADER_SIZE], ctx->txParity[ctx->txIndex - ctx->dataFrames], size);
+    
+    /* Last parity frame closes the group */
+    if( ++ctx->txIndex >= (ctx->dataFrames + ctx->parityFrames) )
+    {
+        ctx->txGroup++;
+        ctx->txIndex = 0;
+        ctx->txParitySize = 0;
+        memset(ctx->txParity, 0, sizeof(ctx->txParity));
+    }
+    
+    return size + FEC_HEADER_SIZE;
+}
+
+
+/*
+ *  Accepts received frame, hands data frames over immediately and lost ones
+ *  as soon as N frames of the group are in
+ */
+extern void NRF_FecDecode(NrfFecCtx_t *ctx, const uint8_t *framePtr, uint8_t size)
+{
+    uint8_t frames = ctx->dataFrames + ctx->parityFrames;
+    
+    if( (size < FEC_HEADER_SIZE) || (framePtr[1] >= frames) ||
+        ((size - FEC_HEADER_SIZE) > ((framePtr[1] < ctx->dataFrames) ? NRF_FEC_MAX_DATA_SIZE : NRF_FEC_BLOCK_SIZE)) )
+    {
+        ctx->stats.discarded++;
+        return;
+    }
+    
+    uint8_t group = framePtr[0];
+    uint8_t index = framePtr[1];
+    uint8_t length = size - FEC_HEADER_SIZE;
+    
+    /* Newer group closes current one, older group arrived too late */
+    if( ctx->isRxGroupValid && (group != ctx->rxGroup) )
+    {
+        if( (int8_t)(group - ctx->rxGroup) < 0 )
+        {
+            ctx->stats.discarded++;
+            return;
+        }
+        
+        FecCloseGroup(ctx);
+        
+        /* Groups lost entirely */
+        ctx->stats.lost += (uint32_t)ctx->dataFrames * (uint8_t)(group - ctx->rxGroup - 1);
+    }
+    
+    if( !ctx->isRxGroupValid )
+    {
+        ctx->isRxGroupValid = true;
+        ctx->rxGroup = group;
+        ctx->rxMask = 0;
+        ctx->doneMask = 0;
+    }
+    
+    /* Duplicate (or data frame already restored) */
+    if( ctx->rxMask & (1UL << index) )
+    {
+        ctx->stats.discarded++;
+        return;
+    }
+    
+    uint8_t *blockPtr = ctx->rxBlock[index];
+    memset(blockPtr, 0, NRF_FEC_BLOCK_SIZE);
+    ctx->rxMask |= 1UL << index;
+    
+    if( index < ctx->dataFrames )
+    {
+        blockPtr[0] = length;
+        memcpy(&blockPtr[1], &framePtr[FEC_HEADER_SIZE], length);
+        
+        ctx->doneMask |= 1UL << index;
+        ctx->stats.delivered++;
+        if( ctx->handler != NULL )
+        {
+            ctx->handler(&blockPtr[1], length, ctx->context);
+        }
+    }
+    else
+    {
+        memcpy(blockPtr, &framePtr[FEC_HEADER_SIZE], length);
+    }
+    
+    /* Any N frames restore the rest of data frames */
+    uint32_t dataMask = (1UL << ctx->dataFrames) - 1;
+    if( (ctx->doneMask != dataMask) && (__builtin_popcount(ctx->rxMask) >= ctx->dataFrames) )
+    {
+        FecRecover(ctx);
+    }
+}
+
+
+/*
+ *  Reads redundancy and recovery statistics
+ */
+extern void NRF_FecReadStats(const NrfFecCtx_t *ctx, NrfFecStats_t *stats)
+{
+    *stats = ctx->stats;
+}
+
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+/*
+ *  Builds GF(256) exponent and logarithm tables (once)
+ */
+static void GfInit(void)
+{
+    if( isGfReady )
+    {
+        return;
+    }
+    
+    uint16_t x = 1;
+    for(uint16_t i = 0; i < 255; i++)
+    {
+        gfExp[i] = (uint8_t)x;
+        gfExp[i + 255] = (uint8_t)x;
+        gfLog[x] = (uint8_t)i;
+        
+        x <<= 1;
+        if( x & 0x100 )
+        {
+            x ^= GF_POLY;
+        }
+    }
+    gfExp[510] = gfExp[0];
+    gfExp[511] = gfExp[1];
+    
+    isGfReady = true;
+}
+
+
+static inline uint8_t GfMul(uint8_t a, uint8_t b)
+{
+    return (a && b) ? gfExp[gfLog[a] + gfLog[b]] : 0;
+}
+
+
+static inline uint8_t GfInv(uint8_t a)
+{
+    return gfExp[255 - gfLog[a]];
+}
+
+
+/*
+ *  dst += coef * src over GF(256) (plain XOR for coefficient 1)
+ */
+static void GfMulAdd(uint8_t *dstPtr, const uint8_t *srcPtr, uint8_t coef, uint8_t size)
+{
+    if( coef == 0 )
+    {
+        return;
+    }
+    
+    if( coef == 1 )
+    {
+        for(uint8_t b = 0; b < size; b++)
+        {
+            dstPtr[b] ^= srcPtr[b];
+        }
+        return;
+    }
+    
+    uint16_t logCoef = gfLog[coef];
+    for(uint8_t b = 0; b < size; b++)
+    {
+        if( srcPtr[b] )
+        {
+            dstPtr[b] ^= gfExp[logCoef + gfLog[srcPtr[b]]];
+        }
+    }
+}
+
+
+/*
+ *  Accounts data frames of current group that were neither received nor
+ *  restored
+ */
+static void FecCloseGroup(NrfFecCtx_t *ctx)
+{
+    ctx->stats.groups++;
+    ctx->stats.lost += ctx->dataFrames - __builtin_popcount(ctx->doneMask);       // Inconsistent ones counted on recovery
+    ctx->isRxGroupValid = false;
+}
+
+
+/*
+ *  Restores missing data frames from received parity frames (solves the
+ *  missing x missing system by Gauss-Jordan elimination over GF(256))
+ */
+static void FecRecover(NrfFecCtx_t *ctx)
+{
+    uint8_t missing[NRF_FEC_MAX_PARITY_FRAMES];
+    uint8_t parity[NRF_FEC_MAX_PARITY_FRAMES];
+    uint8_t matrix[NRF_FEC_MAX_PARITY_FRAMES][NRF_FEC_MAX_PARITY_FRAMES];
+    uint8_t syndrome[NRF_FEC_MAX_PARITY_FRAMES][NRF_FEC_BLOCK_SIZE];
+    uint8_t count = 0;
+    uint8_t parityCount = 0;
+    
+    for(uint8_t i = 0; (i < ctx->dataFrames) && (count < NRF_FEC_MAX_PARITY_FRAMES); i++)
+    {
+        if( !(ctx->doneMask & (1UL << i)) )
+        {
+            missing[count++] = i;
+        }
+    }
+    for(uint8_t j = 0; (j < ctx->parityFrames) && (parityCount < count); j++)
+    {
+        if( ctx->rxMask & (1UL << (ctx->dataFrames + j)) )
+        {
+            parity[parityCount++] = j;
+        }
+    }
+    
+    if( parityCount < count )
+    {
+        return;
+    }
+    
+    /* Syndrome = parity minus contribution of known data frames */
+    for(uint8_t t = 0; t < count; t++)
+    {
+        uint8_t j = parity[t];
+        
+        memcpy(syndrome[t], ctx->rxBlock[ctx->dataFrames + j], NRF_FEC_BLOCK_SIZE);
+        for(uint8_t i = 0; i < ctx->dataFrames; i++)
+        {
+            if( ctx->doneMask & (1UL << i) )
+            {
+                GfMulAdd(syndrome[t], ctx->rxBlock[i], ctx->coef[j][i], NRF_FEC_BLOCK_SIZE);
+            }
+        }
+        for(uint8_t u = 0; u < count; u++)
+        {
+            matrix[t][u] = ctx->coef[j][missing[u]];
+        }
+    }
+    
+    /* Gauss-Jordan elimination (Cauchy sub-matrix is always invertible) */
+    for(uint8_t c = 0; c < count; c++)
+    {
+        uint8_t pivot = c;
+        while( matrix[pivot][c] == 0 )
+        {
+            pivot++;
+        }
+        
+        if( pivot != c )
+        {
+            uint8_t rowTemp[NRF_FEC_MAX_PARITY_FRAMES];
+            uint8_t blockTemp[NRF_FEC_BLOCK_SIZE];
+            
+            memcpy(rowTemp, matrix[c], sizeof(rowTemp));
+            memcpy(matrix[c], matrix[pivot], sizeof(rowTemp));
+            memcpy(matrix[pivot], rowTemp, sizeof(rowTemp));
+            memcpy(blockTemp, syndrome[c], sizeof(blockTemp));
+            memcpy(syndrome[c], syndrome[pivot], sizeof(blockTemp));
+            memcpy(syndrome[pivot], blockTemp, sizeof(blockTemp));
+        }
+        
+        /* Normalize pivot row */
+        uint8_t inv = GfInv(matrix[c][c]);
+        for(uint8_t u = 0; u < count; u++)
+        {
+            matrix[c][u] = GfMul(matrix[c][u], inv);
+        }
+        for(uint8_t b = 0; b < NRF_FEC_BLOCK_SIZE; b++)
+        {
+            syndrome[c][b] = GfMul(syndrome[c][b], inv);
+        }
+        
+        /* Eliminate column from other rows (subtraction is XOR) */
+        for(uint8_t r = 0; r < count; r++)
+        {
+            uint8_t factor = matrix[r][c];
+            
+            if( (r == c) || (factor == 0) )
+            {
+                continue;
+            }
+            
+            for(uint8_t u = 0; u < count; u++)
+            {
+                matrix[r][u] ^= GfMul(factor, matrix[c][u]);
+            }
+            GfMulAdd(syndrome[r], syndrome[c], factor, NRF_FEC_BLOCK_SIZE);
+        }
+    }
+    
+    for(uint8_t u = 0; u < count; u++)
+    {
+        uint8_t index = missing[u];
+        uint8_t *blockPtr = ctx->rxBlock[index];
+        
+        memcpy(blockPtr, syndrome[u], NRF_FEC_BLOCK_SIZE);
+        ctx->rxMask |= 1UL << index;
+        ctx->doneMask |= 1UL << index;
+        
+        /* Inconsistent group (e.g. frames of two streams mixed) */
+        if( blockPtr[0] > NRF_FEC_MAX_DATA_SIZE )
+        {
+            ctx->stats.lost++;
+            continue;
+        }
+        
+        ctx->stats.recovered++;
+        if( ctx->handler != NULL )
+        {
+            ctx->handler(&blockPtr[1], blockPtr[0], ctx->context);
+        }
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef NRF24L01_FEC_H
+#define	NRF24L01_FEC_H
+
+
+/******************************************************************************/
+/*----------------------------------Includes----------------------------------*/
+/******************************************************************************/
+
+/** Standard libs **/
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************/
+/*---------------------------------MACROS-------------------------------------*/
+/******************************************************************************/
+
+/* Maximum data frames per group (N) */
+#ifndef NRF_FEC_MAX_DATA_FRAMES
+#define NRF_FEC_MAX_DATA_FRAMES     16
+#endif
+
+/* Maximum parity frames per group (K, lost frames recoverable per group) */
+#ifndef NRF_FEC_MAX_PARITY_FRAMES
+#define NRF_FEC_MAX_PARITY_FRAMES   4
+#endif
+
+#if (NRF_FEC_MAX_DATA_FRAMES + NRF_FEC_MAX_PARITY_FRAMES) > 32
+    #error "NRF_FEC_MAX_DATA_FRAMES + NRF_FEC_MAX_PARITY_FRAMES must not exceed 32"
+#endif
+
+/* Maximum user data per frame (2-byte header, parity also covers length) */
+#define NRF_FEC_MAX_DATA_SIZE       29
+
+/* Protected block of a frame (length byte + data) */
+#define NRF_FEC_BLOCK_SIZE          (NRF_FEC_MAX_DATA_SIZE + 1)
+
+/* NOTE: Frame layout
+ *       [0]    Group number (wrapping)
+ *       [1]    Index in group (0..N-1 data, N..N+K-1 parity)
+ *       [..]   Data frame: user data
+ *              Parity frame: parity of length bytes and zero padded data
+ *       Parity frame j is sum over GF(256) of coef[j][i] * block[i], where
+ *       coefficients form a Cauchy matrix normalised so that the first parity
+ *       frame is a plain XOR. Any N of the N+K frames restore the group */
+
+/******************************************************************************/
+/*-----------------------------Data Structures--------------------------------*/
+/******************************************************************************/
+
+/* Recovered or received data frame handler */
+typedef void (*NrfFecHandler_t)(const uint8_t *dataPtr, uint8_t size, void *context);
+
+/* Redundancy and recovery statistics */
+typedef struct {
+    uint16_t    redundancyPct;          // Parity frames per 100 data frames (K / N)
+    uint32_t    groups;                 // Groups closed by decoder
+    uint32_t    delivered;              // Data frames received directly
+    uint32_t    recovered;              // Data frames restored from parity
+    uint32_t    lost;                   // Data frames not recoverable
+    uint32_t    discarded;              // Late, duplicate or malformed frames
+} NrfFecStats_t;
+
+/* FEC state of a single stream. Encoder and decoder halves are independent */
+typedef struct {
+    uint8_t         dataFrames;                                         // N
+    uint8_t         parityFrames;                                       // K
+    uint8_t         coef[NRF_FEC_MAX_PARITY_FRAMES][NRF_FEC_MAX_DATA_FRAMES];
+
+    /* Encoder state */
+    uint8_t         txGroup;
+    uint8_t         txIndex;                                            // Next frame index in group
+    uint8_t         txParitySize;                                       // Longest block in group
+    uint8_t         txParity[NRF_FEC_MAX_PARITY_FRAMES][NRF_FEC_BLOCK_SIZE];
+
+    /* Decoder state */
+    NrfFecHandler_t handler;
+    void           *context;
+    bool            isRxGroupValid;
+    uint8_t         rxGroup;
+    uint32_t        rxMask;                                             // Frames received in group
+    uint32_t        doneMask;                                           // Data frames handed over
+    uint8_t         rxBlock[NRF_FEC_MAX_DATA_FRAMES + NRF_FEC_MAX_PARITY_FRAMES][NRF_FEC_BLOCK_SIZE];
+
+    NrfFecStats_t   stats;
+} NrfFecCtx_t;
+
+/******************************************************************************/
+/*---------------------------- Function Prototypes----------------------------*/
+/******************************************************************************/
+
+bool NRF_FecInit(NrfFecCtx_t *ctx, uint8_t dataFrames, uint8_t parityFrames, NrfFecHandler_t handler, void *context);
+uint8_t NRF_FecEncode(NrfFecCtx_t *ctx, const void *dataPtr, uint8_t size, uint8_t *framePtr);
+uint8_t NRF_FecParity(NrfFecCtx_t *ctx, uint8_t *framePtr);
+void NRF_FecDecode(NrfFecCtx_t *ctx, const uint8_t *framePtr, uint8_t size);
+void NRF_FecReadStats(const NrfFecCtx_t *ctx, NrfFecStats_t *stats);
+
+
+#endif	/* NRF24L01_FEC_H */
@@ -0,0 +1,557 @@
+#include "nRF24L01_ota.h"
+
+/** Standard libs **/
+#include <string.h>
+
+/******************************************************************************/
+/*--------------------------------Local Macros--------------------------------*/
+/******************************************************************************/
+
+#define OTA_FRAME_START         0x01
+#define OTA_FRAME_DATA          0x02
+#define OTA_FRAME_POLL          0x03
+
+#define OTA_DATA_HEADER_SIZE    4
+#define OTA_START_SIZE          9
+#define OTA_STATUS_SIZE         12
+
+/******************************************************************************/
+/*--------------------------Local Data Variables------------------------------*/
+/******************************************************************************/
+
+/** Receiving transfer fed by the driver RX sink **/
+static NrfOtaRxCtx_t *volatile otaRxCtx = NULL;
+
+/** CRC-32 nibble table (reflected polynomial 0xEDB88320) **/
+static const uint32_t crcTable[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+/******************************************************************************/
+/*------------------------Local Function Prototypes---------------------------*/
+/******************************************************************************/
+
+static void OtaRxSink(const uint8_t *payldPtr, uint8_t length, NrfRxPipeNo_t pipeNo);
+static void OtaRxData(NrfOtaRxCtx_t *ctx, const uint8_t *dataPtr, uint32_t offset, uint8_t size);
+static void OtaRxGap(NrfOtaRxCtx_t *ctx);
+static void OtaTxStatus(NrfOtaTxCtx_t *ctx, const uint8_t *statusPtr);
+static void OtaTxRewind(NrfOtaTxCtx_t *ctx, uint32_t offset);
+static bool OtaTxQueue(NrfOtaTxCtx_t *ctx);
+static inline uint32_t Le32Read(const uint8_t *bufPtr);
+static inline void Le32Write(uint8_t *bufPtr, uint32_t value);
+
+
+/******************************************************************************/
+/*----------------------External Function Definitions-------------------------*/
+/******************************************************************************/
+
+/*
+ *  Starts reception of images (PRX configured beforehand), payloads are
+ *  taken over by the RX sink and written to flash by NRF_OtaRxTask()
+ */
+extern bool NRF_OtaRxStart(NrfOtaRxCtx_t *ctx, NrfPayloadConfig_t payldConfig, NrfRxPipeNo_t pipeNo, NrfOtaSink_t sink, void *context)
+{
+    if( (sink == NULL) || (pipeNo > NRF_RX_PIPE_5) )
+    {
+        return false;
+    }
+    
+    memset(ctx, 0, sizeof(NrfOtaRxCtx_t));
+    ctx->payldConfig = payldConfig;
+    ctx->pipeNo = pipeNo;
+    ctx->sink = sink;
+    ctx->context = context;
+    ctx->isStatusDirty = true;
+    
+    otaRxCtx = ctx;
+    NRF_SetRxSink(OtaRxSink);
+    
+    return NRF_StartReception(payldConfig, ctx->rxBuffer);
+}
+
+
+/*
+ *  Continues an image whose first "committed" pages are already in flash
+ *  (e.g. after reset), "runningCrc" is CRC-32 of these pages
+ */
+extern bool NRF_OtaRxRestore(NrfOtaRxCtx_t *ctx, uint32_t imageSize, uint32_t imageCrc, uint16_t committed, uint32_t runningCrc)
+{
+    if( ((uint32_t)committed * NRF_OTA_PAGE_SIZE) >= imageSize )
+    {
+        return false;
+    }
+    
+    uint32_t intStatus = __builtin_disable_interrupts();
+    
+    ctx->generation++;
+    ctx->imageSize = imageSize;
+    ctx->imageCrc = imageCrc;
+    ctx->committed = committed;
+    ctx->runningCrc = runningCrc;
+    ctx->expected = (uint32_t)committed * NRF_OTA_PAGE_SIZE;
+    ctx->isPageFull[0] = false;
+    ctx->isPageFull[1] = false;
+    ctx->isGap = false;
+    ctx->state = NRF_OTA_TRANSFER;
+    ctx->isStatusDirty = true;
+    
+    __builtin_mtc0(12, 0, intStatus);
+    
+    return true;
+}
+
+
+/*
+ *  Writes completed pages through the flash sink (overlaps reception of the
+ *  next page) and refreshes status ACK payload, call from main loop
+ */
+extern NrfOtaState_t NRF_OtaRxTask(NrfOtaRxCtx_t *ctx)
+{
+    uint8_t generation = ctx->generation;
+    uint8_t buf = ctx->committed & 1;
+    
+    if( (ctx->state == NRF_OTA_TRANSFER) && ctx->isPageFull[buf] )
+    {
+        uint32_t offset = (uint32_t)ctx->committed * NRF_OTA_PAGE_SIZE;
+        bool isWritten = ctx->sink(offset, ctx->page[buf], ctx->pageSize[buf], ctx->context);
+        
+        /* New image started meanwhile */
+        if( generation != ctx->generation )
+        {
+            return ctx->state;
+        }
+        
+        if( !isWritten )
+        {
+            ctx->state = NRF_OTA_ERROR;
+        }
+        else
+        {
+            ctx->runningCrc = NRF_OtaCrc32(ctx->runningCrc, ctx->page[buf], ctx->pageSize[buf]);
+            ctx->committed++;
+            ctx->isPageFull[buf] = false;
+            
+            if( (offset + ctx->pageSize[buf]) >= ctx->imageSize )
+            {
+                ctx->state = (ctx->runningCrc == ctx->imageCrc) ? NRF_OTA_DONE : NRF_OTA_ERROR;
+            }
+        }
+        
+        ctx->isStatusDirty = true;
+    }
+    
+    /* Status goes out with ACK of a following frame */
+    if( ctx->isStatusDirty && !NRF_IsRxFifoLoading() )
+    {
+        ctx->isStatusDirty = false;
+        
+        ctx->status[0] = ctx->state;
+        ctx->status[1] = ctx->rewindSeq;
+        Le32Write(&ctx->status[2], ctx->imageCrc);
+        Le32Write(&ctx->status[6], ctx->expected);
+        ctx->status[10] = (uint8_t)ctx->committed;
+        ctx->status[11] = (uint8_t)(ctx->committed >> 8);
+        
+        NRF_StoreAckPayload(ctx->payldConfig, ctx->pipeNo, ctx->status, OTA_STATUS_SIZE);
+    }
+    
+    return ctx->state;
+}
+
+
+/*
+ *  Stops taking over payloads (reception itself is left running)
+ */
+extern void NRF_OtaRxStop(NrfOtaRxCtx_t *ctx)
+{
+    if( otaRxCtx == ctx )
+    {
+        NRF_SetRxSink(NULL);
+        otaRxCtx = NULL;
+    }
+}
+
+
+/*
+ *  Starts sending image (PTX configured beforehand), the receiver reports
+ *  where to continue if it already holds a part of the same image. Context
+ *  is initialized here, a running transfer is stopped with NRF_OtaTxStop()
+ *  first
+ */
+extern void NRF_OtaTxStart(NrfOtaTxCtx_t *ctx, NrfPayloadConfig_t payldConfig, const uint8_t *imagePtr, uint32_t imageSize)
+{
+    memset(ctx, 0, sizeof(NrfOtaTxCtx_t));
+    ctx->payldConfig = payldConfig;
+    ctx->imagePtr = imagePtr;
+    ctx->imageSize = imageSize;
+    ctx->imageCrc = NRF_OtaCrc32(0, imagePtr, imageSize);
+    ctx->state = NRF_OTA_STARTING;
+}
+
+
+/*
+ *  Keeps up to NRF_OTA_TX_WINDOW frames queued and processes receiver status,
+ *  call from main loop until NRF_OTA_DONE or NRF_OTA_ERROR
+ */
+extern NrfOtaState_t NRF_OtaTxTask(NrfOtaTxCtx_t *ctx)
+{
+    if( ctx->state == NRF_OTA_IDLE )
+    {
+        return ctx->state;
+    }
+    
+    /* Retire frames in sending order */
+    while( ctx->slotCount )
+    {
+        NrfOpResult_t result;
+        uint8_t head = ctx->slotHead;
+        
+        if( !NRF_PollOp(ctx->slot[head].opHandle, &result) )
+        {
+            break;
+        }
+        
+        NRF_ReleaseOp(ctx->slot[head].opHandle);
+        ctx->slotHead = (head + 1) % NRF_OTA_TX_WINDOW;
+        ctx->slotCount--;
+        
+        if( (result.status == NRF_FLAG_ACK_PLD) && (result.length >= OTA_STATUS_SIZE) )
+        {
+            OtaTxStatus(ctx, ctx->slot[head].ack);
+        }
+        /* Data frame not delivered, go back to it */
+        else if( !(result.status & NRF_FLAG_TX_DS) && !ctx->slot[head].isStale &&
+                 (ctx->slot[head].frame[0] == OTA_FRAME_DATA) && (ctx->state == NRF_OTA_TRANSFER) )
+        {
+            OtaTxRewind(ctx, ctx->slot[head].offset);
+        }
+    }
+    
+    /* Finished transfer still drains its last frames */
+    while( (ctx->state != NRF_OTA_DONE) && (ctx->state != NRF_OTA_ERROR) && (ctx->slotCount < NRF_OTA_TX_WINDOW) )
+    {
+        if( !OtaTxQueue(ctx) )
+        {
+            break;
+        }
+    }
+    
+    return ctx->state;
+}
+
+
+/*
+ *  Stops sending, waits for queued frames to conclude and releases them
+ */
+extern void NRF_OtaTxStop(NrfOtaTxCtx_t *ctx)
+{
+    /* Frames can't be released while pending */
+    while( ctx->slotCount )
+    {
+        if( NRF_PollOp(ctx->slot[ctx->slotHead].opHandle, NULL) )
+        {
+            NRF_ReleaseOp(ctx->slot[ctx->slotHead].opHandle);
+            ctx->slotHead = (ctx->slotHead + 1) % NRF_OTA_TX_WINDOW;
+            ctx->slotCount--;
+        }
+    }
+    
+    ctx->state = NRF_OTA_IDLE;
+}
+
+
+/*
+ *  Computes CRC-32 (IEEE 802.3), "crc" is 0 or result of previous call
+ */
+extern uint32_t NRF_OtaCrc32(uint32_t crc, const uint8_t *dataPtr, uint32_t size)
+{
+    crc = ~crc;
+    
+    for(uint32_t i = 0; i < size; i++)
+    {
+        crc = crcTable[(crc ^ dataPtr[i]) & 0x0F] ^ (crc >> 4);
+        crc = crcTable[(crc ^ (dataPtr[i] >> 4)) & 0x0F] ^ (crc >> 4);
+    }
+    
+    return ~crc;
+}
+
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+/*
+ *  RX sink (executed within scope of driver ISR), takes over frames (POLL
+ *  frame only fetches status with its ACK)
+ */
+static void OtaRxSink(const uint8_t *payldPtr, uint8_t length, NrfRxPipeNo_t pipeNo)
+{
+    (void)pipeNo;
+    
+    NrfOtaRxCtx_t *ctx = otaRxCtx;
+    
+    if( ctx == NULL )
+    {
+        return;
+    }
+    
+    if( (payldPtr[0] == OTA_FRAME_DATA) && (length > OTA_DATA_HEADER_SIZE) )
+    {
+        uint32_t offset = payldPtr[1] | ((uint32_t)payldPtr[2] << 8) | ((uint32_t)payldPtr[3] << 16);
+        OtaRxData(ctx, &payldPtr[OTA_DATA_HEADER_SIZE], offset, length - OTA_DATA_HEADER_SIZE);
+    }
+    else if( (payldPtr[0] == OTA_FRAME_START) && (length >= OTA_START_SIZE) )
+    {
+        uint32_t imageSize = Le32Read(&payldPtr[1]);
+        uint32_t imageCrc = Le32Read(&payldPtr[5]);
+        
+        /* Same image continues where it stopped (partial page is kept) */
+        if( (ctx->state != NRF_OTA_IDLE) && (imageSize == ctx->imageSize) && (imageCrc == ctx->imageCrc) )
+        {
+            ctx->isGap = false;
+        }
+        else
+        {
+            ctx->generation++;
+            ctx->imageSize = imageSize;
+            ctx->imageCrc = imageCrc;
+            ctx->expected = 0;
+            ctx->committed = 0;
+            ctx->runningCrc = 0;
+            ctx->isPageFull[0] = false;
+            ctx->isPageFull[1] = false;
+            ctx->isGap = false;
+            ctx->state = (imageSize != 0) ? NRF_OTA_TRANSFER : NRF_OTA_ERROR;
+        }
+        
+        ctx->isStatusDirty = true;
+    }
+}
+
+
+/*
+ *  Copies in-order data into page buffers, marks gap on anything else
+ */
+static void OtaRxData(NrfOtaRxCtx_t *ctx, const uint8_t *dataPtr, uint32_t offset, uint8_t size)
+{
+    /* Duplicate (e.g. frame resent after lost ACK) */
+    if( (ctx->state != NRF_OTA_TRANSFER) || (offset < ctx->expected) )
+    {
+        return;
+    }
+    
+    if( (offset > ctx->expected) || ((offset + size) > ctx->imageSize) )
+    {
+        OtaRxGap(ctx);
+        return;
+    }
+    
+    while( size )
+    {
+        uint32_t expected = ctx->expected;
+        uint8_t buf = (expected / NRF_OTA_PAGE_SIZE) & 1;
+        uint16_t pos = expected % NRF_OTA_PAGE_SIZE;
+        
+        /* Page two pages back not written yet, sender has to come back */
+        if( ctx->isPageFull[buf] )
+        {
+            OtaRxGap(ctx);
+            return;
+        }
+        
+        uint16_t count = NRF_OTA_PAGE_SIZE - pos;
+        if( count > size )
+        {
+            count = size;
+        }
+        
+        memcpy(&ctx->page[buf][pos], dataPtr, count);
+        dataPtr += count;
+        size -= count;
+        ctx->expected = expected + count;
+        ctx->isGap = false;
+        
+        if( ((pos + count) == NRF_OTA_PAGE_SIZE) || (ctx->expected == ctx->imageSize) )
+        {
+            ctx->pageSize[buf] = pos + count;
+            ctx->isPageFull[buf] = true;
+        }
+    }
+}
+
+
+/*
+ *  Reports first dropped frame, sender goes back to expected offset
+ */
+static void OtaRxGap(NrfOtaRxCtx_t *ctx)
+{
+    if( !ctx->isGap )
+    {
+        ctx->isGap = true;
+        ctx->rewindSeq++;
+        ctx->isStatusDirty = true;
+    }
+}
+
+
+/*
+ *  Applies receiver status carried by ACK payload
+ */
+static void OtaTxStatus(NrfOtaTxCtx_t *ctx, const uint8_t *statusPtr)
+{
+    NrfOtaState_t rxState = statusPtr[0];
+    uint8_t rewindSeq = statusPtr[1];
+    uint32_t expected = Le32Read(&statusPtr[6]);
+    uint16_t committed = statusPtr[10] | (statusPtr[11] << 8);
+    
+    /* Receiver lost the transfer (e.g. reset), start over */
+    if( (rxState == NRF_OTA_IDLE) && (ctx->state != NRF_OTA_STARTING) )
+    {
+        ctx->state = NRF_OTA_STARTING;
+        return;
+    }
+    
+    /* Status of another image (stale ACK payload) */
+    if( Le32Read(&statusPtr[2]) != ctx->imageCrc )
+    {
+        return;
+    }
+    
+    if( (rxState == NRF_OTA_DONE) || (rxState == NRF_OTA_ERROR) )
+    {
+        ctx->state = rxState;
+        ctx->committed = committed;
+        return;
+    }
+    
+    if( rxState != NRF_OTA_TRANSFER )
+    {
+        return;
+    }
+    
+    /* Resume point of (partially) received image */
+    if( ctx->state == NRF_OTA_STARTING )
+    {
+        ctx->rewindSeq = rewindSeq;
+        ctx->committed = committed;
+        OtaTxRewind(ctx, expected);
+        return;
+    }
+    
+    if( committed > ctx->committed )
+    {
+        ctx->committed = committed;
+    }
+    
+    /* Newer gap report (older ACK payloads may still arrive) */
+    if( (int8_t)(rewindSeq - ctx->rewindSeq) > 0 )
+    {
+        ctx->rewindSeq = rewindSeq;
+        OtaTxRewind(ctx, expected);
+    }
+}
+
+
+/*
+ *  Continues sending from "offset", frames already queued are ignored
+ */
+static void OtaTxRewind(NrfOtaTxCtx_t *ctx, uint32_t offset)
+{
+    for(uint8_t i = 0; i < NRF_OTA_TX_WINDOW; i++)
+    {
+        ctx->slot[i].isStale = true;
+    }
+    
+    ctx->next = offset;
+    ctx->state = NRF_OTA_TRANSFER;
+    ctx->rewinds++;
+}
+
+
+/*
+ *  Queues next frame (data, or START/POLL while waiting for status), returns
+ *  false if nothing is to be queued now
+ */
+static bool OtaTxQueue(NrfOtaTxCtx_t *ctx)
+{
+    uint8_t idx = (ctx->slotHead + ctx->slotCount) % NRF_OTA_TX_WINDOW;
+    uint8_t *framePtr = ctx->slot[idx].frame;
+    uint8_t size;
+    
+    if( ctx->state == NRF_OTA_STARTING )
+    {
+        /* One frame at a time until receiver status arrives */
+        if( ctx->slotCount )
+        {
+            return false;
+        }
+        
+        framePtr[0] = OTA_FRAME_START;
+        Le32Write(&framePtr[1], ctx->imageSize);
+        Le32Write(&framePtr[5], ctx->imageCrc);
+        size = OTA_START_SIZE;
+    }
+    else if( ctx->next < ctx->imageSize )
+    {
+        uint32_t left = ctx->imageSize - ctx->next;
+        uint8_t count = (left > NRF_OTA_CHUNK_SIZE) ? NRF_OTA_CHUNK_SIZE : left;
+        
+        framePtr[0] = OTA_FRAME_DATA;
+        framePtr[1] = (uint8_t)ctx->next;
+        framePtr[2] = (uint8_t)(ctx->next >> 8);
+        framePtr[3] = (uint8_t)(ctx->next >> 16);
+        memcpy(&framePtr[OTA_DATA_HEADER_SIZE], &ctx->imagePtr[ctx->next], count);
+        size = OTA_DATA_HEADER_SIZE + count;
+    }
+    else
+    {
+        /* Everything sent, poll until last page is committed */
+        if( ctx->slotCount )
+        {
+            return false;
+        }
+        
+        ctx->state = NRF_OTA_VERIFY;
+        framePtr[0] = OTA_FRAME_POLL;
+        size = 1;
+    }
+    
+    NrfOpHandle_t opHandle = NRF_SendPayloadOp(ctx->payldConfig, ctx->slot[idx].ack, framePtr, size);
+    
+    /* Operation pool exhausted, retry on next call */
+    if( opHandle == NRF_OP_INVALID )
+    {
+        return false;
+    }
+    
+    ctx->slot[idx].opHandle = opHandle;
+    ctx->slot[idx].offset = ctx->next;
+    ctx->slot[idx].isStale = false;
+    ctx->slotCount++;
+    ctx->framesSent++;
+    
+    if( framePtr[0] == OTA_FRAME_DATA )
+    {
+        ctx->next += size - OTA_DATA_HEADER_SIZE;
+    }
+    
+    return true;
+}
+
+
+static inline uint32_t Le32Read(const uint8_t *bufPtr)
+{
+    return (uint32_t)bufPtr[0] | ((uint32_t)bufPtr[1] << 8) |
+           ((uint32_t)bufPtr[2] << 16) | ((uint32_t)bufPtr[3] << 24);
+}
+
+
+static inline void Le32Write(uint8_t *bufPtr, uint32_t value)
+{
+    bufPtr[0] = (uint8_t)value;
+    bufPtr[1] = (uint8_t)(value >> 8);
+    bufPtr[2] = (uint8_t)(value >> 16);
+    bufPtr[3] = (uint8_t)(value >> 24);
+}
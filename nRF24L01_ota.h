@@ -0,0 +1,134 @@
+#ifndef NRF24L01_OTA_H
+#define	NRF24L01_OTA_H
+
+
+/******************************************************************************/
+/*----------------------------------Includes----------------------------------*/
+/******************************************************************************/
+
+/** Custom libs **/
+#include "nRF24L01.h"
+
+/******************************************************************************/
+/*---------------------------------MACROS-------------------------------------*/
+/******************************************************************************/
+
+/* Flash page size committed at once by the receiver (double buffered) */
+#ifndef NRF_OTA_PAGE_SIZE
+#define NRF_OTA_PAGE_SIZE       1024
+#endif
+
+/* Data frames queued by the sender ahead of acknowledgments */
+#ifndef NRF_OTA_TX_WINDOW
+#define NRF_OTA_TX_WINDOW       4
+#endif
+
+/* Image bytes per data frame (frame type and 24-bit offset precede them) */
+#define NRF_OTA_CHUNK_SIZE      28
+
+/* NOTE: Frame layout (PTX -> PRX)
+ *       START  [0] 0x01, [1-4] image size, [5-8] image CRC-32
+ *       DATA   [0] 0x02, [1-3] image offset, [4..] up to 28 image bytes
+ *       POLL   [0] 0x03 (fetches status only)
+ *       Status (ACK payload, PRX -> PTX)
+ *              [0] NrfOtaState_t, [1] rewind sequence, [2-5] image CRC-32,
+ *              [6-9] expected offset, [10-11] committed pages
+ *       All values little-endian. Data frames must arrive in order, the
+ *       receiver bumps rewind sequence on first gap and the sender goes back
+ *       to expected offset */
+
+/******************************************************************************/
+/*----------------------------Enumeration Types-------------------------------*/
+/******************************************************************************/
+
+typedef enum {
+    NRF_OTA_IDLE = 0,
+    NRF_OTA_STARTING = 1,           // Sender waits for receiver status
+    NRF_OTA_TRANSFER = 2,
+    NRF_OTA_VERIFY = 3,             // Sender waits for last page commit
+    NRF_OTA_DONE = 4,
+    NRF_OTA_ERROR = 5               // CRC mismatch or flash write failure
+} NrfOtaState_t;
+
+/******************************************************************************/
+/*-----------------------------Data Structures--------------------------------*/
+/******************************************************************************/
+
+/* Flash sink, writes "size" bytes at image "offset" (page aligned), returns
+ * false on failure. Called from NRF_OtaRxTask() */
+typedef bool (*NrfOtaSink_t)(uint32_t offset, const uint8_t *dataPtr, uint16_t size, void *context);
+
+/* Receiving side of a transfer */
+typedef struct {
+    NrfPayloadConfig_t      payldConfig;
+    NrfRxPipeNo_t           pipeNo;                 // Pipe carrying status ACK payloads
+    NrfOtaSink_t            sink;
+    void                   *context;
+    
+    volatile NrfOtaState_t  state;
+    uint32_t                imageSize;
+    uint32_t                imageCrc;
+    volatile uint32_t       expected;               // Next image offset accepted
+    volatile uint16_t       committed;              // Pages written by sink
+    uint32_t                runningCrc;             // CRC-32 of committed pages
+    volatile uint8_t        rewindSeq;
+    volatile bool           isGap;
+    volatile uint8_t        generation;             // Bumped by every new image
+    volatile bool           isStatusDirty;
+    
+    /* Page "n" is filled in buffer "n & 1" while the other one is written */
+    volatile bool           isPageFull[2];
+    uint16_t                pageSize[2];
+    uint8_t                 page[2][NRF_OTA_PAGE_SIZE];
+    uint8_t                 rxBuffer[32];
+    uint8_t                 status[12];
+} NrfOtaRxCtx_t;
+
+/* Sending side of a transfer */
+typedef struct {
+    NrfPayloadConfig_t      payldConfig;
+    const uint8_t          *imagePtr;
+    uint32_t                imageSize;
+    uint32_t                imageCrc;
+    
+    NrfOtaState_t           state;
+    uint32_t                next;                   // Next image offset to send
+    uint8_t                 rewindSeq;              // Last rewind sequence seen
+    uint16_t                committed;              // Pages committed by receiver
+    
+    /* Ring of queued frames (oldest at "slotHead") */
+    uint8_t                 slotHead;
+    uint8_t                 slotCount;
+    struct {
+        NrfOpHandle_t       opHandle;
+        uint32_t            offset;
+        bool                isStale;                // Sent before last rewind
+        uint8_t             frame[32];
+        uint8_t             ack[32];
+    } slot[NRF_OTA_TX_WINDOW];
+    
+    /* Statistics */
+    uint32_t                framesSent;
+    uint32_t                rewinds;
+} NrfOtaTxCtx_t;
+
+/******************************************************************************/
+/*---------------------------- Function Prototypes----------------------------*/
+/******************************************************************************/
+
+/* PRX functions */
+bool NRF_OtaRxStart(NrfOtaRxCtx_t *ctx, NrfPayloadConfig_t payldConfig, NrfRxPipeNo_t pipeNo, NrfOtaSink_t sink, void *context);
+bool NRF_OtaRxRestore(NrfOtaRxCtx_t *ctx, uint32_t imageSize, uint32_t imageCrc, uint16_t committed, uint32_t runningCrc);
+NrfOtaState_t NRF_OtaRxTask(NrfOtaRxCtx_t *ctx);
+void NRF_OtaRxStop(NrfOtaRxCtx_t *ctx);
+
+/* PTX functions */
+void NRF_OtaTxStart(NrfOtaTxCtx_t *ctx, NrfPayloadConfig_t payldConfig, const uint8_t *imagePtr, uint32_t imageSize);
+NrfOtaState_t NRF_OtaTxTask(NrfOtaTxCtx_t *ctx);
+void NRF_OtaTxStop(NrfOtaTxCtx_t *ctx);
+
+/* CRC-32 (IEEE 802.3) of image, continue with previous value (0 to start) */
+uint32_t NRF_OtaCrc32(uint32_t crc, const uint8_t *dataPtr, uint32_t size);
+
+
+#endif	/* NRF24L01_OTA_H */
@@ -0,0 +1,372 @@
+#include "nRF24L01_route.h"
+
+/** Standard libs **/
+#include <string.h>
+
+/******************************************************************************/
+/*--------------------------------Local Macros--------------------------------*/
+/******************************************************************************/
+
+#define ROUTE_QUEUE_MASK        (NRF_ROUTE_QUEUE_DEPTH - 1)
+
+#if (NRF_ROUTE_QUEUE_DEPTH & ROUTE_QUEUE_MASK) != 0
+    #error "NRF_ROUTE_QUEUE_DEPTH must be a power of two"
+#endif
+
+/* Longest path through the tree (up to gateway and down again) */
+#define ROUTE_MAX_HOPS          (2 * NRF_ROUTE_MAX_DEPTH)
+
+#define ROUTE_DIGIT_MASK        0x07
+
+/******************************************************************************/
+/*--------------------------Local Data Variables------------------------------*/
+/******************************************************************************/
+
+/** Node fed by the driver RX sink **/
+static NrfRouteCtx_t *volatile routeCtx = NULL;
+
+/** Pointer to Interrupt Controller **/
+static IcSfr_t *const icSfr = &IC_MODULE;
+
+/******************************************************************************/
+/*------------------------Local Function Prototypes---------------------------*/
+/******************************************************************************/
+
+static void RouteSink(const uint8_t *payldPtr, uint8_t length, NrfRxPipeNo_t pipeNo);
+static void RouteComplete(NrfRouteCtx_t *ctx, const NrfOpResult_t *result);
+static bool RouteQueue(NrfRouteCtx_t *ctx, const uint8_t *framePtr, uint8_t length);
+INLINE static uint8_t RouteHopIndex(const NrfRouteCtx_t *ctx, uint16_t dstNode);
+
+
+/******************************************************************************/
+/*----------------------External Function Definitions-------------------------*/
+/******************************************************************************/
+
+/*
+ *  Starts routing as "node" (device configured by NRF_ConfigPtxSfr()
+ *  beforehand), the radio listens on its own pipe address whenever it has
+ *  nothing to forward
+ */
+extern bool NRF_RouteStart(NrfRouteCtx_t *ctx, NrfPayloadConfig_t payldConfig, uint16_t node, NrfRouteHandler_t handler, void *context)
+{
+    if( !NRF_RouteIsValidNode(node) )
+    {
+        return false;
+    }
+
+    memset(ctx, 0, sizeof(NrfRouteCtx_t));
+    ctx->payldConfig = payldConfig;
+    ctx->node = node;
+    ctx->handler = handler;
+    ctx->context = context;
+    ctx->opHandle = NRF_OP_INVALID;
+
+    /* Depth of node is number of its digits */
+    uint8_t depth = 0;
+    while( (node >> (3 * depth)) != 0 )
+    {
+        depth++;
+    }
+
+    ctx->levelShift = 3 * depth;
+    ctx->levelMask = (1 << ctx->levelShift) - 1;
+
+    /* Next hop table, children by their digit and parent at index 0 */
+    ctx->hopNode[0] = node & (ctx->levelMask >> 3);
+    for(uint8_t i = 1; i < 8; i++)
+    {
+        ctx->hopNode[i] = (depth < NRF_ROUTE_MAX_DEPTH) ? (node | (i << ctx->levelShift)) : ctx->hopNode[0];
+    }
+
+    NRF_RouteResetStats(ctx);
+
+    routeCtx = ctx;
+    NRF_SetRxSink(RouteSink);
+
+    return NRF_SwitchToPrx(payldConfig, NRF_ROUTE_PIPE_ADDR(node), ctx->rxBuffer);
+}
+
+
+/*
+ *  Stops taking frames from air (queued frames are discarded, reception
+ *  itself is left running)
+ */
+extern void NRF_RouteStop(NrfRouteCtx_t *ctx)
+{
+    if( routeCtx != ctx )
+    {
+        return;
+    }
+
+    NRF_SetRxSink(NULL);
+    routeCtx = NULL;
+
+    /* Frame being forwarded stays at the head and is released by
+     * NRF_RouteTask(), frames queued behind it are dropped */
+    ctx->queueTail = ctx->queueHead + ((ctx->opHandle != NRF_OP_INVALID) ? 1 : 0);
+}
+
+
+/*
+ *  Queues user data for "dstNode", returns false if data is too long, the
+ *  address is not a node or the queue is full (call NRF_RouteTask() and retry)
+ */
+extern bool NRF_RouteSend(NrfRouteCtx_t *ctx, uint16_t dstNode, const void *dataPtr, uint8_t size)
+{
+    if( (size > NRF_ROUTE_MAX_DATA) || !NRF_RouteIsValidNode(dstNode) )
+    {
+        return false;
+    }
+
+    uint8_t frame[32];
+    frame[0] = (uint8_t)dstNode;
+    frame[1] = (uint8_t)(dstNode >> 8);
+    frame[2] = (uint8_t)ctx->node;
+    frame[3] = (uint8_t)(ctx->node >> 8);
+    frame[4] = 0;
+    memcpy(&frame[NRF_ROUTE_HEADER_SIZE], dataPtr, size);
+
+    /* RX sink appends to the same queue */
+    uint32_t intStatus = __builtin_disable_interrupts();
+    bool isQueued = RouteQueue(ctx, frame, NRF_ROUTE_HEADER_SIZE + size);
+    __builtin_mtc0(12, 0, intStatus);
+
+    return isQueued;
+}
+
+
+/*
+ *  Delivers frames for this node and forwards the others one at a time to
+ *  their next hop, call from main loop (also on relays without own traffic)
+ */
+extern void NRF_RouteTask(NrfRouteCtx_t *ctx)
+{
+    NrfOpResult_t result;
+
+    /* Frame at queue head is being forwarded */
+    if( ctx->opHandle != NRF_OP_INVALID )
+    {
+        if( !NRF_PollOp(ctx->opHandle, &result) )
+        {
+            return;
+        }
+
+        NRF_ReleaseOp(ctx->opHandle);
+        ctx->opHandle = NRF_OP_INVALID;
+        RouteComplete(ctx, &result);
+    }
+
+    while( ctx->queueHead != ctx->queueTail )
+    {
+        NrfRouteSlot_t *slot = &ctx->queue[ctx->queueHead & ROUTE_QUEUE_MASK];
+        uint16_t dstNode = slot->frame[0] | (slot->frame[1] << 8);
+
+        if( dstNode == ctx->node )
+        {
+            if( ctx->handler != NULL )
+            {
+                ctx->handler(slot->frame[2] | (slot->frame[3] << 8), &slot->frame[NRF_ROUTE_HEADER_SIZE],
+                             slot->length - NRF_ROUTE_HEADER_SIZE, slot->frame[4], ctx->context);
+            }
+
+            ctx->stats.delivered++;
+            ctx->queueHead++;
+            continue;
+        }
+
+        /* Payload still waiting in RX FIFO would be flushed by the send */
+        if( !ctx->isPtx )
+        {
+            if( (icSfr->ICxIFS0.W & NRF_INTxIF_MASK) || !NRF_SwitchToPtx(ctx->payldConfig) )
+            {
+                return;
+            }
+            ctx->isPtx = true;
+        }
+
+        ctx->payldConfig.pipeAddr = NRF_ROUTE_PIPE_ADDR(ctx->hopNode[RouteHopIndex(ctx, dstNode)]);
+        ctx->opHandle = NRF_SendPayloadOp(ctx->payldConfig, NULL, slot->frame, slot->length);
+
+        /* Retried on next call if the operation pool is exhausted */
+        return;
+    }
+
+    /* Nothing left to forward, listen again */
+    if( ctx->isPtx && NRF_SwitchToPrx(ctx->payldConfig, NRF_ROUTE_PIPE_ADDR(ctx->node), ctx->rxBuffer) )
+    {
+        ctx->isPtx = false;
+    }
+}
+
+
+/*
+ *  Returns node address of the next hop towards "dstNode"
+ */
+extern uint16_t NRF_RouteNextHop(const NrfRouteCtx_t *ctx, uint16_t dstNode)
+{
+    return ctx->hopNode[RouteHopIndex(ctx, dstNode)];
+}
+
+
+/*
+ *  Checks that address has no zero digit below a non-zero one and fits the
+ *  tree depth
+ */
+extern bool NRF_RouteIsValidNode(uint16_t node)
+{
+    if( node >> (3 * NRF_ROUTE_MAX_DEPTH) )
+    {
+        return false;
+    }
+
+    while( node != 0 )
+    {
+        if( (node & ROUTE_DIGIT_MASK) == 0 )
+        {
+            return false;
+        }
+        node >>= 3;
+    }
+
+    return true;
+}
+
+
+/*
+ *  Reads routing statistics
+ */
+extern void NRF_RouteReadStats(NrfRouteCtx_t *ctx, NrfRouteStats_t *stats)
+{
+    uint32_t intStatus = __builtin_disable_interrupts();
+
+    *stats = ctx->stats;
+    stats->latencyMean = (ctx->stats.forwarded != 0) ? (uint32_t)(ctx->latencySum / ctx->stats.forwarded) : 0;
+    stats->queueDepth = ctx->queueTail - ctx->queueHead;
+
+    __builtin_mtc0(12, 0, intStatus);
+}
+
+
+/*
+ *  Resets routing statistics
+ */
+extern void NRF_RouteResetStats(NrfRouteCtx_t *ctx)
+{
+    uint32_t intStatus = __builtin_disable_interrupts();
+
+    memset((void *)&ctx->stats, 0, sizeof(ctx->stats));
+    ctx->stats.latencyMin = UINT32_MAX;
+    ctx->latencySum = 0;
+
+    __builtin_mtc0(12, 0, intStatus);
+}
+
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+/*
+ *  Driver RX sink (executed within scope of driver ISR), queues frame for
+ *  delivery or forwarding
+ */
+static void RouteSink(const uint8_t *payldPtr, uint8_t length, NrfRxPipeNo_t pipeNo)
+{
+    NrfRouteCtx_t *ctx = routeCtx;
+
+    (void)pipeNo;
+
+    if( (ctx == NULL) || (length < NRF_ROUTE_HEADER_SIZE) )
+    {
+        return;
+    }
+
+    ctx->stats.received++;
+
+    /* Hop count is taken over by queued copy */
+    if( payldPtr[4] >= ROUTE_MAX_HOPS )
+    {
+        ctx->stats.dropped++;
+        return;
+    }
+
+    if( RouteQueue(ctx, payldPtr, length) )
+    {
+        ctx->queue[(ctx->queueTail - 1) & ROUTE_QUEUE_MASK].frame[4]++;
+    }
+}
+
+
+/*
+ *  Accounts frame at queue head once its send has completed
+ */
+static void RouteComplete(NrfRouteCtx_t *ctx, const NrfOpResult_t *result)
+{
+    uint32_t latency = result->timestamp - ctx->queue[ctx->queueHead & ROUTE_QUEUE_MASK].stamp;
+
+    uint32_t intStatus = __builtin_disable_interrupts();
+
+    if( result->status & NRF_FLAG_TX_DS )
+    {
+        ctx->stats.forwarded++;
+        ctx->latencySum += latency;
+
+        if( latency < ctx->stats.latencyMin )
+        {
+            ctx->stats.latencyMin = latency;
+        }
+        if( latency > ctx->stats.latencyMax )
+        {
+            ctx->stats.latencyMax = latency;
+        }
+    }
+    else
+    {
+        ctx->stats.lost++;
+    }
+
+    __builtin_mtc0(12, 0, intStatus);
+
+    ctx->queueHead++;
+}
+
+
+/*
+ *  Appends frame to queue (caller prevents concurrent appends)
+ */
+static bool RouteQueue(NrfRouteCtx_t *ctx, const uint8_t *framePtr, uint8_t length)
+{
+    uint32_t tail = ctx->queueTail;
+    uint8_t depth = tail - ctx->queueHead;
+
+    if( depth >= NRF_ROUTE_QUEUE_DEPTH )
+    {
+        ctx->stats.dropped++;
+        return false;
+    }
+
+    NrfRouteSlot_t *slot = &ctx->queue[tail & ROUTE_QUEUE_MASK];
+    slot->stamp = _CP0_GET_COUNT();
+    slot->length = length;
+    memcpy(slot->frame, framePtr, length);
+
+    ctx->queueTail = tail + 1;
+
+    if( (depth + 1) > ctx->stats.queueMax )
+    {
+        ctx->stats.queueMax = depth + 1;
+    }
+
+    return true;
+}
+
+
+/*
+ *  Looks up next hop table index: descendants share the low digits of own
+ *  address and go to the child named by the following digit, all other
+ *  destinations go to the parent (index 0)
+ */
+INLINE static uint8_t RouteHopIndex(const NrfRouteCtx_t *ctx, uint16_t dstNode)
+{
+    return ((dstNode & ctx->levelMask) == ctx->node) ? ((dstNode >> ctx->levelShift) & ROUTE_DIGIT_MASK) : 0;
+}
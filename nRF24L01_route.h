@@ -0,0 +1,116 @@
+#ifndef NRF24L01_ROUTE_H
+#define	NRF24L01_ROUTE_H
+
+
+/******************************************************************************/
+/*----------------------------------Includes----------------------------------*/
+/******************************************************************************/
+
+/** Custom libs **/
+#include "nRF24L01.h"
+
+/******************************************************************************/
+/*---------------------------------MACROS-------------------------------------*/
+/******************************************************************************/
+
+/* NOTE: Node addresses are octal digits, one per tree level, read from the
+ *       least significant digit: 0 is the gateway, 01-07 its children, 021 the
+ *       first child of 02 and so on. A digit is never 0 below a non-zero one */
+
+/* Tree levels below the gateway (3 bits per level, 15-bit node address) */
+#define NRF_ROUTE_MAX_DEPTH     5
+
+/* Gateway (tree root) node address */
+#define NRF_ROUTE_GATEWAY       0
+
+/* Frames waiting for delivery or forwarding (must be a power of two) */
+#ifndef NRF_ROUTE_QUEUE_DEPTH
+#define NRF_ROUTE_QUEUE_DEPTH   8
+#endif
+
+/* Pipe address a node listens on (node address in the two low bytes) */
+#ifndef NRF_ROUTE_ADDR_BASE
+#define NRF_ROUTE_ADDR_BASE     0xC2C2C20000
+#endif
+
+#define NRF_ROUTE_PIPE_ADDR(node)   (NRF_ROUTE_ADDR_BASE | (uint16_t)(node))
+
+/* Routing header and user data per frame */
+#define NRF_ROUTE_HEADER_SIZE   5
+#define NRF_ROUTE_MAX_DATA      (32 - NRF_ROUTE_HEADER_SIZE)
+
+/* NOTE: Frame layout
+ *       [0-1]  Destination node address (little-endian)
+ *       [2-3]  Source node address
+ *       [4]    Hops taken so far (frames over 2 * NRF_ROUTE_MAX_DEPTH hops are
+ *              dropped, which only happens with misconfigured nodes)
+ *       [..]   User data */
+
+/******************************************************************************/
+/*-----------------------------Data Structures--------------------------------*/
+/******************************************************************************/
+
+/* Delivery handler, called from NRF_RouteTask() with frames for this node */
+typedef void (*NrfRouteHandler_t)(uint16_t srcNode, const uint8_t *dataPtr, uint8_t size, uint8_t hops, void *context);
+
+/* Routing statistics, hop latency from frame arrival (or NRF_RouteSend()) to
+ * its acknowledgment by the next hop in core timer ticks (1 tick = 2 SYSCLK) */
+typedef struct {
+    uint32_t    received;           // Frames taken from air
+    uint32_t    delivered;          // Frames handed to delivery handler
+    uint32_t    forwarded;          // Frames acknowledged by next hop (incl. own)
+    uint32_t    lost;               // Frames not acknowledged by next hop
+    uint32_t    dropped;            // Frames dropped on full queue or hop limit
+    uint32_t    latencyMin;
+    uint32_t    latencyMax;
+    uint32_t    latencyMean;
+    uint8_t     queueDepth;         // Frames queued right now
+    uint8_t     queueMax;           // Highest queue depth seen
+} NrfRouteStats_t;
+
+/* Queue slot holds a complete frame */
+typedef struct {
+    uint32_t    stamp;              // Core timer count when frame was queued
+    uint8_t     length;
+    uint8_t     frame[32];
+} NrfRouteSlot_t;
+
+/* Routing state of a node */
+typedef struct {
+    NrfPayloadConfig_t      payldConfig;
+    uint16_t                node;
+    uint16_t                levelMask;              // Digits of own address
+    uint8_t                 levelShift;             // Position of child digit
+    uint16_t                hopNode[8];             // Next hop by child digit (0 = parent)
+    NrfRouteHandler_t       handler;
+    void                   *context;
+
+    bool                    isPtx;
+    NrfOpHandle_t           opHandle;               // Frame being forwarded (NRF_OP_INVALID if none)
+    uint8_t                 rxBuffer[32];
+
+    /* Queue (free-running indexes, RX sink and NRF_RouteSend() append) */
+    volatile uint32_t       queueTail;
+    volatile uint32_t       queueHead;
+    NrfRouteSlot_t          queue[NRF_ROUTE_QUEUE_DEPTH];
+
+    /* Statistics */
+    volatile NrfRouteStats_t    stats;
+    uint64_t                latencySum;
+} NrfRouteCtx_t;
+
+/******************************************************************************/
+/*---------------------------- Function Prototypes----------------------------*/
+/******************************************************************************/
+
+bool NRF_RouteStart(NrfRouteCtx_t *ctx, NrfPayloadConfig_t payldConfig, uint16_t node, NrfRouteHandler_t handler, void *context);
+void NRF_RouteStop(NrfRouteCtx_t *ctx);
+bool NRF_RouteSend(NrfRouteCtx_t *ctx, uint16_t dstNode, const void *dataPtr, uint8_t size);
+void NRF_RouteTask(NrfRouteCtx_t *ctx);
+uint16_t NRF_RouteNextHop(const NrfRouteCtx_t *ctx, uint16_t dstNode);
+bool NRF_RouteIsValidNode(uint16_t node);
+void NRF_RouteReadStats(NrfRouteCtx_t *ctx, NrfRouteStats_t *stats);
+void NRF_RouteResetStats(NrfRouteCtx_t *ctx);
+
+
+#endif	/* NRF24L01_ROUTE_H */
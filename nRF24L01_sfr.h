@@ -9,9 +9,9 @@
 /******************************************************************************/
 
 /* SPI commands */
-#define NRF_WRITE_CMD(regAddr)          ({ (0x20 | (regAddr & 0x1F)); })
-#define NRF_READ_CMD(regAddr)           ({ (0x00 | (regAddr & 0x1F)); })
-#define NRF_WRITE_ACK_PL_CMD(pipeNum)   ({ (0xA8 | (pipeNum & 0x07)); })   
+#define NRF_WRITE_CMD(regAddr)          (0x20 | ((regAddr) & 0x1F))
+#define NRF_READ_CMD(regAddr)           (0x00 | ((regAddr) & 0x1F))
+#define NRF_WRITE_ACK_PL_CMD(pipeNum)   (0xA8 | ((pipeNum) & 0x07))   
 #define NRF_READ_RX_PL_CMD              (0x61)
 #define NRF_WRITE_TX_PL_CMD             (0xA0)
 #define NRF_FLUSH_TX_CMD                (0xE1)
@@ -0,0 +1,512 @@
+#include "nRF24L01_sniff.h"
+
+/** Standard libs **/
+#include <stddef.h>
+#include <string.h>
+
+/******************************************************************************/
+/*--------------------------------Local Macros--------------------------------*/
+/******************************************************************************/
+
+/* Power-up time of capture radio */
+#define SNIFF_POWER_UP_US       1500
+
+#define SNIFF_RING_MASK         (NRF_SNIFF_RING_DEPTH - 1)
+
+#if (NRF_SNIFF_RING_DEPTH & SNIFF_RING_MASK) != 0
+    #error "NRF_SNIFF_RING_DEPTH must be a power of two"
+#endif
+
+/* RX_P_NO value of empty RX FIFO */
+#define SNIFF_RX_FIFO_EMPTY     NRF_RX_P_NO_MASK
+
+/* Pseudo-header preceding raw bytes in each pcap record */
+#define SNIFF_PSEUDO_SIZE       16
+#define SNIFF_PSEUDO_VERSION    1
+#define SNIFF_FLAG_DECODED      0x01
+#define SNIFF_FLAG_NO_ACK       0x02
+#define SNIFF_FLAG_OVERRUN      0x04
+
+/* Bits of Packet Control Field (6-bit length, 2-bit PID, NO_ACK) */
+#define SNIFF_PCF_BITS          9
+
+/******************************************************************************/
+/*--------------------------Local Data Variables------------------------------*/
+/******************************************************************************/
+
+/** Capture ring (free-running indexes, ISR appends, export removes) **/
+static NrfSniffRecord_t sniffRing[NRF_SNIFF_RING_DEPTH];
+static volatile uint32_t ringHead;
+static volatile uint32_t ringTail;
+static volatile bool isOverrun;
+
+/** Capture radio state **/
+static SpiSfr_t *sniffSpiSfr;
+static NrfPinConfig_t sniffPinConfig;
+static uint8_t sniffChannel;
+static NrfDataRate_t sniffDataRate;
+static uint64_t sniffAddr;
+static uint8_t sniffAddrWidth;
+static volatile bool isSniffActive = false;
+static volatile uint8_t txData[2];
+static volatile uint8_t rxData[6];         // Sized for address writes
+
+/* Ring records are read in a single transaction starting at "status" */
+_Static_assert(offsetof(NrfSniffRecord_t, frame) == (offsetof(NrfSniffRecord_t, status) + 1),
+               "NrfSniffRecord_t: frame must directly follow status");
+
+/* R_RX_PAYLOAD command followed by dummy bytes */
+static uint8_t readCmd[1 + NRF_SNIFF_FRAME_SIZE] = { NRF_READ_RX_PL_CMD };
+
+/** pcap timestamps (core timer extended beyond 32 bits) **/
+static uint32_t exportStamp;
+static uint64_t exportTicks;
+
+/** Statistics **/
+static volatile NrfSniffStats_t sniffStats;
+
+/** Pointer to Interrupt Controller **/
+static IcSfr_t *const icSfr = &IC_MODULE;
+
+/******************************************************************************/
+/*------------------------Local Function Prototypes---------------------------*/
+/******************************************************************************/
+
+static bool SniffDecodeAt(const uint8_t *bufPtr, uint16_t bitCount, uint16_t start, uint8_t aw, NrfSniffEsb_t *esb);
+INLINE static uint16_t SniffBits(const uint8_t *bufPtr, uint16_t pos, uint8_t count);
+INLINE static void SniffRegWrite(uint8_t reg, uint8_t value);
+INLINE static uint8_t SniffRegRead(uint8_t reg);
+static void SniffAddrWrite(uint8_t reg, uint64_t addr, uint8_t width);
+static inline void Le16Write(uint8_t *bufPtr, uint16_t value);
+static inline void Le32Write(uint8_t *bufPtr, uint32_t value);
+
+
+/******************************************************************************/
+/*----------------------External Function Definitions-------------------------*/
+/******************************************************************************/
+
+/*
+ *  Configures capture radio as a wide-acceptance receiver (no CRC, no
+ *  auto-ACK, fixed 32-byte payload) and starts recording frames into ring
+ */
+extern bool NRF_SniffStart(NrfSniffConfig_t sniffConfig)
+{
+    if( (sniffConfig.addrWidth < 2) || (sniffConfig.addrWidth > 5) )
+    {
+        return false;
+    }
+
+    NRF_SniffStop();
+
+    sniffSpiSfr = sniffConfig.spiSfr;
+    sniffPinConfig = sniffConfig.pinConfig;
+    sniffChannel = sniffConfig.rfChannel;
+    sniffDataRate = sniffConfig.dataRate;
+    sniffAddr = sniffConfig.addr;
+    sniffAddrWidth = sniffConfig.addrWidth;
+
+    /* IRQ pin as non-GPIO, controlled by Interrupt Controller */
+    PIO_ConfigPpsSfr(sniffPinConfig.irqPin);
+
+    /* Configure PIO settings for CE and IRQ pins (CS configured by SPI) */
+    PIO_ConfigGpioPin(sniffPinConfig.cePin, PIO_TYPE_DIGITAL, PIO_DIR_OUTPUT);
+    PIO_ConfigPpsPin(sniffPinConfig.irqPin, PIO_TYPE_DIGITAL);
+    PIO_ConfigGpioPinPull(sniffPinConfig.irqPin, PIO_CN_PULLUP);
+    PIO_ClearPin(sniffPinConfig.cePin);
+
+    SPI_EnableSsState(sniffPinConfig.csPin);
+
+    /* Device not responding or SPI not configured */
+    if( SniffRegRead(NRF_STATUS_REG) == NRF_FLAG_NO_RP )
+    {
+        return false;
+    }
+
+    /* PRX without CRC and ACK, only RX events raise IRQ */
+    SniffRegWrite(NRF_CONFIG_REG, NRF_PWR_UP_MASK | NRF_PRIM_RX_MASK | NRF_MASK_TX_DS_MASK | NRF_MASK_MAX_RT_MASK);
+    SniffRegWrite(NRF_EN_AA_REG, 0x00);
+    SniffRegWrite(NRF_EN_RXADDR_REG, NRF_ERX_P0_MASK);
+    SniffRegWrite(NRF_SETUP_AW_REG, (sniffAddrWidth - 2) & NRF_AW_MASK);
+    SniffRegWrite(NRF_RF_CH_REG, sniffChannel << NRF_RF_CH_POS);
+    SniffRegWrite(NRF_RF_SETUP_REG, ((sniffDataRate & 0x1) << NRF_RF_DR_HIGH_POS) |
+                                    ((sniffDataRate & 0x2) << NRF_RF_DR_LOW_POS));
+    SniffRegWrite(NRF_FEATURE_REG, 0x00);
+    SniffRegWrite(NRF_DYNPD_REG, 0x00);
+    SniffRegWrite(NRF_RX_PW_P0_REG, NRF_SNIFF_FRAME_SIZE);
+    SniffAddrWrite(NRF_RX_ADDR_P0_REG, sniffAddr, sniffAddrWidth);
+
+    txData[0] = NRF_FLUSH_RX_CMD;
+    SPI_MasterReadWrite(sniffSpiSfr, rxData, txData, 1);
+    SniffRegWrite(NRF_STATUS_REG, NRF_MAX_RT_MASK | NRF_TX_DS_MASK | NRF_RX_DR_MASK);
+
+    TMR_DelayUs(SNIFF_POWER_UP_US);
+
+    ringHead = ringTail = 0;
+    isOverrun = false;
+    exportStamp = _CP0_GET_COUNT();
+    exportTicks = 0;
+    memset((void *)&sniffStats, 0, sizeof(sniffStats));
+
+    /* Configure capture radio INTx */
+    icSfr->ICxIEC0.CLR = NRF_SNIFF_INTxIE_MASK;
+    icSfr->NRF_SNIFF_ICxIPC.CLR = NRF_SNIFF_IPC_MASK;
+    icSfr->NRF_SNIFF_ICxIPC.SET = NRF_SNIFF_IPC_VALUE;
+    icSfr->ICxINTCON.CLR = NRF_SNIFF_INTxEP_MASK;       // Falling-edge triggered
+    icSfr->ICxIFS0.CLR = NRF_SNIFF_INTxIF_MASK;
+    icSfr->ICxIEC0.SET = NRF_SNIFF_INTxIE_MASK;
+
+    isSniffActive = true;
+    PIO_SetPin(sniffPinConfig.cePin);
+
+    return true;
+}
+
+
+/*
+ *  Stops capture (recorded frames stay in ring until exported)
+ */
+extern void NRF_SniffStop(void)
+{
+    if( !isSniffActive )
+    {
+        return;
+    }
+
+    isSniffActive = false;
+    PIO_ClearPin(sniffPinConfig.cePin);
+
+    icSfr->ICxIEC0.CLR = NRF_SNIFF_INTxIE_MASK;
+    icSfr->ICxIFS0.CLR = NRF_SNIFF_INTxIF_MASK;
+}
+
+
+/*
+ *  Moves up to "maxCount" of the oldest captured frames into "bufPtr",
+ *  returns number of frames moved
+ */
+extern uint32_t NRF_SniffRead(NrfSniffRecord_t *bufPtr, uint32_t maxCount)
+{
+    uint32_t count = 0;
+
+    while( (count < maxCount) && (ringTail != ringHead) )
+    {
+        bufPtr[count++] = sniffRing[ringTail & SNIFF_RING_MASK];
+        ringTail++;
+    }
+
+    return count;
+}
+
+
+/*
+ *  Looks for an ESB frame with valid CRC-16 in captured bytes. With a full
+ *  address configured the frame starts right after it, in promiscuous mode
+ *  address widths 3-5 are tried at every bit offset of the first byte
+ */
+extern bool NRF_SniffDecode(const NrfSniffRecord_t *record, NrfSniffEsb_t *esb)
+{
+    uint8_t buf[5 + NRF_SNIFF_FRAME_SIZE];
+
+    /* Address matched by the chip isn't clocked out, put it back on-air
+     * order (MSByte first) so it is covered by CRC */
+    if( sniffAddrWidth > 2 )
+    {
+        for(uint8_t i = 0; i < sniffAddrWidth; i++)
+        {
+            buf[i] = (uint8_t)(sniffAddr >> (8 * (sniffAddrWidth - 1 - i)));
+        }
+        memcpy(&buf[sniffAddrWidth], record->frame, NRF_SNIFF_FRAME_SIZE);
+
+        return SniffDecodeAt(buf, 8 * (sniffAddrWidth + NRF_SNIFF_FRAME_SIZE), 0, sniffAddrWidth, esb);
+    }
+
+    for(uint8_t aw = 5; aw >= 3; aw--)
+    {
+        for(uint8_t start = 0; start < 8; start++)
+        {
+            if( SniffDecodeAt(record->frame, 8 * NRF_SNIFF_FRAME_SIZE, start, aw, esb) )
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+/*
+ *  Writes pcap global header, call once before the first export
+ */
+extern bool NRF_SniffPcapHeader(NrfSniffWriter_t writer, void *context)
+{
+    uint8_t header[24];
+
+    Le32Write(&header[0], 0xA1B2C3D4);              // Microsecond timestamps
+    Le16Write(&header[4], 2);
+    Le16Write(&header[6], 4);
+    Le32Write(&header[8], 0);                       // UTC offset
+    Le32Write(&header[12], 0);                      // Timestamp accuracy
+    Le32Write(&header[16], SNIFF_PSEUDO_SIZE + NRF_SNIFF_FRAME_SIZE);
+    Le32Write(&header[20], NRF_SNIFF_LINKTYPE);
+
+    return writer(header, sizeof(header), context);
+}
+
+
+/*
+ *  Drains up to "maxCount" captured frames from ring as pcap records with
+ *  ESB pseudo-header, returns number of frames written (call from main loop
+ *  at least once per core timer wrap, so timestamps stay monotonic)
+ */
+extern uint32_t NRF_SniffPcapExport(NrfSniffWriter_t writer, void *context, uint32_t maxCount)
+{
+    uint32_t ticksPerUs = OSC_GetSysFreq() / 1000000 / 2;
+    uint32_t count = 0;
+    NrfSniffRecord_t record;
+    NrfSniffEsb_t esb;
+    uint8_t rec[16 + SNIFF_PSEUDO_SIZE + NRF_SNIFF_FRAME_SIZE];
+
+    while( (count < maxCount) && (ringTail != ringHead) )
+    {
+        record = sniffRing[ringTail & SNIFF_RING_MASK];
+
+        /* Timestamps relative to capture start */
+        exportTicks += record.timestamp - exportStamp;
+        exportStamp = record.timestamp;
+        uint64_t us = exportTicks / ticksPerUs;
+
+        bool isDecoded = NRF_SniffDecode(&record, &esb);
+        if( !isDecoded )
+        {
+            memset(&esb, 0, sizeof(esb));
+        }
+
+        /* Record header */
+        Le32Write(&rec[0], (uint32_t)(us / 1000000));
+        Le32Write(&rec[4], (uint32_t)(us % 1000000));
+        Le32Write(&rec[8], SNIFF_PSEUDO_SIZE + NRF_SNIFF_FRAME_SIZE);
+        Le32Write(&rec[12], SNIFF_PSEUDO_SIZE + NRF_SNIFF_FRAME_SIZE);
+
+        /* ESB pseudo-header */
+        uint8_t *pseudo = &rec[16];
+        pseudo[0] = SNIFF_PSEUDO_VERSION;
+        pseudo[1] = (isDecoded ? SNIFF_FLAG_DECODED : 0) |
+                    (esb.isNoAck ? SNIFF_FLAG_NO_ACK : 0) |
+                    (record.isOverrun ? SNIFF_FLAG_OVERRUN : 0);
+        pseudo[2] = record.channel;
+        pseudo[3] = sniffDataRate;
+        pseudo[4] = esb.addrWidth;
+        for(uint8_t i = 0; i < 5; i++)
+        {
+            pseudo[5 + i] = (uint8_t)(esb.addr >> (8 * i));
+        }
+        pseudo[10] = esb.length;
+        pseudo[11] = esb.pid;
+        Le16Write(&pseudo[12], esb.crc);
+        pseudo[14] = esb.bitOffset;
+        pseudo[15] = 0;
+        memcpy(&pseudo[SNIFF_PSEUDO_SIZE], record.frame, NRF_SNIFF_FRAME_SIZE);
+
+        if( !writer(rec, sizeof(rec), context) )
+        {
+            break;
+        }
+
+        ringTail++;
+        count++;
+        sniffStats.exported++;
+        if( isDecoded )
+        {
+            sniffStats.decoded++;
+        }
+    }
+
+    return count;
+}
+
+
+/*
+ *  Reads capture counters
+ */
+extern void NRF_SniffReadStats(NrfSniffStats_t *stats)
+{
+    uint32_t intStatus = __builtin_disable_interrupts();
+    *stats = sniffStats;
+    __builtin_mtc0(12, 0, intStatus);
+}
+
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+/*
+ *  Checks for ESB frame with "aw"-byte address at bit "start": address, PCF,
+ *  payload and CRC-16 (CCITT, initial value 0xFFFF) over all preceding bits
+ */
+static bool SniffDecodeAt(const uint8_t *bufPtr, uint16_t bitCount, uint16_t start, uint8_t aw, NrfSniffEsb_t *esb)
+{
+    uint16_t pos = start + 8 * aw;
+
+    if( (pos + SNIFF_PCF_BITS + 16) > bitCount )
+    {
+        return false;
+    }
+
+    uint16_t pcf = SniffBits(bufPtr, pos, SNIFF_PCF_BITS);
+    uint8_t length = pcf >> 3;
+    uint16_t end = pos + SNIFF_PCF_BITS + 8 * length;
+
+    if( (length > 32) || ((end + 16) > bitCount) )
+    {
+        return false;
+    }
+
+    uint16_t crc = 0xFFFF;
+    for(uint16_t i = start; i < end; i++)
+    {
+        uint16_t bit = (bufPtr[i >> 3] >> (7 - (i & 7))) & 0x01;
+        crc = ((crc >> 15) ^ bit) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+    }
+
+    if( crc != SniffBits(bufPtr, end, 16) )
+    {
+        return false;
+    }
+
+    esb->addr = 0;
+    for(uint8_t i = 0; i < aw; i++)
+    {
+        esb->addr = (esb->addr << 8) | SniffBits(bufPtr, start + 8 * i, 8);
+    }
+    esb->addrWidth = aw;
+    esb->length = length;
+    esb->pid = (pcf >> 1) & 0x03;
+    esb->isNoAck = pcf & 0x01;
+    esb->crc = crc;
+    esb->bitOffset = start;
+    for(uint8_t i = 0; i < length; i++)
+    {
+        esb->payload[i] = SniffBits(bufPtr, pos + SNIFF_PCF_BITS + 8 * i, 8);
+    }
+
+    return true;
+}
+
+
+/*
+ *  Reads up to 16 bits at bit position "pos" (MSBit first)
+ */
+INLINE static uint16_t SniffBits(const uint8_t *bufPtr, uint16_t pos, uint8_t count)
+{
+    uint16_t value = 0;
+
+    for(uint8_t i = 0; i < count; i++, pos++)
+    {
+        value = (value << 1) | ((bufPtr[pos >> 3] >> (7 - (pos & 7))) & 0x01);
+    }
+
+    return value;
+}
+
+
+INLINE static void SniffRegWrite(uint8_t reg, uint8_t value)
+{
+    txData[0] = NRF_WRITE_CMD(reg);
+    txData[1] = value;
+    SPI_MasterReadWrite(sniffSpiSfr, rxData, txData, 2);
+}
+
+
+INLINE static uint8_t SniffRegRead(uint8_t reg)
+{
+    txData[0] = NRF_READ_CMD(reg);
+    txData[1] = 0x00;
+    SPI_MasterReadWrite(sniffSpiSfr, rxData, txData, 2);
+
+    return rxData[0] ? rxData[1] : NRF_FLAG_NO_RP;
+}
+
+
+static void SniffAddrWrite(uint8_t reg, uint64_t addr, uint8_t width)
+{
+    uint8_t addrData[6] = { NRF_WRITE_CMD(reg) };
+
+    /* LSByte first */
+    for(uint8_t i = 0; i < width; i++)
+    {
+        addrData[i + 1] = (uint8_t)(addr >> (8 * i));
+    }
+
+    SPI_MasterReadWrite(sniffSpiSfr, rxData, addrData, width + 1);
+}
+
+
+static inline void Le16Write(uint8_t *bufPtr, uint16_t value)
+{
+    bufPtr[0] = (uint8_t)value;
+    bufPtr[1] = (uint8_t)(value >> 8);
+}
+
+
+static inline void Le32Write(uint8_t *bufPtr, uint32_t value)
+{
+    bufPtr[0] = (uint8_t)value;
+    bufPtr[1] = (uint8_t)(value >> 8);
+    bufPtr[2] = (uint8_t)(value >> 16);
+    bufPtr[3] = (uint8_t)(value >> 24);
+}
+
+
+/******************************************************************************/
+/*-----------------------------Interrupt Routines-----------------------------*/
+/******************************************************************************/
+
+/*
+ *  Capture radio ISR: moves every frame waiting in RX FIFO into ring
+ */
+void __ISR(NRF_SNIFF_ISR_VECTOR, NRF_SNIFF_ISR_IPL) ISR_NrfSniff(void)
+{
+    uint32_t now = _CP0_GET_COUNT();
+
+    icSfr->ICxIFS0.CLR = NRF_SNIFF_INTxIF_MASK;
+
+    /* Clear RX flag first, frames arriving meanwhile raise a new edge */
+    txData[0] = NRF_WRITE_CMD(NRF_STATUS_REG);
+    txData[1] = NRF_RX_DR_MASK;
+    SPI_MasterReadWrite(sniffSpiSfr, rxData, txData, 2);
+    uint8_t status = rxData[0];
+
+    while( (status & NRF_RX_P_NO_MASK) != SNIFF_RX_FIFO_EMPTY )
+    {
+        uint32_t head = ringHead;
+
+        /* Ring full, newest frame is dropped (read out anyway to free FIFO) */
+        if( (head - ringTail) >= NRF_SNIFF_RING_DEPTH )
+        {
+            uint8_t discard[1 + NRF_SNIFF_FRAME_SIZE];
+            SPI_MasterReadWrite(sniffSpiSfr, discard, readCmd, sizeof(readCmd));
+            sniffStats.overruns++;
+            isOverrun = true;
+        }
+        else
+        {
+            NrfSniffRecord_t *record = &sniffRing[head & SNIFF_RING_MASK];
+            record->timestamp = now;
+            record->channel = sniffChannel;
+            record->isOverrun = isOverrun;
+
+            /* STATUS byte and frame land next to each other */
+            SPI_MasterReadWrite(sniffSpiSfr, &record->status, readCmd, sizeof(readCmd));
+
+            isOverrun = false;
+            ringHead = head + 1;
+            sniffStats.captured++;
+        }
+
+        txData[0] = NRF_NOP_CMD;
+        SPI_MasterReadWrite(sniffSpiSfr, rxData, txData, 1);
+        status = rxData[0];
+    }
+}
@@ -0,0 +1,184 @@
+#ifndef NRF24L01_SNIFF_H
+#define	NRF24L01_SNIFF_H
+
+
+/******************************************************************************/
+/*----------------------------------Includes----------------------------------*/
+/******************************************************************************/
+
+/** Custom libs **/
+#include "nRF24L01.h"
+
+/******************************************************************************/
+/*---------------------------------MACROS-------------------------------------*/
+/******************************************************************************/
+
+/**************************Interrupt vector priority***************************/
+
+/* NOTE: IPL = 0 means interrupt disabled. ISR_IPL level must equal ICX_IPL */
+
+/* User-defined (sub)priority levels (IPL: 0-7, ISL: 0-3) */
+#define NRF_SNIFF_ISR_IPL       IPL2SOFT
+#define NRF_SNIFF_ICX_IPL       2
+#define NRF_SNIFF_ICX_ISL       0
+
+/******************************************************************************/
+
+/* User-defined External Interrupt INTx vector of capture radio (must differ
+ * from the driver INTx vector if the driver is linked too) */
+#define SNIFF_INT4_ISR_MACRO
+
+
+/* Macro used by the ISR definition in sniffer module */
+#if defined SNIFF_INT0_ISR_MACRO
+
+    #define NRF_SNIFF_ISR_VECTOR    EXTERNAL_0_VECTOR
+    #define NRF_SNIFF_INTxIF_MASK   IC_INT0IF_MASK
+    #define NRF_SNIFF_INTxIE_MASK   IC_INT0IE_MASK
+    #define NRF_SNIFF_ICxIPC        ICxIPC0
+    #define NRF_SNIFF_IPC_MASK      (IC_INT0IS_MASK | IC_INT0IP_MASK)
+    #define NRF_SNIFF_IPC_VALUE     ((NRF_SNIFF_ICX_ISL << IC_INT0IS_POS) | (NRF_SNIFF_ICX_IPL << IC_INT0IP_POS))
+    #define NRF_SNIFF_INTxEP_MASK   IC_INT0EP_MASK
+
+#elif defined SNIFF_INT1_ISR_MACRO
+
+    #define NRF_SNIFF_ISR_VECTOR    EXTERNAL_1_VECTOR
+    #define NRF_SNIFF_INTxIF_MASK   IC_INT1IF_MASK
+    #define NRF_SNIFF_INTxIE_MASK   IC_INT1IE_MASK
+    #define NRF_SNIFF_ICxIPC        ICxIPC1
+    #define NRF_SNIFF_IPC_MASK      (IC_INT1IS_MASK | IC_INT1IP_MASK)
+    #define NRF_SNIFF_IPC_VALUE     ((NRF_SNIFF_ICX_ISL << IC_INT1IS_POS) | (NRF_SNIFF_ICX_IPL << IC_INT1IP_POS))
+    #define NRF_SNIFF_INTxEP_MASK   IC_INT1EP_MASK
+
+#elif defined SNIFF_INT2_ISR_MACRO
+
+    #define NRF_SNIFF_ISR_VECTOR    EXTERNAL_2_VECTOR
+    #define NRF_SNIFF_INTxIF_MASK   IC_INT2IF_MASK
+    #define NRF_SNIFF_INTxIE_MASK   IC_INT2IE_MASK
+    #define NRF_SNIFF_ICxIPC        ICxIPC2
+    #define NRF_SNIFF_IPC_MASK      (IC_INT2IS_MASK | IC_INT2IP_MASK)
+    #define NRF_SNIFF_IPC_VALUE     ((NRF_SNIFF_ICX_ISL << IC_INT2IS_POS) | (NRF_SNIFF_ICX_IPL << IC_INT2IP_POS))
+    #define NRF_SNIFF_INTxEP_MASK   IC_INT2EP_MASK
+
+#elif defined SNIFF_INT3_ISR_MACRO
+
+    #define NRF_SNIFF_ISR_VECTOR    EXTERNAL_3_VECTOR
+    #define NRF_SNIFF_INTxIF_MASK   IC_INT3IF_MASK
+    #define NRF_SNIFF_INTxIE_MASK   IC_INT3IE_MASK
+    #define NRF_SNIFF_ICxIPC        ICxIPC3
+    #define NRF_SNIFF_IPC_MASK      (IC_INT3IS_MASK | IC_INT3IP_MASK)
+    #define NRF_SNIFF_IPC_VALUE     ((NRF_SNIFF_ICX_ISL << IC_INT3IS_POS) | (NRF_SNIFF_ICX_IPL << IC_INT3IP_POS))
+    #define NRF_SNIFF_INTxEP_MASK   IC_INT3EP_MASK
+
+#elif defined SNIFF_INT4_ISR_MACRO
+
+    #define NRF_SNIFF_ISR_VECTOR    EXTERNAL_4_VECTOR
+    #define NRF_SNIFF_INTxIF_MASK   IC_INT4IF_MASK
+    #define NRF_SNIFF_INTxIE_MASK   IC_INT4IE_MASK
+    #define NRF_SNIFF_ICxIPC        ICxIPC4
+    #define NRF_SNIFF_IPC_MASK      (IC_INT4IS_MASK | IC_INT4IP_MASK)
+    #define NRF_SNIFF_IPC_VALUE     ((NRF_SNIFF_ICX_ISL << IC_INT4IS_POS) | (NRF_SNIFF_ICX_IPL << IC_INT4IP_POS))
+    #define NRF_SNIFF_INTxEP_MASK   IC_INT4EP_MASK
+
+#else
+
+    #error "Define INTx vector for nRF24L01_sniff.c"
+
+#endif
+
+/******************************Capture settings********************************/
+
+/* Captured frames kept until exported (must be a power of two) */
+#ifndef NRF_SNIFF_RING_DEPTH
+#define NRF_SNIFF_RING_DEPTH    64
+#endif
+
+/* Raw bytes captured per frame (fixed maximum payload width) */
+#define NRF_SNIFF_FRAME_SIZE    32
+
+/* Promiscuous addresses: a noise byte followed by preamble (2-byte address
+ * width), frames of any address are caught from their own address on. Use
+ * the one whose pattern continues into the first address bit of interest */
+#define NRF_SNIFF_ADDR_PREAMBLE_AA  0x00AA
+#define NRF_SNIFF_ADDR_PREAMBLE_55  0x0055
+
+/* pcap link type of exported files (LINKTYPE_USER0) */
+#define NRF_SNIFF_LINKTYPE      147
+
+/* NOTE: pcap record layout (all values little-endian)
+ *       [0]      Pseudo-header version (1)
+ *       [1]      Flags: bit 0 ESB frame decoded (CRC-16 valid), bit 1 NO_ACK,
+ *                bit 2 ring overrun right before this frame
+ *       [2]      RF channel
+ *       [3]      Data rate (NrfDataRate_t)
+ *       [4]      Address width of decoded frame (0 if not decoded)
+ *       [5-9]    Address (LSByte first, as in pipe address registers)
+ *       [10]     Payload length (PCF)
+ *       [11]     PID (PCF)
+ *       [12-13]  CRC-16
+ *       [14]     Bit offset of decoded frame in captured bytes
+ *       [15]     Reserved
+ *       [16-47]  Raw captured bytes, as clocked out of the RX FIFO */
+
+/******************************************************************************/
+/*-----------------------------Data Structures--------------------------------*/
+/******************************************************************************/
+
+/* Capture radio configuration, "addrWidth" 2 (promiscuous, chip value 00 is
+ * not documented but matches 2 bytes) to 5 */
+typedef struct {
+    SpiSfr_t *const         spiSfr;
+    NrfRfChannel_t          rfChannel;
+    NrfDataRate_t           dataRate;
+    uint64_t                addr;
+    uint8_t                 addrWidth;
+    NrfPinConfig_t          pinConfig;
+} const NrfSniffConfig_t;
+
+/* Single captured frame (status byte and frame are read in one transaction,
+ * so "frame" must directly follow "status") */
+typedef struct {
+    uint32_t    timestamp;          // Core timer count at IRQ
+    uint8_t     channel;
+    uint8_t     isOverrun;          // Frames were dropped right before this one
+    uint8_t     status;             // nRF STATUS byte
+    uint8_t     frame[NRF_SNIFF_FRAME_SIZE];
+} NrfSniffRecord_t;
+
+/* Enhanced ShockBurst frame found in captured bytes */
+typedef struct {
+    uint64_t    addr;               // LSByte first, as in pipe address registers
+    uint8_t     addrWidth;
+    uint8_t     length;
+    uint8_t     pid;
+    bool        isNoAck;
+    uint16_t    crc;
+    uint8_t     bitOffset;
+    uint8_t     payload[32];
+} NrfSniffEsb_t;
+
+/* Capture counters */
+typedef struct {
+    uint32_t    captured;           // Frames put into ring
+    uint32_t    overruns;           // Frames dropped on full ring
+    uint32_t    exported;           // Frames written as pcap records
+    uint32_t    decoded;            // Exported frames with valid ESB CRC
+} NrfSniffStats_t;
+
+/* pcap output, writes "size" bytes, returns false to abort export */
+typedef bool (*NrfSniffWriter_t)(const void *dataPtr, uint32_t size, void *context);
+
+/******************************************************************************/
+/*---------------------------- Function Prototypes----------------------------*/
+/******************************************************************************/
+
+bool NRF_SniffStart(NrfSniffConfig_t sniffConfig);
+void NRF_SniffStop(void);
+uint32_t NRF_SniffRead(NrfSniffRecord_t *bufPtr, uint32_t maxCount);
+bool NRF_SniffDecode(const NrfSniffRecord_t *record, NrfSniffEsb_t *esb);
+bool NRF_SniffPcapHeader(NrfSniffWriter_t writer, void *context);
+uint32_t NRF_SniffPcapExport(NrfSniffWriter_t writer, void *context, uint32_t maxCount);
+void NRF_SniffReadStats(NrfSniffStats_t *stats);
+
+
+#endif	/* NRF24L01_SNIFF_H */